@@ -0,0 +1,24 @@
+// bindless.glsl
+// Declarations matching VulkanBindlessTable (set 1) and BindlessPushConstants.
+// Needs #extension GL_EXT_nonuniform_qualifier : require in the including shader.
+
+layout(set = 1, binding = 0) readonly buffer BindlessBuffer {
+    uint words[];
+} bindlessBuffers[];
+
+layout(set = 1, binding = 1) uniform texture2D bindlessTextures[];
+layout(set = 1, binding = 2) uniform sampler bindlessSamplers[];
+
+layout(push_constant) uniform BindlessPushConstants {
+    uint bufferIndex;
+    uint textureIndex;
+    uint samplerIndex;
+    uint meshBufferIndex;
+} draw;
+
+const uint kInvalidIndex = 0xFFFFFFFFu;
+
+vec4 sampleBindless(uint textureIndex, uint samplerIndex, vec2 uv) {
+    return texture(sampler2D(bindlessTextures[nonuniformEXT(textureIndex)],
+                             bindlessSamplers[nonuniformEXT(samplerIndex)]), uv);
+}
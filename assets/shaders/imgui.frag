@@ -0,0 +1,13 @@
+// imgui.frag
+#version 450
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 0) out vec4 outColor;
+
+// Font atlas or user texture, bound per draw by the backend
+layout(set = 0, binding = 0) uniform sampler2D drawTexture;
+
+void main() {
+    outColor = fragColor * texture(drawTexture, fragUV);
+}
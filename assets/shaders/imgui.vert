@@ -0,0 +1,22 @@
+// imgui.vert
+// Same interface as the ImGui Vulkan backend's own shader, so pipelines built
+// from it are drawn with the backend's pipeline layout and descriptor sets
+#version 450
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec4 inColor;
+
+layout(push_constant) uniform Transform {
+    vec2 scale;
+    vec2 translate;
+} transform;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragUV;
+
+void main() {
+    fragColor = inColor;
+    fragUV = inUV;
+    gl_Position = vec4(inPosition * transform.scale + transform.translate, 0.0, 1.0);
+}
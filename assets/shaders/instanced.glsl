@@ -0,0 +1,71 @@
+// instanced.glsl
+// triangle.vert with a per-instance model matrix; gl_InstanceIndex selects
+// the instance, which indirect draws pass through firstInstance. Shared by
+// instanced.vert (float vertices) and instanced_packed.vert (PackedVertex),
+// which differ only in how the normal arrives, and instanced_batch.vert,
+// whose instances are the culled survivors of Renderer::submitInstances().
+#extension GL_EXT_nonuniform_qualifier : require
+
+#include "bindless.glsl"
+#include "scene.glsl"
+
+// Normalized formats arrive as floats; quantized positions are undone with the mesh's scale and offset
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+#ifdef OCTAHEDRAL_NORMALS
+layout(location = 2) in vec2 inNormal;
+#else
+layout(location = 2) in vec3 inNormal;
+#endif
+
+layout(location = 0) out vec3 fragColor;
+
+layout(set = 0, binding = 0) uniform CameraUBO {
+    mat4 view;
+    mat4 projection;
+} camera;
+
+#ifdef BATCH_INSTANCES
+layout(set = 1, binding = 0) readonly buffer BatchBuffer { BatchInstance instances[]; } batchBuffers[];
+#else
+layout(set = 1, binding = 0) readonly buffer InstanceBuffer { Instance instances[]; } instanceBuffers[];
+layout(set = 1, binding = 0) readonly buffer MeshBuffer { Mesh meshes[]; } meshBuffers[];
+#endif
+
+// Inverse of VertexEncoding::Octahedral16
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    const float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+void main() {
+#ifdef BATCH_INSTANCES
+    const BatchInstance instance = batchBuffers[draw.bufferIndex].instances[gl_InstanceIndex];
+    const mat4 model = instance.model;
+    const mat3 normalMatrix = mat3(instance.normalMatrix[0].xyz, instance.normalMatrix[1].xyz,
+                                   instance.normalMatrix[2].xyz);
+    const vec3 position = inPosition;
+#else
+    // Dequantization is per mesh and the normal matrix per instance, so neither costs an inverse here
+    const Instance instance = instanceBuffers[draw.bufferIndex].instances[gl_InstanceIndex];
+    const Mesh mesh = meshBuffers[draw.meshBufferIndex].meshes[instance.mesh];
+    const mat4 model = instance.model;
+    const mat3 normalMatrix = mat3(instance.normalMatrix[0].xyz, instance.normalMatrix[1].xyz,
+                                   instance.normalMatrix[2].xyz);
+    const vec3 position = mesh.positionOffset.xyz + mesh.positionScale.xyz * inPosition;
+#endif
+
+#ifdef OCTAHEDRAL_NORMALS
+    const vec3 normal = octDecode(inNormal);
+#else
+    const vec3 normal = inNormal;
+#endif
+
+    const vec3 worldNormal = normalize(normalMatrix * normal);
+    const vec3 lightDirection = normalize(vec3(-0.3, 0.4, 0.85));
+    fragColor = inColor * (0.3 + 0.7 * max(dot(worldNormal, lightDirection), 0.0));
+
+    gl_Position = camera.projection * camera.view * model * vec4(position, 1.0);
+}
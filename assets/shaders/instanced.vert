@@ -0,0 +1,6 @@
+// instanced.vert
+// Instanced scene with full-precision Vertex input; body in instanced.glsl.
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#include "instanced.glsl"
@@ -0,0 +1,8 @@
+// instanced_batch.vert
+// Batches of registered meshes with float Vertex input, one model and normal
+// matrix per instance in a storage buffer; body in instanced.glsl.
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#define BATCH_INSTANCES
+#include "instanced.glsl"
@@ -0,0 +1,8 @@
+// instanced_packed.vert
+// Instanced scene with PackedVertex input: quantized positions, RGBA8
+// colors and octahedral normals; body in instanced.glsl.
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#define OCTAHEDRAL_NORMALS
+#include "instanced.glsl"
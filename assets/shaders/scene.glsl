@@ -0,0 +1,35 @@
+// scene.glsl
+// Matches GpuInstance, GpuMesh and GpuBatchInstance in include/vulkan/GpuScene.h.
+
+struct Instance {
+    mat4 model;
+    vec4 normalMatrix[3];
+    vec4 boundingSphere;
+    uint mesh;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+struct Mesh {
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint padding;
+    vec4 positionScale;
+    vec4 positionOffset;
+};
+
+struct BatchInstance {
+    mat4 model;
+    vec4 normalMatrix[3];
+};
+
+// VkDrawIndexedIndirectCommand
+struct DrawIndexedCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
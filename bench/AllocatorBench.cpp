@@ -0,0 +1,124 @@
+// CPU-side stress benchmark for the TLSF sub-allocator that backs
+// VulkanMemoryAllocator. No device is needed: offsets are all we measure.
+
+#include "TlsfAllocator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint64_t blockSize = 256ull << 20;
+    uint32_t operations = 2'000'000;
+    uint32_t liveTarget = 1'000;
+    uint32_t seed = 1234;
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--ops")) options.operations = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--live")) options.liveTarget = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--block-mib")) options.blockSize = std::strtoull(argv[i + 1], nullptr, 10) << 20;
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = std::strtoul(argv[i + 1], nullptr, 10);
+    }
+    return options;
+}
+
+// Mostly small uniform/vertex-sized buffers with a tail of large ones
+uint64_t randomSize(std::mt19937& rng) {
+    std::uniform_int_distribution bucket(0, 99);
+    const int b = bucket(rng);
+    if (b < 60) return std::uniform_int_distribution<uint64_t>(64, 4096)(rng);
+    if (b < 95) return std::uniform_int_distribution<uint64_t>(4096, 256 * 1024)(rng);
+    return std::uniform_int_distribution<uint64_t>(256 * 1024, 4 * 1024 * 1024)(rng);
+}
+
+uint64_t randomAlignment(std::mt19937& rng) {
+    static constexpr uint64_t alignments[] = { 16, 64, 256, 256, 1024 };
+    return alignments[std::uniform_int_distribution<size_t>(0, std::size(alignments) - 1)(rng)];
+}
+
+void printStats(const char* label, const TlsfAllocator::Stats& stats) {
+    std::printf("%-10s allocations=%u used=%.2f MiB wasted=%.2f KiB free blocks=%u largest free=%.2f MiB fragmentation=%.2f%%\n",
+                label,
+                stats.allocationCount,
+                stats.usedBytes / 1048576.0,
+                stats.wastedBytes / 1024.0,
+                stats.freeBlockCount,
+                stats.largestFreeBlock / 1048576.0,
+                stats.fragmentation() * 100.0f);
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+    std::mt19937 rng(options.seed);
+
+    TlsfAllocator allocator(options.blockSize);
+    std::vector<uint32_t> live;
+    live.reserve(options.liveTarget * 2);
+
+    using clock = std::chrono::steady_clock;
+
+    // Fill phase: grow to the live target
+    auto start = clock::now();
+    uint32_t failed = 0;
+    while (live.size() < options.liveTarget) {
+        const auto allocation = allocator.allocate(randomSize(rng), randomAlignment(rng));
+        if (!allocation) { ++failed; if (failed > options.liveTarget) break; continue; }
+        live.push_back(allocation->node);
+    }
+    const double fillNs = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    std::printf("fill:  %zu allocations in %.2f ms (%.1f ns/alloc)\n",
+                live.size(), fillNs / 1e6, fillNs / static_cast<double>(live.size()));
+    printStats("after fill", allocator.getStats());
+
+    // Churn phase: interleaved frees and allocations around the live target
+    uint32_t allocs = 0, frees = 0;
+    failed = 0;
+    start = clock::now();
+    for (uint32_t op = 0; op < options.operations; ++op) {
+        const bool doFree = !live.empty() && (live.size() >= options.liveTarget || (rng() & 1));
+        if (doFree) {
+            const size_t index = rng() % live.size();
+            allocator.free(live[index]);
+            live[index] = live.back();
+            live.pop_back();
+            ++frees;
+        } else if (const auto allocation = allocator.allocate(randomSize(rng), randomAlignment(rng))) {
+            live.push_back(allocation->node);
+            ++allocs;
+        } else {
+            ++failed;
+        }
+    }
+    const double churnNs = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    std::printf("churn: %u allocs + %u frees (%u failed) in %.2f ms (%.1f ns/op, %.2f Mops/s)\n",
+                allocs, frees, failed, churnNs / 1e6,
+                churnNs / options.operations, options.operations / churnNs * 1e3);
+    printStats("after churn", allocator.getStats());
+
+    // Drain phase: everything must coalesce back into one block
+    start = clock::now();
+    for (const uint32_t node : live) allocator.free(node);
+    const double drainNs = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    std::printf("drain: %zu frees in %.2f ms (%.1f ns/free)\n",
+                live.size(), drainNs / 1e6, live.empty() ? 0.0 : drainNs / static_cast<double>(live.size()));
+
+    const TlsfAllocator::Stats finalStats = allocator.getStats();
+    printStats("after drain", finalStats);
+
+    if (finalStats.freeBlockCount != 1 || finalStats.largestFreeBlock != options.blockSize) {
+        std::printf("ERROR: free space did not coalesce back into a single block\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
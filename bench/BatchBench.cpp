@@ -0,0 +1,189 @@
+// CPU-only cost of turning --instances submitted model matrices into one
+// frame's instanced batches, the per-frame work behind
+// Renderer::submitInstances(). The instances sit on a cubic grid around a
+// camera looking along +X and are submitted in chunk-sized spans spread over
+// --meshes meshes, as Renderer::submitWorld() does:
+//
+//   copy      the previous path: every span appended to a per-mesh vector,
+//             then all of them copied to the destination, nothing culled
+//   batcher   InstanceBatcher culling the spans in place and writing model
+//             and normal matrices of the survivors to the destination, on
+//             one thread and on the job system
+//
+// The destination is a plain heap buffer standing in for the mapped ring.
+// The batcher's output is checked against Frustum::intersectsSphere() over
+// the same instances in the same order.
+
+#include "Frustum.h"
+#include "GpuScene.h"
+#include "InstanceBatcher.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+struct Options {
+    uint32_t instances = 1'000'000;
+    uint32_t meshes = 4;
+    uint32_t chunk = 1024;          // Instances per submitted span
+    uint32_t repeats = 10;          // Best of
+    uint32_t threads = 0;           // Job system size for the parallel rows; 0 = one per core
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--instances")) options.instances = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--meshes")) options.meshes = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--chunk")) options.chunk = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--repeats")) options.repeats = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads")) options.threads = std::strtoul(value(), nullptr, 10);
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    options.instances = std::max(1u, options.instances);
+    options.meshes = std::max(1u, options.meshes);
+    options.chunk = std::max(1u, options.chunk);
+    options.repeats = std::max(1u, options.repeats);
+    return options;
+}
+
+// Unit cube, spaced like the renderer's stress grid
+constexpr float kMeshRadius = 0.87f;
+constexpr float kSpacing = 2.5f;
+
+struct Span {
+    uint32_t mesh;
+    std::span<const glm::mat4> transforms;
+};
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Function>
+double bestSeconds(const uint32_t repeats, const Function& function) {
+    double best = 1e30;
+    for (uint32_t i = 0; i < repeats; ++i) {
+        const auto start = Clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+void printRow(const char* label, const uint32_t threads, const double seconds, const uint32_t count,
+              const uint32_t written, const double baseline) {
+    std::printf("%-16s %7u %10.2f ms %8.2f ns/instance %7.1fx %10u written\n", label, threads, seconds * 1e3,
+                seconds * 1e9 / count, baseline / seconds, written);
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    // Scaled and translated on a grid centered on the camera, so the frustum keeps a fraction of it
+    const auto side = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(options.instances))));
+    const float halfExtent = 0.5f * static_cast<float>(side - 1) * kSpacing;
+    std::vector<glm::mat4> matrices(options.instances, glm::mat4(1.0f));
+    for (uint32_t i = 0; i < options.instances; ++i) {
+        const float scale = 0.5f + 0.25f * static_cast<float>(i % 3);
+        matrices[i][0][0] = scale;
+        matrices[i][1][1] = scale;
+        matrices[i][2][2] = scale;
+        matrices[i][3] = glm::vec4(glm::vec3(i % side, (i / side) % side, i / (side * side)) * kSpacing - halfExtent,
+                                   1.0f);
+    }
+
+    std::vector<Span> spans;
+    for (uint32_t first = 0; first < options.instances; first += options.chunk) {
+        const uint32_t count = std::min(options.chunk, options.instances - first);
+        spans.push_back({ static_cast<uint32_t>(spans.size() % options.meshes), { matrices.data() + first, count } });
+    }
+
+    const glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 400.0f);
+    const Frustum frustum = Frustum::fromMatrix(
+        projection * glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+
+    JobSystem jobs(options.threads);
+    const auto destination = std::make_unique<GpuBatchInstance[]>(options.instances);
+
+    std::printf("%u instances in %zu spans over %u meshes, best of %u\n", options.instances, spans.size(),
+                options.meshes, options.repeats);
+
+    // Previous path: per-mesh vectors, then one parallel copy of every matrix
+    std::vector<std::vector<glm::mat4>> perMesh(options.meshes);
+    auto* models = reinterpret_cast<glm::mat4*>(destination.get());
+    const double copySeconds = bestSeconds(options.repeats, [&] {
+        for (const Span& span : spans) {
+            perMesh[span.mesh].insert(perMesh[span.mesh].end(), span.transforms.begin(), span.transforms.end());
+        }
+        std::vector<uint32_t> firsts;
+        uint32_t total = 0;
+        for (const auto& instances : perMesh) {
+            firsts.push_back(total);
+            total += static_cast<uint32_t>(instances.size());
+        }
+        jobs.parallelFor(options.meshes, [&](const uint32_t mesh, uint32_t) {
+            std::memcpy(models + firsts[mesh], perMesh[mesh].data(), sizeof(glm::mat4) * perMesh[mesh].size());
+        });
+        for (auto& instances : perMesh) instances.clear();
+    });
+    printRow("copy", jobs.getThreadCount(), copySeconds, options.instances, options.instances, copySeconds);
+
+    InstanceBatcher batcher;
+    for (uint32_t mesh = 0; mesh < options.meshes; ++mesh) batcher.addMesh(kMeshRadius);
+
+    uint32_t visible = 0;
+    for (JobSystem* system : { static_cast<JobSystem*>(nullptr), &jobs }) {
+        if (system && jobs.getThreadCount() == 1) continue;
+        double buildSeconds = 1e30;
+        const double seconds = bestSeconds(options.repeats, [&] {
+            const auto start = Clock::now();
+            for (const Span& span : spans) batcher.submit(span.mesh, span.transforms);
+            visible = batcher.build(frustum, system);
+            buildSeconds = std::min(buildSeconds, std::chrono::duration<double>(Clock::now() - start).count());
+            batcher.write(destination.get(), system);
+            batcher.clear();
+        });
+        const uint32_t threads = system ? jobs.getThreadCount() : 1;
+        printRow("batcher", threads, seconds, options.instances, visible, copySeconds);
+        printRow("  cull only", threads, buildSeconds, options.instances, visible, copySeconds);
+    }
+
+    // Same survivors, in mesh then submission order, with the same matrices
+    uint32_t mismatches = 0;
+    uint32_t expected = 0;
+    for (uint32_t mesh = 0; mesh < options.meshes; ++mesh) {
+        for (const Span& span : spans) {
+            if (span.mesh != mesh) continue;
+            for (const glm::mat4& model : span.transforms) {
+                const float scale = std::sqrt(std::max({ glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                                         glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                                                         glm::dot(glm::vec3(model[2]), glm::vec3(model[2])) }));
+                if (!frustum.intersectsSphere(glm::vec3(model[3]), kMeshRadius * scale)) continue;
+                if (expected >= visible || std::memcmp(&destination[expected].model, &model, sizeof(model))) {
+                    ++mismatches;
+                }
+                ++expected;
+            }
+        }
+    }
+    if (expected != visible) ++mismatches;
+
+    if (mismatches > 0) {
+        std::printf("%u instances did not match the scalar cull (%u expected, %u written)\n", mismatches, expected,
+                    visible);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,303 @@
+// CPU-only dynamic BVH benchmark. Scatters --objects boxes through a cube and
+// moves every one of them each frame for --frames frames, timing update()
+// (refit in place or reinsert) and commit(), and watching the tree's SAH
+// cost drift before a rebuild, single-threaded and on the job system. Then
+// measures query throughput on the moved scene against brute force loops
+// over every box:
+//
+//   frustum   eight view directions from the center of the cube
+//   ray       nearest box along random rays
+//   box       boxes of --range half-extent at random points
+//   sphere    spheres of --range radius at random points
+//
+// Every query's result is checked against the brute force one.
+
+#include "DynamicBvh.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+struct Options {
+    uint32_t objects = 100'000;
+    uint32_t frames = 120;
+    uint32_t queries = 10'000;      // Per query kind; frustum queries are always the eight directions
+    float speed = 0.5f;             // Maximum world units per frame
+    float margin = 1.0f;            // Fat box margin
+    float range = 20.0f;
+    uint32_t threads = 0;           // Job system size for the parallel rebuild; 0 = one per core
+    uint32_t seed = 1234;
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--objects")) options.objects = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--frames")) options.frames = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--queries")) options.queries = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--speed")) options.speed = std::strtof(value(), nullptr);
+        else if (!std::strcmp(argv[i], "--margin")) options.margin = std::strtof(value(), nullptr);
+        else if (!std::strcmp(argv[i], "--range")) options.range = std::strtof(value(), nullptr);
+        else if (!std::strcmp(argv[i], "--threads")) options.threads = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = std::strtoul(value(), nullptr, 10);
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    options.objects = std::max(1u, options.objects);
+    options.queries = std::max(1u, options.queries);
+    return options;
+}
+
+constexpr uint32_t kDirections = 8;
+constexpr float kWorldHalfExtent = 500.0f;
+constexpr float kRayLength = 2000.0f;
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(const Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Object {
+    glm::vec3 center;
+    glm::vec3 extent;
+    glm::vec3 velocity;
+    uint32_t proxy;
+
+    [[nodiscard]] Aabb getBounds() const { return { center - extent, center + extent }; }
+};
+
+// Straight lines, bouncing off the walls of the cube
+void move(std::vector<Object>& objects) {
+    for (Object& object : objects) {
+        object.center += object.velocity;
+        if (std::abs(object.center.x) > kWorldHalfExtent) object.velocity.x = -object.velocity.x;
+        if (std::abs(object.center.y) > kWorldHalfExtent) object.velocity.y = -object.velocity.y;
+        if (std::abs(object.center.z) > kWorldHalfExtent) object.velocity.z = -object.velocity.z;
+    }
+}
+
+// Same positive-vertex test, with the same rounding, as the BVH's
+bool frustumVisible(const Frustum& frustum, const Aabb& box) {
+    for (const glm::vec4& plane : frustum.planes) {
+        const float distance = (plane.x * (plane.x >= 0.0f ? box.max.x : box.min.x) +
+                                plane.y * (plane.y >= 0.0f ? box.max.y : box.min.y)) +
+                               (plane.z * (plane.z >= 0.0f ? box.max.z : box.min.z) + plane.w);
+        if (!(distance >= 0.0f)) return false;
+    }
+    return true;
+}
+
+std::optional<float> rayEntry(const glm::vec3& origin, const glm::vec3& inverse, const Aabb& box) {
+    const glm::vec3 t0 = (box.min - origin) * inverse;
+    const glm::vec3 t1 = (box.max - origin) * inverse;
+    const glm::vec3 near = glm::min(t0, t1);
+    const glm::vec3 far = glm::max(t0, t1);
+    const float entry = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+    const float exit = std::min(std::min(far.x, far.y), std::min(far.z, kRayLength));
+    if (entry <= exit) return entry;
+    return std::nullopt;
+}
+
+float sphereDistance2(const glm::vec3& center, const Aabb& box) {
+    const glm::vec3 d = glm::max(glm::max(box.min - center, center - box.max), glm::vec3(0.0f));
+    return glm::dot(d, d);
+}
+
+struct QueryResult {
+    double bvhSeconds = 0.0;
+    double bruteSeconds = 0.0;
+    uint64_t results = 0;
+    uint32_t mismatches = 0;
+};
+
+void printQuery(const char* name, const uint32_t count, const QueryResult& result) {
+    std::printf("%-8s %8u queries %10.2f us/query %10.2f us brute force %8.1fx %12llu results\n", name, count,
+                result.bvhSeconds * 1e6 / count, result.bruteSeconds * 1e6 / count,
+                result.bruteSeconds / result.bvhSeconds, static_cast<unsigned long long>(result.results));
+}
+
+// Runs query on the BVH and brute on every box, timing both and comparing the sorted ids
+template<typename Query, typename Brute>
+void compareSets(QueryResult& result, const Query& query, const Brute& brute) {
+    static std::vector<uint32_t> actual;
+    static std::vector<uint32_t> expected;
+
+    auto start = Clock::now();
+    query(actual);
+    result.bvhSeconds += secondsSince(start);
+
+    start = Clock::now();
+    brute(expected);
+    result.bruteSeconds += secondsSince(start);
+
+    result.results += actual.size();
+    std::ranges::sort(actual);
+    if (actual != expected) ++result.mismatches;
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<float> position(-kWorldHalfExtent, kWorldHalfExtent);
+    std::uniform_real_distribution<float> size(0.25f, 4.0f);
+    std::uniform_real_distribution<float> velocity(-options.speed, options.speed);
+
+    std::vector<Object> objects(options.objects);
+    for (Object& object : objects) {
+        object.center = { position(rng), position(rng), position(rng) };
+        object.extent = { size(rng), size(rng), size(rng) };
+        object.velocity = { velocity(rng), velocity(rng), velocity(rng) };
+    }
+
+    JobSystem jobs(options.threads);
+    DynamicBvh bvh(DynamicBvh::Options { .margin = options.margin });
+
+    std::printf("%u objects moving up to %.2f units/frame for %u frames, margin %.2f, %u job threads\n",
+                options.objects, options.speed, options.frames, options.margin, jobs.getThreadCount());
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < options.objects; ++i) objects[i].proxy = bvh.insert(objects[i].getBounds(), i);
+    const double insertSeconds = secondsSince(start);
+    start = Clock::now();
+    bvh.commit();
+    const double collapseSeconds = secondsSince(start);
+    std::printf("insert   %10.2f ms (%.0f ns/object), commit %.2f ms, SAH cost %.1f, height %u\n",
+                insertSeconds * 1e3, insertSeconds * 1e9 / options.objects, collapseSeconds * 1e3,
+                bvh.getSahCost(), bvh.getHeight());
+
+    const float insertedCost = bvh.getSahCost();
+    double updateSeconds = 0.0;
+    double commitSeconds = 0.0;
+    double refitSeconds = 0.0;
+    uint64_t reinserts = 0;
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        move(objects);
+
+        start = Clock::now();
+        for (const Object& object : objects) reinserts += bvh.update(object.proxy, object.getBounds()) ? 1 : 0;
+        updateSeconds += secondsSince(start);
+
+        start = Clock::now();
+        bvh.commit();
+        commitSeconds += secondsSince(start);
+    }
+
+    // A frame whose motion stayed inside the fat boxes only refits the query tree
+    for (const Object& object : objects) bvh.update(object.proxy, object.getBounds());
+    start = Clock::now();
+    bvh.commit();
+    refitSeconds = secondsSince(start);
+
+    const double frames = std::max(1u, options.frames);
+    std::printf("frame    %10.2f ms update + %.2f ms commit, %.1f%% reinserted, refit-only commit %.2f ms\n",
+                updateSeconds * 1e3 / frames, commitSeconds * 1e3 / frames,
+                100.0 * reinserts / (frames * options.objects), refitSeconds * 1e3);
+    std::printf("drift    SAH cost %.1f after inserting, %.1f after %u frames, height %u\n", insertedCost,
+                bvh.getSahCost(), options.frames, bvh.getHeight());
+
+    for (JobSystem* system : { static_cast<JobSystem*>(nullptr), &jobs }) {
+        if (system && jobs.getThreadCount() == 1) continue;
+        start = Clock::now();
+        bvh.rebuild(system);
+        const double rebuildSeconds = secondsSince(start);
+        start = Clock::now();
+        bvh.commit();
+        std::printf("rebuild  %10.2f ms on %u thread(s) + %.2f ms commit, SAH cost %.1f, height %u\n",
+                    rebuildSeconds * 1e3, system ? jobs.getThreadCount() : 1, secondsSince(start) * 1e3,
+                    bvh.getSahCost(), bvh.getHeight());
+    }
+
+    std::vector<Aabb> boxes;
+    for (const Object& object : objects) boxes.push_back(object.getBounds());
+    const auto bruteForce = [&](const auto& predicate) {
+        return [&boxes, predicate](std::vector<uint32_t>& out) {
+            out.clear();
+            for (uint32_t i = 0; i < static_cast<uint32_t>(boxes.size()); ++i) {
+                if (predicate(boxes[i])) out.push_back(i);
+            }
+        };
+    };
+
+    uint32_t mismatches = 0;
+
+    QueryResult frustumResult;
+    const glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 400.0f);
+    for (uint32_t i = 0; i < kDirections; ++i) {
+        const float yaw = 6.2831853f * static_cast<float>(i) / kDirections;
+        const glm::vec3 forward(std::cos(yaw), std::sin(yaw), 0.0f);
+        const Frustum frustum =
+            Frustum::fromMatrix(projection * glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0, 0, 1)));
+        compareSets(frustumResult, [&](std::vector<uint32_t>& out) { bvh.queryFrustum(frustum, out); },
+                    bruteForce([&](const Aabb& box) { return frustumVisible(frustum, box); }));
+    }
+    printQuery("frustum", kDirections, frustumResult);
+    mismatches += frustumResult.mismatches;
+
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    QueryResult rayResult;
+    for (uint32_t i = 0; i < options.queries; ++i) {
+        const glm::vec3 origin(position(rng), position(rng), position(rng));
+        const glm::vec3 direction = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(1e-3f));
+        const glm::vec3 inverse = glm::vec3(1.0f) / direction;
+
+        auto begin = Clock::now();
+        const auto hit = bvh.raycast(origin, direction, kRayLength);
+        rayResult.bvhSeconds += secondsSince(begin);
+
+        begin = Clock::now();
+        float closest = kRayLength;
+        bool found = false;
+        for (const Aabb& box : boxes) {
+            const auto entry = rayEntry(origin, inverse, box);
+            if (entry && *entry <= closest) {
+                closest = *entry;
+                found = true;
+            }
+        }
+        rayResult.bruteSeconds += secondsSince(begin);
+
+        // Compare distances, since boxes the ray starts inside all tie at zero
+        rayResult.results += hit ? 1 : 0;
+        if (found != hit.has_value() || (found && std::abs(hit->distance - closest) > 1e-3f * (1.0f + closest))) {
+            ++rayResult.mismatches;
+        }
+    }
+    printQuery("ray", options.queries, rayResult);
+    mismatches += rayResult.mismatches;
+
+    QueryResult boxResult;
+    QueryResult sphereResult;
+    for (uint32_t i = 0; i < options.queries; ++i) {
+        const glm::vec3 center(position(rng), position(rng), position(rng));
+        const Aabb range = Aabb::fromSphere(center, options.range);
+        compareSets(boxResult, [&](std::vector<uint32_t>& out) { bvh.queryAabb(range, out); },
+                    bruteForce([&](const Aabb& box) { return range.overlaps(box); }));
+        compareSets(sphereResult, [&](std::vector<uint32_t>& out) { bvh.querySphere(center, options.range, out); },
+                    bruteForce([&](const Aabb& box) {
+                        return sphereDistance2(center, box) <= options.range * options.range;
+                    }));
+    }
+    printQuery("box", options.queries, boxResult);
+    printQuery("sphere", options.queries, sphereResult);
+    mismatches += boxResult.mismatches + sphereResult.mismatches;
+
+    if (mismatches > 0) {
+        std::printf("%u queries did not match brute force\n", mismatches);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+// CPU-only frustum culling throughput. Scatters --objects bounding volumes
+// through a cube around the camera and culls them against eight view
+// directions, comparing a naive per-object glm loop over AoS data with every
+// FrustumCuller kernel the CPU supports, single-threaded and on the job
+// system. Every kernel's visible list is checked against the scalar one.
+
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+struct Options {
+    uint32_t objects = 1'000'000;
+    uint32_t repeats = 20;          // Best of; each repeat culls all eight directions
+    uint32_t threads = 0;           // Job system size for the parallel rows; 0 = one per core
+    uint32_t seed = 1234;
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--objects")) options.objects = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--repeats")) options.repeats = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads")) options.threads = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = std::strtoul(value(), nullptr, 10);
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    options.repeats = std::max(1u, options.repeats);
+    return options;
+}
+
+constexpr uint32_t kDirections = 8;
+constexpr float kWorldHalfExtent = 500.0f;
+
+// Camera at the origin looking along the horizon, Z up like FreeLookCamera
+std::vector<Frustum> makeFrusta() {
+    const glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 400.0f);
+
+    std::vector<Frustum> frusta;
+    for (uint32_t i = 0; i < kDirections; ++i) {
+        const float yaw = 6.2831853f * static_cast<float>(i) / kDirections;
+        const glm::vec3 forward(std::cos(yaw), std::sin(yaw), 0.0f);
+        frusta.push_back(Frustum::fromMatrix(projection * glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0, 0, 1))));
+    }
+    return frusta;
+}
+
+struct AosBox {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// The obvious way: one glm test per object, survivors pushed one at a time
+uint32_t cullNaive(const Frustum& frustum, const std::vector<glm::vec4>& spheres, std::vector<uint32_t>& visible) {
+    visible.clear();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(spheres.size()); ++i) {
+        if (frustum.intersectsSphere(glm::vec3(spheres[i]), spheres[i].w)) visible.push_back(i);
+    }
+    return static_cast<uint32_t>(visible.size());
+}
+
+// Positive-vertex test: the box corner furthest along each plane normal
+uint32_t cullNaive(const Frustum& frustum, const std::vector<AosBox>& boxes, std::vector<uint32_t>& visible) {
+    visible.clear();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(boxes.size()); ++i) {
+        bool inside = true;
+        for (const glm::vec4& plane : frustum.planes) {
+            const glm::vec3 corner(plane.x >= 0.0f ? boxes[i].max.x : boxes[i].min.x,
+                                   plane.y >= 0.0f ? boxes[i].max.y : boxes[i].min.y,
+                                   plane.z >= 0.0f ? boxes[i].max.z : boxes[i].min.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) visible.push_back(i);
+    }
+    return static_cast<uint32_t>(visible.size());
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Best time for one pass over all directions, and the survivors summed over them
+template<typename Cull>
+std::pair<double, uint64_t> measure(const Options& options, const std::vector<Frustum>& frusta, const Cull& cull) {
+    double best = 1e30;
+    uint64_t survivors = 0;
+    for (uint32_t repeat = 0; repeat < options.repeats; ++repeat) {
+        survivors = 0;
+        const auto start = Clock::now();
+        for (const Frustum& frustum : frusta) survivors += cull(frustum);
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return { best / frusta.size(), survivors };
+}
+
+void printRow(const char* shape, const char* label, const uint32_t threads, const std::pair<double, uint64_t>& result,
+              const double baseline, const uint32_t objects) {
+    std::printf("%-7s %-10s %7u %10.3f ms %8.2f ns/object %7.1fx %10llu visible\n", shape, label, threads,
+                result.first * 1e3, result.first * 1e9 / objects, baseline / result.first,
+                static_cast<unsigned long long>(result.second));
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<float> position(-kWorldHalfExtent, kWorldHalfExtent);
+    std::uniform_real_distribution<float> size(0.25f, 4.0f);
+
+    std::vector<glm::vec4> aosSpheres;
+    std::vector<AosBox> aosBoxes;
+    BoundingSpheres spheres;
+    BoundingBoxes boxes;
+    spheres.reserve(options.objects);
+    boxes.reserve(options.objects);
+    for (uint32_t i = 0; i < options.objects; ++i) {
+        const glm::vec3 center(position(rng), position(rng), position(rng));
+        const glm::vec3 extent(size(rng), size(rng), size(rng));
+        const float radius = glm::length(extent);
+
+        aosSpheres.emplace_back(center, radius);
+        spheres.add(center, radius);
+        aosBoxes.push_back({ center - extent, center + extent });
+        boxes.add(center - extent, center + extent);
+    }
+
+    const std::vector<Frustum> frusta = makeFrusta();
+    JobSystem jobs(options.threads);
+
+    std::printf("%u objects, %u view directions, best of %u, detected %s\n", options.objects, kDirections,
+                options.repeats, FrustumCuller::getIsaName(FrustumCuller::detectIsa()));
+
+    std::vector<uint32_t> naiveVisible;
+    std::vector<uint32_t> reference;
+    std::vector<uint32_t> storage;
+    uint32_t mismatches = 0;
+
+    const auto runShape = [&](const char* shape, const auto& aos, const auto& soa) {
+        const auto naive = measure(options, frusta, [&](const Frustum& frustum) {
+            return cullNaive(frustum, aos, naiveVisible);
+        });
+        printRow(shape, "naive glm", 1, naive, naive.first, options.objects);
+
+        for (const auto isa : { FrustumCuller::Isa::Scalar, FrustumCuller::Isa::Sse2, FrustumCuller::Isa::Avx2,
+                                FrustumCuller::Isa::Avx512 }) {
+            if (!FrustumCuller::isSupported(isa)) continue;
+            const FrustumCuller culler(isa);
+
+            for (JobSystem* system : { static_cast<JobSystem*>(nullptr), &jobs }) {
+                if (system && jobs.getThreadCount() == 1) continue;
+                const auto result = measure(options, frusta, [&](const Frustum& frustum) {
+                    return static_cast<uint32_t>(culler.cull(frustum, soa, storage, system).size());
+                });
+                printRow(shape, FrustumCuller::getIsaName(isa), system ? jobs.getThreadCount() : 1, result,
+                         naive.first, options.objects);
+            }
+
+            // Same survivors as the scalar kernel, direction by direction
+            const FrustumCuller scalar(FrustumCuller::Isa::Scalar);
+            for (const Frustum& frustum : frusta) {
+                const auto expected = scalar.cull(frustum, soa, reference);
+                const auto actual = culler.cull(frustum, soa, storage, &jobs);
+                if (!std::ranges::equal(expected, actual)) ++mismatches;
+            }
+        }
+    };
+
+    runShape("spheres", aosSpheres, spheres);
+    runShape("boxes", aosBoxes, boxes);
+
+    if (mismatches > 0) {
+        std::printf("%u culls did not match the scalar kernel\n", mismatches);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
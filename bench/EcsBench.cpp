@@ -0,0 +1,229 @@
+// CPU-only entity/component benchmark at --entities entities, each with a
+// Transform, WorldTransform, WorldBounds and Renderable:
+//
+//   create    structural throughput of building the world
+//   update    TRS -> world matrix -> bounding sphere, over the chunks on one
+//             thread and on the job system, against the same objects as
+//             individually allocated structs visited through a shuffled
+//             pointer list
+//   gather    packing GpuInstance records for the renderer from a linear
+//             chunk scan, against the pointer list
+//   add/remove   tagging and untagging every tenth entity (an archetype move)
+//   destroy/create   recycling every other entity
+//
+// Every ECS pass is checked against the pointer-list one.
+
+#include "Components.h"
+#include "EntityWorld.h"
+#include "GpuScene.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint32_t entities = 1'000'000;
+    uint32_t repeats = 5;           // Best of
+    uint32_t threads = 0;           // Job system size for the parallel rows; 0 = one per core
+    uint32_t seed = 1234;
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--entities")) options.entities = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--repeats")) options.repeats = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads")) options.threads = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = std::strtoul(value(), nullptr, 10);
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    options.entities = std::max(1u, options.entities);
+    options.repeats = std::max(1u, options.repeats);
+    return options;
+}
+
+constexpr float kMeshRadius = 0.87f;
+
+struct Highlighted {};
+
+// The same data as one heap object per thing
+struct SceneObject {
+    Transform transform;
+    WorldTransform world;
+    WorldBounds bounds;
+    Renderable renderable;
+};
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Function>
+double bestSeconds(const uint32_t repeats, const Function& function) {
+    double best = 1e30;
+    for (uint32_t i = 0; i < repeats; ++i) {
+        const auto start = Clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+void updateObject(const Transform& transform, WorldTransform& world, WorldBounds& bounds) {
+    world.matrix = transform.getMatrix();
+    bounds.center = glm::vec3(world.matrix[3]);
+    bounds.radius = kMeshRadius * std::max(transform.scale.x, std::max(transform.scale.y, transform.scale.z));
+}
+
+GpuInstance makeInstance(const WorldTransform& world, const WorldBounds& bounds, const Renderable& renderable) {
+    GpuInstance instance {};
+    instance.model = world.matrix;
+    setNormalMatrix(instance.normalMatrix, world.matrix);
+    instance.boundingSphere = glm::vec4(bounds.center, bounds.radius);
+    instance.mesh = renderable.mesh;
+    return instance;
+}
+
+void printRow(const char* label, const uint32_t threads, const double seconds, const uint32_t count,
+              const double baseline) {
+    std::printf("%-16s %7u %10.2f ms %8.2f ns/entity", label, threads, seconds * 1e3, seconds * 1e9 / count);
+    if (baseline > 0.0) std::printf(" %7.1fx", baseline / seconds);
+    std::printf("\n");
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Transform> transforms(options.entities);
+    for (Transform& transform : transforms) {
+        transform.position = { position(rng), position(rng), position(rng) };
+        transform.rotation = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+        transform.scale = glm::vec3(scale(rng));
+    }
+
+    JobSystem jobs(options.threads);
+    std::printf("%u entities, %u-byte chunks, best of %u, %u job threads\n", options.entities,
+                EntityWorld::kChunkSize, options.repeats, jobs.getThreadCount());
+    std::printf("%-16s %7s %13s %19s %8s\n", "pass", "threads", "time", "per entity", "speedup");
+
+    // Baseline objects, allocated in order but visited in a shuffled order as
+    // they would be after a while of churn
+    std::vector<std::unique_ptr<SceneObject>> objects;
+    objects.reserve(options.entities);
+    for (uint32_t i = 0; i < options.entities; ++i) {
+        objects.push_back(std::make_unique<SceneObject>(SceneObject {
+            .transform = transforms[i], .world = {}, .bounds = {}, .renderable = { .mesh = i % 4, .material = 0 } }));
+    }
+    std::shuffle(objects.begin(), objects.end(), rng);
+
+    EntityWorld world;
+    std::vector<Entity> entities(options.entities);
+    const double createSeconds = bestSeconds(1, [&] {
+        for (uint32_t i = 0; i < options.entities; ++i) {
+            entities[i] = world.create(transforms[i], WorldTransform {}, WorldBounds {},
+                                       Renderable { .mesh = i % 4, .material = 0 });
+        }
+    });
+    printRow("create", 1, createSeconds, options.entities, 0.0);
+
+    const double pointerUpdate = bestSeconds(options.repeats, [&] {
+        for (const auto& object : objects) updateObject(object->transform, object->world, object->bounds);
+    });
+    printRow("update pointers", 1, pointerUpdate, options.entities, pointerUpdate);
+
+    const double chunkUpdate = bestSeconds(options.repeats, [&] {
+        world.each<const Transform, WorldTransform, WorldBounds>(updateObject);
+    });
+    printRow("update chunks", 1, chunkUpdate, options.entities, pointerUpdate);
+
+    if (jobs.getThreadCount() > 1) {
+        const double parallelUpdate = bestSeconds(options.repeats, [&] {
+            world.parallelEach<const Transform, WorldTransform, WorldBounds>(jobs, updateObject);
+        });
+        printRow("update chunks", jobs.getThreadCount(), parallelUpdate, options.entities, pointerUpdate);
+    }
+
+    std::vector<GpuInstance> instances(options.entities);
+    const double pointerGather = bestSeconds(options.repeats, [&] {
+        GpuInstance* out = instances.data();
+        for (const auto& object : objects) *out++ = makeInstance(object->world, object->bounds, object->renderable);
+    });
+    printRow("gather pointers", 1, pointerGather, options.entities, pointerGather);
+
+    const double chunkGather = bestSeconds(options.repeats, [&] {
+        GpuInstance* out = instances.data();
+        world.forEachChunk<const WorldTransform, const WorldBounds, const Renderable>(
+            [&](const uint32_t count, const Entity*, const WorldTransform* transforms, const WorldBounds* bounds,
+                const Renderable* renderables) {
+                for (uint32_t i = 0; i < count; ++i) *out++ = makeInstance(transforms[i], bounds[i], renderables[i]);
+            });
+    });
+    printRow("gather chunks", 1, chunkGather, options.entities, pointerGather);
+
+    // Same results as the baseline, matched up by position since both orders differ
+    uint32_t mismatches = 0;
+    {
+        const auto byPosition = [](const WorldBounds& a, const WorldBounds& b) {
+            return std::make_tuple(a.center.x, a.center.y, a.center.z) < std::make_tuple(b.center.x, b.center.y, b.center.z);
+        };
+        std::vector<WorldBounds> expected;
+        std::vector<WorldBounds> actual;
+        for (const auto& object : objects) expected.push_back(object->bounds);
+        world.each<const WorldBounds>([&](const WorldBounds& bounds) { actual.push_back(bounds); });
+        std::ranges::sort(expected, byPosition);
+        std::ranges::sort(actual, byPosition);
+        for (uint32_t i = 0; i < options.entities; ++i) {
+            if (std::memcmp(&expected[i], &actual[i], sizeof(WorldBounds)) != 0) ++mismatches;
+        }
+    }
+
+    const uint32_t tagged = (options.entities + 9) / 10;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < options.entities; i += 10) world.add(entities[i], Highlighted {});
+    printRow("add tag", 1, std::chrono::duration<double>(Clock::now() - start).count(), tagged, 0.0);
+
+    uint32_t counted = 0;
+    world.each<const Highlighted>([&](const Highlighted&) { ++counted; });
+    if (counted != tagged) ++mismatches;
+
+    start = Clock::now();
+    for (uint32_t i = 0; i < options.entities; i += 10) world.remove<Highlighted>(entities[i]);
+    printRow("remove tag", 1, std::chrono::duration<double>(Clock::now() - start).count(), tagged, 0.0);
+
+    const uint32_t recycled = (options.entities + 1) / 2;
+    start = Clock::now();
+    for (uint32_t i = 0; i < options.entities; i += 2) world.destroy(entities[i]);
+    printRow("destroy", 1, std::chrono::duration<double>(Clock::now() - start).count(), recycled, 0.0);
+
+    start = Clock::now();
+    for (uint32_t i = 0; i < options.entities; i += 2) {
+        entities[i] = world.create(transforms[i], WorldTransform {}, WorldBounds {}, Renderable {});
+    }
+    printRow("recreate", 1, std::chrono::duration<double>(Clock::now() - start).count(), recycled, 0.0);
+
+    if (world.getEntityCount() != options.entities) ++mismatches;
+    std::printf("%u archetypes, %u chunks, %.1f MiB of chunks\n", world.getArchetypeCount(), world.getChunkCount(),
+                world.getChunkCount() * double(EntityWorld::kChunkSize) / (1024.0 * 1024.0));
+
+    if (mismatches > 0) {
+        std::printf("%u checks did not match the baseline\n", mismatches);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
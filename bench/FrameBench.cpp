@@ -0,0 +1,363 @@
+// Deterministic frame-time benchmark. Renders the default scene headless while
+// a scripted camera path replaces InputManager, then reports per-frame CPU and
+// GPU times. With --baseline it exits non-zero when p50/p95 regress by more
+// than --threshold percent, so it can gate CI.
+//
+// --instances/--sphere/--packed-vertices add the instanced stress scene; run
+// it with and without --packed-vertices to compare vertex layouts. --mesh
+// instances a converted mesh file instead of the generated mesh. --animate
+// spins half of it through the transform hierarchy every frame; --batched
+// submits it every frame as one instanced batch, culled on the job system.
+
+#include "CameraPath.h"
+#include "Renderer.h"
+#include "VulkanConfig.h"
+#include "VulkanGpuProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint32_t warmupFrames = 100;
+    uint32_t measuredFrames = 1000;
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    bool validation = false;
+    bool dynamicRendering = true;
+    uint32_t instanceCount = 0;
+    bool gpuCulling = true;
+    uint32_t sphereSegments = 0;
+    bool packedVertices = false;
+    bool animate = false;
+    bool batched = false;
+    std::string meshPath;
+    std::string csvPath;
+    std::string jsonPath;
+    std::string baselinePath;
+    double thresholdPercent = 5.0;
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--warmup")) options.warmupFrames = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--frames")) options.measuredFrames = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--width")) options.width = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--height")) options.height = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--validation")) options.validation = true;
+        else if (!std::strcmp(argv[i], "--no-dynamic-rendering")) options.dynamicRendering = false;
+        else if (!std::strcmp(argv[i], "--instances")) options.instanceCount = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--cpu-culling")) options.gpuCulling = false;
+        else if (!std::strcmp(argv[i], "--sphere")) options.sphereSegments = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--packed-vertices")) options.packedVertices = true;
+        else if (!std::strcmp(argv[i], "--animate")) options.animate = true;
+        else if (!std::strcmp(argv[i], "--batched")) options.batched = true;
+        else if (!std::strcmp(argv[i], "--mesh")) options.meshPath = value();
+        else if (!std::strcmp(argv[i], "--csv")) options.csvPath = value();
+        else if (!std::strcmp(argv[i], "--json")) options.jsonPath = value();
+        else if (!std::strcmp(argv[i], "--baseline")) options.baselinePath = value();
+        else if (!std::strcmp(argv[i], "--threshold")) options.thresholdPercent = std::strtod(value(), nullptr);
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    return options;
+}
+
+struct Summary {
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Nearest-rank percentiles over the samples that were actually recorded
+Summary summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) return summary;
+
+    std::ranges::sort(samples);
+    const auto rank = [&](const double p) {
+        const auto index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(index, samples.size() - 1)];
+    };
+
+    double total = 0.0;
+    for (const double sample : samples) total += sample;
+
+    summary.mean = total / static_cast<double>(samples.size());
+    summary.p50 = rank(0.50);
+    summary.p95 = rank(0.95);
+    summary.p99 = rank(0.99);
+    summary.max = samples.back();
+    return summary;
+}
+
+struct Results {
+    std::vector<double> cpuMs;
+    std::vector<std::optional<double>> gpuMs;
+    std::map<std::string, std::vector<double>> scopeMs;
+    Summary cpu;
+    Summary gpu;
+    std::map<std::string, Summary> scopes;
+};
+
+void writeCsv(const std::string& path, const Results& results) {
+    std::ofstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "Failed to open %s for writing\n", path.c_str());
+        return;
+    }
+
+    file << "frame,cpu_ms,gpu_ms\n";
+    for (size_t i = 0; i < results.cpuMs.size(); ++i) {
+        file << i << ',' << results.cpuMs[i] << ',';
+        if (results.gpuMs[i]) file << *results.gpuMs[i];
+        file << '\n';
+    }
+
+    // Summary rows keep the file loadable as a single table
+    const auto row = [&](const char* label, const double cpu, const double gpu) {
+        file << label << ',' << cpu << ',' << gpu << '\n';
+    };
+    row("mean", results.cpu.mean, results.gpu.mean);
+    row("p50", results.cpu.p50, results.gpu.p50);
+    row("p95", results.cpu.p95, results.gpu.p95);
+    row("p99", results.cpu.p99, results.gpu.p99);
+    row("max", results.cpu.max, results.gpu.max);
+}
+
+// Quotes, backslashes and control characters; paths come straight from the command line
+void writeEscaped(std::ostream& out, const char* text) {
+    for (; *text; ++text) {
+        const auto c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\') {
+            out << '\\' << *text;
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << *text;
+        }
+    }
+}
+
+void writeSummaryJson(std::ostream& out, const char* name, const Summary& summary) {
+    out << "  \"";
+    writeEscaped(out, name);
+    out << "\": { "
+        << "\"mean\": " << summary.mean << ", "
+        << "\"p50\": " << summary.p50 << ", "
+        << "\"p95\": " << summary.p95 << ", "
+        << "\"p99\": " << summary.p99 << ", "
+        << "\"max\": " << summary.max << " }";
+}
+
+void writeJson(const std::string& path, const Options& options, const Results& results, const Renderer& renderer) {
+    std::ofstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "Failed to open %s for writing\n", path.c_str());
+        return;
+    }
+
+    file << "{\n"
+         << "  \"warmupFrames\": " << options.warmupFrames << ",\n"
+         << "  \"measuredFrames\": " << options.measuredFrames << ",\n"
+         << "  \"width\": " << options.width << ",\n"
+         << "  \"height\": " << options.height << ",\n"
+         << "  \"instances\": " << options.instanceCount << ",\n"
+         << "  \"gpuCulling\": " << (options.gpuCulling ? "true" : "false") << ",\n"
+         << "  \"sphereSegments\": " << options.sphereSegments << ",\n"
+         << "  \"animate\": " << (options.animate ? "true" : "false") << ",\n"
+         << "  \"batched\": " << (options.batched ? "true" : "false") << ",\n"
+         << "  \"mesh\": \"";
+    writeEscaped(file, options.meshPath.c_str());
+    file << "\",\n"
+         << "  \"packedVertices\": " << (renderer.hasPackedVertices() ? "true" : "false") << ",\n"
+         << "  \"vertexBytes\": " << renderer.getSceneVertexBytes() << ",\n";
+    writeSummaryJson(file, "cpu", results.cpu);
+    file << ",\n";
+    writeSummaryJson(file, "gpu", results.gpu);
+
+    file << ",\n  \"scopes\": {\n";
+    for (auto it = results.scopes.begin(); it != results.scopes.end(); ++it) {
+        file << "  ";
+        writeSummaryJson(file, it->first.c_str(), it->second);
+        file << (std::next(it) != results.scopes.end() ? ",\n" : "\n");
+    }
+    file << "  },\n  \"frames\": [\n";
+
+    for (size_t i = 0; i < results.cpuMs.size(); ++i) {
+        file << "    { \"cpu\": " << results.cpuMs[i] << ", \"gpu\": ";
+        if (results.gpuMs[i]) file << *results.gpuMs[i];
+        else file << "null";
+        file << (i + 1 < results.cpuMs.size() ? " },\n" : " }\n");
+    }
+    file << "  ]\n}\n";
+}
+
+// Reads "<section>": { ... "<key>": value } from a file written by writeJson
+std::optional<double> readBaselineValue(const std::string& json, const char* section, const char* key) {
+    const size_t sectionPos = json.find(std::string("\"") + section + "\"");
+    if (sectionPos == std::string::npos) return std::nullopt;
+
+    const size_t end = json.find('}', sectionPos);
+    const size_t keyPos = json.find(std::string("\"") + key + "\"", sectionPos);
+    if (keyPos == std::string::npos || keyPos > end) return std::nullopt;
+
+    const size_t colon = json.find(':', keyPos);
+    return std::strtod(json.c_str() + colon + 1, nullptr);
+}
+
+// Returns the number of metrics that regressed beyond the threshold
+int compareBaseline(const std::string& path, const Results& results, const double thresholdPercent) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "Failed to open baseline %s\n", path.c_str());
+        return 1;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string json = buffer.str();
+
+    struct Metric { const char* section; const char* key; double current; };
+    const Metric metrics[] = {
+        { "cpu", "p50", results.cpu.p50 },
+        { "cpu", "p95", results.cpu.p95 },
+        { "gpu", "p50", results.gpu.p50 },
+        { "gpu", "p95", results.gpu.p95 },
+    };
+
+    int regressions = 0;
+    std::printf("\nbaseline comparison (threshold %.1f%%):\n", thresholdPercent);
+    for (const auto& [section, key, current] : metrics) {
+        const auto baseline = readBaselineValue(json, section, key);
+        if (!baseline || *baseline <= 0.0) {
+            std::printf("  %s %-4s  no baseline value, skipped\n", section, key);
+            continue;
+        }
+
+        const double change = (current - *baseline) / *baseline * 100.0;
+        const bool regressed = change > thresholdPercent;
+        regressions += regressed;
+        std::printf("  %s %-4s  %8.3f ms -> %8.3f ms  (%+.1f%%)%s\n",
+                    section, key, *baseline, current, change, regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+void printSummary(const char* label, const Summary& summary) {
+    std::printf("%-4s mean=%.3f ms p50=%.3f ms p95=%.3f ms p99=%.3f ms max=%.3f ms\n",
+                label, summary.mean, summary.p50, summary.p95, summary.p99, summary.max);
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    VulkanConfig config;
+    config.enableValidationLayers = options.validation;
+    config.dynamicRendering = options.dynamicRendering;
+    config.headlessExtent = { options.width, options.height };
+    config.stressInstanceCount = options.instanceCount;
+    config.gpuCulling = options.gpuCulling;
+    config.stressMeshSegments = options.sphereSegments;
+    config.packedVertices = options.packedVertices;
+    config.stressMeshPath = options.meshPath;
+    config.animateStressScene = options.animate;
+    config.batchedStressScene = options.batched;
+
+    Renderer renderer(nullptr, config);
+    const CameraPath path = CameraPath::orbit(3.0f, 0.5f);
+
+    const uint32_t totalFrames = options.warmupFrames + options.measuredFrames;
+    const uint32_t drainFrames = config.frameSlotCount;
+
+    Results results;
+    results.cpuMs.reserve(options.measuredFrames);
+    results.gpuMs.assign(options.measuredFrames, std::nullopt);
+
+    // Frame numbers of the first measured frame; GPU times arrive a few frames late
+    const uint64_t firstMeasured = renderer.getFrameNumber() + options.warmupFrames + 1;
+
+    uint64_t lastGpuFrame = 0;
+
+    using clock = std::chrono::steady_clock;
+    for (uint32_t frame = 0; frame < totalFrames + drainFrames; ++frame) {
+        // The path advances per frame, not per second, so every run sees the same views
+        const auto pose = path.sample(static_cast<float>(frame) / static_cast<float>(totalFrames));
+        renderer.getCamera().setPosition(pose.position);
+        renderer.getCamera().setOrientation(pose.orientation);
+
+        const auto start = clock::now();
+        renderer.draw();
+        const double cpuMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+        if (frame >= options.warmupFrames && frame < totalFrames) {
+            results.cpuMs.push_back(cpuMs);
+        }
+
+        // The profiler keeps its latest result until a newer frame retires
+        const auto& gpu = renderer.getGpuProfiler().getLatestResult();
+        if (gpu && gpu->frame != lastGpuFrame &&
+            gpu->frame >= firstMeasured && gpu->frame < firstMeasured + options.measuredFrames) {
+            results.gpuMs[gpu->frame - firstMeasured] = gpu->totalMs;
+            for (const auto& scope : gpu->scopes) {
+                results.scopeMs[scope.name].push_back(scope.ms);
+            }
+        }
+        if (gpu) lastGpuFrame = gpu->frame;
+    }
+    renderer.waitIdle();
+
+    std::vector<double> gpuSamples;
+    for (const auto& sample : results.gpuMs) {
+        if (sample) gpuSamples.push_back(*sample);
+    }
+    results.cpu = summarize(results.cpuMs);
+    results.gpu = summarize(gpuSamples);
+    for (const auto& [name, samples] : results.scopeMs) {
+        results.scopes[name] = summarize(samples);
+    }
+
+    std::printf("%u warm-up + %u measured frames at %ux%u\n",
+                options.warmupFrames, options.measuredFrames, options.width, options.height);
+    if (renderer.getInstanceCount() > 0) {
+        std::printf("%u instances, culled on the %s, %s vertices: %.1f KiB\n", renderer.getInstanceCount(),
+                    renderer.isGpuCulling() ? "GPU" : "CPU", renderer.hasPackedVertices() ? "packed" : "float",
+                    renderer.getSceneVertexBytes() / 1024.0);
+    }
+    printSummary("cpu", results.cpu);
+    printSummary("gpu", results.gpu);
+    for (const auto& [name, summary] : results.scopes) {
+        std::printf("  %s\n", name.c_str());
+        printSummary("gpu", summary);
+    }
+    if (gpuSamples.size() < results.cpuMs.size()) {
+        std::printf("gpu  %zu of %zu frames have timestamps\n", gpuSamples.size(), results.cpuMs.size());
+    }
+
+    if (!options.csvPath.empty()) writeCsv(options.csvPath, results);
+    if (!options.jsonPath.empty()) writeJson(options.jsonPath, options, results, renderer);
+
+    if (!options.baselinePath.empty() &&
+        compareBaseline(options.baselinePath, results, options.thresholdPercent) > 0) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+// CPU-only job system microbenchmarks, run for 1, 2, 4, ... --max-threads
+// threads:
+//
+//   spawn     owner spawns batches of empty jobs and helps drain them
+//   steal     owner spawns batches but only watches, so every job is stolen
+//   chain     spawnAfter chains of dependent jobs (one counter per link)
+//   for       parallelFor over a fixed per-item workload, per grain size,
+//             with the speedup over one thread
+//
+// Thread counts above the core count are still run; they show the cost of
+// oversubscription rather than scaling.
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t jobs = 1u << 20;       // Empty jobs per spawn/steal run
+    uint32_t chainLength = 1u << 16;
+    uint32_t items = 1u << 20;      // parallelFor items
+    uint32_t repeats = 5;           // Best of
+    bool pin = false;
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--max-threads")) options.maxThreads = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--jobs")) options.jobs = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--chain")) options.chainLength = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--items")) options.items = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--repeats")) options.repeats = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--pin")) options.pin = true;
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    options.maxThreads = std::max(1u, options.maxThreads);
+    options.repeats = std::max(1u, options.repeats);
+    return options;
+}
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Function>
+double bestSeconds(const uint32_t repeats, const Function& function) {
+    double best = 1e30;
+    for (uint32_t i = 0; i < repeats; ++i) {
+        const auto start = Clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+// Below the per-worker deque capacity, so nothing runs inline on overflow
+constexpr uint32_t kSpawnBatch = 1024;
+
+double spawnNs(JobSystem& jobs, const Options& options, const bool help) {
+    std::atomic<uint32_t> ran = 0;
+    const double seconds = bestSeconds(options.repeats, [&] {
+        for (uint32_t done = 0; done < options.jobs; done += kSpawnBatch) {
+            JobCounter counter;
+            for (uint32_t i = 0; i < kSpawnBatch; ++i) {
+                jobs.spawn([&ran](uint32_t) { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+
+            if (help) {
+                jobs.wait(counter);
+            } else {
+                while (!counter.isDone()) std::this_thread::yield();
+            }
+        }
+    });
+    return seconds * 1e9 / options.jobs;
+}
+
+double chainNs(JobSystem& jobs, const Options& options) {
+    const double seconds = bestSeconds(options.repeats, [&] {
+        const auto links = std::make_unique<JobCounter[]>(options.chainLength);
+        jobs.spawn([](uint32_t) {}, &links[0]);
+        for (uint32_t i = 1; i < options.chainLength; ++i) {
+            jobs.spawnAfter(links[i - 1], [](uint32_t) {}, &links[i]);
+        }
+        jobs.wait(links[options.chainLength - 1]);
+    });
+    return seconds * 1e9 / options.chainLength;
+}
+
+// A few hundred nanoseconds of dependent arithmetic per item
+float work(const uint32_t item) {
+    float value = static_cast<float>(item & 1023) * 0.001f;
+    for (uint32_t i = 0; i < 64; ++i) {
+        value = std::sqrt(value * value + 1.0f) * 0.5f;
+    }
+    return value;
+}
+
+double forSeconds(JobSystem& jobs, const Options& options, const uint32_t grain, std::vector<float>& output) {
+    return bestSeconds(options.repeats, [&] {
+        jobs.parallelFor(options.items, grain, [&](const uint32_t begin, const uint32_t end, uint32_t) {
+            for (uint32_t i = begin; i < end; ++i) output[i] = work(i);
+        });
+    });
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t threads = 1; threads < options.maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(options.maxThreads);
+
+    const uint32_t grains[] = { 0, 64, 1024, 16384 };
+    std::vector<float> output(options.items);
+
+    std::printf("%u jobs, chain of %u, %u parallelFor items, best of %u%s\n", options.jobs, options.chainLength,
+                options.items, options.repeats, options.pin ? ", pinned" : "");
+    std::printf("%8s %10s %10s %10s", "threads", "spawn ns", "steal ns", "chain ns");
+    for (const uint32_t grain : grains) {
+        char label[32];
+        std::snprintf(label, sizeof(label), grain == 0 ? "for auto" : "for %u", grain);
+        std::printf(" %10s", label);
+    }
+    std::printf(" %8s\n", "speedup");
+
+    double baseline = 0.0;
+    for (const uint32_t threads : threadCounts) {
+        JobSystem jobs(JobSystem::Options { .threadCount = threads, .pinThreads = options.pin });
+
+        std::printf("%8u %10.1f", threads, spawnNs(jobs, options, true));
+        if (threads > 1) {
+            std::printf(" %10.1f", spawnNs(jobs, options, false));
+        } else {
+            std::printf(" %10s", "-");
+        }
+        std::printf(" %10.1f", chainNs(jobs, options));
+
+        double autoSeconds = 0.0;
+        for (const uint32_t grain : grains) {
+            const double seconds = forSeconds(jobs, options, grain, output);
+            if (grain == 0) autoSeconds = seconds;
+            std::printf(" %8.2fms", seconds * 1e3);
+        }
+
+        if (baseline == 0.0) baseline = autoSeconds;
+        std::printf(" %7.2fx\n", baseline / autoSeconds);
+    }
+
+    return 0;
+}
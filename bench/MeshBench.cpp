@@ -0,0 +1,120 @@
+// CPU-only benchmark for MeshOptimizer. Builds a large UV sphere as a
+// shuffled, non-indexed triangle soup (the worst case an exporter can hand
+// us), runs each pass and reports post-transform cache efficiency and
+// throughput after every step, then the memory saved by PackedVertex.
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint32_t segments = 512;    // Sphere is segments x segments quads
+    uint32_t cacheSize = 16;
+    uint32_t seed = 1234;
+    bool shuffle = true;        // --ordered keeps the generator's row order instead
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--segments")) options.segments = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--cache")) options.cacheSize = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--ordered")) options.shuffle = false;
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    return options;
+}
+
+// Expands the indexed sphere back into a soup, as a naive exporter would write it
+std::vector<Vertex> makeSphereSoup(const Options& options) {
+    const Mesh sphere = Mesh::uvSphere(options.segments);
+
+    std::vector<std::array<Vertex, 3>> triangles(sphere.indices.size() / 3);
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        for (size_t k = 0; k < 3; ++k) {
+            triangles[t][k] = sphere.vertices[sphere.indices[t * 3 + k]];
+        }
+    }
+
+    if (options.shuffle) {
+        std::mt19937 rng(options.seed);
+        std::ranges::shuffle(triangles, rng);
+    }
+
+    std::vector<Vertex> soup;
+    soup.reserve(triangles.size() * 3);
+    for (const auto& triangle : triangles) {
+        soup.insert(soup.end(), triangle.begin(), triangle.end());
+    }
+    return soup;
+}
+
+void printStats(const char* label, const Mesh& mesh, const uint32_t cacheSize) {
+    const MeshOptimizer::CacheStats stats = MeshOptimizer::analyzeVertexCache(mesh.indices, mesh.vertices.size(), cacheSize);
+    std::printf("%-10s ACMR=%.3f ATVR=%.3f\n", label, stats.acmr, stats.atvr);
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+    const std::vector<Vertex> soup = makeSphereSoup(options);
+    const double triangles = static_cast<double>(soup.size() / 3);
+
+    using clock = std::chrono::steady_clock;
+    const auto timed = [&](const char* label, const auto& pass) {
+        const auto start = clock::now();
+        pass();
+        const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        std::printf("%-10s %8.2f ms (%.2f Mtri/s)\n", label, ms, triangles / ms / 1e3);
+    };
+
+    std::printf("%.0f triangles, %s order, FIFO cache of %u\n",
+                triangles, options.shuffle ? "shuffled" : "generated", options.cacheSize);
+
+    Mesh mesh;
+    timed("dedup", [&] { mesh = MeshOptimizer::buildIndexed(soup); });
+    std::printf("%-10s %zu -> %zu vertices, %s indices\n", "", soup.size(), mesh.vertices.size(),
+                mesh.getIndexType() == VK_INDEX_TYPE_UINT16 ? "16-bit" : "32-bit");
+    printStats("before", mesh, options.cacheSize);
+
+    timed("cache", [&] { MeshOptimizer::optimizeVertexCache(mesh.indices, mesh.vertices.size()); });
+    printStats("", mesh, options.cacheSize);
+
+    // Trades a bounded amount of ACMR for front-to-back cluster order
+    timed("overdraw", [&] { MeshOptimizer::optimizeOverdraw(mesh.indices, mesh.vertices); });
+    printStats("", mesh, options.cacheSize);
+
+    timed("fetch", [&] { MeshOptimizer::optimizeVertexFetch(mesh); });
+    printStats("after", mesh, options.cacheSize);
+
+    // Memory side of the vertex layout comparison; FrameBench --packed-vertices measures the GPU side
+    VertexQuantization quantization;
+    std::vector<PackedVertex> packed;
+    timed("pack", [&] { packed = packVertices<PackedVertex>(mesh.vertices, quantization); });
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < packed.size(); ++i) {
+        const glm::vec3 stored(packed[i].position[0], packed[i].position[1], packed[i].position[2]);
+        const glm::vec3 restored = quantization.offset + quantization.scale * (stored / 32767.0f);
+        maxError = std::max(maxError, glm::length(restored - mesh.vertices[i].position));
+    }
+
+    const double floatKiB = sizeof(Vertex) * mesh.vertices.size() / 1024.0;
+    const double packedKiB = sizeof(PackedVertex) * packed.size() / 1024.0;
+    std::printf("%-10s float %.1f KiB -> packed %.1f KiB (%.0f%% smaller), max position error %.2e\n",
+                "vertices", floatKiB, packedKiB, (1.0 - packedKiB / floatKiB) * 100.0, maxError);
+
+    return 0;
+}
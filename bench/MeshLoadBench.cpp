@@ -0,0 +1,256 @@
+// CPU-only load-time comparison across the mesh import paths. Writes a
+// synthetic scene of --objects UV spheres as OBJ and as GLB, plus the merged
+// scene as a memory-mapped mesh file, then times each path up to the point
+// where the data is ready for upload:
+//
+//   obj/glb   MeshImporter with one thread and with every thread, reporting
+//             when the first mesh was delivered and when the last one was
+//   mapped    mmap + one copy per stream
+//
+// The files are read back through the page cache; drop it between runs
+// (e.g. `echo 3 > /proc/sys/vm/drop_caches`) to measure cold loads.
+
+#include "JobSystem.h"
+#include "MeshFile.h"
+#include "MeshImporter.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Options {
+    uint32_t objects = 64;
+    uint32_t segments = 256;    // Every sphere is segments x segments quads
+    uint32_t threads = 0;       // Pool size for the parallel runs; 0 = one per core
+    std::string directory = std::filesystem::temp_directory_path().string();
+    bool packed = false;
+    bool keep = false;          // --keep leaves the generated files behind
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--objects")) options.objects = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--segments")) options.segments = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads")) options.threads = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--dir")) options.directory = value();
+        else if (!std::strcmp(argv[i], "--packed")) options.packed = true;
+        else if (!std::strcmp(argv[i], "--keep")) options.keep = true;
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    return options;
+}
+
+// Spheres in a row along x, already optimized so every path ends with the same data
+std::vector<Mesh> makeScene(const Options& options) {
+    Mesh sphere = Mesh::uvSphere(options.segments);
+    MeshOptimizer::optimize(sphere);
+
+    std::vector<Mesh> scene(options.objects, sphere);
+    for (uint32_t i = 0; i < options.objects; ++i) {
+        for (Vertex& vertex : scene[i].vertices) {
+            vertex.position.x += 2.5f * static_cast<float>(i);
+        }
+    }
+    return scene;
+}
+
+// Plain o/v/vn/f records with running indices, the way most exporters write scanned geometry
+void writeObj(const std::string& path, const std::vector<Mesh>& scene) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::fprintf(stderr, "Failed to create %s\n", path.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+
+    uint32_t base = 1;
+    for (size_t i = 0; i < scene.size(); ++i) {
+        const Mesh& mesh = scene[i];
+        std::fprintf(file, "o sphere%zu\n", i);
+        for (const Vertex& vertex : mesh.vertices) {
+            std::fprintf(file, "v %.6f %.6f %.6f %.4f %.4f %.4f\n", vertex.position.x, vertex.position.y, vertex.position.z,
+                         vertex.color.x, vertex.color.y, vertex.color.z);
+        }
+        for (const Vertex& vertex : mesh.vertices) {
+            std::fprintf(file, "vn %.6f %.6f %.6f\n", vertex.normal.x, vertex.normal.y, vertex.normal.z);
+        }
+        for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+            const uint32_t a = base + mesh.indices[t];
+            const uint32_t b = base + mesh.indices[t + 1];
+            const uint32_t c = base + mesh.indices[t + 2];
+            std::fprintf(file, "f %u//%u %u//%u %u//%u\n", a, a, b, b, c, c);
+        }
+        base += static_cast<uint32_t>(mesh.vertices.size());
+    }
+    std::fclose(file);
+}
+
+// One mesh per sphere; positions, normals, colors and 32-bit indices in tightly packed views
+void writeGlb(const std::string& path, const std::vector<Mesh>& scene) {
+    std::string binary;
+    std::string views;
+    std::string accessors;
+    std::string meshes;
+    size_t viewCount = 0;
+
+    const auto addView = [&](const void* data, const size_t size, const size_t count, const char* type,
+                             const uint32_t componentType) {
+        const std::string separator = viewCount > 0 ? "," : "";
+        views += separator + "{\"buffer\":0,\"byteOffset\":" + std::to_string(binary.size()) +
+                 ",\"byteLength\":" + std::to_string(size) + "}";
+        accessors += separator + "{\"bufferView\":" + std::to_string(viewCount) +
+                     ",\"componentType\":" + std::to_string(componentType) + ",\"count\":" + std::to_string(count) +
+                     ",\"type\":\"" + type + "\"}";
+        binary.append(static_cast<const char*>(data), size);
+        binary.resize((binary.size() + 3) & ~size_t(3), '\0');
+        return viewCount++;
+    };
+
+    for (size_t i = 0; i < scene.size(); ++i) {
+        const Mesh& mesh = scene[i];
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> colors;
+        for (const Vertex& vertex : mesh.vertices) {
+            positions.push_back(vertex.position);
+            normals.push_back(vertex.normal);
+            colors.push_back(vertex.color);
+        }
+
+        const size_t count = mesh.vertices.size();
+        const size_t position = addView(positions.data(), count * sizeof(glm::vec3), count, "VEC3", 5126);
+        const size_t normal = addView(normals.data(), count * sizeof(glm::vec3), count, "VEC3", 5126);
+        const size_t color = addView(colors.data(), count * sizeof(glm::vec3), count, "VEC3", 5126);
+        const size_t index = addView(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t), mesh.indices.size(),
+                                     "SCALAR", 5125);
+
+        meshes += std::string(i > 0 ? "," : "") + "{\"name\":\"sphere" + std::to_string(i) +
+                  "\",\"primitives\":[{\"attributes\":{\"POSITION\":" + std::to_string(position) +
+                  ",\"NORMAL\":" + std::to_string(normal) + ",\"COLOR_0\":" + std::to_string(color) +
+                  "},\"indices\":" + std::to_string(index) + "}]}";
+    }
+
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},\"buffers\":[{\"byteLength\":" + std::to_string(binary.size()) +
+                       "}],\"bufferViews\":[" + views + "],\"accessors\":[" + accessors + "],\"meshes\":[" + meshes + "]}";
+    json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+    std::ofstream file(path, std::ios::binary);
+    const auto writeU32 = [&](const uint32_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    writeU32(0x46546C67);  // "glTF"
+    writeU32(2);
+    writeU32(static_cast<uint32_t>(12 + 8 + json.size() + 8 + binary.size()));
+    writeU32(static_cast<uint32_t>(json.size()));
+    writeU32(0x4E4F534A);  // "JSON"
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    writeU32(static_cast<uint32_t>(binary.size()));
+    writeU32(0x004E4942);  // "BIN\0"
+    file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+}
+
+Mesh merge(const std::vector<Mesh>& scene) {
+    Mesh merged;
+    for (const Mesh& mesh : scene) {
+        const auto base = static_cast<uint32_t>(merged.vertices.size());
+        merged.vertices.insert(merged.vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        for (const uint32_t index : mesh.indices) {
+            merged.indices.push_back(base + index);
+        }
+    }
+    return merged;
+}
+
+double fileMiB(const std::string& path) {
+    return static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+}
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(const Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Imports like the renderer would: optimized meshes, packed on arrival when requested
+void timeImport(const char* label, const std::string& path, const uint32_t threads, const bool packed) {
+    JobSystem jobs(threads);
+    MeshImporter importer(jobs);
+
+    std::atomic<uint32_t> meshes = 0;
+    std::atomic<int64_t> firstNs = -1;
+    const auto start = Clock::now();
+    importer.import(path, [&](ImportedMesh&& mesh) {
+        int64_t none = -1;
+        firstNs.compare_exchange_strong(none, std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        if (packed) {
+            VertexQuantization quantization;
+            packVertices<PackedVertex>(mesh.mesh.vertices, quantization);
+        }
+        ++meshes;
+    });
+    const double total = secondsSince(start);
+
+    std::printf("%-6s %2u threads %8.3f s, first mesh after %.3f s (%u meshes)\n",
+                label, jobs.getThreadCount(), total, static_cast<double>(firstNs.load()) / 1e9, meshes.load());
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+    const std::filesystem::path directory(options.directory);
+    const std::string objPath = (directory / "VulkanLabMeshLoad.obj").string();
+    const std::string glbPath = (directory / "VulkanLabMeshLoad.glb").string();
+    const std::string meshPath = (directory / "VulkanLabMeshLoad.vmesh").string();
+
+    size_t uploadBytes = 0;
+    {
+        const std::vector<Mesh> scene = makeScene(options);
+        writeObj(objPath, scene);
+        writeGlb(glbPath, scene);
+        const Mesh merged = merge(scene);
+        MeshFile::write(meshPath, merged, options.packed ? MeshVertexFormat::Packed : MeshVertexFormat::Float);
+        uploadBytes = std::filesystem::file_size(meshPath);
+
+        std::printf("%u objects, %zu vertices, %zu triangles: OBJ %.1f MiB, GLB %.1f MiB, mesh file %.1f MiB (%s)\n",
+                    options.objects, merged.vertices.size(), merged.indices.size() / 3, fileMiB(objPath),
+                    fileMiB(glbPath), fileMiB(meshPath), options.packed ? "packed" : "float");
+    }
+
+    const uint32_t threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    for (const char* format : { "obj", "glb" }) {
+        const std::string& path = format[0] == 'o' ? objPath : glbPath;
+        timeImport(format, path, 1, options.packed);
+        if (threads > 1) timeImport(format, path, threads, options.packed);
+    }
+
+    // Stand-in for the staging ring the streams are copied into
+    const auto upload = std::make_unique_for_overwrite<std::byte[]>(uploadBytes);
+    const auto start = Clock::now();
+    {
+        const MeshFile file(meshPath);
+        const auto vertices = file.getVertexData();
+        const auto indices = file.getIndexData();
+        std::memcpy(upload.get(), vertices.data(), vertices.size());
+        std::memcpy(upload.get() + vertices.size(), indices.data(), indices.size());
+    }
+    const double mapped = secondsSince(start);
+    std::printf("%-6s %8.3f s (%.2f GiB/s)\n", "mapped", mapped, uploadBytes / (1024.0 * 1024.0 * 1024.0) / mapped);
+
+    if (!options.keep) {
+        std::filesystem::remove(objPath);
+        std::filesystem::remove(glbPath);
+        std::filesystem::remove(meshPath);
+    }
+    return 0;
+}
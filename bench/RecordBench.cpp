@@ -0,0 +1,87 @@
+// Command recording scaling benchmark. Renders a large headless draw list while
+// varying the number of recording workers from 1 to N and reports how the CPU
+// time spent recording the frame scales.
+
+#include "Renderer.h"
+#include "VulkanConfig.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint32_t draws = 50'000;
+    uint32_t warmupFrames = 30;
+    uint32_t measuredFrames = 300;
+    uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--draws")) options.draws = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--warmup")) options.warmupFrames = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--frames")) options.measuredFrames = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--max-threads")) options.maxThreads = std::strtoul(argv[i + 1], nullptr, 10);
+    }
+    return options;
+}
+
+double median(std::vector<double> samples) {
+    if (samples.empty()) return 0.0;
+    std::ranges::sort(samples);
+    return samples[samples.size() / 2];
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    VulkanConfig config;
+    config.enableValidationLayers = false;
+    config.headlessExtent = { 640, 360 };
+
+    Renderer renderer(nullptr, config);
+
+    // Every draw is the same triangle; only the CPU cost of recording matters here
+    const DrawCommand draw = renderer.getDrawList().front();
+    renderer.setDrawList(std::vector(options.draws, draw));
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t threads = 1; threads < options.maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(options.maxThreads);
+
+    std::printf("%u draws, %u measured frames per run\n", options.draws, options.measuredFrames);
+    std::printf("%8s %14s %14s %10s\n", "threads", "record p50 ms", "record min ms", "speedup");
+
+    double baseline = 0.0;
+    for (const uint32_t threads : threadCounts) {
+        renderer.setRecordThreadCount(threads);
+
+        for (uint32_t frame = 0; frame < options.warmupFrames; ++frame) {
+            renderer.draw();
+        }
+
+        std::vector<double> samples;
+        samples.reserve(options.measuredFrames);
+        for (uint32_t frame = 0; frame < options.measuredFrames; ++frame) {
+            renderer.draw();
+            samples.push_back(renderer.getLastRecordMs());
+        }
+
+        const double p50 = median(samples);
+        const double best = *std::ranges::min_element(samples);
+        if (baseline == 0.0) baseline = p50;
+
+        std::printf("%8u %14.3f %14.3f %9.2fx\n", threads, p50, best, baseline / p50);
+    }
+
+    renderer.waitIdle();
+    return 0;
+}
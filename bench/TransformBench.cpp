@@ -0,0 +1,259 @@
+// CPU-only transform hierarchy benchmark on a tree of --nodes nodes where
+// every node has up to --branching children (so the depth grows with the
+// log of the node count):
+//
+//   recursive   the usual scene graph walk: one heap object per node holding
+//               its children, parent * local.getMatrix() with glm
+//   glm         the depth-sorted arrays, still composing with glm::mat4
+//   simd        the depth-sorted arrays with the SSE compose kernel, on one
+//               thread and on the job system
+//   dirty       --dirty random nodes touched per frame, recomputing only
+//               their subtrees
+//   output      every world matrix also copied into GpuInstance records,
+//               as the renderer does into its per-frame ring
+//
+// Every pass is checked against the recursive one.
+
+#include "GpuScene.h"
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint32_t nodes = 1'000'000;
+    uint32_t branching = 4;
+    uint32_t dirty = 1000;          // Nodes touched per frame in the dirty row
+    uint32_t repeats = 5;           // Best of
+    uint32_t threads = 0;           // Job system size for the parallel rows; 0 = one per core
+    uint32_t seed = 1234;
+};
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--nodes")) options.nodes = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--branching")) options.branching = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--dirty")) options.dirty = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--repeats")) options.repeats = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads")) options.threads = std::strtoul(value(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = std::strtoul(value(), nullptr, 10);
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    options.nodes = std::max(1u, options.nodes);
+    options.branching = std::max(1u, options.branching);
+    options.repeats = std::max(1u, options.repeats);
+    return options;
+}
+
+// Relative to the largest element of the expected matrix, since deep chains
+// of rotations accumulate rounding differences between the kernels
+constexpr float kTolerance = 1e-4f;
+
+struct SceneNode {
+    Transform local;
+    glm::mat4 world { 1.0f };
+    std::vector<SceneNode*> children;
+};
+
+void updateRecursive(SceneNode& node, const glm::mat4& parent) {
+    node.world = parent * node.local.getMatrix();
+    for (SceneNode* child : node.children) updateRecursive(*child, node.world);
+}
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Function>
+double bestSeconds(const uint32_t repeats, const Function& function) {
+    double best = 1e30;
+    for (uint32_t i = 0; i < repeats; ++i) {
+        const auto start = Clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+void printRow(const char* label, const uint32_t threads, const double seconds, const uint32_t count,
+              const double baseline) {
+    std::printf("%-16s %7u %10.2f ms %8.2f ns/node", label, threads, seconds * 1e3, seconds * 1e9 / count);
+    if (baseline > 0.0) std::printf(" %7.1fx", baseline / seconds);
+    std::printf("\n");
+}
+
+bool matches(const glm::mat4& expected, const glm::mat4& actual) {
+    float scale = 1.0f;
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) scale = std::max(scale, std::abs(expected[c][r]));
+    }
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            if (std::abs(expected[c][r] - actual[c][r]) > kTolerance * scale) return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(const int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> scale(0.9f, 1.1f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const auto randomTransform = [&] {
+        return Transform {
+            .position = { offset(rng), offset(rng), offset(rng) },
+            .rotation = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng))),
+            .scale = glm::vec3(scale(rng))
+        };
+    };
+
+    // Node i's parent is (i - 1) / branching, a complete tree
+    std::vector<Transform> locals(options.nodes);
+    for (Transform& local : locals) local = randomTransform();
+    const auto parentOf = [&](const uint32_t i) {
+        return i == 0 ? TransformHierarchy::kInvalid : (i - 1) / options.branching;
+    };
+
+    // Baseline objects, allocated in a shuffled order as after a while of churn
+    std::vector<uint32_t> allocationOrder(options.nodes);
+    for (uint32_t i = 0; i < options.nodes; ++i) allocationOrder[i] = i;
+    std::shuffle(allocationOrder.begin(), allocationOrder.end(), rng);
+    std::vector<std::unique_ptr<SceneNode>> sceneNodes(options.nodes);
+    for (const uint32_t i : allocationOrder) {
+        sceneNodes[i] = std::make_unique<SceneNode>();
+        sceneNodes[i]->local = locals[i];
+    }
+    for (uint32_t i = 1; i < options.nodes; ++i) sceneNodes[parentOf(i)]->children.push_back(sceneNodes[i].get());
+
+    JobSystem jobs(options.threads);
+    TransformHierarchy hierarchy;
+    TransformHierarchy glmHierarchy(TransformHierarchy::Options { .simd = false });
+    std::vector<uint32_t> handles(options.nodes);
+    for (uint32_t i = 0; i < options.nodes; ++i) {
+        const uint32_t parent = i == 0 ? TransformHierarchy::kInvalid : handles[parentOf(i)];
+        handles[i] = hierarchy.add(locals[i], parent, i);
+        glmHierarchy.add(locals[i], parent, i);
+    }
+
+    // The first update sorts; it and the full ones below recompute everything
+    const double sortSeconds = bestSeconds(1, [&] { hierarchy.update(); });
+    glmHierarchy.update();
+
+    std::printf("%u nodes, branching %u, %u levels, best of %u, %u job threads\n", options.nodes, options.branching,
+                hierarchy.getLevelCount(), options.repeats, jobs.getThreadCount());
+    std::printf("%-16s %7s %13s %17s %8s\n", "pass", "threads", "time", "per node", "speedup");
+    printRow("sort + update", 1, sortSeconds, options.nodes, 0.0);
+
+    // Full recomputes: touching the root dirties the whole tree
+    const auto touchRoot = [&](TransformHierarchy& target) { target.setLocal(handles[0], locals[0]); };
+
+    const double recursive = bestSeconds(options.repeats, [&] { updateRecursive(*sceneNodes[0], glm::mat4(1.0f)); });
+    printRow("recursive", 1, recursive, options.nodes, recursive);
+
+    const double glmSeconds = bestSeconds(options.repeats, [&] {
+        touchRoot(glmHierarchy);
+        glmHierarchy.update();
+    });
+    printRow("glm", 1, glmSeconds, options.nodes, recursive);
+
+    const double simdSeconds = bestSeconds(options.repeats, [&] {
+        touchRoot(hierarchy);
+        hierarchy.update();
+    });
+    printRow("simd", 1, simdSeconds, options.nodes, recursive);
+
+    uint32_t mismatches = 0;
+    const auto check = [&](const TransformHierarchy& target) {
+        for (uint32_t i = 0; i < options.nodes; ++i) {
+            if (!matches(sceneNodes[i]->world, target.getWorld(handles[i]))) ++mismatches;
+        }
+    };
+    check(glmHierarchy);
+    check(hierarchy);
+
+    if (jobs.getThreadCount() > 1) {
+        const double parallelSeconds = bestSeconds(options.repeats, [&] {
+            touchRoot(hierarchy);
+            hierarchy.update(&jobs);
+        });
+        printRow("simd", jobs.getThreadCount(), parallelSeconds, options.nodes, recursive);
+        check(hierarchy);
+    }
+
+    // Sparse edits: each frame moves a few random nodes; their subtrees follow
+    std::uniform_int_distribution<uint32_t> anyNode(0, options.nodes - 1);
+    std::vector<uint32_t> touched(options.dirty);
+    uint32_t updatedCount = 0;
+    const double dirtySeconds = bestSeconds(options.repeats, [&] {
+        for (uint32_t& node : touched) {
+            node = anyNode(rng);
+            locals[node] = randomTransform();
+            hierarchy.setLocal(handles[node], locals[node]);
+        }
+        hierarchy.update(&jobs);
+        updatedCount = hierarchy.getUpdatedCount();
+    });
+    printRow("dirty", jobs.getThreadCount(), dirtySeconds, options.nodes, recursive);
+    std::printf("%-16s %u touched, %u recomputed\n", "", options.dirty, updatedCount);
+
+    for (uint32_t i = 0; i < options.nodes; ++i) sceneNodes[i]->local = locals[i];
+    updateRecursive(*sceneNodes[0], glm::mat4(1.0f));
+    check(hierarchy);
+
+    // Output into instance records; nothing is dirty, so this is the copy alone
+    std::vector<GpuInstance> instances(options.nodes);
+    const TransformHierarchy::Output output { .data = instances.data(), .stride = sizeof(GpuInstance) };
+    const double outputSeconds = bestSeconds(options.repeats, [&] { hierarchy.update(&jobs, output); });
+    printRow("output", jobs.getThreadCount(), outputSeconds, options.nodes, recursive);
+    for (uint32_t i = 0; i < options.nodes; ++i) {
+        if (std::memcmp(&instances[i].model, &hierarchy.getWorld(handles[i]), sizeof(glm::mat4)) != 0) ++mismatches;
+    }
+
+    // Reparenting half of the root's subtrees onto a new root, then removing the old one
+    const uint32_t newRoot = hierarchy.add(Transform {});
+    for (uint32_t i = 1; i <= options.branching && i < options.nodes; i += 2) hierarchy.setParent(handles[i], newRoot);
+    hierarchy.remove(handles[0]);
+    const auto start = Clock::now();
+    hierarchy.update(&jobs);
+    printRow("reparent + sort", jobs.getThreadCount(), std::chrono::duration<double>(Clock::now() - start).count(),
+             hierarchy.getNodeCount(), 0.0);
+
+    uint32_t kept = 1;
+    std::vector<uint8_t> alive(options.nodes, 0);
+    for (uint32_t i = 1; i < options.nodes; ++i) {
+        const uint32_t parent = parentOf(i);
+        alive[i] = parent == 0 ? (i - 1) % 2 == 0 : alive[parent];
+        if (alive[i]) {
+            ++kept;
+            const glm::mat4 parentWorld = parent == 0 ? glm::mat4(1.0f) : sceneNodes[parent]->world;
+            sceneNodes[i]->world = parentWorld * locals[i].getMatrix();
+            if (!hierarchy.isAlive(handles[i]) || !matches(sceneNodes[i]->world, hierarchy.getWorld(handles[i]))) {
+                ++mismatches;
+            }
+        } else if (hierarchy.isAlive(handles[i])) {
+            ++mismatches;
+        }
+    }
+    if (hierarchy.getNodeCount() != kept) ++mismatches;
+
+    if (mismatches > 0) {
+        std::printf("%u checks did not match the baseline\n", mismatches);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -169,4 +169,20 @@ private:
 #define WARN(...)  Logger::warn(__FILE__, __LINE__, __func__, __VA_ARGS__)
 #define ERROR(...) Logger::error(__FILE__, __LINE__, __func__, __VA_ARGS__)
 
+// CPU profiling scopes (see CpuProfiler.h); compiled out unless VULKANLAB_ENABLE_PROFILING is set
+#ifdef VULKANLAB_ENABLE_PROFILING
+#include "CpuProfiler.h"
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) const CpuProfiler::Scope PROFILE_CONCAT(profileScope_, __COUNTER__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_FRAME(frame) CpuProfiler::beginFrame(frame)
+#define PROFILE_THREAD(name) CpuProfiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME(frame) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
 #endif // LOGGER_H
\ No newline at end of file
@@ -1,24 +1,58 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
 class WindowManager;
 class Renderer;
 class ImGuiLayer;
 
+struct LaunchOptions {
+    bool headless = false;          // Render offscreen without a window
+    uint32_t frameCount = 1000;     // Frames to render before exiting in headless mode
+    uint32_t width = 1920;          // Headless render target size
+    uint32_t height = 1080;
+    bool validation = true;
+    bool dynamicRendering = true;   // --no-dynamic-rendering forces the render pass path
+    uint32_t instanceCount = 0;     // --instances N adds a stress scene of N cubes
+    bool gpuCulling = true;         // --cpu-culling tests and draws them one by one on the CPU
+    uint32_t sphereSegments = 0;    // --sphere N instances an N x N UV sphere instead of the cube
+    bool packedVertices = false;    // --packed-vertices stores that mesh as PackedVertex
+    std::string meshPath;           // --mesh FILE instances a converted mesh file instead
+    bool animate = false;           // --animate spins half of the stress scene every frame
+    bool batched = false;           // --batched submits it as instanced batches instead, culled on the CPU
+    std::string scenePath;          // --scene FILE imports an OBJ or glTF scene, drawing meshes as they finish
+    bool pinThreads = false;        // --pin-threads pins job system workers to cores
+
+    // CPU trace output. With a frame range only those frames are recorded;
+    // otherwise the trace is written on F9, or at exit when headless.
+    std::string tracePath;
+    uint32_t traceFirstFrame = 0;
+    uint32_t traceFrameCount = 0;
+
+    static LaunchOptions parse(int argc, char** argv);
+};
+
 class Application {
 public:
-    Application();
+    explicit Application(const LaunchOptions& options = {});
     ~Application();
 
     void run();
 
 private:
+    LaunchOptions m_options;
+
     std::unique_ptr<WindowManager> m_windowManager;
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<ImGuiLayer> m_imguiLayer;
 
+    uint64_t m_frame = 0;
+
+    void runHeadless();
+    void writeTrace() const;
 };
 
 #endif // APPLICATION_H
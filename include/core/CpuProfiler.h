@@ -0,0 +1,78 @@
+#ifndef CPU_PROFILER_H
+#define CPU_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#define VULKANLAB_PROFILER_TSC 1
+#endif
+
+// CPU scope profiler that exports Chrome trace-event JSON (chrome://tracing,
+// ui.perfetto.dev). Each thread appends to its own fixed-size ring with
+// relaxed stores and one release store per scope, so recording takes no locks
+// and writeTrace() can copy the rings while threads keep recording; the newest
+// kEventsPerThread events per thread are kept.
+//
+// Use the PROFILE_SCOPE / PROFILE_FUNCTION macros from Logger.h rather than
+// this class directly: they compile to nothing without VULKANLAB_ENABLE_PROFILING.
+// Scope names must outlive the trace; string literals and __func__ do.
+class CpuProfiler {
+public:
+    static constexpr uint32_t kEventsPerThread = 1u << 16;
+
+    class Scope {
+    public:
+        explicit Scope(const char* name)
+            : m_name(name), m_start(s_enabled.load(std::memory_order_relaxed) ? now() : 0) {}
+
+        ~Scope() {
+            if (m_start != 0) record(m_name, m_start, now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_start;
+    };
+
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Shown as the thread's track name in the trace viewer
+    static void setThreadName(std::string name);
+
+    // Marks the start of a frame and drives any pending captureFrames() request
+    static void beginFrame(uint64_t frame);
+
+    // Records only frames [first, first + count) and writes them to path once the
+    // last one has finished
+    static void captureFrames(uint64_t first, uint64_t count, std::filesystem::path path);
+
+    // Writes everything currently held in the per-thread rings
+    static bool writeTrace(const std::filesystem::path& path);
+
+private:
+    static inline std::atomic<bool> s_enabled = true;
+
+    // Raw ticks; the TSC is several times cheaper to read than steady_clock and
+    // is converted to nanoseconds once, at export
+    static uint64_t now() {
+#ifdef VULKANLAB_PROFILER_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static void record(const char* name, uint64_t start, uint64_t end);
+};
+
+#endif // CPU_PROFILER_H
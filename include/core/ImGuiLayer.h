@@ -7,6 +7,8 @@
 #include "VulkanContext.h"
 #include "VulkanConfig.h"
 
+class VulkanDeletionQueue;
+
 class ImGuiLayer {
 public:
     explicit ImGuiLayer(
@@ -21,11 +23,24 @@ public:
 
     static void rebuildFontAtlas(VkCommandBuffer cmd);
 
+    // Builds the pipeline for a new swapchain format or render pass; the old one is retired
+    // into deletionQueue at lastUse, the last frame that may have drawn with it
+    void recreatePipeline(const VulkanContext& context, VulkanDeletionQueue& deletionQueue, uint64_t lastUse);
+
 private:
     void createDescriptorPool();
+    void createPipelineLayout();
+    [[nodiscard]] VkPipeline createPipeline(const VulkanContext& context) const;
+
+    // Drawn with in place of the backend's own pipeline, which can only be rebuilt
+    // by reinitializing the backend and uploading the font atlas again
+    static inline VkPipeline s_pipeline = VK_NULL_HANDLE;
 
     VkDevice m_device;
+    VkDescriptorSetLayout m_textureSetLayout = VK_NULL_HANDLE;   // Matches the backend's layout
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
     VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    VkFormat m_colorFormat = VK_FORMAT_UNDEFINED; // Referenced by ImGui's pipeline create info
 
 };
 
@@ -0,0 +1,129 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+
+// Work-stealing job scheduler. Every thread owns a Chase-Lev deque: it pushes
+// and pops its own jobs at the bottom (LIFO, cache-warm), and idle threads
+// steal from the top of a random victim's deque. Waiting never blocks a
+// thread that could be working; wait() runs queued jobs until the counter it
+// waits on drains, which also makes nested parallelFor calls safe.
+//
+// Worker indices are stable (0 is the thread that owns the system), so
+// callers can keep per-worker state such as command pools without locking.
+// A job that waits may run other jobs on its own worker in the meantime.
+//
+// Only the owning thread and jobs themselves may submit work, and jobs must
+// not throw.
+class JobSystem {
+public:
+    using JobFunction = std::function<void(uint32_t worker)>;
+    using Task = std::function<void(uint32_t task, uint32_t worker)>;
+    using RangeTask = std::function<void(uint32_t begin, uint32_t end, uint32_t worker)>;
+
+    struct Options {
+        uint32_t threadCount = 0;   // Caller included; 0 picks one per hardware thread
+        bool pinThreads = false;    // Pin worker i to logical core i; the owning thread is left alone
+    };
+
+    explicit JobSystem(uint32_t threadCount = 0);
+    explicit JobSystem(const Options& options);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    [[nodiscard]] uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    // Index of the calling thread; any thread that is not one of the workers counts as 0
+    [[nodiscard]] uint32_t getCurrentWorker() const;
+
+    // Queues job on the calling thread's deque. counter, when given, is
+    // incremented now and decremented once the job has run.
+    void spawn(JobFunction job, JobCounter* counter = nullptr);
+
+    // Queues job once dependency has drained to zero; counter is incremented now
+    void spawnAfter(JobCounter& dependency, JobFunction job, JobCounter* counter = nullptr);
+
+    // Runs queued jobs until counter reaches zero
+    void wait(const JobCounter& counter);
+
+    // Runs task(i, worker) for every i in [0, count) and returns once all have finished
+    void parallelFor(uint32_t count, const Task& task);
+
+    // Runs task over [0, count) in ranges of at most grain items, split
+    // recursively so thieves take large halves first. 0 picks a grain that
+    // gives every thread several ranges.
+    void parallelFor(uint32_t count, uint32_t grain, const RangeTask& task);
+
+private:
+    friend class JobCounter;
+
+    struct Job {
+        JobFunction function;
+        JobCounter* counter = nullptr;
+        Job* next = nullptr;        // Free list or continuation list link
+        uint32_t owner = 0;         // Worker whose free list the job returns to
+    };
+
+    struct Worker;
+
+    // Shared by every piece of one parallelFor; lives on the caller's stack until it returns
+    struct RangeSplit {
+        JobSystem* system;
+        const RangeTask* task;
+        JobCounter* counter;
+        uint32_t grain;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    // Idle workers sleep on m_wakeEpoch; spawning bumps it only when someone is asleep
+    std::atomic<uint32_t> m_sleepers = 0;
+    std::atomic<uint32_t> m_wakeEpoch = 0;
+    std::atomic<bool> m_stop = false;
+
+    void workerLoop(uint32_t worker, bool pin);
+
+    Job* allocateJob(uint32_t worker);
+    void freeJob(Job* job, uint32_t worker);
+
+    void push(Job* job, uint32_t worker);
+    Job* findJob(uint32_t worker);
+    void execute(Job* job, uint32_t worker);
+    void release(JobCounter& counter, uint32_t worker);
+
+    void splitRange(const RangeSplit& split, uint32_t begin, uint32_t end, uint32_t worker);
+};
+
+// Number of outstanding jobs that something is waiting on. Reusable once it
+// has drained, but must outlive every job and continuation attached to it.
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    [[nodiscard]] bool isDone() const { return m_state.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    // Held while continuations are attached, and by the last job while it
+    // takes them, so nobody sees zero before they have been queued
+    static constexpr uint32_t kLocked = 1u << 31;
+
+    std::atomic<uint32_t> m_state = 0;                  // Pending jobs, plus kLocked
+    JobSystem::Job* m_continuations = nullptr;          // Queued by whoever drains the counter
+};
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,50 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include <limits>
+#include <glm/glm.hpp>
+
+// Axis-aligned bounding box. empty() is inverted (min > max) so that growing
+// it by anything yields exactly that thing.
+struct Aabb {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    static Aabb empty() {
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+        return { glm::vec3(infinity), glm::vec3(-infinity) };
+    }
+
+    static Aabb fromSphere(const glm::vec3& center, const float radius) {
+        return { center - glm::vec3(radius), center + glm::vec3(radius) };
+    }
+
+    static Aabb merge(const Aabb& a, const Aabb& b) {
+        return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+    }
+
+    [[nodiscard]] glm::vec3 getCenter() const { return 0.5f * (min + max); }
+    [[nodiscard]] glm::vec3 getExtent() const { return 0.5f * (max - min); }
+
+    // SAH cost weight
+    [[nodiscard]] float getSurfaceArea() const {
+        const glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    [[nodiscard]] Aabb expanded(const float margin) const {
+        return { min - glm::vec3(margin), max + glm::vec3(margin) };
+    }
+
+    [[nodiscard]] bool contains(const Aabb& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    [[nodiscard]] bool overlaps(const Aabb& other) const {
+        return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z &&
+               max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+    }
+};
+
+#endif // AABB_H
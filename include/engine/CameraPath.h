@@ -0,0 +1,35 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+// Closed Catmull-Rom spline through camera keyframes. Sampling is a pure
+// function of t, so scripted fly-throughs are identical on every run.
+class CameraPath {
+public:
+    struct Keyframe {
+        glm::vec3 position;
+        glm::vec3 target;
+    };
+
+    struct Pose {
+        glm::vec3 position;
+        glm::quat orientation; // Same basis as FreeLookCamera: X+ forward, Z+ up
+    };
+
+    explicit CameraPath(std::vector<Keyframe> keyframes);
+
+    // t wraps into [0, 1) and covers the whole loop
+    [[nodiscard]] Pose sample(float t) const;
+
+    // Slow orbit around the origin that keeps the default scene in view
+    static CameraPath orbit(float radius, float height, uint32_t keyframeCount = 8);
+
+private:
+    std::vector<Keyframe> m_keyframes;
+};
+
+#endif // CAMERA_PATH_H
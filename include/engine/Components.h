@@ -0,0 +1,43 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Components the engine's own systems understand. Plain data only, see EntityWorld.
+
+// Local translation, rotation and scale
+struct Transform {
+    glm::vec3 position { 0.0f };
+    glm::quat rotation { 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 scale { 1.0f };
+
+    [[nodiscard]] glm::mat4 getMatrix() const {
+        glm::mat4 matrix = glm::mat4_cast(rotation);
+        matrix[0] *= scale.x;
+        matrix[1] *= scale.y;
+        matrix[2] *= scale.z;
+        matrix[3] = glm::vec4(position, 1.0f);
+        return matrix;
+    }
+};
+
+// Model matrix the renderer draws with
+struct WorldTransform {
+    glm::mat4 matrix { 1.0f };
+};
+
+// World-space bounding sphere, as culled by FrustumCuller and the GPU culler
+struct WorldBounds {
+    glm::vec3 center { 0.0f };
+    float radius = 0.0f;
+};
+
+// Indices into the renderer's mesh and material tables
+struct Renderable {
+    uint32_t mesh = 0;
+    uint32_t material = 0;
+};
+
+#endif // COMPONENTS_H
@@ -0,0 +1,148 @@
+#ifndef DYNAMIC_BVH_H
+#define DYNAMIC_BVH_H
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Aabb.h"
+#include "Frustum.h"
+
+class JobSystem;
+
+// Dynamic AABB tree for scene queries. Edits go to a binary tree of fat
+// boxes: insert() picks the sibling with the cheapest SAH cost increase
+// (branch and bound), remove() splices the leaf out, and both rebalance the
+// path to the root with tree rotations. update() only reinserts an object
+// once it leaves its fat box, so small per-frame motion costs a store.
+// rebuild() replaces the tree with a binned SAH build, in parallel on a job
+// system, for when incremental edits have let its quality drift.
+//
+// Queries run on a 4-wide copy of the tree (one SSE lane per child, bounds in
+// SoA) that commit() collapses from the binary one. commit() only refits the
+// wide bounds to the tight object boxes when the topology has not changed.
+// Queries see the tree as of the last commit(); calling one before the first
+// commit, or after edits without committing, throws.
+class DynamicBvh {
+public:
+    static constexpr uint32_t kInvalid = ~0u;
+
+    struct Options {
+        float margin = 0.1f;    // World units a fat box extends past its object on every side
+    };
+
+    struct RayHit {
+        uint32_t userData;
+        float distance;         // Along the ray, in units of its direction's length
+    };
+
+    // Exact test for objects whose box the ray enters at boxDistance; returns
+    // the hit distance, or nothing on a miss. Without one, raycast() reports
+    // the nearest box.
+    using RayTest = std::function<std::optional<float>(uint32_t userData, float boxDistance)>;
+
+    DynamicBvh();
+    explicit DynamicBvh(const Options& options);
+
+    // Returns a proxy handle that stays valid until remove()
+    uint32_t insert(const Aabb& bounds, uint32_t userData);
+    void remove(uint32_t proxy);
+
+    // Returns true when the object left its fat box and was reinserted
+    bool update(uint32_t proxy, const Aabb& bounds);
+
+    // Rebuilds the binary tree from scratch with binned SAH
+    void rebuild(JobSystem* jobs = nullptr);
+
+    // Publishes pending edits to the query tree
+    void commit();
+
+    void clear();
+
+    [[nodiscard]] uint32_t getProxyCount() const { return m_proxyCount; }
+    [[nodiscard]] uint32_t getUserData(const uint32_t proxy) const { return m_proxies[proxy].userData; }
+    [[nodiscard]] const Aabb& getBounds(const uint32_t proxy) const { return m_proxies[proxy].bounds; }
+
+    // Surface area of every internal node relative to the root's; lower is better
+    [[nodiscard]] float getSahCost() const;
+    [[nodiscard]] uint32_t getHeight() const;
+
+    // Each query replaces out with the userData of the matching objects in
+    // no particular order. The frustum test is the same conservative
+    // per-plane box test as FrustumCuller; a subtree drops each plane it is
+    // entirely inside of, and one inside all six is emitted untested.
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const;
+    void queryAabb(const Aabb& bounds, std::vector<uint32_t>& out) const;
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+
+    // Nearest hit along origin + t * direction for t in [0, maxDistance],
+    // visiting children front to back and skipping any box further than the
+    // best hit so far
+    [[nodiscard]] std::optional<RayHit> raycast(const glm::vec3& origin, const glm::vec3& direction,
+                                                float maxDistance, const RayTest& test = {}) const;
+
+private:
+    struct Node {
+        Aabb bounds;                        // Fat
+        uint32_t parent = kInvalid;
+        uint32_t children[2] = { kInvalid, kInvalid };
+        uint32_t proxy = kInvalid;          // Leaves only
+
+        [[nodiscard]] bool isLeaf() const { return children[0] == kInvalid; }
+    };
+
+    struct Proxy {
+        Aabb bounds;                        // Tight
+        uint32_t node = kInvalid;           // kInvalid once removed
+        uint32_t userData = 0;
+    };
+
+    // Four children side by side; a child with kLeafBit set is a proxy index
+    struct alignas(64) WideNode {
+        float minX[4], minY[4], minZ[4];
+        float maxX[4], maxY[4], maxZ[4];
+        uint32_t children[4];
+        uint32_t count;
+    };
+
+    static constexpr uint32_t kLeafBit = 1u << 31;
+
+    // Insertion search entry: a node and the area its ancestors would grow by
+    struct Candidate {
+        uint32_t node;
+        float inheritedCost;
+    };
+
+    uint32_t allocateNode();
+    void freeNode(uint32_t node);
+
+    uint32_t findBestSibling(const Aabb& bounds);
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    void refitAncestors(uint32_t node);
+    void rotate(uint32_t node);
+
+    void collapse();
+    void refitWide();
+    void requireCommitted() const;
+
+    Options m_options;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_freeNodes;
+    std::vector<Candidate> m_candidates;    // Reused by every insertion
+    uint32_t m_root = kInvalid;
+
+    std::vector<Proxy> m_proxies;
+    std::vector<uint32_t> m_freeProxies;
+    uint32_t m_proxyCount = 0;
+
+    // Query tree; parents come before their children, so refitting walks it backwards
+    std::vector<WideNode> m_wideNodes;
+    bool m_topologyDirty = true;
+    bool m_boundsDirty = true;
+};
+
+#endif // DYNAMIC_BVH_H
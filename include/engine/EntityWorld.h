@@ -0,0 +1,238 @@
+#ifndef ENTITY_WORLD_H
+#define ENTITY_WORLD_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "JobSystem.h"
+
+// Generational handle; stale handles (to destroyed entities) fail isAlive()
+struct Entity {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity&) const = default;
+};
+
+// Archetype entity/component storage. Every distinct set of component types
+// is an archetype whose entities live in 16 KiB chunks, one tightly packed
+// array per component (SoA) plus one of entity handles. Chunks stay dense:
+// destroying or moving an entity fills its row with the archetype's last one,
+// so iteration is a linear walk over full chunks.
+//
+// Components must be trivially copyable and destructible plain data; rows
+// move between archetypes with memcpy. At most kMaxComponents types exist
+// per process.
+//
+// Structural changes (create, destroy, add, remove) invalidate pointers into
+// chunks and must not happen while iterating. Queries take the component
+// types to visit; const-qualify a type to only read it.
+class EntityWorld {
+public:
+    static constexpr uint32_t kChunkSize = 16 * 1024;
+    static constexpr uint32_t kMaxComponents = 64;
+    static constexpr uint32_t kInvalid = ~0u;
+
+    using ComponentMask = uint64_t;
+
+    template<typename T>
+    [[nodiscard]] static uint32_t getComponentId() {
+        // const T shares T's id
+        if constexpr (!std::is_same_v<T, std::remove_cv_t<T>>) {
+            return getComponentId<std::remove_cv_t<T>>();
+        } else {
+            static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                          "Components are moved with memcpy and never destroyed");
+            static const uint32_t id = registerComponent(sizeof(T), alignof(T));
+            return id;
+        }
+    }
+
+    template<typename... Ts>
+    [[nodiscard]] static ComponentMask getMask() {
+        return (ComponentMask(0) | ... | (ComponentMask(1) << getComponentId<Ts>()));
+    }
+
+    EntityWorld();
+    ~EntityWorld();
+
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    template<typename... Ts>
+    Entity create(const Ts&... components) {
+        const Entity entity = createEntity(getMask<Ts...>());
+        (write(entity, components), ...);
+        return entity;
+    }
+
+    void destroy(Entity entity);
+    void clear();
+
+    [[nodiscard]] bool isAlive(Entity entity) const;
+
+    // Overwrites the component if the entity already has one
+    template<typename T>
+    void add(const Entity entity, const T& component) {
+        const ComponentMask mask = getEntityMask(entity);
+        const ComponentMask bit = ComponentMask(1) << getComponentId<T>();
+        if (!(mask & bit)) moveEntity(entity, mask | bit);
+        write(entity, component);
+    }
+
+    template<typename T>
+    void remove(const Entity entity) {
+        const ComponentMask mask = getEntityMask(entity);
+        const ComponentMask bit = ComponentMask(1) << getComponentId<T>();
+        if (mask & bit) moveEntity(entity, mask & ~bit);
+    }
+
+    template<typename T>
+    [[nodiscard]] bool has(const Entity entity) const {
+        return (getEntityMask(entity) & (ComponentMask(1) << getComponentId<T>())) != 0;
+    }
+
+    // Null when the entity lacks the component
+    template<typename T>
+    [[nodiscard]] T* tryGet(const Entity entity) {
+        return static_cast<T*>(getComponent(entity, getComponentId<T>()));
+    }
+
+    template<typename T>
+    [[nodiscard]] T& get(const Entity entity) {
+        return *static_cast<T*>(requireComponent(entity, getComponentId<T>()));
+    }
+
+    [[nodiscard]] uint32_t getEntityCount() const { return m_entityCount; }
+    [[nodiscard]] uint32_t getArchetypeCount() const { return static_cast<uint32_t>(m_archetypes.size()); }
+    [[nodiscard]] uint32_t getChunkCount() const;
+
+    // Bumped by every structural change, so derived data such as draw lists
+    // can tell when it needs gathering again
+    [[nodiscard]] uint64_t getStructureVersion() const { return m_structureVersion; }
+
+    // Calls function(count, entities, Ts*... arrays) once per chunk holding
+    // entities with every type in Ts
+    template<typename... Ts, typename Function>
+    void forEachChunk(Function&& function) {
+        const ComponentMask mask = getMask<Ts...>();
+        for (Archetype& archetype : m_archetypes) {
+            if ((archetype.mask & mask) != mask) continue;
+            for (uint32_t chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+                visitChunk<Ts...>(archetype, chunk, function);
+            }
+        }
+    }
+
+    // Calls function(Ts&... components) for every matching entity
+    template<typename... Ts, typename Function>
+    void each(Function&& function) {
+        forEachChunk<Ts...>([&](const uint32_t count, const Entity*, Ts*... arrays) {
+            for (uint32_t i = 0; i < count; ++i) function(arrays[i]...);
+        });
+    }
+
+    // forEachChunk() with the chunks spread over the job system; function
+    // also receives the worker index last
+    template<typename... Ts, typename Function>
+    void parallelForEachChunk(JobSystem& jobs, Function&& function) {
+        const std::vector<ChunkRef> chunks = collectChunks(getMask<Ts...>());
+        jobs.parallelFor(static_cast<uint32_t>(chunks.size()), 0,
+                         [&](const uint32_t begin, const uint32_t end, const uint32_t worker) {
+            for (uint32_t i = begin; i < end; ++i) {
+                visitChunk<Ts...>(m_archetypes[chunks[i].archetype], chunks[i].chunk,
+                                  [&](const uint32_t count, const Entity* entities, Ts*... arrays) {
+                    function(count, entities, arrays..., worker);
+                });
+            }
+        });
+    }
+
+    template<typename... Ts, typename Function>
+    void parallelEach(JobSystem& jobs, Function&& function) {
+        parallelForEachChunk<Ts...>(jobs, [&](const uint32_t count, const Entity*, Ts*... arrays, uint32_t) {
+            for (uint32_t i = 0; i < count; ++i) function(arrays[i]...);
+        });
+    }
+
+private:
+    struct ChunkDeleter {
+        void operator()(std::byte* chunk) const;
+    };
+    using ChunkPointer = std::unique_ptr<std::byte[], ChunkDeleter>;
+
+    // Chunk layout: capacity entity handles at offset 0, then one
+    // cache-line-aligned array per component at offsets[id]
+    struct Archetype {
+        ComponentMask mask = 0;
+        std::vector<uint32_t> components;       // Ids, ascending
+        uint32_t offsets[kMaxComponents] = {};  // 0 when the component is absent
+        uint32_t capacity = 0;                  // Rows per chunk
+        uint32_t count = 0;                     // Rows in use; every chunk but the last is full
+        std::vector<ChunkPointer> chunks;
+    };
+
+    struct EntityRecord {
+        uint32_t archetype = kInvalid;          // kInvalid while the index is free
+        uint32_t row = 0;
+        uint32_t generation = 0;
+    };
+
+    struct ChunkRef {
+        uint32_t archetype;
+        uint32_t chunk;
+    };
+
+    static uint32_t registerComponent(size_t size, size_t alignment);
+    static size_t getComponentSize(uint32_t id);
+
+    Entity createEntity(ComponentMask mask);
+    void moveEntity(Entity entity, ComponentMask mask);
+    [[nodiscard]] ComponentMask getEntityMask(Entity entity) const;
+    [[nodiscard]] const EntityRecord& getRecord(Entity entity) const;
+    [[nodiscard]] void* getComponent(Entity entity, uint32_t id);
+    [[nodiscard]] void* requireComponent(Entity entity, uint32_t id);
+
+    uint32_t getArchetype(ComponentMask mask);
+    uint32_t allocateRow(uint32_t archetype);
+    // Fills the row with the archetype's last one
+    void freeRow(uint32_t archetype, uint32_t row);
+    [[nodiscard]] std::vector<ChunkRef> collectChunks(ComponentMask mask) const;
+
+    [[nodiscard]] static std::byte* getRowPointer(Archetype& archetype, const uint32_t row, const uint32_t id) {
+        const uint32_t chunk = row / archetype.capacity;
+        const uint32_t slot = row % archetype.capacity;
+        return archetype.chunks[chunk].get() + archetype.offsets[id] + slot * getComponentSize(id);
+    }
+
+    template<typename T>
+    void write(const Entity entity, const T& component) {
+        std::memcpy(getComponent(entity, getComponentId<T>()), &component, sizeof(T));
+    }
+
+    template<typename... Ts, typename Function>
+    static void visitChunk(Archetype& archetype, const uint32_t chunk, Function&& function) {
+        std::byte* data = archetype.chunks[chunk].get();
+        const uint32_t count = std::min(archetype.capacity, archetype.count - chunk * archetype.capacity);
+        function(count, reinterpret_cast<const Entity*>(data),
+                 std::launder(reinterpret_cast<Ts*>(data + archetype.offsets[getComponentId<Ts>()]))...);
+    }
+
+    std::vector<Archetype> m_archetypes;
+    std::unordered_map<ComponentMask, uint32_t> m_archetypeByMask;
+    std::vector<EntityRecord> m_records;
+    std::vector<uint32_t> m_freeRecords;
+    std::vector<ChunkPointer> m_freeChunks;     // Released by shrinking archetypes, reused before allocating
+    uint32_t m_entityCount = 0;
+    uint64_t m_structureVersion = 0;
+};
+
+#endif // ENTITY_WORLD_H
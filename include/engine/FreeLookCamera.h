@@ -17,6 +17,7 @@ public:
     glm::quat getOrientation() const override { return m_orientation; }
 
     void setPosition(const glm::vec3& pos) { m_position = pos; }
+    void setOrientation(const glm::quat& orientation) { m_orientation = orientation; }
 
 private:
     glm::vec3 m_position;
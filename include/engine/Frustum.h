@@ -0,0 +1,28 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <array>
+#include <glm/glm.hpp>
+
+class Camera;
+
+// Six inward-facing planes (xyz = normal, w = distance) extracted from a
+// view-projection matrix. The near plane assumes a -1..1 clip depth range,
+// which is conservative for the 0..1 range, so culling stays safe with either.
+struct Frustum {
+    enum Plane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    std::array<glm::vec4, PlaneCount> planes;
+
+    static Frustum fromMatrix(const glm::mat4& viewProjection);
+    static Frustum fromCamera(const Camera& camera);
+
+    [[nodiscard]] bool intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+};
+
+#endif // FRUSTUM_H
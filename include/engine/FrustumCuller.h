@@ -0,0 +1,86 @@
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+
+class JobSystem;
+
+// World-space bounding spheres, one array per component so a SIMD lane
+// holds one object
+struct BoundingSpheres {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> radius;
+
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(radius.size()); }
+
+    void reserve(size_t count);
+    void clear();
+    void add(const glm::vec3& center, float sphereRadius);
+    void set(uint32_t index, const glm::vec3& center, float sphereRadius);
+};
+
+// World-space AABBs in center/half-extent form, which makes the plane test
+// one dot product and one absolute-value dot product
+struct BoundingBoxes {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(centerX.size()); }
+
+    void reserve(size_t count);
+    void clear();
+    void add(const glm::vec3& min, const glm::vec3& max);
+    void set(uint32_t index, const glm::vec3& min, const glm::vec3& max);
+};
+
+// Batch frustum culling over SoA bounds. Tests 4, 8 or 16 objects per
+// instruction with SSE2, AVX2 or AVX-512 kernels picked at runtime from what
+// the CPU supports, with a scalar fallback, and writes the indices of the
+// survivors to a compact list in ascending order.
+//
+// Spheres use the same test as Frustum::intersectsSphere(). Both shapes are
+// tested against each plane independently, so a few objects just outside the
+// frustum's corners are kept.
+class FrustumCuller {
+public:
+    enum class Isa { Scalar, Sse2, Avx2, Avx512 };
+
+    // Widest kernel the CPU and OS support
+    [[nodiscard]] static Isa detectIsa();
+    [[nodiscard]] static bool isSupported(Isa isa);
+    [[nodiscard]] static const char* getIsaName(Isa isa);
+
+    // Falls back to the widest supported kernel when isa is not available
+    explicit FrustumCuller(Isa isa = detectIsa());
+
+    [[nodiscard]] Isa getIsa() const { return m_isa; }
+
+    // Writes the indices of the objects that intersect the frustum to the
+    // front of storage and returns them. storage only ever grows, so reusing
+    // one vector every frame neither reallocates nor clears it. With a job
+    // system the set is culled in parallel blocks and compacted afterwards.
+    std::span<const uint32_t> cull(const Frustum& frustum, const BoundingSpheres& spheres,
+                                   std::vector<uint32_t>& storage, JobSystem* jobs = nullptr) const;
+    std::span<const uint32_t> cull(const Frustum& frustum, const BoundingBoxes& boxes,
+                                   std::vector<uint32_t>& storage, JobSystem* jobs = nullptr) const;
+
+    // Culls objects [begin, end) into out and returns how many survived.
+    // out needs room for end - begin + kOutputSlack indices, since the
+    // vector kernels store whole registers.
+    static constexpr uint32_t kOutputSlack = 16;
+
+    uint32_t cullRange(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end,
+                       uint32_t* out) const;
+    uint32_t cullRange(const Frustum& frustum, const BoundingBoxes& boxes, uint32_t begin, uint32_t end,
+                       uint32_t* out) const;
+
+private:
+    Isa m_isa;
+};
+
+#endif // FRUSTUM_CULLER_H
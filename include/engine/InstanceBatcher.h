@@ -0,0 +1,76 @@
+#ifndef INSTANCE_BATCHER_H
+#define INSTANCE_BATCHER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "FrustumCuller.h"
+
+class JobSystem;
+struct GpuBatchInstance;
+
+// Builds one frame's instanced batches from spans of model matrices.
+// build() culls the submissions in fixed-size pieces across the job system,
+// bounding each instance by its mesh's radius scaled by the matrix's widest
+// axis, and lays the survivors out as one contiguous range per mesh. write()
+// then fills those ranges, piece by piece, straight into the destination,
+// which is normally mapped GPU memory sized from getVisibleCount().
+//
+// Submissions are not copied: every span must stay valid and unchanged until
+// write() has run or clear() drops it.
+class InstanceBatcher {
+public:
+    struct Batch {
+        uint32_t mesh;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+    };
+
+    // radius bounds the mesh's vertices around its model-space origin; returns the mesh id
+    uint32_t addMesh(float radius);
+    [[nodiscard]] uint32_t getMeshCount() const { return static_cast<uint32_t>(m_radii.size()); }
+
+    void submit(uint32_t mesh, std::span<const glm::mat4> transforms);
+    [[nodiscard]] uint32_t getSubmittedCount() const { return m_submittedCount; }
+
+    // Culls everything submitted since the last clear() and returns how many survived
+    uint32_t build(const Frustum& frustum, JobSystem* jobs = nullptr);
+    // Writes build()'s survivors, with their normal matrices, to out[0, getVisibleCount())
+    void write(GpuBatchInstance* out, JobSystem* jobs = nullptr) const;
+
+    // Batches of the last build(), in mesh order; they outlive clear()
+    [[nodiscard]] std::span<const Batch> getBatches() const { return m_batches; }
+    [[nodiscard]] uint32_t getVisibleCount() const { return m_visibleCount; }
+
+    // Drops the submissions; registered meshes stay
+    void clear();
+
+private:
+    struct Submission {
+        uint32_t mesh;
+        std::span<const glm::mat4> transforms;
+    };
+    // Up to kPieceSize instances of one submission, culled and written by one task
+    struct Piece {
+        uint32_t submission;
+        uint32_t begin;
+        uint32_t end;
+        size_t survivors;           // Offset of the piece's stretch of m_survivors
+        uint32_t visibleCount;
+        uint32_t firstVisible;      // Where its survivors start in the output
+    };
+
+    FrustumCuller m_culler;
+    std::vector<float> m_radii;
+    std::vector<Submission> m_submissions;
+    std::vector<Piece> m_pieces;
+    std::vector<uint32_t> m_survivors;          // Piece-relative indices, with the culler's slack after each stretch
+    std::vector<BoundingSpheres> m_spheres;     // Per worker scratch
+    std::vector<Batch> m_batches;
+    uint32_t m_submittedCount = 0;
+    uint32_t m_visibleCount = 0;
+};
+
+#endif // INSTANCE_BATCHER_H
@@ -0,0 +1,43 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "Vertex.h"
+
+// Indexed triangle list in the renderer's vertex format
+struct Mesh {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    // Primitive restart stays disabled, so every 16-bit value is a valid index
+    [[nodiscard]] VkIndexType getIndexType() const {
+        return vertices.size() <= UINT16_MAX + 1ull ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
+
+    // Index data at getIndexType()'s width, ready to upload
+    [[nodiscard]] std::vector<uint8_t> packIndices() const {
+        if (getIndexType() == VK_INDEX_TYPE_UINT32) {
+            std::vector<uint8_t> packed(indices.size() * sizeof(uint32_t));
+            std::memcpy(packed.data(), indices.data(), packed.size());
+            return packed;
+        }
+
+        std::vector<uint8_t> packed(indices.size() * sizeof(uint16_t));
+        auto* narrow = reinterpret_cast<uint16_t*>(packed.data());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            narrow[i] = static_cast<uint16_t>(indices[i]);
+        }
+        return packed;
+    }
+
+    // Unit cube centered on the origin, 8 shared vertices with corner normals
+    static Mesh cube();
+    // Unit sphere of segments x segments quads over a (segments + 1)^2 vertex grid; poles get triangles only
+    static Mesh uvSphere(uint32_t segments);
+};
+
+#endif // MESH_H
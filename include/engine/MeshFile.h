@@ -0,0 +1,93 @@
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "Vertex.h"
+
+enum class MeshVertexFormat : uint32_t {
+    Float   = 0,  // Vertex
+    Packed  = 1   // PackedVertex
+};
+
+// One level of detail: a range of the shared index stream
+struct MeshFileLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;  // Cluster cell size the level was simplified with, in model units; 0 for the source mesh
+    uint32_t reserved = 0;
+};
+
+// Little-endian on-disk header, followed by the LOD table. The vertex and
+// index streams start on kStreamAlignment boundaries and hold exactly what
+// the GPU buffers hold, so loading is one copy from the mapping into staging.
+struct MeshFileHeader {
+    static constexpr uint32_t kMagic = 0x48534D56;  // "VMSH"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint64_t kStreamAlignment = 4096;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    MeshVertexFormat vertexFormat = MeshVertexFormat::Float;
+    uint32_t vertexStride = 0;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    uint32_t lodCount = 0;
+
+    uint64_t vertexCount = 0;
+    uint64_t vertexOffset = 0;
+    uint64_t vertexBytes = 0;
+    uint64_t indexCount = 0;    // All levels
+    uint64_t indexOffset = 0;
+    uint64_t indexBytes = 0;
+
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    float radius = 0.0f;        // Bounding sphere around the model-space origin
+
+    // Dequantization of packed positions; identity for float vertices
+    glm::vec3 quantizationOffset = glm::vec3(0.0f);
+    glm::vec3 quantizationScale = glm::vec3(1.0f);
+    uint32_t reserved = 0;
+};
+
+static_assert(sizeof(MeshFileHeader) == 128, "MeshFileHeader is an on-disk format");
+static_assert(sizeof(MeshFileLod) == 16, "MeshFileLod is an on-disk format");
+
+// Read-only memory mapping of a mesh file. Nothing is parsed or copied on
+// open; the spans point into the mapping and stay valid while the MeshFile lives.
+class MeshFile {
+public:
+    explicit MeshFile(const std::string& path);
+
+    // lods index mesh.indices; an empty list writes the whole mesh as a single level
+    static void write(const std::string& path, const Mesh& mesh, MeshVertexFormat format,
+                      const std::vector<MeshFileLod>& lods = {});
+
+    [[nodiscard]] const MeshFileHeader& getHeader() const { return *m_header; }
+    [[nodiscard]] std::span<const MeshFileLod> getLods() const { return m_lods; }
+    [[nodiscard]] std::span<const std::byte> getVertexData() const { return m_vertexData; }
+    [[nodiscard]] std::span<const std::byte> getIndexData() const { return m_indexData; }
+    [[nodiscard]] size_t getFileSize() const { return m_file.getSize(); }
+
+    [[nodiscard]] VertexQuantization getQuantization() const {
+        return { .offset = m_header->quantizationOffset, .scale = m_header->quantizationScale };
+    }
+
+private:
+    MappedFile m_file;
+
+    const MeshFileHeader* m_header = nullptr;
+    std::span<const MeshFileLod> m_lods;
+    std::span<const std::byte> m_vertexData;
+    std::span<const std::byte> m_indexData;
+};
+
+#endif // MESH_FILE_H
@@ -0,0 +1,99 @@
+#ifndef MESH_IMPORTER_H
+#define MESH_IMPORTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+
+class JobSystem;
+
+struct ImportedMesh {
+    uint32_t index = 0;     // Position in the source file, so out-of-order delivery can be sorted back
+    std::string name;
+    Mesh mesh;
+};
+
+// Parallel scene geometry import.
+//
+// OBJ text is split into chunks at line boundaries and parsed on every
+// worker; chunks are stitched back together in file order as they finish,
+// and each object (o/g) is handed on as soon as its last face has been seen,
+// so early objects are delivered while the rest of the file is still parsing.
+// Renderer::importScene() runs an import on a background thread and uploads
+// each delivered mesh on the next frame, so those objects are drawn before the
+// file is finished.
+//
+// glTF (.gltf with external or data-URI buffers, and .glb) decodes each
+// triangle primitive as an independent task, and splits large accessors into
+// ranges decoded across workers. Node transforms are not applied; meshes come
+// out in their own model space.
+//
+// Output is always the full-precision Vertex layout; packVertices() converts
+// it for upload when a compressed layout is wanted.
+class MeshImporter {
+public:
+    struct Options {
+        bool optimize = true;                       // Run MeshOptimizer::optimize() on every mesh before delivery
+        size_t objChunkBytes = 4u << 20;            // OBJ text per parse task
+        uint32_t gltfElementsPerTask = 1u << 16;    // glTF accessor elements per decode task
+    };
+
+    // Called once per mesh, from whichever worker finished it; calls can overlap
+    using MeshCallback = std::function<void(ImportedMesh&& mesh)>;
+
+    explicit MeshImporter(JobSystem& jobs);
+    MeshImporter(JobSystem& jobs, const Options& options);
+
+    // The format is picked from the extension: .obj, .gltf or .glb. Returns
+    // once every mesh has been delivered; parse errors are rethrown here.
+    void import(const std::string& path, const MeshCallback& onMesh);
+
+    // Collects every mesh, in file order
+    std::vector<ImportedMesh> import(const std::string& path);
+
+private:
+    // Keeps the first exception a task throws, since jobs must not throw;
+    // the remaining tasks skip their work once one has failed
+    class TaskErrors {
+    public:
+        template<typename Function>
+        void run(const Function& function) {
+            if (failed()) return;
+            try {
+                function();
+            } catch (...) {
+                std::lock_guard lock(m_mutex);
+                if (!m_error) m_error = std::current_exception();
+                m_failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] bool failed() const { return m_failed.load(std::memory_order_relaxed); }
+
+        void rethrow() const {
+            if (m_error) std::rethrow_exception(m_error);
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::exception_ptr m_error;
+        std::atomic<bool> m_failed = false;
+    };
+
+    JobSystem& m_jobs;
+    Options m_options;
+
+    void importObj(const std::string& path, const MeshCallback& onMesh);
+    void importGltf(const std::string& path, const MeshCallback& onMesh);
+
+    // Optimizes (when enabled) and delivers one finished mesh
+    void finish(ImportedMesh&& mesh, const MeshCallback& onMesh) const;
+};
+
+#endif // MESH_IMPORTER_H
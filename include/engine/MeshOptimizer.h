@@ -0,0 +1,48 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+// At-load mesh preparation. optimize() runs the passes in the order that
+// keeps each one's gains: vertex cache order first, then overdraw (which
+// moves whole cache-friendly clusters), then vertex fetch (which only renames
+// vertices, leaving the triangle order alone).
+class MeshOptimizer {
+public:
+    // Post-transform cache efficiency of a triangle order
+    struct CacheStats {
+        float acmr = 0.0f;  // Vertex shader invocations per triangle; 0.5 is the ideal for large grids
+        float atvr = 0.0f;  // Invocations per referenced vertex; 1.0 is ideal
+    };
+
+    // Merges bitwise-identical vertices of a non-indexed triangle list
+    static Mesh buildIndexed(const std::vector<Vertex>& vertices);
+
+    // Forsyth's linear-speed reordering for an LRU post-transform cache
+    static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+    // Splits the cache-ordered list into clusters and draws the outward-facing
+    // ones first. threshold bounds the ACMR each split may cost (1.05 = 5%).
+    static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                                 float threshold = 1.05f);
+
+    // Renumbers vertices in order of first use and drops unreferenced ones
+    static void optimizeVertexFetch(Mesh& mesh);
+
+    static void optimize(Mesh& mesh);
+
+    // Vertex-clustering LOD: snaps vertices to a grid of cellSize and keeps the
+    // surviving triangles, indexing the existing vertices so levels can share
+    // one vertex buffer. The result is cache-optimized.
+    static std::vector<uint32_t> simplifyClustered(const std::vector<uint32_t>& indices,
+                                                   const std::vector<Vertex>& vertices, float cellSize);
+
+    // FIFO cache simulation; 16 entries approximates current desktop GPUs
+    static CacheStats analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                         uint32_t cacheSize = 16);
+};
+
+#endif // MESH_OPTIMIZER_H
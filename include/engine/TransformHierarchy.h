@@ -0,0 +1,103 @@
+#ifndef TRANSFORM_HIERARCHY_H
+#define TRANSFORM_HIERARCHY_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Components.h"
+
+class JobSystem;
+
+// Parent/child transforms stored breadth first: every depth level is one
+// contiguous range of slots, parents before children and siblings side by
+// side, with local TRS, world matrix, parent slot and dirty flag each in its
+// own array. update() walks the levels top down; a node is recomputed when
+// it or any ancestor was touched since the last update, so a still subtree
+// costs one flag test per node and a still level costs nothing. Each level is
+// split across the job system, since nothing within a level depends on
+// anything else in it. World matrices are composed with an SSE kernel that
+// multiplies the parent's columns by the child's TRS directly.
+//
+// Node handles stay valid until remove(). Structural changes (add, remove,
+// setParent) only re-sort the arrays at the next update(); until then world
+// matrices are as of the last update, and identity for new nodes.
+class TransformHierarchy {
+public:
+    static constexpr uint32_t kInvalid = ~0u;
+
+    struct Options {
+        bool simd = true;       // false composes with glm::mat4 products, for comparison
+    };
+
+    // Where update() also writes world matrices, typically this frame's
+    // allocation in a mapped GPU buffer: a node added with output index i
+    // lands at data + i * stride. Every such node is written, changed or not,
+    // since a ring allocation starts out with some older frame's contents.
+    struct Output {
+        void* data = nullptr;
+        uint32_t stride = sizeof(glm::mat4);
+    };
+
+    TransformHierarchy();
+    explicit TransformHierarchy(const Options& options);
+
+    // parent must be alive; outputIndex is the node's record in update()'s output
+    uint32_t add(const Transform& local, uint32_t parent = kInvalid, uint32_t outputIndex = kInvalid);
+
+    // Removes the node along with all of its descendants
+    void remove(uint32_t node);
+
+    // kInvalid makes the node a root. Throws if parent is node or one of its descendants.
+    void setParent(uint32_t node, uint32_t parent);
+
+    void setLocal(uint32_t node, const Transform& local);
+    void clear();
+
+    [[nodiscard]] bool isAlive(uint32_t node) const;
+    [[nodiscard]] uint32_t getParent(const uint32_t node) const { return m_nodes[node].parent; }
+    [[nodiscard]] const Transform& getLocal(const uint32_t node) const { return m_local[m_nodes[node].slot]; }
+    [[nodiscard]] const glm::mat4& getWorld(const uint32_t node) const { return m_world[m_nodes[node].slot]; }
+
+    [[nodiscard]] uint32_t getNodeCount() const { return m_nodeCount; }
+    [[nodiscard]] uint32_t getLevelCount() const { return static_cast<uint32_t>(m_levelDirty.size()); }
+    // Nodes whose world matrix the last update() recomputed
+    [[nodiscard]] uint32_t getUpdatedCount() const { return m_updatedCount; }
+
+    void update(JobSystem* jobs = nullptr);
+    void update(JobSystem* jobs, const Output& output);
+
+private:
+    struct Node {
+        uint32_t parent = kInvalid;
+        uint32_t slot = kInvalid;           // kInvalid while the handle is free
+        uint32_t level = 0;                 // Valid while the order is
+        bool removed = false;               // Freed, with its descendants, by the next sort
+    };
+
+    // Rebuilds the breadth-first order and frees removed subtrees
+    void sort();
+    // Composes slots [begin, end) of one level; returns how many were recomputed
+    uint32_t updateRange(uint32_t begin, uint32_t end, const Output& output);
+
+    Options m_options;
+
+    std::vector<Node> m_nodes;              // By handle
+    std::vector<uint32_t> m_freeNodes;
+    uint32_t m_nodeCount = 0;
+
+    // By slot
+    std::vector<Transform> m_local;
+    std::vector<glm::mat4> m_world;
+    std::vector<uint32_t> m_parentSlot;
+    std::vector<uint32_t> m_outputIndex;
+    std::vector<uint32_t> m_handle;
+    std::vector<uint8_t> m_dirty;
+
+    std::vector<uint32_t> m_levelStart;     // One past the last level too
+    std::vector<uint8_t> m_levelDirty;      // Some slot in the level was touched directly
+    bool m_orderDirty = false;
+    uint32_t m_updatedCount = 0;
+};
+
+#endif // TRANSFORM_HIERARCHY_H
@@ -0,0 +1,52 @@
+#ifndef GPU_SCENE_H
+#define GPU_SCENE_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// std430 layouts shared with assets/shaders/scene.glsl
+
+struct GpuInstance {
+    glm::mat4 model;
+    glm::vec4 normalMatrix[3];  // setNormalMatrix(model), one column each; w unused
+    glm::vec4 boundingSphere;   // World-space center and radius
+    uint32_t mesh;              // Index into the GpuMesh array
+    uint32_t padding[3];
+};
+static_assert(sizeof(GpuInstance) == 144);
+
+// Where a mesh's indices live in the shared index and vertex buffers, and how
+// its stored positions map back to model space: offset + scale * position
+struct GpuMesh {
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t padding;
+    glm::vec4 positionScale;    // w unused
+    glm::vec4 positionOffset;
+};
+static_assert(sizeof(GpuMesh) == 48);
+
+// One instance of a Renderer::submitInstances() batch; the mesh is per draw
+struct GpuBatchInstance {
+    glm::mat4 model;
+    glm::vec4 normalMatrix[3];  // setNormalMatrix(model)
+};
+static_assert(sizeof(GpuBatchInstance) == 112);
+
+// Cofactor matrix of the model's upper 3x3: its inverse transpose scaled by
+// the determinant, flipped back to a positive scale. Shaders normalize the
+// transformed normal, so this stands in for the inverse without a division
+// and stays finite for degenerate scales.
+inline void setNormalMatrix(glm::vec4 (&normalMatrix)[3], const glm::mat4& model) {
+    const glm::vec3 x(model[0]);
+    const glm::vec3 y(model[1]);
+    const glm::vec3 z(model[2]);
+    const glm::vec3 yz = glm::cross(y, z);
+    const float sign = glm::dot(x, yz) < 0.0f ? -1.0f : 1.0f;
+    normalMatrix[0] = glm::vec4(yz * sign, 0.0f);
+    normalMatrix[1] = glm::vec4(glm::cross(z, x) * sign, 0.0f);
+    normalMatrix[2] = glm::vec4(glm::cross(x, y) * sign, 0.0f);
+}
+
+#endif // GPU_SCENE_H
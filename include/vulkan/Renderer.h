@@ -2,64 +2,310 @@
 #define RENDERER_H
 
 #include <FreeLookCamera.h>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "CameraUBO.h"
+#include "EntityWorld.h"
+#include "Frustum.h"
+#include "FrustumCuller.h"
+#include "GpuScene.h"
+#include "InstanceBatcher.h"
+#include "Mesh.h"
+#include "MeshImporter.h"
+#include "TransformHierarchy.h"
+#include "VulkanBindlessTable.h"
 #include "VulkanConfig.h"
 #include "VulkanContext.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanRenderGraph.h"
 
 class VulkanInstance;
 class VulkanDebugMessenger;
 class WindowManager;
 class VulkanDevice;
 class VulkanSwapchain;
+class VulkanOffscreenTarget;
 class VulkanRenderPass;
 class VulkanFramebuffer;
 class VulkanCommandManager;
-class VulkanSyncObjects;
+class VulkanFrameScheduler;
 class VulkanBuffer;
+class VulkanUniformRing;
+class VulkanUploadManager;
 class VulkanPipeline;
+struct VulkanShaderStages;
+class VulkanIndirectCuller;
+class VulkanGpuProfiler;
+class JobSystem;
+
+// Draws indices [firstIndex, firstIndex + indexCount) of the scene geometry, offset by vertexOffset
+struct DrawCommand {
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+};
 
 class Renderer {
 public:
-    explicit Renderer(WindowManager& windowManager);
+    static constexpr uint32_t kInvalidMesh = ~0u;
+
+    // windowManager is null in headless mode, where frames go to an offscreen image ring
+    Renderer(WindowManager* windowManager, const VulkanConfig& config);
     ~Renderer();
 
     void draw();
     void onResize();
     void waitIdle() const;
 
+    // Called with the updated context when a recreated swapchain changes format,
+    // for code that built its own pipelines against the old one
+    void setFormatChangedCallback(std::function<void(const VulkanContext&)> callback) {
+        m_formatChangedCallback = std::move(callback);
+    }
+
     VulkanContext& getContext();
     VulkanConfig& getConfig();
+    FreeLookCamera& getCamera() { return m_camera; }
+
+    [[nodiscard]] const std::vector<DrawCommand>& getDrawList() const { return m_drawList; }
+    void setDrawList(std::vector<DrawCommand> drawList) { m_drawList = std::move(drawList); }
+
+    // Waits for the GPU, then rebuilds the job system and its command pools
+    void setRecordThreadCount(uint32_t threadCount);
+    [[nodiscard]] uint32_t getRecordThreadCount() const;
+
+    // Shared with the other CPU systems; replaced by setRecordThreadCount()
+    [[nodiscard]] JobSystem& getJobSystem() { return *m_jobSystem; }
+
+    // Scene entities; the stress scene's instances are gathered from its renderables
+    [[nodiscard]] EntityWorld& getWorld() { return m_world; }
+
+    // Wall time from the last resize event to the first frame presented at the new size
+    [[nodiscard]] double getLastResizeMs() const { return m_lastResizeMs; }
+
+    // CPU time spent recording the last frame's command buffers
+    [[nodiscard]] double getLastRecordMs() const { return m_lastRecordMs; }
+
+    // Frames submitted so far; the next draw() submits frame getFrameNumber() + 1
+    [[nodiscard]] uint64_t getFrameNumber() const;
+
+    // Frames the CPU may run ahead of the GPU, clamped to VulkanConfig::frameSlotCount
+    void setMaxFramesInFlight(uint32_t count);
+    [[nodiscard]] uint32_t getMaxFramesInFlight() const;
+
+    // Per-scope GPU timings; results are tagged with getFrameNumber() values
+    [[nodiscard]] const VulkanGpuProfiler& getGpuProfiler() const { return *m_gpuProfiler; }
     [[nodiscard]] uint32_t getGraphicsQueueIndex() const;
 
+    [[nodiscard]] const VulkanRenderGraph::Stats& getRenderGraphStats() const { return m_renderGraph->getStats(); }
+
+    // Register textures and buffers here for shaders to index; release through retireBindless()
+    [[nodiscard]] VulkanBindlessTable& getBindlessTable() { return *m_bindlessTable; }
+    // Frees the index once every frame submitted so far has retired
+    void retireBindless(VulkanBindlessTable::Kind kind, uint32_t index);
+    // For objects owned outside the renderer; tag them with getFrameNumber()
+    [[nodiscard]] VulkanDeletionQueue& getDeletionQueue() { return m_deletionQueue; }
+
+    // Stress scene culling: compute + indirect count when supported, otherwise one CPU test and draw per instance
+    void setGpuCulling(bool enabled);
+    [[nodiscard]] bool isGpuCulling() const { return m_indirectCuller != nullptr; }
+    [[nodiscard]] uint32_t getInstanceCount() const { return static_cast<uint32_t>(m_instances.size()); }
+    // Instances drawn last frame by the CPU path; the GPU path keeps its count on the device
+    [[nodiscard]] uint32_t getLastVisibleCount() const { return m_lastVisibleCount; }
+    // Vertex buffer size of the stress scene's mesh in the configured layout
+    [[nodiscard]] VkDeviceSize getSceneVertexBytes() const { return m_sceneVertexBytes; }
+    [[nodiscard]] bool hasPackedVertices() const { return m_config.packedVertices; }
+
+    // Instanced batches. A registered mesh is uploaded once and drawn with one
+    // vkCmdDrawIndexed per frame covering every submitted instance of it that
+    // survives frustum culling; the survivors are written straight into this
+    // frame's region of a mapped ring and read by instance index. Submitted
+    // spans are not copied, so they must stay valid and unchanged until the
+    // next draw(), which consumes them or drops them if it skips its frame.
+    uint32_t registerMesh(const Mesh& mesh);
+    void submitInstances(uint32_t mesh, std::span<const glm::mat4> transforms);
+    // Imports an OBJ or glTF scene on a background thread. Each mesh is
+    // registered, and so starts uploading, on the first draw() after it has
+    // been parsed, then drawn at the origin every frame; import errors are
+    // rethrown from that draw().
+    void importScene(const std::string& path);
+    // Draws and visible instances of the last frame's batches
+    [[nodiscard]] uint32_t getBatchCount() const { return static_cast<uint32_t>(m_batcher.getBatches().size()); }
+    [[nodiscard]] uint32_t getBatchedInstanceCount() const { return m_batcher.getVisibleCount(); }
+
 private:
-    void recreateSwapchain();
+    // Returns false while the window is minimized; the resize then stays pending
+    bool recreateSwapchain();
+    // Render pass and pipelines if the format changed; old ones are retired. Framebuffers come with the graph.
+    void recreateSwapchainDependents(bool formatChanged);
+    [[nodiscard]] bool isHeadless() const { return m_windowManager == nullptr; }
+    [[nodiscard]] VkExtent2D getTargetExtent() const;
+    // Declares the frame's passes; only needed again when the targets change
+    void buildRenderGraph();
+    // Records the whole frame; returns the upload timeline value the submit must wait on
+    uint64_t recordCommandBuffer(VkCommandBuffer cmd, uint64_t frame, uint32_t imageIndex, uint32_t cameraOffset);
+    // Body of the graph's main pass: scene draws (inline or across workers) and ImGui
+    void recordMainPass(VkCommandBuffer cmd);
+    // Binds all state and records draws [first, last); safe to call from several workers at once
+    void recordDraws(VkCommandBuffer cmd, uint32_t first, uint32_t last, uint32_t cameraOffset, VkExtent2D extent) const;
+    // Stress scene draws; records on the calling thread only, since the CPU path updates m_lastVisibleCount
+    void recordInstances(VkCommandBuffer cmd, uint32_t cameraOffset, VkExtent2D extent);
+    // One instanced draw per batch built by uploadBatches()
+    void recordBatches(VkCommandBuffer cmd, uint32_t cameraOffset, VkExtent2D extent) const;
+    void bindPipeline(VkCommandBuffer cmd, const VulkanPipeline& pipeline, uint32_t cameraOffset,
+                      VkExtent2D extent, const BindlessPushConstants& pushConstants) const;
+    // Every graphics pipeline; the instanced ones only when a stress scene or batches exist
+    void createPipelines(VkFormat colorFormat);
+    [[nodiscard]] std::unique_ptr<VulkanPipeline> createPipeline(VkFormat colorFormat,
+                                                                 const VulkanShaderStages& shaders) const;
+    // count instances on a grid, sharing one indexed mesh
+    void createStressScene(uint32_t count);
+    // Rebuilds m_instances and m_instanceBounds with one pass over the world's renderable chunks
+    void gatherInstances();
+    // The same grid as registered-mesh instances, drawn through submitInstances()
+    void createBatchedStressScene(uint32_t count);
+    // Spins the animated stress scene and writes this frame's instance records into the uniform ring
+    void animateStressScene(uint32_t slot, float deltaTime);
+    // Submits every renderable's world matrix, in runs of equal mesh
+    void submitWorld();
+    // Registers the meshes the scene import has finished since the last frame
+    void registerImportedMeshes();
+    // Culls this frame's submissions and writes the survivors into the batch ring
+    void uploadBatches(uint32_t slot);
+    // Device-local buffer filled through the upload manager; pendingUploads drops back once it lands
+    std::unique_ptr<VulkanBuffer> uploadStatic(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+                                               uint32_t& pendingUploads);
+    // Only collects edits into m_debugUiChanges, since it runs while the frame is recorded
+    void drawDebugUi();
+    // Applies them at the start of the next draw(), before anything is recorded
+    void applyDebugUiChanges();
+
+    // Debug UI edits waiting for the next frame
+    struct DebugUiChanges {
+        std::optional<bool> gpuCulling;
+        std::optional<uint32_t> maxFramesInFlight;
+    };
 
-    WindowManager& m_windowManager;
+    WindowManager* m_windowManager;
     VulkanContext m_context;
+    std::function<void(const VulkanContext&)> m_formatChangedCallback;
     VulkanConfig m_config;
 
     FreeLookCamera m_camera;
 
     VkDescriptorSet m_descriptorSet;
     VkDescriptorPool m_descriptorPool;
-    std::unique_ptr<VulkanBuffer> m_cameraBuffer;
+    std::unique_ptr<VulkanUniformRing> m_uniformRing;
     CameraUBO m_cameraUBO;
 
+    std::unique_ptr<VulkanBindlessTable> m_bindlessTable;
+    VkSampler m_defaultSampler = VK_NULL_HANDLE;
+    uint32_t m_defaultSamplerIndex = UINT32_MAX;
+
     std::unique_ptr<VulkanInstance> m_instance;
     std::unique_ptr<VulkanDebugMessenger> m_debugMessenger;
     std::unique_ptr<VulkanDevice> m_device;
     std::unique_ptr<VulkanSwapchain> m_swapchain;
+    std::unique_ptr<VulkanOffscreenTarget> m_offscreenTarget;
     std::unique_ptr<VulkanRenderPass> m_renderPass;
     std::unique_ptr<VulkanFramebuffer> m_framebuffer;
+    std::unique_ptr<VulkanRenderGraph> m_renderGraph;
+    VulkanRenderGraph::ImageHandle m_backbuffer;
+    VulkanRenderGraph::ImageHandle m_depth;
+    VkFormat m_depthFormat = VK_FORMAT_UNDEFINED;
     std::unique_ptr<VulkanCommandManager> m_commandManager;
-    std::unique_ptr<VulkanSyncObjects> m_syncObjects;
+    std::unique_ptr<JobSystem> m_jobSystem;
+    std::vector<DrawCommand> m_drawList;
+    double m_lastRecordMs = 0.0;
+    std::unique_ptr<VulkanFrameScheduler> m_frameScheduler;
     std::unique_ptr<VulkanPipeline> m_pipeline;
+    std::unique_ptr<VulkanUploadManager> m_uploadManager;
     std::unique_ptr<VulkanBuffer> m_vertexBuffer;
+    std::unique_ptr<VulkanBuffer> m_indexBuffer;
+    VkIndexType m_indexType = VK_INDEX_TYPE_UINT32;
+    uint32_t m_pendingGeometryUploads = 0;
+
+    // Stress scene: instances and meshes are mirrored on the CPU for the culling baseline
+    EntityWorld m_world;
+    std::vector<GpuInstance> m_instances;
+    std::vector<GpuMesh> m_meshes;
+    std::unique_ptr<VulkanBuffer> m_sceneVertexBuffer;
+    std::unique_ptr<VulkanBuffer> m_sceneIndexBuffer;
+    VkIndexType m_sceneIndexType = VK_INDEX_TYPE_UINT32;
+    VkDeviceSize m_sceneVertexBytes = 0;
+    std::unique_ptr<VulkanBuffer> m_instanceBuffer;
+    std::unique_ptr<VulkanBuffer> m_meshBuffer;
+    uint32_t m_instanceBufferIndex = VulkanBindlessTable::kInvalidIndex;
+    uint32_t m_meshBufferIndex = VulkanBindlessTable::kInvalidIndex;
+    uint32_t m_drawInstanceBufferIndex = VulkanBindlessTable::kInvalidIndex; // What this frame culls and draws
+    uint32_t m_pendingSceneUploads = 0;
+    uint32_t m_lastVisibleCount = 0;
+    DebugUiChanges m_debugUiChanges;
+    Frustum m_frustum{};
+    BoundingSpheres m_instanceBounds;               // SoA copy of the instance spheres for the CPU path
+    FrustumCuller m_frustumCuller;
+    std::vector<uint32_t> m_visibleInstances;
+    std::unique_ptr<VulkanPipeline> m_instancedPipeline;
+    std::unique_ptr<VulkanIndirectCuller> m_indirectCuller;
+    VulkanRenderGraph::BufferHandle m_cullDraws;
+    VulkanRenderGraph::BufferHandle m_cullCount;
+
+    // Animated stress scene: slab pivot -> row pivot -> instance. Instance
+    // records are rewritten into the uniform ring every frame and bound
+    // through one bindless index per frame slot.
+    TransformHierarchy m_transforms;
+    std::vector<uint32_t> m_slabNodes;
+    std::vector<uint32_t> m_instanceNodes;
+    std::vector<uint32_t> m_frameInstanceIndices;
+    float m_animationTime = 0.0f;
+
+    // Instanced batches, in registration order; a deque so pending upload counters stay put
+    struct BatchMesh {
+        std::unique_ptr<VulkanBuffer> vertexBuffer;
+        std::unique_ptr<VulkanBuffer> indexBuffer;
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+        uint32_t indexCount = 0;
+        uint32_t pendingUploads = 0;
+    };
+    std::deque<BatchMesh> m_batchMeshes;
+    InstanceBatcher m_batcher;
+    std::unique_ptr<VulkanUniformRing> m_batchRing; // Created and grown on demand by uploadBatches()
+    std::vector<uint32_t> m_batchBufferIndices;     // One per frame slot, repointed at that frame's instances
+    std::unique_ptr<VulkanPipeline> m_batchPipeline;
+    uint32_t m_lastSubmittedBatchInstances = 0;
+
+    // Background scene import; finished meshes wait under the mutex until draw() registers them
+    std::thread m_importThread;
+    std::mutex m_importMutex;
+    std::vector<ImportedMesh> m_importedMeshes;
+    std::exception_ptr m_importError;
+    std::vector<uint32_t> m_sceneMeshes;        // Registered imported meshes
+    glm::mat4 m_sceneTransform { 1.0f };
+
+    std::chrono::steady_clock::time_point m_lastFrameTime = std::chrono::steady_clock::now();
+    std::unique_ptr<VulkanGpuProfiler> m_gpuProfiler;
+    VulkanDeletionQueue m_deletionQueue; // Objects replaced while frames were still in flight
+
+    // What the graph's pass callbacks need from the frame being recorded
+    struct FrameContext {
+        uint32_t frameIndex = 0;
+        uint32_t imageIndex = 0;
+        uint32_t cameraOffset = 0;
+    } m_frameContext;
 
-    size_t m_currentFrame = 0;
     bool m_framebufferResized = false;
+    std::optional<std::chrono::steady_clock::time_point> m_resizeStart;
+    double m_lastResizeMs = 0.0;
 };
 
 #endif // RENDERER_H
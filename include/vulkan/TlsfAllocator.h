@@ -0,0 +1,88 @@
+#ifndef TLSF_ALLOCATOR_H
+#define TLSF_ALLOCATOR_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Two-level segregated fit allocator over an abstract address range.
+// It never touches memory itself; it only hands out offsets, so the same
+// code manages VkDeviceMemory blocks and can be benchmarked on the CPU.
+class TlsfAllocator {
+public:
+    static constexpr uint32_t kInvalidNode = UINT32_MAX;
+
+    struct Allocation {
+        uint64_t offset = 0;  // Aligned offset handed to the caller
+        uint64_t size = 0;    // Size requested by the caller
+        uint32_t node = kInvalidNode;
+    };
+
+    struct Stats {
+        uint64_t totalSize = 0;
+        uint64_t usedBytes = 0;     // Bytes owned by live allocations, padding included
+        uint64_t wastedBytes = 0;   // Alignment padding and unsplittable tails
+        uint64_t largestFreeBlock = 0;
+        uint32_t allocationCount = 0;
+        uint32_t freeBlockCount = 0;
+
+        // 0 when all free space is one contiguous block, approaching 1 as it scatters
+        [[nodiscard]] float fragmentation() const {
+            const uint64_t freeBytes = totalSize - usedBytes;
+            if (freeBytes == 0) return 0.0f;
+            return 1.0f - static_cast<float>(largestFreeBlock) / static_cast<float>(freeBytes);
+        }
+    };
+
+    explicit TlsfAllocator(uint64_t size);
+
+    [[nodiscard]] std::optional<Allocation> allocate(uint64_t size, uint64_t alignment);
+    void free(uint32_t node);
+
+    [[nodiscard]] bool empty() const { return m_allocationCount == 0; }
+    [[nodiscard]] uint64_t getSize() const { return m_size; }
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    static constexpr uint32_t kSecondLevelLog2 = 5;
+    static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelLog2;
+    static constexpr uint32_t kFirstLevelCount = 64 - kSecondLevelLog2 + 1;
+    static constexpr uint64_t kMinSplitSize = 64;
+
+    struct Block {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint64_t requested = 0;
+        uint32_t prevPhysical = kInvalidNode;
+        uint32_t nextPhysical = kInvalidNode;
+        uint32_t prevFree = kInvalidNode;
+        uint32_t nextFree = kInvalidNode;
+        bool free = false;
+    };
+
+    uint64_t m_size;
+    uint64_t m_usedBytes = 0;
+    uint64_t m_wastedBytes = 0;
+    uint32_t m_allocationCount = 0;
+    uint32_t m_freeBlockCount = 0;
+
+    std::vector<Block> m_blocks;
+    std::vector<uint32_t> m_unusedNodes;
+
+    uint64_t m_firstLevelBitmap = 0;
+    std::array<uint32_t, kFirstLevelCount> m_secondLevelBitmaps{};
+    std::array<std::array<uint32_t, kSecondLevelCount>, kFirstLevelCount> m_freeHeads{};
+
+    static void mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+    static void mappingSearch(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+    uint32_t createNode();
+    void releaseNode(uint32_t node);
+
+    void insertFree(uint32_t node);
+    void removeFree(uint32_t node);
+    [[nodiscard]] uint32_t findSuitable(uint64_t size) const;
+};
+
+#endif // TLSF_ALLOCATOR_H
@@ -1,39 +1,189 @@
 #ifndef VERTEX_H
 #define VERTEX_H
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 
-struct Vertex {
-    glm::vec3 position;
-    glm::vec3 color;
+// Attribute encodings: storage type, Vulkan format and conversion from the
+// full-precision value. Normalized formats are expanded back to floats by
+// the vertex fetch hardware, so only octahedral normals need shader code.
+namespace VertexEncoding {
+
+inline int16_t toSnorm16(const float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline uint8_t toUnorm8(const float value) {
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+struct Float3 {
+    using Storage = glm::vec3;
+    static constexpr VkFormat format = VK_FORMAT_R32G32B32_SFLOAT;
+    static constexpr bool quantized = false;
+
+    static Storage encode(const glm::vec3& value) { return value; }
+};
+
+// Positions remapped to [-1, 1] over the mesh bounds; w pads the attribute to 8 bytes
+struct Snorm16x4 {
+    using Storage = std::array<int16_t, 4>;
+    static constexpr VkFormat format = VK_FORMAT_R16G16B16A16_SNORM;
+    static constexpr bool quantized = true;
+
+    static Storage encode(const glm::vec3& value) {
+        return { toSnorm16(value.x), toSnorm16(value.y), toSnorm16(value.z), 0 };
+    }
+};
+
+// Unit vectors projected onto an octahedron and unfolded into a square;
+// decoded by octDecode() in assets/shaders/instanced.glsl
+struct Octahedral16 {
+    using Storage = std::array<int16_t, 2>;
+    static constexpr VkFormat format = VK_FORMAT_R16G16_SNORM;
+    static constexpr bool quantized = false;
+
+    static Storage encode(const glm::vec3& value) {
+        const float l1 = std::abs(value.x) + std::abs(value.y) + std::abs(value.z);
+        if (l1 == 0.0f) return { 0, 0 };
+
+        float x = value.x / l1;
+        float y = value.y / l1;
+        if (value.z < 0.0f) {
+            // Fold the lower hemisphere over the diagonals
+            const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+        return { toSnorm16(x), toSnorm16(y) };
+    }
+};
+
+// Colors in [0, 1] with an opaque alpha
+struct Unorm8x4 {
+    using Storage = std::array<uint8_t, 4>;
+    static constexpr VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    static constexpr bool quantized = false;
+
+    static Storage encode(const glm::vec3& value) {
+        return { toUnorm8(value.x), toUnorm8(value.y), toUnorm8(value.z), 255 };
+    }
+};
+
+}
+
+// One interleaved vertex; the attribute descriptions are generated from the
+// encodings, so the pipeline's vertex input always matches the storage.
+// Locations: 0 position, 1 color, 2 normal.
+template<typename PositionEncoding, typename ColorEncoding, typename NormalEncoding>
+struct VertexLayout {
+    using Position = PositionEncoding;
+    using Color = ColorEncoding;
+    using Normal = NormalEncoding;
+
+    typename PositionEncoding::Storage position;
+    typename ColorEncoding::Storage color;
+    typename NormalEncoding::Storage normal;
+
+    static constexpr bool quantizedPositions = PositionEncoding::quantized;
 
     static VkVertexInputBindingDescription getBindingDescription() {
         return {
             .binding = 0,
-            .stride = sizeof(Vertex),
+            .stride = sizeof(VertexLayout),
             .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
         };
     }
 
-    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions() {
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions() {
         return {{
             {
                 .location = 0,
                 .binding = 0,
-                .format = VK_FORMAT_R32G32B32_SFLOAT, // vec3 instead of vec2
-                .offset = offsetof(Vertex, position)
+                .format = PositionEncoding::format,
+                .offset = offsetof(VertexLayout, position)
             },
             {
                 .location = 1,
                 .binding = 0,
-                .format = VK_FORMAT_R32G32B32_SFLOAT,
-                .offset = offsetof(Vertex, color)
+                .format = ColorEncoding::format,
+                .offset = offsetof(VertexLayout, color)
+            },
+            {
+                .location = 2,
+                .binding = 0,
+                .format = NormalEncoding::format,
+                .offset = offsetof(VertexLayout, normal)
             }
         }};
     }
 };
 
+// Full-precision layout meshes are loaded and optimized in (36 bytes)
+using Vertex = VertexLayout<VertexEncoding::Float3, VertexEncoding::Float3, VertexEncoding::Float3>;
+
+// Bandwidth-optimized layout for dense meshes (16 bytes)
+using PackedVertex = VertexLayout<VertexEncoding::Snorm16x4, VertexEncoding::Unorm8x4, VertexEncoding::Octahedral16>;
+
+// Restores quantized positions: original = offset + scale * stored
+struct VertexQuantization {
+    glm::vec3 offset = glm::vec3(0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+// The packing step on load. quantization receives the transform that undoes
+// position quantization (identity for float positions).
+template<typename Layout>
+std::vector<Layout> packVertices(const std::vector<Vertex>& vertices, VertexQuantization& quantization) {
+    quantization = {};
+    if (Layout::quantizedPositions && !vertices.empty()) {
+        glm::vec3 lower = vertices.front().position;
+        glm::vec3 upper = lower;
+        for (const Vertex& vertex : vertices) {
+            lower = glm::min(lower, vertex.position);
+            upper = glm::max(upper, vertex.position);
+        }
+
+        // Flat axes keep a unit scale so nothing divides by zero
+        const glm::vec3 halfExtent = (upper - lower) * 0.5f;
+        quantization.offset = (upper + lower) * 0.5f;
+        for (int axis = 0; axis < 3; ++axis) {
+            quantization.scale[axis] = halfExtent[axis] > 0.0f ? halfExtent[axis] : 1.0f;
+        }
+    }
+
+    std::vector<Layout> packed;
+    packed.reserve(vertices.size());
+    for (const Vertex& vertex : vertices) {
+        const glm::vec3 position = Layout::quantizedPositions
+            ? (vertex.position - quantization.offset) / quantization.scale
+            : vertex.position;
+        packed.push_back({
+            .position   = Layout::Position::encode(position),
+            .color      = Layout::Color::encode(vertex.color),
+            .normal     = Layout::Normal::encode(vertex.normal)
+        });
+    }
+    return packed;
+}
+
+// Binding and attributes of one layout, in the form VulkanPipeline consumes
+struct VulkanVertexInput {
+    VkVertexInputBindingDescription binding;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+
+    template<typename Layout>
+    static VulkanVertexInput of() {
+        const auto attributes = Layout::getAttributeDescriptions();
+        return { Layout::getBindingDescription(), { attributes.begin(), attributes.end() } };
+    }
+};
 
 #endif // VERTEX_H
@@ -0,0 +1,89 @@
+#ifndef VULKAN_BINDLESS_TABLE_H
+#define VULKAN_BINDLESS_TABLE_H
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class VulkanDevice;
+
+// One global descriptor set holding every storage buffer, sampled image and
+// sampler the renderer uses, in large partially bound arrays. Shaders index
+// them with integers from push constants or buffers (assets/shaders/bindless.glsl),
+// so the set is bound once per command buffer no matter how many objects or
+// materials are drawn.
+//
+// Bindings are update-after-bind and update-unused-while-pending: new entries
+// can be written while frames using the set are in flight. Released indices
+// are handed out again immediately, so release only once no frame in flight
+// can still read them (Renderer routes this through its deletion queue).
+class VulkanBindlessTable {
+public:
+    enum class Kind : uint32_t {
+        StorageBuffer,  // binding 0
+        SampledImage,   // binding 1
+        Sampler,        // binding 2
+        Count
+    };
+
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    struct Stats {
+        std::array<uint32_t, static_cast<size_t>(Kind::Count)> used{};
+        std::array<uint32_t, static_cast<size_t>(Kind::Count)> capacity{};
+    };
+
+    // Capacities are clamped to the device's update-after-bind limits
+    VulkanBindlessTable(const VulkanDevice& device, uint32_t bufferCapacity,
+                        uint32_t imageCapacity, uint32_t samplerCapacity);
+    ~VulkanBindlessTable();
+
+    VulkanBindlessTable(const VulkanBindlessTable&) = delete;
+    VulkanBindlessTable& operator=(const VulkanBindlessTable&) = delete;
+
+    uint32_t addStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    uint32_t addSampledImage(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    uint32_t addSampler(VkSampler sampler);
+
+    // Points an existing index at a new resource, e.g. after a buffer was reallocated
+    void updateStorageBuffer(uint32_t index, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    void updateSampledImage(uint32_t index, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    void release(Kind kind, uint32_t index);
+
+    [[nodiscard]] VkDescriptorSetLayout getSetLayout() const { return m_setLayout; }
+    [[nodiscard]] VkDescriptorSet getSet() const { return m_set; }
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    // Free-list handle allocator for one binding's array
+    struct Slots {
+        uint32_t capacity = 0;
+        uint32_t next = 0;              // Never-used indices start here
+        std::vector<uint32_t> freed;
+
+        uint32_t acquire();
+        void release(uint32_t index);
+        [[nodiscard]] uint32_t used() const { return next - static_cast<uint32_t>(freed.size()); }
+    };
+
+    VkDevice m_device;
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    VkDescriptorSet m_set = VK_NULL_HANDLE;
+    std::array<Slots, static_cast<size_t>(Kind::Count)> m_slots;
+
+    Slots& slots(Kind kind) { return m_slots[static_cast<size_t>(kind)]; }
+    void write(Kind kind, uint32_t index, const VkDescriptorBufferInfo* bufferInfo, const VkDescriptorImageInfo* imageInfo) const;
+};
+
+// Matches the push constant block in assets/shaders/bindless.glsl
+struct BindlessPushConstants {
+    uint32_t bufferIndex = VulkanBindlessTable::kInvalidIndex; // Per-draw data (objects, materials)
+    uint32_t textureIndex = VulkanBindlessTable::kInvalidIndex;
+    uint32_t samplerIndex = VulkanBindlessTable::kInvalidIndex;
+    uint32_t meshBufferIndex = VulkanBindlessTable::kInvalidIndex; // GpuMesh table of instanced draws
+};
+
+#endif // VULKAN_BINDLESS_TABLE_H
@@ -3,9 +3,12 @@
 
 #include <vulkan/vulkan.h>
 
+#include "VulkanMemoryAllocator.h"
+
 class VulkanBuffer {
 public:
-    VulkanBuffer(VkDevice device, VkPhysicalDevice physicalDevice,
+    // Host-visible buffers always get coherent memory, so getMappedData() needs no flushes
+    VulkanBuffer(VulkanMemoryAllocator& allocator,
                  VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
     ~VulkanBuffer();
 
@@ -13,15 +16,18 @@ public:
     VulkanBuffer& operator=(const VulkanBuffer&) = delete;
 
     [[nodiscard]] VkBuffer get() const { return m_buffer; }
-    [[nodiscard]] VkDeviceMemory getMemory() const { return m_memory; }
+    [[nodiscard]] VkDeviceSize getSize() const { return m_size; }
+    [[nodiscard]] const VulkanAllocation& getAllocation() const { return m_allocation; }
+    [[nodiscard]] void* getMappedData() const { return m_allocation.mapped; }
 
 private:
+    VulkanMemoryAllocator& m_allocator;
     VkDevice m_device;
     VkBuffer m_buffer = VK_NULL_HANDLE;
-    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    VkDeviceSize m_size;
+    VulkanAllocation m_allocation;
 
-    void allocate(VkPhysicalDevice physicalDevice, VkMemoryPropertyFlags properties, VkDeviceSize size);
-    uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    void allocate(VkMemoryPropertyFlags properties);
 };
 
 #endif // VULKAN_BUFFER_H
@@ -4,21 +4,45 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 
+// Command pools per frame slot and per recording worker. A slot's pools are
+// reset wholesale in beginFrame() once its previous frame has retired, which is
+// cheaper than resetting buffers one by one and lets workers allocate from
+// their own pool without synchronization.
 class VulkanCommandManager {
 public:
-    VulkanCommandManager(VkDevice device, uint32_t queueFamily, size_t bufferCount);
+    VulkanCommandManager(VkDevice device, uint32_t queueFamily, uint32_t frameCount, uint32_t workerCount = 1);
     ~VulkanCommandManager();
 
     VulkanCommandManager(const VulkanCommandManager&) = delete;
     VulkanCommandManager& operator=(const VulkanCommandManager&) = delete;
 
-    [[nodiscard]] VkCommandPool getCommandPool() const { return m_commandPool; }
-    [[nodiscard]] const std::vector<VkCommandBuffer>& getCommandBuffers() const { return m_commandBuffers; }
+    // Resets every pool of this frame and returns its (not yet begun) primary buffer
+    VkCommandBuffer beginFrame(uint32_t frameIndex);
+
+    // Hands out the worker's next secondary buffer for this frame; only the
+    // worker itself may call this between two beginFrame() calls
+    VkCommandBuffer acquireSecondary(uint32_t frameIndex, uint32_t worker);
+
+    [[nodiscard]] uint32_t getWorkerCount() const { return m_workerCount; }
 
 private:
+    struct WorkerCommands {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> secondaries; // Grown on demand, recycled by the pool reset
+        uint32_t used = 0;
+    };
+
+    struct FrameCommands {
+        VkCommandPool primaryPool = VK_NULL_HANDLE;
+        VkCommandBuffer primary = VK_NULL_HANDLE;
+        std::vector<WorkerCommands> workers;
+    };
+
     VkDevice m_device;
-    VkCommandPool m_commandPool = VK_NULL_HANDLE;
-    std::vector<VkCommandBuffer> m_commandBuffers;
+    uint32_t m_workerCount;
+    std::vector<FrameCommands> m_frames;
+
+    VkCommandPool createPool(uint32_t queueFamily) const;
 };
 
 #endif // VULKAN_COMMAND_MANAGER_H
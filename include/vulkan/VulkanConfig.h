@@ -2,6 +2,7 @@
 #define VULKAN_CONFIG_H
 
 #include <vulkan/vulkan.h>
+#include <string>
 #include <vector>
 
 struct VulkanConfig {
@@ -16,12 +17,44 @@ struct VulkanConfig {
     VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR; // Prefer no vsync
     VkFormat preferredSurfaceFormat = VK_FORMAT_B8G8R8A8_SRGB;             // sRGB color space
 
+    // Headless mode renders into an offscreen image ring; no window, surface or swapchain
+    bool headless = false;
+    VkExtent2D headlessExtent = { 1920, 1080 };
+
+    // Pipeline cache persisted between runs; empty disables loading and saving
+    std::string pipelineCachePath = "pipeline_cache.bin";
+
+    // Render without VkRenderPass/VkFramebuffer when the device allows it, so a
+    // resize only recreates the swapchain
+    bool dynamicRendering = true;
+
     // Pipeline Defaults
     VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL; // Wireframe vs. solid
     VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT; // Back-face culling
 
     // Application-specific settings
-    uint32_t maxFramesInFlight = 2;
+    uint32_t maxFramesInFlight = 2;        // Initial value; adjustable at runtime up to frameSlotCount
+    uint32_t frameSlotCount = 3;           // Per-frame command pools, uniform regions and query slots
+    uint32_t recordThreads = 0;            // Job system threads, caller included; 0 = one per core
+    bool pinWorkerThreads = false;         // Pin job system worker i to logical core i
+    uint32_t minDrawsPerRecordTask = 256;  // Below this many draws per worker, record inline
+    VkDeviceSize uniformRingRegionSize = 256 * 1024; // Per-frame uniform/storage scratch
+    VkDeviceSize stagingBufferSize = 64 * 1024 * 1024; // Upload staging ring
+
+    // Bindless table sizes; clamped to the device's update-after-bind limits
+    uint32_t bindlessStorageBuffers = 65536;
+    uint32_t bindlessSampledImages = 65536;
+    uint32_t bindlessSamplers = 256;
+
+    // Stress scene of instanced cubes; 0 disables it. GPU culling falls back to the CPU when unsupported
+    uint32_t stressInstanceCount = 0;
+    bool gpuCulling = true;
+    uint32_t stressMeshSegments = 0;       // 0 = cube, otherwise a UV sphere this dense
+    bool packedVertices = false;           // PackedVertex instead of Vertex for the stress mesh
+    std::string stressMeshPath;            // Mesh file to instance instead; its vertex format wins
+    bool animateStressScene = false;       // Spin half the grid, rewriting every instance into the uniform ring each frame
+    bool batchedStressScene = false;       // Submit the grid through Renderer::submitInstances() instead: one culled draw
+    std::string scenePath;                 // OBJ or glTF scene streamed in by Renderer::importScene()
 
     void setWireframeMode(bool enabled) {
         polygonMode = enabled ? VK_POLYGON_MODE_LINE : VK_POLYGON_MODE_FILL;
@@ -10,9 +10,11 @@ struct VulkanContext {
     VkSurfaceKHR surface;
     VkQueue graphicsQueue;
     VkQueue presentQueue;
-    VkRenderPass renderPass;
+    VkRenderPass renderPass;        // VK_NULL_HANDLE with dynamic rendering
+    bool dynamicRendering;
     VkExtent2D swapchainExtent;
     VkFormat swapchainImageFormat;
+    VkFormat depthFormat;           // Of the main pass's depth attachment
     uint32_t graphicsQueueFamily;
 };
 
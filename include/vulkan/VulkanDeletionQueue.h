@@ -0,0 +1,47 @@
+#ifndef VULKAN_DELETION_QUEUE_H
+#define VULKAN_DELETION_QUEUE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+
+// Defers destruction of GPU objects until the last frame that could have used
+// them has retired, so replacing a resource never needs a vkDeviceWaitIdle.
+// Entries are tagged with a frame number and run in retirement order.
+class VulkanDeletionQueue {
+public:
+    VulkanDeletionQueue() = default;
+    ~VulkanDeletionQueue() { flush(); }
+
+    VulkanDeletionQueue(const VulkanDeletionQueue&) = delete;
+    VulkanDeletionQueue& operator=(const VulkanDeletionQueue&) = delete;
+
+    // Runs deleter once frame `lastUse` has completed on the GPU
+    void retire(uint64_t lastUse, std::function<void()> deleter);
+
+    // Keeps an owning wrapper (swapchain, framebuffers, pipeline, ...) alive until then
+    template<typename T>
+    void retire(const uint64_t lastUse, std::unique_ptr<T> object) {
+        if (!object) return;
+        retire(lastUse, [owned = std::shared_ptr<T>(std::move(object))]() mutable { owned.reset(); });
+    }
+
+    // Destroys everything retired up to and including completedFrame
+    void collect(uint64_t completedFrame);
+
+    // Destroys everything; only valid once the device is idle
+    void flush();
+
+    [[nodiscard]] size_t size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t lastUse;
+        std::function<void()> deleter;
+    };
+
+    std::deque<Entry> m_entries;
+};
+
+#endif // VULKAN_DELETION_QUEUE_H
@@ -3,51 +3,81 @@
 
 #include <vulkan/vulkan.h>
 #include <GLFW/glfw3.h>
+#include <memory>
 #include <optional>
+#include <vector>
 
-class WindowManager;
+#include "VulkanConfig.h"
+
+class VulkanMemoryAllocator;
+class VulkanPipelineCache;
 
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphics;
     std::optional<uint32_t> present;
+    std::optional<uint32_t> transfer; // Transfer-only family when the device exposes one
 
-    [[nodiscard]] bool isComplete() const {
-        return graphics.has_value() && present.has_value();
+    // Headless devices have no surface and therefore no present family
+    [[nodiscard]] bool isComplete(const bool requirePresent = true) const {
+        return graphics.has_value() && (present.has_value() || !requirePresent);
     }
 };
 
 class VulkanDevice {
 public:
-    VulkanDevice(VkInstance instance, const WindowManager& windowManager);
+    // window may be null for headless rendering; no surface or swapchain support is created then
+    VulkanDevice(VkInstance instance, GLFWwindow* window, const VulkanConfig& config);
     ~VulkanDevice();
 
     VulkanDevice(const VulkanDevice&) = delete;
     VulkanDevice& operator=(const VulkanDevice&) = delete;
 
     [[nodiscard]] VkPhysicalDevice getPhysicalDevice() const { return m_physicalDevice; }
+    [[nodiscard]] const VkPhysicalDeviceProperties& getProperties() const { return m_properties; }
+    [[nodiscard]] const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const { return m_memoryProperties; }
     [[nodiscard]] VkSurfaceKHR getSurface() const { return m_surface; }
+    [[nodiscard]] bool isHeadless() const { return m_surface == VK_NULL_HANDLE; }
     [[nodiscard]] const QueueFamilyIndices& getQueueIndices() const { return m_queueIndices; }
 
     [[nodiscard]] VkDevice getDevice() const { return m_device; }
     [[nodiscard]] VkQueue getGraphicsQueue() const { return m_graphicsQueue; }
     [[nodiscard]] VkQueue getPresentQueue() const { return m_presentQueue; }
-
+    [[nodiscard]] VkQueue getTransferQueue() const { return m_transferQueue; }
+    [[nodiscard]] uint32_t getTransferQueueFamily() const {
+        return m_queueIndices.transfer.value_or(m_queueIndices.graphics.value());
+    }
+    [[nodiscard]] bool hasDedicatedTransferQueue() const { return m_queueIndices.transfer.has_value(); }
+    // True when VulkanConfig::dynamicRendering was requested and the device supports it
+    [[nodiscard]] bool hasDynamicRendering() const { return m_dynamicRendering; }
+    // GPU-generated draws: vkCmdDrawIndexedIndirectCount with non-zero firstInstance
+    [[nodiscard]] bool hasIndirectCount() const { return m_indirectCount; }
+    [[nodiscard]] VulkanMemoryAllocator& getAllocator() const { return *m_allocator; }
+    [[nodiscard]] VulkanPipelineCache& getPipelineCache() const { return *m_pipelineCache; }
 
 private:
     VkInstance m_instance = VK_NULL_HANDLE;
     VkSurfaceKHR m_surface = VK_NULL_HANDLE;
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties m_properties{};
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
     QueueFamilyIndices m_queueIndices;
 
     void createSurface(GLFWwindow* window);
     void pickPhysicalDevice();
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device) const;
+    // The required API version or names of the Vulkan 1.2 features the device lacks; empty if it has them all
+    static std::vector<const char*> findMissingFeatures(VkPhysicalDevice device);
 
     VkDevice m_device = VK_NULL_HANDLE;
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
+    VkQueue m_transferQueue = VK_NULL_HANDLE;
+    bool m_dynamicRendering = false;
+    bool m_indirectCount = false;
+    std::unique_ptr<VulkanMemoryAllocator> m_allocator;
+    std::unique_ptr<VulkanPipelineCache> m_pipelineCache;
 
-    void createLogicalDevice();
+    void createLogicalDevice(const VulkanConfig& config);
 };
 
 #endif // VULKAN_DEVICE_H
@@ -0,0 +1,70 @@
+#ifndef VULKAN_FRAME_SCHEDULER_H
+#define VULKAN_FRAME_SCHEDULER_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+// Paces frames with one timeline semaphore on the graphics queue: frame N
+// signals value N, so "is frame N done" is a counter read instead of a fence
+// per frame. Frame numbers start at 1 and only grow.
+//
+// Per-frame resources (command pools, uniform ring regions, query slots) are
+// allocated for slotCount frames and indexed with getSlot(frame). The number
+// of frames actually in flight can be changed at runtime up to slotCount;
+// beginFrame() waits until the slot about to be reused has retired.
+//
+// Present semaphores are per swapchain image rather than per frame: a binary
+// semaphore waited on by vkQueuePresentKHR is only known to be free again once
+// that image has been acquired again. A new swapchain gets a new set, since the
+// old one's last presents may still be waiting on the previous semaphores.
+class VulkanFrameScheduler {
+public:
+    VulkanFrameScheduler(VkDevice device, uint32_t slotCount, uint32_t maxFramesInFlight);
+    ~VulkanFrameScheduler();
+
+    VulkanFrameScheduler(const VulkanFrameScheduler&) = delete;
+    VulkanFrameScheduler& operator=(const VulkanFrameScheduler&) = delete;
+
+    // Waits until the frame about to be recorded may start and returns its number.
+    // Calling it again without endFrame() returns the same frame.
+    uint64_t beginFrame();
+
+    // Marks the frame from beginFrame() as submitted with getTimelineSemaphore() signaling it
+    void endFrame();
+
+    [[nodiscard]] uint64_t getCompletedFrame() const;
+    void waitForFrame(uint64_t frame) const;
+
+    // Last frame handed to the GPU; resources used by it retire with that number
+    [[nodiscard]] uint64_t getSubmittedFrame() const { return m_submittedFrame; }
+    [[nodiscard]] uint32_t getSlot(const uint64_t frame) const { return static_cast<uint32_t>(frame % m_slotCount); }
+    [[nodiscard]] uint32_t getSlotCount() const { return m_slotCount; }
+
+    [[nodiscard]] uint32_t getMaxFramesInFlight() const { return m_maxFramesInFlight; }
+    // Clamped to [1, slotCount]; lowering it takes effect at the next beginFrame()
+    void setMaxFramesInFlight(uint32_t count);
+
+    [[nodiscard]] VkSemaphore getTimelineSemaphore() const { return m_timeline; }
+    [[nodiscard]] VkSemaphore getAcquireSemaphore(const uint64_t frame) const { return m_acquireSemaphores[getSlot(frame)]; }
+    [[nodiscard]] VkSemaphore getPresentSemaphore(const uint32_t imageIndex) const { return m_presentSemaphores[imageIndex]; }
+
+    // Creates one present semaphore per image of a new swapchain and returns the
+    // previous set, which the caller destroys once the old swapchain is retired
+    std::vector<VkSemaphore> setSwapchainImageCount(uint32_t imageCount);
+
+private:
+    VkDevice m_device;
+    VkSemaphore m_timeline = VK_NULL_HANDLE;
+    std::vector<VkSemaphore> m_acquireSemaphores;
+    std::vector<VkSemaphore> m_presentSemaphores;
+
+    uint32_t m_slotCount;
+    uint32_t m_maxFramesInFlight;
+    uint64_t m_submittedFrame = 0;
+    mutable uint64_t m_completedFrame = 0; // Cached counter value; only ever grows
+
+    VkSemaphore createBinarySemaphore() const;
+};
+
+#endif // VULKAN_FRAME_SCHEDULER_H
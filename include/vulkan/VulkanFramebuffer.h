@@ -6,9 +6,10 @@
 
 class VulkanFramebuffer {
 public:
+    // depthView, when given, is attached second to every framebuffer
     VulkanFramebuffer(VkDevice device, VkRenderPass renderPass,
                       const std::vector<VkImageView>& imageViews,
-                      VkExtent2D extent);
+                      VkExtent2D extent, VkImageView depthView = VK_NULL_HANDLE);
 
     ~VulkanFramebuffer();
 
@@ -0,0 +1,111 @@
+#ifndef VULKAN_GPU_PROFILER_H
+#define VULKAN_GPU_PROFILER_H
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class VulkanDevice;
+
+// Timestamp-query profiler with named, nestable scopes. Each frame slot owns a
+// slice of one query pool; a slice is read back in beginFrame(), once the frame
+// that last used the slot has retired, so results never stall the CPU and are
+// frameSlotCount frames old.
+//
+// Devices whose graphics queue has no timestamp support get a profiler that
+// records nothing; every call stays valid.
+class VulkanGpuProfiler {
+public:
+    static constexpr uint32_t kHistorySize = 240;
+    static constexpr uint32_t kInvalidScope = UINT32_MAX;
+
+    struct ScopeTiming {
+        std::string name;
+        uint32_t depth;
+        double ms;
+    };
+
+    struct FrameResult {
+        uint64_t frame = 0;  // Frame number passed to beginFrame()
+        double totalMs = 0.0;
+        std::vector<ScopeTiming> scopes;
+    };
+
+    // Rolling window of a scope's (or the whole frame's) GPU time
+    struct History {
+        std::array<float, kHistorySize> samples{};
+        uint32_t next = 0;   // Oldest sample, i.e. the ImGui::PlotLines offset
+        float averageMs = 0.0f;
+
+        void push(float ms);
+    };
+
+    VulkanGpuProfiler(const VulkanDevice& device, uint32_t framesInFlight, uint32_t maxScopesPerFrame = 32);
+    ~VulkanGpuProfiler();
+
+    VulkanGpuProfiler(const VulkanGpuProfiler&) = delete;
+    VulkanGpuProfiler& operator=(const VulkanGpuProfiler&) = delete;
+
+    // Call once the slot's previous frame has retired and the command buffer is begun
+    void beginFrame(VkCommandBuffer cmd, uint32_t frameIndex, uint64_t frameNumber);
+    void endFrame(VkCommandBuffer cmd);
+
+    uint32_t beginScope(VkCommandBuffer cmd, std::string name);
+    void endScope(VkCommandBuffer cmd, uint32_t scope);
+
+    class Scope {
+    public:
+        Scope(VulkanGpuProfiler& profiler, VkCommandBuffer cmd, std::string name)
+            : m_profiler(profiler), m_cmd(cmd), m_scope(profiler.beginScope(cmd, std::move(name))) {}
+        ~Scope() { m_profiler.endScope(m_cmd, m_scope); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        VulkanGpuProfiler& m_profiler;
+        VkCommandBuffer m_cmd;
+        uint32_t m_scope;
+    };
+
+    [[nodiscard]] bool isEnabled() const { return m_queryPool != VK_NULL_HANDLE; }
+    [[nodiscard]] const std::optional<FrameResult>& getLatestResult() const { return m_latest; }
+    [[nodiscard]] const History& getFrameHistory() const { return m_frameHistory; }
+    [[nodiscard]] const History* getScopeHistory(const std::string& name) const;
+
+private:
+    struct PendingScope {
+        std::string name;
+        uint32_t depth;
+        bool ended;
+    };
+
+    struct FrameSlot {
+        uint64_t frame = 0;  // 0 while the slot holds no submitted frame
+        std::vector<PendingScope> scopes;
+    };
+
+    VkDevice m_device;
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    double m_periodNs = 0.0;
+    uint64_t m_validMask = 0;
+    uint32_t m_maxScopes;
+    uint32_t m_queriesPerFrame;
+
+    std::vector<FrameSlot> m_slots;
+    FrameSlot* m_current = nullptr;
+    uint32_t m_currentBase = 0;
+    uint32_t m_depth = 0;
+    std::vector<uint64_t> m_readback;
+
+    std::optional<FrameResult> m_latest;
+    History m_frameHistory;
+    std::unordered_map<std::string, History> m_scopeHistory;
+
+    void collect(FrameSlot& slot, uint32_t base);
+};
+
+#endif // VULKAN_GPU_PROFILER_H
@@ -0,0 +1,79 @@
+#ifndef VULKAN_INDIRECT_CULLER_H
+#define VULKAN_INDIRECT_CULLER_H
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+
+#include "Frustum.h"
+
+class VulkanBuffer;
+class VulkanDevice;
+class VulkanBindlessTable;
+
+// GPU-driven culling: a compute pass tests every GpuInstance against the
+// frustum and writes one VkDrawIndexedIndirectCommand per survivor, compacted
+// with subgroup ballots, plus the draw count. The draw is then a single
+// vkCmdDrawIndexedIndirectCount, so the CPU cost no longer grows with the
+// number of objects.
+//
+// Draw and count buffers exist once per frame slot; the frame scheduler
+// guarantees a slot's previous frame has retired before it is culled into
+// again. Instance and mesh buffers are read through the bindless table.
+class VulkanIndirectCuller {
+public:
+    // Needs drawIndirectCount, multiDrawIndirect, drawIndirectFirstInstance
+    // and subgroup ballots in compute shaders
+    static bool isSupported(const VulkanDevice& device);
+
+    VulkanIndirectCuller(const VulkanDevice& device, VulkanBindlessTable& bindless,
+                         uint32_t maxDraws, uint32_t slotCount);
+    ~VulkanIndirectCuller();
+
+    VulkanIndirectCuller(const VulkanIndirectCuller&) = delete;
+    VulkanIndirectCuller& operator=(const VulkanIndirectCuller&) = delete;
+
+    // Clears the slot's count and dispatches the cull. Buffers are bindless indices;
+    // instanceCount must not exceed maxDraws.
+    void recordCull(VkCommandBuffer cmd, uint32_t slot, const Frustum& frustum,
+                    uint32_t instanceBuffer, uint32_t meshBuffer, uint32_t instanceCount) const;
+
+    // Inside a render pass with the index and vertex buffers already bound
+    void recordDraw(VkCommandBuffer cmd, uint32_t slot) const;
+
+    [[nodiscard]] VkBuffer getDrawBuffer(uint32_t slot) const;
+    [[nodiscard]] VkBuffer getCountBuffer(uint32_t slot) const;
+    [[nodiscard]] VkDeviceSize getDrawBufferSize() const;
+    [[nodiscard]] uint32_t getMaxDraws() const { return m_maxDraws; }
+
+private:
+    // Matches CullParams in assets/shaders/cull.comp
+    struct PushConstants {
+        glm::vec4 planes[Frustum::PlaneCount];
+        uint32_t instanceBuffer;
+        uint32_t meshBuffer;
+        uint32_t drawBuffer;
+        uint32_t countBuffer;
+        uint32_t instanceCount;
+    };
+
+    struct SlotBuffers {
+        std::unique_ptr<VulkanBuffer> draws;
+        std::unique_ptr<VulkanBuffer> count;
+        uint32_t drawIndex;     // Bindless indices
+        uint32_t countIndex;
+    };
+
+    VkDevice m_device;
+    VulkanBindlessTable& m_bindless;
+    uint32_t m_maxDraws;
+
+    VkDescriptorSetLayout m_emptySetLayout = VK_NULL_HANDLE; // Set 0 is unused; bindless sits at set 1
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    std::vector<SlotBuffers> m_slots;
+
+    static constexpr uint32_t kWorkgroupSize = 64;
+};
+
+#endif // VULKAN_INDIRECT_CULLER_H
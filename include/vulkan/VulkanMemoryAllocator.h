@@ -0,0 +1,86 @@
+#ifndef VULKAN_MEMORY_ALLOCATOR_H
+#define VULKAN_MEMORY_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "TlsfAllocator.h"
+
+// Linear resources (buffers, linear images) and optimal-tiling images are kept
+// in separate pools so bufferImageGranularity never has to be padded for.
+enum class VulkanResourceKind : uint32_t {
+    Linear = 0,
+    Optimal = 1
+};
+
+struct VulkanAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr; // Non-null for host-visible memory, already offset
+
+    uint32_t pool = UINT32_MAX;
+    uint32_t block = UINT32_MAX;
+    uint32_t node = TlsfAllocator::kInvalidNode;
+
+    [[nodiscard]] bool isValid() const { return memory != VK_NULL_HANDLE; }
+};
+
+struct VulkanAllocatorStats {
+    uint32_t blockCount = 0;
+    uint32_t dedicatedBlockCount = 0;
+    uint32_t allocationCount = 0;
+    VkDeviceSize reservedBytes = 0; // Sum of all VkDeviceMemory blocks
+    VkDeviceSize usedBytes = 0;
+    VkDeviceSize wastedBytes = 0;
+    float fragmentation = 0.0f;     // Worst fragmentation across blocks
+};
+
+class VulkanMemoryAllocator {
+public:
+    VulkanMemoryAllocator(VkDevice device,
+                          const VkPhysicalDeviceMemoryProperties& memoryProperties,
+                          const VkPhysicalDeviceLimits& limits);
+    ~VulkanMemoryAllocator();
+
+    VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+    VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+
+    [[nodiscard]] VulkanAllocation allocate(const VkMemoryRequirements& requirements,
+                                            VkMemoryPropertyFlags properties,
+                                            VulkanResourceKind kind = VulkanResourceKind::Linear);
+    void free(const VulkanAllocation& allocation);
+
+    [[nodiscard]] uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    [[nodiscard]] VulkanAllocatorStats getStats() const;
+    [[nodiscard]] VkDevice getDevice() const { return m_device; }
+
+private:
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+        bool dedicated = false;
+        std::unique_ptr<TlsfAllocator> allocator;
+    };
+
+    struct Pool {
+        uint32_t memoryType = 0;
+        VkDeviceSize blockSize = 0;
+        std::vector<std::unique_ptr<Block>> blocks; // Null slots keep block indices stable
+    };
+
+    VkDevice m_device;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties;
+    VkDeviceSize m_bufferImageGranularity;
+
+    std::vector<Pool> m_pools;
+    mutable std::mutex m_mutex;
+
+    [[nodiscard]] VkDeviceSize preferredBlockSize(uint32_t memoryType) const;
+    uint32_t createBlock(Pool& pool, VkDeviceSize size, bool dedicated);
+    void destroyBlock(Pool& pool, uint32_t blockIndex);
+};
+
+#endif // VULKAN_MEMORY_ALLOCATOR_H
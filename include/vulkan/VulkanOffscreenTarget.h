@@ -0,0 +1,39 @@
+#ifndef VULKAN_OFFSCREEN_TARGET_H
+#define VULKAN_OFFSCREEN_TARGET_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+#include "VulkanMemoryAllocator.h"
+
+// Swapchain-less ring of color images for headless rendering. It exposes the
+// same image view/format/extent surface as VulkanSwapchain so the render pass
+// and framebuffers don't care which one they target.
+class VulkanOffscreenTarget {
+public:
+    VulkanOffscreenTarget(VulkanMemoryAllocator& allocator,
+                          VkFormat format,
+                          VkExtent2D extent,
+                          uint32_t imageCount);
+    ~VulkanOffscreenTarget();
+
+    VulkanOffscreenTarget(const VulkanOffscreenTarget&) = delete;
+    VulkanOffscreenTarget& operator=(const VulkanOffscreenTarget&) = delete;
+
+    [[nodiscard]] const std::vector<VkImage>& getImages() const { return m_images; }
+    [[nodiscard]] const std::vector<VkImageView>& getImageViews() const { return m_imageViews; }
+    [[nodiscard]] VkFormat getImageFormat() const { return m_imageFormat; }
+    [[nodiscard]] VkExtent2D getExtent() const { return m_extent; }
+
+private:
+    VulkanMemoryAllocator& m_allocator;
+    VkDevice m_device;
+    VkFormat m_imageFormat;
+    VkExtent2D m_extent;
+
+    std::vector<VkImage> m_images;
+    std::vector<VulkanAllocation> m_allocations;
+    std::vector<VkImageView> m_imageViews;
+};
+
+#endif // VULKAN_OFFSCREEN_TARGET_H
@@ -5,9 +5,24 @@
 #include <vulkan/vulkan.h>
 #include "Vertex.h"
 
+class VulkanPipelineCache;
+
+// SPIR-V file names under VULKANLAB_SHADER_DIR, and the vertex layout the vertex shader reads
+struct VulkanShaderStages {
+    std::string vertex = "triangle.vert.spv";
+    std::string fragment = "triangle.frag.spv";
+    VulkanVertexInput vertexInput = VulkanVertexInput::of<Vertex>();
+};
+
+// Set 0 holds the per-frame camera UBO, set 1 the bindless table (VulkanBindlessTable),
+// and BindlessPushConstants carry the indices into it
 class VulkanPipeline {
 public:
-    VulkanPipeline(VkDevice device, VkRenderPass renderPass);
+    VulkanPipeline(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout bindlessLayout,
+                   VulkanPipelineCache& pipelineCache, const VulkanShaderStages& shaders = {});
+    // Dynamic rendering: built against the attachment formats, so it outlives any resize
+    VulkanPipeline(VkDevice device, VkFormat colorFormat, VkFormat depthFormat, VkDescriptorSetLayout bindlessLayout,
+                   VulkanPipelineCache& pipelineCache, const VulkanShaderStages& shaders = {});
     ~VulkanPipeline();
 
     VulkanPipeline(const VulkanPipeline&) = delete;
@@ -17,14 +32,17 @@ public:
     [[nodiscard]] VkPipelineLayout getLayout() const { return m_pipelineLayout; }
     VkDescriptorSetLayout getDescriptorSetLayout() const;
 
+    static VkShaderModule loadShaderModule(VkDevice device, const std::string& path);
+
 private:
     VkDevice m_device;
     VkPipeline m_pipeline = VK_NULL_HANDLE;
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
-    VkDescriptorSetLayout m_descriptorSetLayout;
-
-    VkShaderModule loadShaderModule(const std::string& path) const;
+    VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
 
+    VulkanPipeline(VkDevice device, VkRenderPass renderPass, VkFormat colorFormat, VkFormat depthFormat,
+                   VkDescriptorSetLayout bindlessLayout, VulkanPipelineCache& pipelineCache,
+                   const VulkanShaderStages& shaders);
 
 };
 
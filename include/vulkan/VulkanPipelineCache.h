@@ -0,0 +1,50 @@
+#ifndef VULKAN_PIPELINE_CACHE_H
+#define VULKAN_PIPELINE_CACHE_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+// VkPipelineCache persisted between runs. The on-disk blob is only trusted
+// when its header matches this exact driver/device; it is written back
+// atomically (temp file + rename) on destruction.
+class VulkanPipelineCache {
+public:
+    struct Stats {
+        bool warmStart = false;       // A valid cache blob was loaded from disk
+        uint32_t pipelineCount = 0;
+        double totalCreateMs = 0.0;
+        double firstCreateMs = 0.0;
+        double lastCreateMs = 0.0;
+    };
+
+    VulkanPipelineCache(VkDevice device,
+                        const VkPhysicalDeviceProperties& properties,
+                        std::filesystem::path path);
+    ~VulkanPipelineCache();
+
+    VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+    VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+
+    [[nodiscard]] VkPipelineCache get() const { return m_cache; }
+
+    void recordPipelineCreation(double milliseconds);
+    [[nodiscard]] Stats getStats() const;
+
+    void save() const;
+
+private:
+    VkDevice m_device;
+    VkPhysicalDeviceProperties m_properties;
+    std::filesystem::path m_path;
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+
+    Stats m_stats;
+    mutable std::mutex m_statsMutex;
+
+    [[nodiscard]] std::vector<char> loadValidatedBlob() const;
+};
+
+#endif // VULKAN_PIPELINE_CACHE_H
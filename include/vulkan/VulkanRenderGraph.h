@@ -0,0 +1,241 @@
+#ifndef VULKAN_RENDER_GRAPH_H
+#define VULKAN_RENDER_GRAPH_H
+
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "VulkanMemoryAllocator.h"
+
+class VulkanGpuProfiler;
+
+// Frame graph: passes declare the images and buffers they read and write, and
+// compile() works out everything else once:
+//  - passes whose output never reaches an imported resource (or a pass marked
+//    as having side effects) are culled,
+//  - transient resources get lifetimes, and transients whose lifetimes don't
+//    overlap are placed on the same memory,
+//  - layout transitions and barriers between passes are precomputed, so
+//    execute() only replays them.
+//
+// Passes run in declaration order and record their own rendering; the graph
+// leaves each attachment in its usage layout before the pass, so render passes
+// used inside should keep initialLayout == finalLayout == that layout.
+// Imported images (the swapchain image, say) may change every frame through
+// setImportedImage() without recompiling. compile() must only be called while
+// the GPU is not using the previous transients.
+class VulkanRenderGraph {
+public:
+    struct ImageHandle {
+        uint32_t index = UINT32_MAX;
+        [[nodiscard]] bool isValid() const { return index != UINT32_MAX; }
+    };
+
+    struct BufferHandle {
+        uint32_t index = UINT32_MAX;
+        [[nodiscard]] bool isValid() const { return index != UINT32_MAX; }
+    };
+
+    enum class ImageUsage {
+        ColorAttachment,
+        DepthAttachment,
+        DepthRead,
+        Sampled,        // Fragment shader sampling
+        Storage,        // Compute shader image load/store
+        TransferSrc,
+        TransferDst
+    };
+
+    enum class BufferUsage {
+        Vertex,
+        Index,
+        Indirect,
+        Uniform,
+        Storage,        // Compute shader SSBO
+        TransferSrc,
+        TransferDst
+    };
+
+    struct ImageDesc {
+        VkFormat format;
+        VkExtent2D extent;
+    };
+
+    // State an imported image is in when the graph starts and must be left in
+    struct ImportedImageState {
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags initialStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    };
+
+    struct Stats {
+        uint32_t passCount = 0;
+        uint32_t culledPassCount = 0;
+        uint32_t barrierBatchCount = 0;
+        uint32_t transientImageCount = 0;
+        uint32_t transientBufferCount = 0;
+        uint32_t memorySlotCount = 0;
+        VkDeviceSize transientBytes = 0;    // Sum of every transient's requirements
+        VkDeviceSize allocatedBytes = 0;    // What aliasing actually needed
+    };
+
+    class PassBuilder {
+    public:
+        ImageHandle createImage(std::string name, const ImageDesc& desc);
+        BufferHandle createBuffer(std::string name, VkDeviceSize size);
+
+        void read(ImageHandle image, ImageUsage usage);
+        void write(ImageHandle image, ImageUsage usage);
+        void read(BufferHandle buffer, BufferUsage usage);
+        void write(BufferHandle buffer, BufferUsage usage);
+
+        // Keeps the pass even if nothing reads its outputs (readbacks, debug output)
+        void setSideEffect() const;
+
+    private:
+        friend class VulkanRenderGraph;
+        PassBuilder(VulkanRenderGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+        VulkanRenderGraph& m_graph;
+        uint32_t m_pass;
+    };
+
+    using SetupFn = std::function<void(PassBuilder&)>;
+    using ExecuteFn = std::function<void(VkCommandBuffer)>;
+
+    explicit VulkanRenderGraph(VulkanMemoryAllocator& allocator);
+    ~VulkanRenderGraph();
+
+    VulkanRenderGraph(const VulkanRenderGraph&) = delete;
+    VulkanRenderGraph& operator=(const VulkanRenderGraph&) = delete;
+
+    ImageHandle importImage(std::string name, const ImageDesc& desc, const ImportedImageState& state);
+    BufferHandle importBuffer(std::string name, VkDeviceSize size);
+
+    void addPass(std::string name, const SetupFn& setup, ExecuteFn execute);
+
+    // Culls, allocates transients and plans barriers; cheap to skip when nothing changed
+    void compile();
+    [[nodiscard]] bool isCompiled() const { return m_compiled; }
+
+    // Drops every pass and resource so the graph can be declared again
+    void reset();
+
+    void setImportedImage(ImageHandle handle, VkImage image, VkImageView view);
+    void setImportedBuffer(BufferHandle handle, VkBuffer buffer);
+
+    // Records every live pass with its barriers; passes become GPU profiler scopes
+    void execute(VkCommandBuffer cmd, VulkanGpuProfiler* profiler = nullptr) const;
+
+    [[nodiscard]] VkImage getImage(ImageHandle handle) const { return m_images[handle.index].image; }
+    [[nodiscard]] VkImageView getImageView(ImageHandle handle) const { return m_images[handle.index].view; }
+    [[nodiscard]] VkBuffer getBuffer(BufferHandle handle) const { return m_buffers[handle.index].buffer; }
+    [[nodiscard]] const Stats& getStats() const { return m_stats; }
+
+private:
+    struct Access {
+        uint32_t resource;
+        bool isImage;
+        bool isWrite;
+        uint32_t usage; // ImageUsage or BufferUsage
+    };
+
+    struct Pass {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<Access> accesses;
+        bool sideEffect = false;
+        bool live = false;
+    };
+
+    struct ImageResource {
+        std::string name;
+        ImageDesc desc;
+        bool imported;
+        ImportedImageState importState;
+        VkImageUsageFlags usage = 0;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t firstPass = UINT32_MAX;
+        uint32_t lastPass = 0;
+        uint32_t slot = UINT32_MAX;
+    };
+
+    struct BufferResource {
+        std::string name;
+        VkDeviceSize size;
+        bool imported;
+        VkBufferUsageFlags usage = 0;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        uint32_t firstPass = UINT32_MAX;
+        uint32_t lastPass = 0;
+        uint32_t slot = UINT32_MAX;
+    };
+
+    // One allocation shared by transients with disjoint lifetimes
+    struct MemorySlot {
+        VulkanAllocation allocation;
+        VkMemoryRequirements requirements;
+        VulkanResourceKind kind;
+        std::vector<std::pair<uint32_t, uint32_t>> lifetimes; // [firstPass, lastPass] of each occupant
+        VkPipelineStageFlags lastStage = 0;                    // Last use by the previous occupant or frame
+        VkAccessFlags lastAccess = 0;
+    };
+
+    struct ImageBarrier {
+        uint32_t image;
+        VkImageLayout oldLayout;
+        VkImageLayout newLayout;
+        VkAccessFlags srcAccess;
+        VkAccessFlags dstAccess;
+    };
+
+    struct BufferBarrier {
+        uint32_t buffer;
+        VkAccessFlags srcAccess;
+        VkAccessFlags dstAccess;
+    };
+
+    struct BarrierBatch {
+        VkPipelineStageFlags srcStage = 0;
+        VkPipelineStageFlags dstStage = 0;
+        std::vector<ImageBarrier> images;
+        std::vector<BufferBarrier> buffers;
+
+        [[nodiscard]] bool empty() const { return images.empty() && buffers.empty(); }
+    };
+
+    struct Step {
+        uint32_t pass;
+        BarrierBatch barriers; // Applied before the pass
+    };
+
+    VulkanMemoryAllocator& m_allocator;
+    VkDevice m_device;
+
+    std::vector<Pass> m_passes;
+    std::vector<ImageResource> m_images;
+    std::vector<BufferResource> m_buffers;
+    std::vector<MemorySlot> m_slots;
+
+    std::vector<Step> m_steps;
+    BarrierBatch m_finalBarriers; // Moves imported images to their final layout
+    Stats m_stats;
+    bool m_compiled = false;
+
+    void cullPasses();
+    void computeLifetimes();
+    void allocateTransients();
+    void planBarriers();
+    void destroyTransients();
+
+    uint32_t assignSlot(const VkMemoryRequirements& requirements, VulkanResourceKind kind,
+                        uint32_t firstPass, uint32_t lastPass);
+
+    static void recordBarriers(VkCommandBuffer cmd, const BarrierBatch& batch,
+                               const std::vector<ImageResource>& images,
+                               const std::vector<BufferResource>& buffers);
+};
+
+#endif // VULKAN_RENDER_GRAPH_H
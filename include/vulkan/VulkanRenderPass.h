@@ -5,7 +5,12 @@
 
 class VulkanRenderPass {
 public:
-    VulkanRenderPass(VkDevice device, VkFormat imageFormat);
+    // A render graph pass passes the attachment layout for both, since the graph
+    // does the transitions around it. The depth attachment, unless depthFormat is
+    // VK_FORMAT_UNDEFINED, is always in the depth attachment layout and cleared.
+    VulkanRenderPass(VkDevice device, VkFormat imageFormat, VkFormat depthFormat,
+                     VkImageLayout finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                     VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED);
     ~VulkanRenderPass();
 
     VulkanRenderPass(const VulkanRenderPass&) = delete;
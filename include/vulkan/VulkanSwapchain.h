@@ -27,6 +27,7 @@ public:
     VulkanSwapchain& operator=(const VulkanSwapchain&) = delete;
 
     [[nodiscard]] VkSwapchainKHR get() const { return m_swapchain; }
+    [[nodiscard]] const std::vector<VkImage>& getImages() const { return m_images; }
     [[nodiscard]] const std::vector<VkImageView>& getImageViews() const { return m_imageViews; }
     [[nodiscard]] VkFormat getImageFormat() const { return m_imageFormat; }
     [[nodiscard]] VkExtent2D getExtent() const { return m_extent; }
@@ -0,0 +1,58 @@
+#ifndef VULKAN_UNIFORM_RING_H
+#define VULKAN_UNIFORM_RING_H
+
+#include <vulkan/vulkan.h>
+#include <cstring>
+#include <memory>
+
+class VulkanBuffer;
+class VulkanMemoryAllocator;
+
+// Persistently mapped, host-coherent buffer split into one region per frame in
+// flight. Per-frame data is bump-allocated from the current region and bound
+// with dynamic offsets, so nothing is mapped, unmapped or overwritten while
+// the GPU may still be reading it.
+class VulkanUniformRing {
+public:
+    struct Allocation {
+        void* data = nullptr;
+        uint32_t offset = 0; // Dynamic offset into getBuffer()
+        VkDeviceSize size = 0;
+    };
+
+    VulkanUniformRing(VulkanMemoryAllocator& allocator,
+                      VkDeviceSize minOffsetAlignment,
+                      VkDeviceSize regionSize,
+                      uint32_t regionCount);
+    ~VulkanUniformRing();
+
+    VulkanUniformRing(const VulkanUniformRing&) = delete;
+    VulkanUniformRing& operator=(const VulkanUniformRing&) = delete;
+
+    // Call once the frame that last used this region has retired
+    void beginFrame(uint32_t frameIndex);
+
+    [[nodiscard]] Allocation allocate(VkDeviceSize size);
+
+    template <typename T>
+    uint32_t push(const T& value) {
+        const Allocation allocation = allocate(sizeof(T));
+        std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation.offset;
+    }
+
+    [[nodiscard]] VkBuffer getBuffer() const;
+    [[nodiscard]] VkDeviceSize getRegionSize() const { return m_regionSize; }
+    [[nodiscard]] VkDeviceSize getBytesUsed() const { return m_head - m_regionBegin; }
+
+private:
+    std::unique_ptr<VulkanBuffer> m_buffer;
+    VkDeviceSize m_alignment;
+    VkDeviceSize m_regionSize;
+    uint32_t m_regionCount;
+
+    VkDeviceSize m_regionBegin = 0;
+    VkDeviceSize m_head = 0;
+};
+
+#endif // VULKAN_UNIFORM_RING_H
@@ -0,0 +1,116 @@
+#ifndef VULKAN_UPLOAD_MANAGER_H
+#define VULKAN_UPLOAD_MANAGER_H
+
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class VulkanBuffer;
+class VulkanDevice;
+
+// Streams data into DEVICE_LOCAL buffers and images through a staging ring.
+// Copies are batched and submitted on the transfer-only queue family when
+// the device has one; completion is tracked with a timeline semaphore and
+// queue-family ownership is handed back to graphics inside the frame's
+// command buffer, so draw() never blocks on an upload.
+//
+// Upload calls are thread-safe. flush() and recordAcquireBarriers() must be
+// called from the render thread, since the transfer queue may alias the
+// graphics queue on devices without a dedicated copy engine.
+class VulkanUploadManager {
+public:
+    using Callback = std::function<void()>;
+
+    VulkanUploadManager(const VulkanDevice& device, VkDeviceSize stagingSize);
+    ~VulkanUploadManager();
+
+    VulkanUploadManager(const VulkanUploadManager&) = delete;
+    VulkanUploadManager& operator=(const VulkanUploadManager&) = delete;
+
+    // Returns a ticket that isComplete() can be polled with
+    uint64_t uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset,
+                          const void* data, VkDeviceSize size,
+                          Callback onComplete = {});
+
+    uint64_t uploadImage(VkImage dst, VkExtent3D extent, VkImageAspectFlags aspect,
+                         const void* data, VkDeviceSize size,
+                         VkImageLayout finalLayout,
+                         Callback onComplete = {});
+
+    // Submits everything recorded since the last flush
+    void flush();
+
+    // Records graphics-side ownership acquires for finished batches and fires
+    // their callbacks. Returns the timeline value the frame's submit must wait on
+    // (already reached, so the wait never stalls), or 0 when nothing was acquired.
+    uint64_t recordAcquireBarriers(VkCommandBuffer graphicsCmd);
+
+    [[nodiscard]] bool isComplete(uint64_t ticket) const;
+    [[nodiscard]] VkSemaphore getTimelineSemaphore() const { return m_timeline; }
+
+    // Blocks until every submitted batch has finished on the GPU
+    void waitIdle();
+
+private:
+    struct BufferTransfer {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    struct ImageTransfer {
+        VkImage image;
+        VkImageAspectFlags aspect;
+        VkImageLayout layout;
+    };
+
+    struct Batch {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        uint64_t value = 0;
+        VkDeviceSize stagingEnd = 0;    // Ring head after this batch's last staging copy
+        VkDeviceSize stagingBytes = 0;  // Ring bytes consumed, padding included
+        std::vector<BufferTransfer> buffers;
+        std::vector<ImageTransfer> images;
+        std::vector<Callback> callbacks;
+        std::vector<std::unique_ptr<VulkanBuffer>> dedicatedStaging;
+    };
+
+    VkDevice m_device;
+    const VulkanDevice& m_vulkanDevice;
+    VkQueue m_queue;
+    uint32_t m_transferFamily;
+    uint32_t m_graphicsFamily;
+
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> m_freeCommandBuffers;
+    VkSemaphore m_timeline = VK_NULL_HANDLE;
+    uint64_t m_nextValue = 1;
+
+    std::unique_ptr<VulkanBuffer> m_staging;
+    VkDeviceSize m_stagingSize;
+    VkDeviceSize m_stagingAlignment;
+    VkDeviceSize m_stagingHead = 0;  // Next free byte
+    VkDeviceSize m_stagingTail = 0;  // Oldest byte still in flight
+    VkDeviceSize m_stagingUsed = 0;
+    uint64_t m_stagingRetiredValue = 0;
+
+    Batch m_recording;
+    std::deque<Batch> m_inFlight;
+    mutable std::mutex m_mutex;
+
+    [[nodiscard]] bool ownershipTransferRequired() const { return m_transferFamily != m_graphicsFamily; }
+    [[nodiscard]] uint64_t completedValue() const;
+
+    void beginRecording();
+    void submitRecording();
+    void retireStaging(uint64_t completed);
+
+    // Copies data into the ring, or a dedicated staging buffer when the ring is
+    // full, and returns the {buffer, offset} to copy from
+    std::pair<VkBuffer, VkDeviceSize> stage(const void* data, VkDeviceSize size);
+};
+
+#endif // VULKAN_UPLOAD_MANAGER_H
@@ -1,5 +1,11 @@
 #include "Application.h"
 
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
 #include "CameraUBO.h"
 #include "FreeLookCamera.h"
 #include "WindowManager.h"
@@ -8,13 +14,100 @@
 #include "InputManager.h"
 #include "Logger.h"
 
-Application::Application() {
+LaunchOptions LaunchOptions::parse(int argc, char** argv) {
+    LaunchOptions options;
+
+    const auto readValue = [&](int& i) -> uint32_t {
+        if (i + 1 >= argc) {
+            throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        }
+        return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--frames") {
+            options.frameCount = readValue(i);
+        } else if (arg == "--width") {
+            options.width = readValue(i);
+        } else if (arg == "--height") {
+            options.height = readValue(i);
+        } else if (arg == "--no-validation") {
+            options.validation = false;
+        } else if (arg == "--no-dynamic-rendering") {
+            options.dynamicRendering = false;
+        } else if (arg == "--instances") {
+            options.instanceCount = readValue(i);
+        } else if (arg == "--cpu-culling") {
+            options.gpuCulling = false;
+        } else if (arg == "--sphere") {
+            options.sphereSegments = readValue(i);
+        } else if (arg == "--packed-vertices") {
+            options.packedVertices = true;
+        } else if (arg == "--animate") {
+            options.animate = true;
+        } else if (arg == "--batched") {
+            options.batched = true;
+        } else if (arg == "--mesh") {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for --mesh");
+            options.meshPath = argv[++i];
+        } else if (arg == "--scene") {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for --scene");
+            options.scenePath = argv[++i];
+        } else if (arg == "--pin-threads") {
+            options.pinThreads = true;
+        } else if (arg == "--trace") {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for --trace");
+            options.tracePath = argv[++i];
+        } else if (arg == "--trace-frames") {
+            options.traceFirstFrame = readValue(i);
+            options.traceFrameCount = readValue(i);
+        } else {
+            WARN("Ignoring unknown argument: ", arg);
+        }
+    }
+
+    return options;
+}
+
+Application::Application(const LaunchOptions& options) : m_options(options) {
+    PROFILE_THREAD("Main");
+
+#ifdef VULKANLAB_ENABLE_PROFILING
+    if (m_options.traceFrameCount > 0) {
+        CpuProfiler::captureFrames(m_options.traceFirstFrame, m_options.traceFrameCount,
+                                   m_options.tracePath.empty() ? "trace.json" : m_options.tracePath);
+    }
+#endif
+
+    VulkanConfig config;
+    config.enableValidationLayers = m_options.validation;
+    config.dynamicRendering = m_options.dynamicRendering;
+    config.stressInstanceCount = m_options.instanceCount;
+    config.gpuCulling = m_options.gpuCulling;
+    config.stressMeshSegments = m_options.sphereSegments;
+    config.packedVertices = m_options.packedVertices;
+    config.stressMeshPath = m_options.meshPath;
+    config.animateStressScene = m_options.animate;
+    config.batchedStressScene = m_options.batched;
+    config.scenePath = m_options.scenePath;
+    config.pinWorkerThreads = m_options.pinThreads;
+    config.preferredPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+
+    if (m_options.headless) {
+        config.headlessExtent = { m_options.width, m_options.height };
+        m_renderer = std::make_unique<Renderer>(nullptr, config);
+        return;
+    }
+
     m_windowManager = std::make_unique<WindowManager>();
     m_windowManager->create("VulkanLab");
 
     InputManager::initialize(m_windowManager->get());
 
-    m_renderer = std::make_unique<Renderer>(*m_windowManager);
+    m_renderer = std::make_unique<Renderer>(m_windowManager.get(), config);
 
     m_imguiLayer = std::make_unique<ImGuiLayer>(
         m_windowManager->get(),
@@ -25,6 +118,9 @@ Application::Application() {
     m_windowManager->setResizeCallback([this](int, int) {
         m_renderer->onResize();
     });
+    m_renderer->setFormatChangedCallback([this](const VulkanContext& context) {
+        m_imguiLayer->recreatePipeline(context, m_renderer->getDeletionQueue(), m_renderer->getFrameNumber());
+    });
 }
 
 Application::~Application() {
@@ -34,11 +130,59 @@ Application::~Application() {
 }
 
 void Application::run() {
+    if (m_options.headless) {
+        runHeadless();
+        return;
+    }
 
     while (!m_windowManager->shouldClose()) {
+        PROFILE_FRAME(m_frame++);
+        PROFILE_SCOPE("Frame");
+
         glfwPollEvents();
+
+        // Nothing to render into while minimized; sleep until the window changes
+        if (glfwGetWindowAttrib(m_windowManager->get(), GLFW_ICONIFIED)) {
+            glfwWaitEvents();
+            continue;
+        }
+
         InputManager::update();
+
+        if (InputManager::isKeyPressed(GLFW_KEY_F9)) {
+            writeTrace();
+        }
+
+        m_renderer->draw();
+    }
+}
+
+void Application::runHeadless() {
+    INFO("Rendering ", m_options.frameCount, " headless frames at ",
+         m_options.width, "x", m_options.height, ".");
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < m_options.frameCount; ++frame) {
+        PROFILE_FRAME(m_frame++);
+        PROFILE_SCOPE("Frame");
         m_renderer->draw();
     }
+    m_renderer->waitIdle();
+    const auto end = std::chrono::steady_clock::now();
+
+    const double totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+    const double avgMs = m_options.frameCount > 0 ? totalMs / m_options.frameCount : 0.0;
+    INFO("Headless run finished: ", totalMs, " ms total, ", avgMs, " ms/frame.");
+
+    if (!m_options.tracePath.empty() && m_options.traceFrameCount == 0) {
+        writeTrace();
+    }
 }
 
+void Application::writeTrace() const {
+#ifdef VULKANLAB_ENABLE_PROFILING
+    CpuProfiler::writeTrace(m_options.tracePath.empty() ? "trace.json" : m_options.tracePath);
+#else
+    WARN("CPU profiling is compiled out; rebuild with VULKANLAB_ENABLE_PROFILING to write traces.");
+#endif
+}
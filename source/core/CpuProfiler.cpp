@@ -0,0 +1,233 @@
+#include "CpuProfiler.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Relaxed atomics, so a reader copying a slot its owner is rewriting gets a
+// stale or torn copy to throw away rather than a data race
+struct EventSlot {
+    std::atomic<const char*> name = nullptr;
+    std::atomic<uint64_t> start = 0;
+    std::atomic<uint64_t> end = 0;
+};
+
+// Single-producer ring. The owning thread claims a slot, writes it, then
+// publishes it with a release store of head. Readers copy up to head and drop
+// whatever was claimed again meanwhile, seqlock style.
+struct ThreadBuffer {
+    std::vector<EventSlot> events = std::vector<EventSlot>(CpuProfiler::kEventsPerThread);
+    std::atomic<uint64_t> head = 0;     // Events [0, head) are complete
+    std::atomic<uint64_t> claimed = 0;  // Events [0, claimed) have been started
+    uint32_t id = 0;
+    std::string name;
+};
+
+uint64_t steadyNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Pairs a tick reading with steady_clock so ticks can be converted at export
+struct ClockReference {
+    uint64_t ticks;
+    uint64_t ns;
+};
+
+ClockReference clockReference(const uint64_t ticks) {
+    return { ticks, steadyNs() };
+}
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; // Never shrinks; outlives exiting threads
+    uint32_t nextId = 1;
+
+    // Frame-range capture state, only touched from the thread calling beginFrame()
+    uint64_t captureFirst = 0;
+    uint64_t captureEnd = 0;
+    std::filesystem::path capturePath;
+    bool captureArmed = false;
+    bool enabledBeforeCapture = true;
+    std::atomic<uint64_t> traceSince = 0; // Events that started earlier are left out of the trace
+    ClockReference start{};
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer& threadBuffer(const uint64_t ticks) {
+    thread_local ThreadBuffer* buffer = [&] {
+        auto& reg = registry();
+        std::lock_guard lock(reg.mutex);
+        if (reg.start.ticks == 0) {
+            reg.start = clockReference(ticks);
+        }
+        auto& created = reg.buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        created->id = reg.nextId++;
+        return created.get();
+    }();
+    return *buffer;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\') out << '\\';
+        out << *text;
+    }
+}
+
+}
+
+void CpuProfiler::record(const char* name, const uint64_t start, const uint64_t end) {
+    ThreadBuffer& buffer = threadBuffer(start);
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+    // The fence orders the claim before the slot's stores, so a reader that sees any of them sees the claim
+    buffer.claimed.store(head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    EventSlot& slot = buffer.events[head & (kEventsPerThread - 1)];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void CpuProfiler::setThreadName(std::string name) {
+    ThreadBuffer& buffer = threadBuffer(now());
+    std::lock_guard lock(registry().mutex);
+    buffer.name = std::move(name);
+}
+
+void CpuProfiler::beginFrame(const uint64_t frame) {
+    auto& reg = registry();
+    if (!reg.captureArmed) return;
+
+    if (frame == reg.captureFirst) {
+        reg.traceSince = now();
+        setEnabled(true);
+    } else if (frame == reg.captureEnd) {
+        setEnabled(reg.enabledBeforeCapture);
+        reg.captureArmed = false;
+        writeTrace(reg.capturePath);
+        reg.traceSince = 0;
+    }
+}
+
+void CpuProfiler::captureFrames(const uint64_t first, const uint64_t count, std::filesystem::path path) {
+    auto& reg = registry();
+    reg.captureFirst = first;
+    reg.captureEnd = first + count;
+    reg.capturePath = std::move(path);
+    reg.captureArmed = count > 0;
+    reg.enabledBeforeCapture = isEnabled();
+
+    // Nothing outside the range should end up in the trace
+    setEnabled(false);
+}
+
+bool CpuProfiler::writeTrace(const std::filesystem::path& path) {
+    struct ThreadEvents {
+        uint32_t id;
+        std::string name;
+        std::vector<Event> events;
+    };
+    std::vector<ThreadEvents> threads;
+    auto& reg = registry();
+    const uint64_t since = reg.traceSince;
+
+    {
+        std::lock_guard lock(reg.mutex);
+        for (const auto& buffer : reg.buffers) {
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            const uint64_t first = head > kEventsPerThread ? head - kEventsPerThread : 0;
+
+            ThreadEvents copy { buffer->id, buffer->name, {} };
+            copy.events.reserve(head - first);
+            for (uint64_t i = first; i < head; ++i) {
+                const EventSlot& slot = buffer->events[i & (kEventsPerThread - 1)];
+                copy.events.push_back({ slot.name.load(std::memory_order_relaxed),
+                                        slot.start.load(std::memory_order_relaxed),
+                                        slot.end.load(std::memory_order_relaxed) });
+            }
+
+            // Drop the oldest entries if the producer lapped us while copying; the fence makes
+            // any claim whose stores the copy saw visible to the load below
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t claimed = buffer->claimed.load(std::memory_order_relaxed);
+            const uint64_t overwritten = claimed > kEventsPerThread ? claimed - kEventsPerThread : 0;
+            if (overwritten > first) {
+                const auto drop = std::min<uint64_t>(overwritten - first, copy.events.size());
+                copy.events.erase(copy.events.begin(), copy.events.begin() + static_cast<std::ptrdiff_t>(drop));
+            }
+
+            threads.push_back(std::move(copy));
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        WARN("Failed to write CPU trace to ", path.string());
+        return false;
+    }
+
+    // Tick rate measured over the whole run; exact for steady_clock, and the TSC is
+    // invariant on every x86-64 CPU we target
+    const ClockReference end = clockReference(now());
+    const double nsPerTick = end.ticks > reg.start.ticks
+        ? static_cast<double>(end.ns - reg.start.ns) / static_cast<double>(end.ticks - reg.start.ticks)
+        : 1.0;
+
+    // Timestamps are relative to the earliest event so the viewer starts at zero
+    uint64_t origin = UINT64_MAX;
+    for (const auto& thread : threads) {
+        for (const Event& event : thread.events) {
+            if (event.name && event.start >= since) origin = std::min(origin, event.start);
+        }
+    }
+
+    size_t eventCount = 0;
+    bool firstEvent = true;
+    const auto separator = [&]() -> const char* {
+        if (firstEvent) { firstEvent = false; return "\n"; }
+        return ",\n";
+    };
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto& thread : threads) {
+        if (!thread.name.empty()) {
+            file << separator() << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << thread.id
+                 << R"(,"args":{"name":")";
+            writeEscaped(file, thread.name.c_str());
+            file << "\"}}";
+        }
+
+        for (const Event& event : thread.events) {
+            if (!event.name || event.start < since) continue;
+            file << separator() << R"({"name":")";
+            writeEscaped(file, event.name);
+            file << R"(","ph":"X","pid":1,"tid":)" << thread.id
+                 << ",\"ts\":" << static_cast<double>(event.start - origin) * nsPerTick / 1000.0
+                 << ",\"dur\":" << static_cast<double>(event.end - event.start) * nsPerTick / 1000.0 << "}";
+            ++eventCount;
+        }
+    }
+    file << "\n]}\n";
+
+    INFO("Wrote ", eventCount, " CPU trace events to ", path.string());
+    return true;
+}
@@ -2,8 +2,12 @@
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
+#include <cstddef>
 #include <stdexcept>
 
+#include "VulkanDeletionQueue.h"
+#include "VulkanPipeline.h"
+
 ImGuiLayer::ImGuiLayer(
     GLFWwindow* window,
     const VulkanContext& context,
@@ -27,21 +31,49 @@ ImGuiLayer::ImGuiLayer(
     initInfo.QueueFamily        = context.graphicsQueueFamily;
     initInfo.Queue              = context.graphicsQueue;
     initInfo.DescriptorPool     = m_descriptorPool;
-    initInfo.MinImageCount      = config.maxFramesInFlight;
-    initInfo.ImageCount         = config.maxFramesInFlight;
+    initInfo.MinImageCount      = config.frameSlotCount;
+    initInfo.ImageCount         = config.frameSlotCount; // ImGui's buffers must outlive every frame in flight
     initInfo.RenderPass         = context.renderPass;
 
+    // ImGui builds its pipeline against the main pass's formats instead of a render pass
+    if (context.dynamicRendering) {
+        m_colorFormat = context.swapchainImageFormat;
+        initInfo.UseDynamicRendering = true;
+        initInfo.PipelineRenderingCreateInfo = {
+            .sType                      = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+            .colorAttachmentCount       = 1,
+            .pColorAttachmentFormats    = &m_colorFormat,
+            .depthAttachmentFormat      = context.depthFormat
+        };
+    }
+
     ImGui_ImplVulkan_Init(&initInfo);
+
+    createPipelineLayout();
+    s_pipeline = createPipeline(context);
 }
 
 ImGuiLayer::~ImGuiLayer() {
     vkDeviceWaitIdle(m_device);
+    vkDestroyPipeline(m_device, s_pipeline, nullptr);
+    s_pipeline = VK_NULL_HANDLE;
+    vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_textureSetLayout, nullptr);
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
     vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
 }
 
+void ImGuiLayer::recreatePipeline(const VulkanContext& context, VulkanDeletionQueue& deletionQueue,
+                                  const uint64_t lastUse) {
+    const VkPipeline pipeline = createPipeline(context);
+    deletionQueue.retire(lastUse, [device = m_device, old = s_pipeline] {
+        vkDestroyPipeline(device, old, nullptr);
+    });
+    s_pipeline = pipeline;
+}
+
 void ImGuiLayer::createDescriptorPool() {
     VkDescriptorPoolSize poolSizes[] = {
         { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000 },
@@ -59,6 +91,183 @@ void ImGuiLayer::createDescriptorPool() {
     }
 }
 
+void ImGuiLayer::createPipelineLayout() {
+    // Defined exactly like the backend's, so its descriptor sets and push constants
+    // stay compatible with pipelines built on this layout
+    VkDescriptorSetLayoutBinding textureBinding {
+        .binding            = 0,
+        .descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .descriptorCount    = 1,
+        .stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT
+    };
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo {
+        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount   = 1,
+        .pBindings      = &textureBinding
+    };
+
+    if (vkCreateDescriptorSetLayout(m_device, &setLayoutInfo, nullptr, &m_textureSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create ImGui descriptor set layout.");
+    }
+
+    // Scale and translate into clip space
+    VkPushConstantRange pushConstantRange {
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+        .offset     = 0,
+        .size       = sizeof(float) * 4
+    };
+
+    VkPipelineLayoutCreateInfo layoutInfo {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount         = 1,
+        .pSetLayouts            = &m_textureSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &pushConstantRange
+    };
+
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create ImGui pipeline layout.");
+    }
+}
+
+VkPipeline ImGuiLayer::createPipeline(const VulkanContext& context) const {
+    VkShaderModule vertShader = VulkanPipeline::loadShaderModule(m_device, VULKANLAB_SHADER_DIR "/imgui.vert.spv");
+    VkShaderModule fragShader = VulkanPipeline::loadShaderModule(m_device, VULKANLAB_SHADER_DIR "/imgui.frag.spv");
+
+    const VkPipelineShaderStageCreateInfo shaderStages[] = {
+        {
+            .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage  = VK_SHADER_STAGE_VERTEX_BIT,
+            .module = vertShader,
+            .pName  = "main"
+        },
+        {
+            .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage  = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .module = fragShader,
+            .pName  = "main"
+        }
+    };
+
+    VkVertexInputBindingDescription binding {
+        .binding    = 0,
+        .stride     = sizeof(ImDrawVert),
+        .inputRate  = VK_VERTEX_INPUT_RATE_VERTEX
+    };
+
+    const VkVertexInputAttributeDescription attributes[] = {
+        { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT, .offset = offsetof(ImDrawVert, pos) },
+        { .location = 1, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT, .offset = offsetof(ImDrawVert, uv) },
+        { .location = 2, .binding = 0, .format = VK_FORMAT_R8G8B8A8_UNORM, .offset = offsetof(ImDrawVert, col) }
+    };
+
+    VkPipelineVertexInputStateCreateInfo vertexInput {
+        .sType                              = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount      = 1,
+        .pVertexBindingDescriptions         = &binding,
+        .vertexAttributeDescriptionCount    = 3,
+        .pVertexAttributeDescriptions       = attributes
+    };
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly {
+        .sType      = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .topology   = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+    };
+
+    VkPipelineViewportStateCreateInfo viewportState {
+        .sType          = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount  = 1,
+        .scissorCount   = 1
+    };
+
+    VkPipelineRasterizationStateCreateInfo rasterizer {
+        .sType          = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode    = VK_POLYGON_MODE_FILL,
+        .cullMode       = VK_CULL_MODE_NONE,
+        .frontFace      = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .lineWidth      = 1.0f
+    };
+
+    VkPipelineMultisampleStateCreateInfo multisampling {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .rasterizationSamples   = VK_SAMPLE_COUNT_1_BIT
+    };
+
+    // Drawn over the scene, so depth is neither tested nor written
+    VkPipelineDepthStencilStateCreateInfo depthStencil {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO
+    };
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment {
+        .blendEnable            = VK_TRUE,
+        .srcColorBlendFactor    = VK_BLEND_FACTOR_SRC_ALPHA,
+        .dstColorBlendFactor    = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+        .colorBlendOp           = VK_BLEND_OP_ADD,
+        .srcAlphaBlendFactor    = VK_BLEND_FACTOR_ONE,
+        .dstAlphaBlendFactor    = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+        .alphaBlendOp           = VK_BLEND_OP_ADD,
+        .colorWriteMask         = VK_COLOR_COMPONENT_R_BIT |
+                                  VK_COLOR_COMPONENT_G_BIT |
+                                  VK_COLOR_COMPONENT_B_BIT |
+                                  VK_COLOR_COMPONENT_A_BIT
+    };
+
+    VkPipelineColorBlendStateCreateInfo colorBlending {
+        .sType              = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .attachmentCount    = 1,
+        .pAttachments       = &colorBlendAttachment
+    };
+
+    const VkDynamicState dynamicStates[] = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR
+    };
+
+    VkPipelineDynamicStateCreateInfo dynamicState {
+        .sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount  = 2,
+        .pDynamicStates     = dynamicStates
+    };
+
+    // Same attachments as the main pass it is recorded in
+    VkPipelineRenderingCreateInfo renderingInfo {
+        .sType                      = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount       = 1,
+        .pColorAttachmentFormats    = &context.swapchainImageFormat,
+        .depthAttachmentFormat      = context.depthFormat
+    };
+
+    VkGraphicsPipelineCreateInfo pipelineInfo {
+        .sType                  = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext                  = context.dynamicRendering ? &renderingInfo : nullptr,
+        .stageCount             = 2,
+        .pStages                = shaderStages,
+        .pVertexInputState      = &vertexInput,
+        .pInputAssemblyState    = &inputAssembly,
+        .pViewportState         = &viewportState,
+        .pRasterizationState    = &rasterizer,
+        .pMultisampleState      = &multisampling,
+        .pDepthStencilState     = &depthStencil,
+        .pColorBlendState       = &colorBlending,
+        .pDynamicState          = &dynamicState,
+        .layout                 = m_pipelineLayout,
+        .renderPass             = context.dynamicRendering ? VK_NULL_HANDLE : context.renderPass,
+        .subpass                = 0
+    };
+
+    VkPipeline pipeline;
+    const VkResult result = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+
+    vkDestroyShaderModule(m_device, vertShader, nullptr);
+    vkDestroyShaderModule(m_device, fragShader, nullptr);
+
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create ImGui pipeline.");
+    }
+    return pipeline;
+}
+
 void ImGuiLayer::beginFrame() {
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -67,7 +276,7 @@ void ImGuiLayer::beginFrame() {
 
 void ImGuiLayer::endFrame(VkCommandBuffer cmd) {
     ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd, s_pipeline);
 }
 
 void ImGuiLayer::rebuildFontAtlas(VkCommandBuffer cmd) {
@@ -1,6 +1,8 @@
 #include "InputManager.h"
 #include <imgui.h>
 
+#include "Logger.h"
+
 GLFWwindow* InputManager::s_window = nullptr;
 std::unordered_map<int, bool> InputManager::s_keys;
 std::unordered_map<int, bool> InputManager::s_prevKeys;
@@ -21,6 +23,8 @@ void InputManager::initialize(GLFWwindow* window) {
 }
 
 void InputManager::update() {
+    PROFILE_FUNCTION();
+
     // Store previous states
     s_prevKeys = s_keys;
     s_prevMouseButtons = s_mouseButtons;
@@ -0,0 +1,415 @@
+#include "JobSystem.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Per worker; pushes beyond this run inline instead of queueing
+constexpr int64_t kDequeCapacity = 4096;
+constexpr uint32_t kJobsPerBlock = 256;
+
+// Failed steal rounds before a worker goes to sleep, and before a waiter yields
+constexpr uint32_t kSpinsBeforeSleep = 256;
+constexpr uint32_t kSpinsBeforeYield = 64;
+
+constexpr size_t kCacheLine = 64;
+
+thread_local const void* t_system = nullptr;
+thread_local uint32_t t_worker = 0;
+
+void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+void pinCurrentThread(const uint32_t core) {
+#if defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (core % 64));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        WARN("Failed to pin worker thread to core ", core);
+    }
+#else
+    (void)core;
+#endif
+}
+
+// Fixed-capacity Chase-Lev deque with the C11 orderings from Lê et al.,
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (2013); push
+// publishes with a release store rather than a fence, which is the same cost
+// on x86 and is something ThreadSanitizer can follow.
+// push/pop are owner-only; steal may be called from any thread.
+template<typename T>
+class WorkStealingDeque {
+public:
+    bool push(const T item) {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= kDequeCapacity) return false;
+
+        m_items[bottom & (kDequeCapacity - 1)].store(item, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    T pop() {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return T {};
+        }
+
+        T item = m_items[bottom & (kDequeCapacity - 1)].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last item: race any thief for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = T {};
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T steal() {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) return T {};
+
+        T item = m_items[top & (kDequeCapacity - 1)].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return T {};
+        }
+        return item;
+    }
+
+private:
+    alignas(kCacheLine) std::atomic<int64_t> m_top = 0;
+    alignas(kCacheLine) std::atomic<int64_t> m_bottom = 0;
+    alignas(kCacheLine) std::atomic<T> m_items[kDequeCapacity] {};
+};
+
+}
+
+struct alignas(kCacheLine) JobSystem::Worker {
+    WorkStealingDeque<Job*> deque;
+
+    // Only this worker pops freeJobs; others hand jobs back through remoteFree,
+    // which it takes over wholesale when its own list runs dry
+    Job* freeJobs = nullptr;
+    alignas(kCacheLine) std::atomic<Job*> remoteFree = nullptr;
+    std::vector<std::unique_ptr<Job[]>> blocks;
+
+    uint32_t random = 0;    // xorshift state for picking steal victims
+};
+
+JobSystem::JobSystem(const uint32_t threadCount) : JobSystem(Options { .threadCount = threadCount }) {}
+
+JobSystem::JobSystem(const Options& options) {
+    uint32_t threadCount = options.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(threadCount);
+    for (uint32_t worker = 0; worker < threadCount; ++worker) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->random = 0x9E3779B9u * (worker + 1);
+    }
+
+    m_threads.reserve(threadCount - 1);
+    for (uint32_t worker = 1; worker < threadCount; ++worker) {
+        m_threads.emplace_back(&JobSystem::workerLoop, this, worker, options.pinThreads);
+    }
+
+    DEBUG("Job system started with ", threadCount, " threads", options.pinThreads ? " (pinned)." : ".");
+}
+
+JobSystem::~JobSystem() {
+    m_stop.store(true, std::memory_order_seq_cst);
+    m_wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+    m_wakeEpoch.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+uint32_t JobSystem::getCurrentWorker() const {
+    return t_system == this ? t_worker : 0;
+}
+
+void JobSystem::spawn(JobFunction job, JobCounter* counter) {
+    const uint32_t worker = getCurrentWorker();
+    if (counter) counter->m_state.fetch_add(1, std::memory_order_relaxed);
+
+    Job* entry = allocateJob(worker);
+    entry->function = std::move(job);
+    entry->counter = counter;
+    push(entry, worker);
+}
+
+void JobSystem::spawnAfter(JobCounter& dependency, JobFunction job, JobCounter* counter) {
+    const uint32_t worker = getCurrentWorker();
+    if (counter) counter->m_state.fetch_add(1, std::memory_order_relaxed);
+
+    Job* entry = allocateJob(worker);
+    entry->function = std::move(job);
+    entry->counter = counter;
+
+    // Take the lock bit; if nothing is pending any more the job can go straight out
+    uint32_t state = dependency.m_state.load(std::memory_order_relaxed);
+    while (true) {
+        if (state & JobCounter::kLocked) {
+            cpuRelax();
+            state = dependency.m_state.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (state == 0) {
+            push(entry, worker);
+            return;
+        }
+        if (dependency.m_state.compare_exchange_weak(state, state | JobCounter::kLocked, std::memory_order_acquire,
+                                                     std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    entry->next = dependency.m_continuations;
+    dependency.m_continuations = entry;
+    dependency.m_state.fetch_and(~JobCounter::kLocked, std::memory_order_release);
+}
+
+void JobSystem::wait(const JobCounter& counter) {
+    const uint32_t worker = getCurrentWorker();
+    uint32_t idle = 0;
+    while (!counter.isDone()) {
+        if (Job* job = findJob(worker)) {
+            execute(job, worker);
+            idle = 0;
+        } else if (++idle < kSpinsBeforeYield) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(const uint32_t count, const Task& task) {
+    if (count == 0) return;
+
+    // Not worth waking anyone for a single task
+    if (count == 1 || getThreadCount() == 1) {
+        const uint32_t worker = getCurrentWorker();
+        for (uint32_t i = 0; i < count; ++i) task(i, worker);
+        return;
+    }
+
+    parallelFor(count, 1, [&task](const uint32_t begin, const uint32_t end, const uint32_t worker) {
+        for (uint32_t i = begin; i < end; ++i) task(i, worker);
+    });
+}
+
+void JobSystem::parallelFor(const uint32_t count, uint32_t grain, const RangeTask& task) {
+    if (count == 0) return;
+
+    if (grain == 0) {
+        grain = std::max(1u, count / (getThreadCount() * 8));
+    }
+
+    const uint32_t worker = getCurrentWorker();
+    if (count <= grain || getThreadCount() == 1) {
+        task(0, count, worker);
+        return;
+    }
+
+    JobCounter counter;
+    const RangeSplit split { .system = this, .task = &task, .counter = &counter, .grain = grain };
+    splitRange(split, 0, count, worker);
+    wait(counter);
+}
+
+void JobSystem::workerLoop(const uint32_t worker, const bool pin) {
+    t_system = this;
+    t_worker = worker;
+    PROFILE_THREAD("Worker " + std::to_string(worker));
+
+    if (pin) {
+        pinCurrentThread(worker % std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    uint32_t idle = 0;
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        if (Job* job = findJob(worker)) {
+            execute(job, worker);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < kSpinsBeforeSleep) {
+            cpuRelax();
+            continue;
+        }
+
+        // Announce the sleep before the last look, so a push either shows up
+        // here or sees the sleeper and bumps the epoch
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        const uint32_t epoch = m_wakeEpoch.load(std::memory_order_seq_cst);
+        Job* job = findJob(worker);
+        if (!job && !m_stop.load(std::memory_order_seq_cst)) {
+            m_wakeEpoch.wait(epoch, std::memory_order_seq_cst);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+        if (job) execute(job, worker);
+        idle = 0;
+    }
+}
+
+JobSystem::Job* JobSystem::allocateJob(const uint32_t worker) {
+    Worker& owner = *m_workers[worker];
+    if (!owner.freeJobs) {
+        owner.freeJobs = owner.remoteFree.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    if (!owner.freeJobs) {
+        auto& block = owner.blocks.emplace_back(std::make_unique<Job[]>(kJobsPerBlock));
+        for (uint32_t i = 0; i < kJobsPerBlock; ++i) {
+            block[i].owner = worker;
+            block[i].next = i + 1 < kJobsPerBlock ? &block[i + 1] : nullptr;
+        }
+        owner.freeJobs = &block[0];
+    }
+
+    Job* job = owner.freeJobs;
+    owner.freeJobs = job->next;
+    job->next = nullptr;
+    return job;
+}
+
+void JobSystem::freeJob(Job* job, const uint32_t worker) {
+    job->function = nullptr;
+    job->counter = nullptr;
+
+    if (job->owner == worker) {
+        job->next = m_workers[worker]->freeJobs;
+        m_workers[worker]->freeJobs = job;
+        return;
+    }
+
+    // Push-only stack; the owner only ever takes the whole list, so there is no ABA
+    std::atomic<Job*>& remote = m_workers[job->owner]->remoteFree;
+    job->next = remote.load(std::memory_order_relaxed);
+    while (!remote.compare_exchange_weak(job->next, job, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+void JobSystem::push(Job* job, const uint32_t worker) {
+    // A full deque means plenty of queued work already; run this one here rather than block
+    if (!m_workers[worker]->deque.push(job)) {
+        execute(job, worker);
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) > 0) {
+        m_wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+        m_wakeEpoch.notify_one();
+    }
+}
+
+JobSystem::Job* JobSystem::findJob(const uint32_t worker) {
+    Worker& self = *m_workers[worker];
+    if (Job* job = self.deque.pop()) return job;
+
+    const auto count = static_cast<uint32_t>(m_workers.size());
+    if (count == 1) return nullptr;
+
+    self.random ^= self.random << 13;
+    self.random ^= self.random >> 17;
+    self.random ^= self.random << 5;
+
+    const uint32_t start = self.random % count;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t victim = (start + i) % count;
+        if (victim == worker) continue;
+        if (Job* job = m_workers[victim]->deque.steal()) return job;
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job, const uint32_t worker) {
+    job->function(worker);
+
+    JobCounter* counter = job->counter;
+    freeJob(job, worker);
+    if (counter) release(*counter, worker);
+}
+
+void JobSystem::release(JobCounter& counter, const uint32_t worker) {
+    // The last job takes the lock bit along with the zero, so waiters keep
+    // waiting until the continuations are out and the counter is untouched
+    uint32_t state = counter.m_state.load(std::memory_order_relaxed);
+    while (true) {
+        const bool last = (state & ~JobCounter::kLocked) == 1;
+        if (last && (state & JobCounter::kLocked)) {
+            cpuRelax();
+            state = counter.m_state.load(std::memory_order_relaxed);
+            continue;
+        }
+        const uint32_t next = last ? JobCounter::kLocked : state - 1;
+        if (counter.m_state.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            if (!last) return;
+            break;
+        }
+    }
+
+    Job* continuation = std::exchange(counter.m_continuations, nullptr);
+    counter.m_state.store(0, std::memory_order_release);
+
+    while (continuation) {
+        Job* next = continuation->next;
+        continuation->next = nullptr;
+        push(continuation, worker);
+        continuation = next;
+    }
+}
+
+void JobSystem::splitRange(const RangeSplit& split, const uint32_t begin, uint32_t end, const uint32_t worker) {
+    // Hand the upper half out and keep splitting the lower one, so a thief
+    // always takes the biggest piece left. The capture stays within
+    // std::function's small buffer, so spawning here does not allocate.
+    while (end - begin > split.grain) {
+        const uint32_t middle = begin + (end - begin) / 2;
+        spawn([split = &split, middle, end](const uint32_t thief) {
+            split->system->splitRange(*split, middle, end, thief);
+        }, split.counter);
+        end = middle;
+    }
+    (*split.task)(begin, end, worker);
+}
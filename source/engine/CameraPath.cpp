@@ -0,0 +1,69 @@
+#include "CameraPath.h"
+
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+#include <stdexcept>
+
+namespace {
+
+glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t) {
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    return 0.5f * ((2.0f * p1) +
+                   (-p0 + p2) * t +
+                   (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+}
+
+glm::quat lookRotation(const glm::vec3& forwardDir) {
+    const glm::vec3 forward = glm::normalize(forwardDir);
+    const glm::vec3 worldUp = std::abs(forward.z) > 0.999f ? glm::vec3(1, 0, 0) : glm::vec3(0, 0, 1);
+    const glm::vec3 left = glm::normalize(glm::cross(worldUp, forward));
+    const glm::vec3 up = glm::cross(forward, left);
+
+    // Columns are where X+, Y+ and Z+ end up
+    return glm::normalize(glm::quat_cast(glm::mat3(forward, left, up)));
+}
+
+}
+
+CameraPath::CameraPath(std::vector<Keyframe> keyframes) : m_keyframes(std::move(keyframes)) {
+    if (m_keyframes.size() < 2) {
+        throw std::runtime_error("Camera path needs at least two keyframes.");
+    }
+}
+
+CameraPath::Pose CameraPath::sample(float t) const {
+    const auto count = static_cast<int>(m_keyframes.size());
+    t -= std::floor(t);
+
+    const float scaled = t * static_cast<float>(count);
+    const int segment = static_cast<int>(scaled) % count;
+    const float local = scaled - std::floor(scaled);
+
+    const auto at = [&](const int i) -> const Keyframe& { return m_keyframes[(i + count) % count]; };
+    const Keyframe& k0 = at(segment - 1);
+    const Keyframe& k1 = at(segment);
+    const Keyframe& k2 = at(segment + 1);
+    const Keyframe& k3 = at(segment + 2);
+
+    const glm::vec3 position = catmullRom(k0.position, k1.position, k2.position, k3.position, local);
+    const glm::vec3 target = catmullRom(k0.target, k1.target, k2.target, k3.target, local);
+
+    return { position, lookRotation(target - position) };
+}
+
+CameraPath CameraPath::orbit(const float radius, const float height, const uint32_t keyframeCount) {
+    std::vector<Keyframe> keyframes;
+    keyframes.reserve(keyframeCount);
+
+    for (uint32_t i = 0; i < keyframeCount; ++i) {
+        const float angle = 2.0f * glm::pi<float>() * static_cast<float>(i) / static_cast<float>(keyframeCount);
+        keyframes.push_back({
+            .position = { radius * std::cos(angle), radius * std::sin(angle), height },
+            .target = { 0.0f, 0.0f, 0.0f }
+        });
+    }
+
+    return CameraPath(std::move(keyframes));
+}
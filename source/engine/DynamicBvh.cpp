@@ -0,0 +1,809 @@
+#include "DynamicBvh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define VULKANLAB_BVH_SSE 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Binned SAH build
+constexpr uint32_t kBinCount = 16;
+// Ranges at least this large build their left half as a separate job
+constexpr uint32_t kParallelBuildThreshold = 4096;
+// Rotations must shrink the surface area by at least this much, so float
+// noise cannot make two equivalent layouts swap back and forth
+constexpr float kRotationEpsilon = 1e-6f;
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+float axisValue(const glm::vec3& v, const uint32_t axis) {
+    return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+// Per-plane coefficients plus, for each plane, which side of a box is its
+// positive vertex (the corner furthest along the normal)
+struct QueryPlanes {
+    float x[Frustum::PlaneCount], y[Frustum::PlaneCount], z[Frustum::PlaneCount], w[Frustum::PlaneCount];
+    bool positiveX[Frustum::PlaneCount], positiveY[Frustum::PlaneCount], positiveZ[Frustum::PlaneCount];
+
+    explicit QueryPlanes(const Frustum& frustum) {
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            x[p] = frustum.planes[p].x;
+            y[p] = frustum.planes[p].y;
+            z[p] = frustum.planes[p].z;
+            w[p] = frustum.planes[p].w;
+            positiveX[p] = x[p] >= 0.0f;
+            positiveY[p] = y[p] >= 0.0f;
+            positiveZ[p] = z[p] >= 0.0f;
+        }
+    }
+};
+
+constexpr uint32_t kAllPlanes = (1u << Frustum::PlaneCount) - 1;
+
+// Lane tests over one wide node. Each returns a bitmask of the lanes in
+// lanes (the node's occupied children) that pass.
+//
+// The frustum test is the positive/negative vertex form, which is monotonic
+// under containment: a child is never visible when its parent is culled, or
+// partially inside a plane its parent is entirely inside of.
+
+#if VULKANLAB_BVH_SSE
+
+template<typename Node>
+uint32_t frustumLanes(const Node& node, const QueryPlanes& planes, const uint32_t activePlanes, uint32_t lanes,
+                      uint32_t inside[Frustum::PlaneCount]) {
+    for (uint32_t active = activePlanes; active != 0; active &= active - 1) {
+        const int p = std::countr_zero(active);
+        const __m128 nx = _mm_set1_ps(planes.x[p]);
+        const __m128 ny = _mm_set1_ps(planes.y[p]);
+        const __m128 nz = _mm_set1_ps(planes.z[p]);
+        const __m128 w = _mm_set1_ps(planes.w[p]);
+
+        const __m128 positive = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(planes.positiveX[p] ? node.maxX : node.minX)),
+                       _mm_mul_ps(ny, _mm_load_ps(planes.positiveY[p] ? node.maxY : node.minY))),
+            _mm_add_ps(_mm_mul_ps(nz, _mm_load_ps(planes.positiveZ[p] ? node.maxZ : node.minZ)), w));
+        const __m128 negative = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(planes.positiveX[p] ? node.minX : node.maxX)),
+                       _mm_mul_ps(ny, _mm_load_ps(planes.positiveY[p] ? node.minY : node.maxY))),
+            _mm_add_ps(_mm_mul_ps(nz, _mm_load_ps(planes.positiveZ[p] ? node.minZ : node.maxZ)), w));
+
+        const __m128 zero = _mm_setzero_ps();
+        lanes &= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(positive, zero)));
+        inside[p] = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(negative, zero)));
+    }
+    return lanes;
+}
+
+template<typename Node>
+uint32_t overlapLanes(const Node& node, const Aabb& bounds, const uint32_t lanes) {
+    const __m128 x = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minX), _mm_set1_ps(bounds.max.x)),
+                                _mm_cmpge_ps(_mm_load_ps(node.maxX), _mm_set1_ps(bounds.min.x)));
+    const __m128 y = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minY), _mm_set1_ps(bounds.max.y)),
+                                _mm_cmpge_ps(_mm_load_ps(node.maxY), _mm_set1_ps(bounds.min.y)));
+    const __m128 z = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minZ), _mm_set1_ps(bounds.max.z)),
+                                _mm_cmpge_ps(_mm_load_ps(node.maxZ), _mm_set1_ps(bounds.min.z)));
+    return lanes & static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(_mm_and_ps(x, y), z)));
+}
+
+// Squared distance from the center to each box, against the squared radius
+template<typename Node>
+uint32_t sphereLanes(const Node& node, const glm::vec3& center, const float radius, const uint32_t lanes) {
+    const __m128 zero = _mm_setzero_ps();
+    const auto axisDistance = [&](const float* min, const float* max, const float c) {
+        const __m128 value = _mm_set1_ps(c);
+        const __m128 d = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(min), value),
+                                               _mm_sub_ps(value, _mm_load_ps(max))), zero);
+        return _mm_mul_ps(d, d);
+    };
+    const __m128 distance = _mm_add_ps(_mm_add_ps(axisDistance(node.minX, node.maxX, center.x),
+                                                  axisDistance(node.minY, node.maxY, center.y)),
+                                       axisDistance(node.minZ, node.maxZ, center.z));
+    return lanes & static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(distance, _mm_set1_ps(radius * radius))));
+}
+
+// Slab test; entry receives where the ray enters each box
+template<typename Node>
+uint32_t rayLanes(const Node& node, const glm::vec3& origin, const glm::vec3& inverse, const float maxDistance,
+                  const uint32_t lanes, float entry[4]) {
+    const auto slab = [](const float* min, const float* max, const float o, const float inv, __m128& near,
+                         __m128& far) {
+        const __m128 value = _mm_set1_ps(o);
+        const __m128 scale = _mm_set1_ps(inv);
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(min), value), scale);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(max), value), scale);
+        near = _mm_min_ps(t0, t1);
+        far = _mm_max_ps(t0, t1);
+    };
+    __m128 nearX, farX, nearY, farY, nearZ, farZ;
+    slab(node.minX, node.maxX, origin.x, inverse.x, nearX, farX);
+    slab(node.minY, node.maxY, origin.y, inverse.y, nearY, farY);
+    slab(node.minZ, node.maxZ, origin.z, inverse.z, nearZ, farZ);
+
+    const __m128 near = _mm_max_ps(_mm_max_ps(nearX, nearY), _mm_max_ps(nearZ, _mm_setzero_ps()));
+    const __m128 far = _mm_min_ps(_mm_min_ps(farX, farY), _mm_min_ps(farZ, _mm_set1_ps(maxDistance)));
+    _mm_storeu_ps(entry, near);
+    return lanes & static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(near, far)));
+}
+
+#else
+
+template<typename Node>
+uint32_t frustumLanes(const Node& node, const QueryPlanes& planes, const uint32_t activePlanes, uint32_t lanes,
+                      uint32_t inside[Frustum::PlaneCount]) {
+    for (uint32_t active = activePlanes; active != 0; active &= active - 1) {
+        const int p = std::countr_zero(active);
+        inside[p] = 0;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            const float positive = planes.x[p] * (planes.positiveX[p] ? node.maxX : node.minX)[lane] +
+                                   planes.y[p] * (planes.positiveY[p] ? node.maxY : node.minY)[lane] +
+                                   (planes.z[p] * (planes.positiveZ[p] ? node.maxZ : node.minZ)[lane] + planes.w[p]);
+            const float negative = planes.x[p] * (planes.positiveX[p] ? node.minX : node.maxX)[lane] +
+                                   planes.y[p] * (planes.positiveY[p] ? node.minY : node.maxY)[lane] +
+                                   (planes.z[p] * (planes.positiveZ[p] ? node.minZ : node.maxZ)[lane] + planes.w[p]);
+            if (!(positive >= 0.0f)) lanes &= ~(1u << lane);
+            if (negative >= 0.0f) inside[p] |= 1u << lane;
+        }
+    }
+    return lanes;
+}
+
+template<typename Node>
+uint32_t overlapLanes(const Node& node, const Aabb& bounds, uint32_t lanes) {
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        const bool overlaps = node.minX[lane] <= bounds.max.x && node.maxX[lane] >= bounds.min.x &&
+                              node.minY[lane] <= bounds.max.y && node.maxY[lane] >= bounds.min.y &&
+                              node.minZ[lane] <= bounds.max.z && node.maxZ[lane] >= bounds.min.z;
+        if (!overlaps) lanes &= ~(1u << lane);
+    }
+    return lanes;
+}
+
+template<typename Node>
+uint32_t sphereLanes(const Node& node, const glm::vec3& center, const float radius, uint32_t lanes) {
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        const float dx = std::max(std::max(node.minX[lane] - center.x, center.x - node.maxX[lane]), 0.0f);
+        const float dy = std::max(std::max(node.minY[lane] - center.y, center.y - node.maxY[lane]), 0.0f);
+        const float dz = std::max(std::max(node.minZ[lane] - center.z, center.z - node.maxZ[lane]), 0.0f);
+        if (!(dx * dx + dy * dy + dz * dz <= radius * radius)) lanes &= ~(1u << lane);
+    }
+    return lanes;
+}
+
+template<typename Node>
+uint32_t rayLanes(const Node& node, const glm::vec3& origin, const glm::vec3& inverse, const float maxDistance,
+                  uint32_t lanes, float entry[4]) {
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        const float x0 = (node.minX[lane] - origin.x) * inverse.x, x1 = (node.maxX[lane] - origin.x) * inverse.x;
+        const float y0 = (node.minY[lane] - origin.y) * inverse.y, y1 = (node.maxY[lane] - origin.y) * inverse.y;
+        const float z0 = (node.minZ[lane] - origin.z) * inverse.z, z1 = (node.maxZ[lane] - origin.z) * inverse.z;
+        const float near = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), 0.0f));
+        const float far = std::min(std::min(std::max(x0, x1), std::max(y0, y1)),
+                                   std::min(std::max(z0, z1), maxDistance));
+        entry[lane] = near;
+        if (!(near <= far)) lanes &= ~(1u << lane);
+    }
+    return lanes;
+}
+
+#endif
+
+// Zero components become tiny ones of the same sign, so the slab test sees
+// huge but finite distances instead of 0 * inf
+float safeInverse(const float value) {
+    constexpr float kTiny = 1e-30f;
+    return 1.0f / (std::abs(value) > kTiny ? value : std::copysign(kTiny, value));
+}
+
+struct BuildPrimitive {
+    Aabb bounds;
+    glm::vec3 centroid;
+    uint32_t proxy;
+};
+
+}
+
+DynamicBvh::DynamicBvh() : DynamicBvh(Options {}) {}
+
+DynamicBvh::DynamicBvh(const Options& options) : m_options(options) {}
+
+uint32_t DynamicBvh::insert(const Aabb& bounds, const uint32_t userData) {
+    uint32_t proxy;
+    if (!m_freeProxies.empty()) {
+        proxy = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    } else {
+        proxy = static_cast<uint32_t>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+
+    const uint32_t leaf = allocateNode();
+    m_nodes[leaf].bounds = bounds.expanded(m_options.margin);
+    m_nodes[leaf].proxy = proxy;
+    m_proxies[proxy] = { .bounds = bounds, .node = leaf, .userData = userData };
+
+    insertLeaf(leaf);
+    ++m_proxyCount;
+    m_topologyDirty = true;
+    return proxy;
+}
+
+void DynamicBvh::remove(const uint32_t proxy) {
+    Proxy& entry = m_proxies.at(proxy);
+    if (entry.node == kInvalid) throw std::runtime_error("DynamicBvh proxy removed twice");
+
+    removeLeaf(entry.node);
+    freeNode(entry.node);
+    entry.node = kInvalid;
+    m_freeProxies.push_back(proxy);
+    --m_proxyCount;
+    m_topologyDirty = true;
+}
+
+bool DynamicBvh::update(const uint32_t proxy, const Aabb& bounds) {
+    Proxy& entry = m_proxies[proxy];
+    entry.bounds = bounds;
+    m_boundsDirty = true;
+    if (m_nodes[entry.node].bounds.contains(bounds)) return false;
+
+    const uint32_t leaf = entry.node;
+    removeLeaf(leaf);
+    m_nodes[leaf].bounds = bounds.expanded(m_options.margin);
+    insertLeaf(leaf);
+    m_topologyDirty = true;
+    return true;
+}
+
+void DynamicBvh::clear() {
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_root = kInvalid;
+    m_proxies.clear();
+    m_freeProxies.clear();
+    m_proxyCount = 0;
+    m_wideNodes.clear();
+    m_topologyDirty = true;
+    m_boundsDirty = true;
+}
+
+uint32_t DynamicBvh::allocateNode() {
+    if (!m_freeNodes.empty()) {
+        const uint32_t node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        return node;
+    }
+    m_nodes.emplace_back();
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void DynamicBvh::freeNode(const uint32_t node) {
+    m_nodes[node] = Node {};
+    m_freeNodes.push_back(node);
+}
+
+// Branch and bound over the tree (Bittner et al.): the cost of making node
+// the sibling is the area of the new parent plus the growth of every
+// ancestor, and no descendant can cost less than the new leaf's own area plus
+// what its ancestors already grew by
+uint32_t DynamicBvh::findBestSibling(const Aabb& bounds) {
+    const auto cheaper = [](const Candidate& a, const Candidate& b) { return a.inheritedCost > b.inheritedCost; };
+
+    const float leafArea = bounds.getSurfaceArea();
+    uint32_t best = m_root;
+    float bestCost = Aabb::merge(m_nodes[m_root].bounds, bounds).getSurfaceArea();
+
+    std::vector<Candidate>& heap = m_candidates;
+    heap.clear();
+    heap.push_back({ m_root, 0.0f });
+    while (!heap.empty()) {
+        std::ranges::pop_heap(heap, cheaper);
+        const Candidate candidate = heap.back();
+        heap.pop_back();
+        if (candidate.inheritedCost + leafArea >= bestCost) break;
+
+        const Node& node = m_nodes[candidate.node];
+        const float directCost = Aabb::merge(node.bounds, bounds).getSurfaceArea();
+        const float cost = directCost + candidate.inheritedCost;
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = candidate.node;
+        }
+
+        if (node.isLeaf()) continue;
+        const float childInherited = candidate.inheritedCost + directCost - node.bounds.getSurfaceArea();
+        if (childInherited + leafArea >= bestCost) continue;
+        for (const uint32_t child : node.children) {
+            heap.push_back({ child, childInherited });
+            std::ranges::push_heap(heap, cheaper);
+        }
+    }
+    return best;
+}
+
+void DynamicBvh::insertLeaf(const uint32_t leaf) {
+    if (m_root == kInvalid) {
+        m_root = leaf;
+        m_nodes[leaf].parent = kInvalid;
+        return;
+    }
+
+    const uint32_t sibling = findBestSibling(m_nodes[leaf].bounds);
+    const uint32_t oldParent = m_nodes[sibling].parent;
+    const uint32_t parent = allocateNode();
+
+    Node& node = m_nodes[parent];
+    node.parent = oldParent;
+    node.children[0] = sibling;
+    node.children[1] = leaf;
+    node.bounds = Aabb::merge(m_nodes[sibling].bounds, m_nodes[leaf].bounds);
+    m_nodes[sibling].parent = parent;
+    m_nodes[leaf].parent = parent;
+
+    if (oldParent == kInvalid) {
+        m_root = parent;
+    } else {
+        Node& grandparent = m_nodes[oldParent];
+        grandparent.children[grandparent.children[0] == sibling ? 0 : 1] = parent;
+    }
+    refitAncestors(parent);
+}
+
+void DynamicBvh::removeLeaf(const uint32_t leaf) {
+    if (leaf == m_root) {
+        m_root = kInvalid;
+        return;
+    }
+
+    const uint32_t parent = m_nodes[leaf].parent;
+    const uint32_t grandparent = m_nodes[parent].parent;
+    const uint32_t sibling = m_nodes[parent].children[m_nodes[parent].children[0] == leaf ? 1 : 0];
+
+    m_nodes[sibling].parent = grandparent;
+    freeNode(parent);
+    m_nodes[leaf].parent = kInvalid;
+
+    if (grandparent == kInvalid) {
+        m_root = sibling;
+        return;
+    }
+    Node& node = m_nodes[grandparent];
+    node.children[node.children[0] == parent ? 0 : 1] = sibling;
+    refitAncestors(grandparent);
+}
+
+void DynamicBvh::refitAncestors(uint32_t node) {
+    while (node != kInvalid) {
+        Node& current = m_nodes[node];
+        current.bounds = Aabb::merge(m_nodes[current.children[0]].bounds, m_nodes[current.children[1]].bounds);
+        rotate(node);
+        node = current.parent;
+    }
+}
+
+// Swaps a child of node with one of its grandchildren under the other child
+// when that shrinks the other child's box, the only area that changes. This
+// keeps the tree from degrading into long chains under incremental edits.
+void DynamicBvh::rotate(const uint32_t node) {
+    const uint32_t b = m_nodes[node].children[0];
+    const uint32_t c = m_nodes[node].children[1];
+
+    // Best swap so far: child of node, grandchild it trades places with
+    uint32_t child = kInvalid;
+    uint32_t grandchild = kInvalid;
+    float bestGain = kRotationEpsilon;
+
+    const auto consider = [&](const uint32_t sibling, const uint32_t parent) {
+        const Node& inner = m_nodes[parent];
+        if (inner.isLeaf()) return;
+        const float area = inner.bounds.getSurfaceArea();
+        for (int i = 0; i < 2; ++i) {
+            const Aabb merged = Aabb::merge(m_nodes[sibling].bounds, m_nodes[inner.children[1 - i]].bounds);
+            const float gain = (area - merged.getSurfaceArea()) / std::max(area, 1e-30f);
+            if (gain > bestGain) {
+                bestGain = gain;
+                child = sibling;
+                grandchild = inner.children[i];
+            }
+        }
+    };
+    consider(c, b);
+    consider(b, c);
+    if (child == kInvalid) return;
+
+    const uint32_t other = child == b ? c : b;
+    Node& parent = m_nodes[node];
+    parent.children[parent.children[0] == child ? 0 : 1] = grandchild;
+    m_nodes[grandchild].parent = node;
+
+    Node& inner = m_nodes[other];
+    inner.children[inner.children[0] == grandchild ? 0 : 1] = child;
+    m_nodes[child].parent = other;
+    inner.bounds = Aabb::merge(m_nodes[inner.children[0]].bounds, m_nodes[inner.children[1]].bounds);
+}
+
+void DynamicBvh::rebuild(JobSystem* jobs) {
+    std::vector<BuildPrimitive> primitives;
+    primitives.reserve(m_proxyCount);
+    for (uint32_t proxy = 0; proxy < static_cast<uint32_t>(m_proxies.size()); ++proxy) {
+        if (m_proxies[proxy].node == kInvalid) continue;
+        const Aabb fat = m_proxies[proxy].bounds.expanded(m_options.margin);
+        primitives.push_back({ .bounds = fat, .centroid = fat.getCenter(), .proxy = proxy });
+    }
+
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_root = kInvalid;
+    m_topologyDirty = true;
+    if (primitives.empty()) return;
+
+    // A binary tree over n leaves has exactly 2n - 1 nodes, so parallel
+    // subtrees can claim indices with one counter and never reallocate
+    m_nodes.resize(2 * primitives.size() - 1);
+    std::atomic<uint32_t> nextNode = 0;
+
+    const auto build = [&](const auto& self, const uint32_t begin, const uint32_t end, const uint32_t parent) -> uint32_t {
+        const uint32_t index = nextNode.fetch_add(1, std::memory_order_relaxed);
+        Node& node = m_nodes[index];
+        node.parent = parent;
+
+        if (end - begin == 1) {
+            node.bounds = primitives[begin].bounds;
+            node.proxy = primitives[begin].proxy;
+            m_proxies[node.proxy].node = index;
+            return index;
+        }
+
+        Aabb bounds = Aabb::empty();
+        Aabb centroids = Aabb::empty();
+        for (uint32_t i = begin; i < end; ++i) {
+            bounds = Aabb::merge(bounds, primitives[i].bounds);
+            centroids = Aabb::merge(centroids, { primitives[i].centroid, primitives[i].centroid });
+        }
+        node.bounds = bounds;
+
+        const glm::vec3 spread = centroids.max - centroids.min;
+        const uint32_t axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : spread.y >= spread.z ? 1 : 2;
+        const float low = axisValue(centroids.min, axis);
+        const float width = axisValue(spread, axis);
+
+        uint32_t middle = begin + (end - begin) / 2;
+        if (width > 0.0f) {
+            const float scale = kBinCount / width;
+            const auto binOf = [&](const BuildPrimitive& primitive) {
+                const auto bin = static_cast<uint32_t>((axisValue(primitive.centroid, axis) - low) * scale);
+                return std::min(bin, kBinCount - 1);
+            };
+
+            Aabb binBounds[kBinCount];
+            uint32_t binCounts[kBinCount] = {};
+            std::ranges::fill(binBounds, Aabb::empty());
+            for (uint32_t i = begin; i < end; ++i) {
+                const uint32_t bin = binOf(primitives[i]);
+                binBounds[bin] = Aabb::merge(binBounds[bin], primitives[i].bounds);
+                ++binCounts[bin];
+            }
+
+            // Cost of splitting after each bin: area times count on both sides
+            float rightCost[kBinCount] = {};
+            Aabb sweep = Aabb::empty();
+            uint32_t count = 0;
+            for (uint32_t bin = kBinCount - 1; bin > 0; --bin) {
+                sweep = Aabb::merge(sweep, binBounds[bin]);
+                count += binCounts[bin];
+                rightCost[bin - 1] = count > 0 ? sweep.getSurfaceArea() * static_cast<float>(count) : 0.0f;
+            }
+
+            uint32_t split = 0;
+            float bestCost = kInfinity;
+            sweep = Aabb::empty();
+            count = 0;
+            for (uint32_t bin = 0; bin + 1 < kBinCount; ++bin) {
+                sweep = Aabb::merge(sweep, binBounds[bin]);
+                count += binCounts[bin];
+                const float cost = (count > 0 ? sweep.getSurfaceArea() * static_cast<float>(count) : 0.0f) +
+                                   rightCost[bin];
+                if (count > 0 && count < end - begin && cost < bestCost) {
+                    bestCost = cost;
+                    split = bin;
+                }
+            }
+
+            const auto first = primitives.begin() + begin;
+            const auto pivot = std::partition(first, primitives.begin() + end, [&](const BuildPrimitive& primitive) {
+                return binOf(primitive) <= split;
+            });
+            middle = begin + static_cast<uint32_t>(pivot - first);
+            if (middle == begin || middle == end) middle = begin + (end - begin) / 2;
+        }
+
+        // node may move no further (m_nodes was sized up front), so it is safe to
+        // hold across the recursion
+        if (jobs && end - begin >= kParallelBuildThreshold) {
+            JobCounter counter;
+            jobs->spawn([&, begin, middle, index](uint32_t) {
+                m_nodes[index].children[0] = self(self, begin, middle, index);
+            }, &counter);
+            node.children[1] = self(self, middle, end, index);
+            jobs->wait(counter);
+        } else {
+            node.children[0] = self(self, begin, middle, index);
+            node.children[1] = self(self, middle, end, index);
+        }
+        return index;
+    };
+    m_root = build(build, 0, static_cast<uint32_t>(primitives.size()), kInvalid);
+}
+
+void DynamicBvh::commit() {
+    if (m_topologyDirty) collapse();
+    if (m_topologyDirty || m_boundsDirty) refitWide();
+    m_topologyDirty = false;
+    m_boundsDirty = false;
+}
+
+// Breadth-first, so every wide node is stored after its parent. Each wide
+// node absorbs the binary subtree below it by repeatedly opening its largest
+// internal child until it has four.
+void DynamicBvh::collapse() {
+    m_wideNodes.clear();
+    if (m_root == kInvalid) return;
+
+    std::vector<std::pair<uint32_t, uint32_t>> pending;    // Binary node, wide node
+    pending.reserve(m_proxyCount / 2 + 1);
+    pending.emplace_back(m_root, 0);
+    m_wideNodes.emplace_back();
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const auto [root, wide] = pending[i];
+
+        uint32_t slots[4];
+        uint32_t count = 0;
+        if (m_nodes[root].isLeaf()) {
+            slots[count++] = root;
+        } else {
+            slots[count++] = m_nodes[root].children[0];
+            slots[count++] = m_nodes[root].children[1];
+        }
+
+        while (count < 4) {
+            uint32_t largest = kInvalid;
+            float largestArea = -1.0f;
+            for (uint32_t s = 0; s < count; ++s) {
+                const Node& node = m_nodes[slots[s]];
+                if (!node.isLeaf() && node.bounds.getSurfaceArea() > largestArea) {
+                    largestArea = node.bounds.getSurfaceArea();
+                    largest = s;
+                }
+            }
+            if (largest == kInvalid) break;
+
+            const Node& opened = m_nodes[slots[largest]];
+            slots[count++] = opened.children[1];
+            slots[largest] = opened.children[0];
+        }
+
+        for (uint32_t s = 0; s < count; ++s) {
+            const Node& node = m_nodes[slots[s]];
+            uint32_t child;
+            if (node.isLeaf()) {
+                child = kLeafBit | node.proxy;
+            } else {
+                child = static_cast<uint32_t>(m_wideNodes.size());
+                m_wideNodes.emplace_back();
+                pending.emplace_back(slots[s], child);
+            }
+            m_wideNodes[wide].children[s] = child;
+        }
+        m_wideNodes[wide].count = count;
+    }
+}
+
+// Bottom-up over the tight object boxes; the fat ones only steer insertion
+void DynamicBvh::refitWide() {
+    for (size_t i = m_wideNodes.size(); i-- > 0;) {
+        WideNode& node = m_wideNodes[i];
+        for (uint32_t s = 0; s < 4; ++s) {
+            Aabb bounds = Aabb::empty();
+            if (s < node.count) {
+                const uint32_t child = node.children[s];
+                if (child & kLeafBit) {
+                    bounds = m_proxies[child & ~kLeafBit].bounds;
+                } else {
+                    const WideNode& inner = m_wideNodes[child];
+                    for (uint32_t c = 0; c < inner.count; ++c) {
+                        bounds.min = glm::min(bounds.min, glm::vec3(inner.minX[c], inner.minY[c], inner.minZ[c]));
+                        bounds.max = glm::max(bounds.max, glm::vec3(inner.maxX[c], inner.maxY[c], inner.maxZ[c]));
+                    }
+                }
+            }
+            node.minX[s] = bounds.min.x;
+            node.minY[s] = bounds.min.y;
+            node.minZ[s] = bounds.min.z;
+            node.maxX[s] = bounds.max.x;
+            node.maxY[s] = bounds.max.y;
+            node.maxZ[s] = bounds.max.z;
+        }
+    }
+}
+
+float DynamicBvh::getSahCost() const {
+    if (m_root == kInvalid || m_nodes[m_root].isLeaf()) return 0.0f;
+
+    float area = 0.0f;
+    std::vector<uint32_t> stack = { m_root };
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (node.isLeaf()) continue;
+        area += node.bounds.getSurfaceArea();
+        stack.push_back(node.children[0]);
+        stack.push_back(node.children[1]);
+    }
+    return area / m_nodes[m_root].bounds.getSurfaceArea();
+}
+
+uint32_t DynamicBvh::getHeight() const {
+    if (m_root == kInvalid) return 0;
+
+    uint32_t height = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> stack = { { m_root, 1 } };
+    while (!stack.empty()) {
+        const auto [index, depth] = stack.back();
+        stack.pop_back();
+        height = std::max(height, depth);
+        const Node& node = m_nodes[index];
+        if (node.isLeaf()) continue;
+        stack.emplace_back(node.children[0], depth + 1);
+        stack.emplace_back(node.children[1], depth + 1);
+    }
+    return height;
+}
+
+void DynamicBvh::requireCommitted() const {
+    if (m_topologyDirty || m_boundsDirty) throw std::runtime_error("DynamicBvh queried with uncommitted edits");
+}
+
+void DynamicBvh::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const {
+    requireCommitted();
+    out.clear();
+    if (m_wideNodes.empty()) return;
+
+    const QueryPlanes planes(frustum);
+
+    // Each entry carries the planes its box still straddles; none left means
+    // the whole subtree is inside and is emitted without further tests
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.reserve(64);
+    stack.emplace_back(0, kAllPlanes);
+    while (!stack.empty()) {
+        const auto [index, activePlanes] = stack.back();
+        stack.pop_back();
+        const WideNode& node = m_wideNodes[index];
+
+        uint32_t inside[Frustum::PlaneCount];
+        const uint32_t occupied = (1u << node.count) - 1;
+        const uint32_t visible = activePlanes ? frustumLanes(node, planes, activePlanes, occupied, inside) : occupied;
+        for (uint32_t lanes = visible; lanes != 0; lanes &= lanes - 1) {
+            const int lane = std::countr_zero(lanes);
+            const uint32_t child = node.children[lane];
+            if (child & kLeafBit) {
+                out.push_back(m_proxies[child & ~kLeafBit].userData);
+                continue;
+            }
+
+            uint32_t straddled = 0;
+            for (uint32_t active = activePlanes; active != 0; active &= active - 1) {
+                const int p = std::countr_zero(active);
+                if (!(inside[p] & (1u << lane))) straddled |= 1u << p;
+            }
+            stack.emplace_back(child, straddled);
+        }
+    }
+}
+
+void DynamicBvh::queryAabb(const Aabb& bounds, std::vector<uint32_t>& out) const {
+    requireCommitted();
+    out.clear();
+    if (m_wideNodes.empty()) return;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const WideNode& node = m_wideNodes[stack.back()];
+        stack.pop_back();
+        for (uint32_t lanes = overlapLanes(node, bounds, (1u << node.count) - 1); lanes != 0; lanes &= lanes - 1) {
+            const uint32_t child = node.children[std::countr_zero(lanes)];
+            if (child & kLeafBit) {
+                out.push_back(m_proxies[child & ~kLeafBit].userData);
+            } else {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+void DynamicBvh::querySphere(const glm::vec3& center, const float radius, std::vector<uint32_t>& out) const {
+    requireCommitted();
+    out.clear();
+    if (m_wideNodes.empty()) return;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const WideNode& node = m_wideNodes[stack.back()];
+        stack.pop_back();
+        for (uint32_t lanes = sphereLanes(node, center, radius, (1u << node.count) - 1); lanes != 0;
+             lanes &= lanes - 1) {
+            const uint32_t child = node.children[std::countr_zero(lanes)];
+            if (child & kLeafBit) {
+                out.push_back(m_proxies[child & ~kLeafBit].userData);
+            } else {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+std::optional<DynamicBvh::RayHit> DynamicBvh::raycast(const glm::vec3& origin, const glm::vec3& direction,
+                                                      const float maxDistance, const RayTest& test) const {
+    requireCommitted();
+    if (m_wideNodes.empty()) return std::nullopt;
+
+    const glm::vec3 inverse(safeInverse(direction.x), safeInverse(direction.y), safeInverse(direction.z));
+    std::optional<RayHit> hit;
+    float closest = maxDistance;
+
+    std::vector<std::pair<uint32_t, float>> stack;    // Wide node, where the ray enters it
+    stack.reserve(64);
+    stack.emplace_back(0, 0.0f);
+    while (!stack.empty()) {
+        const auto [index, nodeEntry] = stack.back();
+        stack.pop_back();
+        if (nodeEntry > closest) continue;
+        const WideNode& node = m_wideNodes[index];
+
+        float entry[4];
+        const uint32_t lanes = rayLanes(node, origin, inverse, closest, (1u << node.count) - 1, entry);
+
+        std::pair<uint32_t, float> inner[4];
+        uint32_t innerCount = 0;
+        for (uint32_t remaining = lanes; remaining != 0; remaining &= remaining - 1) {
+            const int lane = std::countr_zero(remaining);
+            const uint32_t child = node.children[lane];
+            if (!(child & kLeafBit)) {
+                inner[innerCount++] = { child, entry[lane] };
+                continue;
+            }
+
+            // An earlier leaf of this node may have moved the best hit closer
+            if (entry[lane] > closest) continue;
+            const uint32_t userData = m_proxies[child & ~kLeafBit].userData;
+            const std::optional<float> distance = test ? test(userData, entry[lane]) : entry[lane];
+            if (distance && *distance >= 0.0f && *distance <= closest) {
+                closest = *distance;
+                hit = RayHit { .userData = userData, .distance = *distance };
+            }
+        }
+
+        // Furthest first, so the nearest child is popped next
+        for (uint32_t i = 1; i < innerCount; ++i) {
+            for (uint32_t j = i; j > 0 && inner[j - 1].second < inner[j].second; --j) std::swap(inner[j - 1], inner[j]);
+        }
+        for (uint32_t i = 0; i < innerCount; ++i) stack.push_back(inner[i]);
+    }
+    return hit;
+}
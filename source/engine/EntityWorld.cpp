@@ -0,0 +1,241 @@
+#include "EntityWorld.h"
+
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Component arrays start on their own cache line, so neighbouring arrays
+// never share one between workers writing different components
+constexpr uint32_t kChunkAlignment = 64;
+
+struct ComponentInfo {
+    size_t size;
+    size_t alignment;
+};
+
+std::mutex g_registryMutex;
+ComponentInfo g_components[EntityWorld::kMaxComponents];
+uint32_t g_componentCount = 0;
+
+uint32_t alignUp(const uint32_t value, const uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+uint32_t EntityWorld::registerComponent(const size_t size, const size_t alignment) {
+    std::lock_guard lock(g_registryMutex);
+    if (g_componentCount == kMaxComponents) {
+        throw std::runtime_error("More than " + std::to_string(kMaxComponents) + " component types registered");
+    }
+    g_components[g_componentCount] = { .size = size, .alignment = alignment };
+    return g_componentCount++;
+}
+
+size_t EntityWorld::getComponentSize(const uint32_t id) {
+    return g_components[id].size;
+}
+
+void EntityWorld::ChunkDeleter::operator()(std::byte* chunk) const {
+    ::operator delete[](chunk, std::align_val_t(kChunkAlignment));
+}
+
+EntityWorld::EntityWorld() = default;
+
+EntityWorld::~EntityWorld() = default;
+
+bool EntityWorld::isAlive(const Entity entity) const {
+    return entity.index < m_records.size() && m_records[entity.index].archetype != kInvalid &&
+           m_records[entity.index].generation == entity.generation;
+}
+
+const EntityWorld::EntityRecord& EntityWorld::getRecord(const Entity entity) const {
+    if (!isAlive(entity)) throw std::runtime_error("Entity " + std::to_string(entity.index) + " is not alive");
+    return m_records[entity.index];
+}
+
+EntityWorld::ComponentMask EntityWorld::getEntityMask(const Entity entity) const {
+    return m_archetypes[getRecord(entity).archetype].mask;
+}
+
+void* EntityWorld::getComponent(const Entity entity, const uint32_t id) {
+    const EntityRecord& record = getRecord(entity);
+    Archetype& archetype = m_archetypes[record.archetype];
+    if (archetype.offsets[id] == 0) return nullptr;
+    return getRowPointer(archetype, record.row, id);
+}
+
+void* EntityWorld::requireComponent(const Entity entity, const uint32_t id) {
+    void* component = getComponent(entity, id);
+    if (!component) {
+        throw std::runtime_error("Entity " + std::to_string(entity.index) + " has no component " + std::to_string(id));
+    }
+    return component;
+}
+
+uint32_t EntityWorld::getChunkCount() const {
+    uint32_t count = 0;
+    for (const Archetype& archetype : m_archetypes) count += static_cast<uint32_t>(archetype.chunks.size());
+    return count;
+}
+
+Entity EntityWorld::createEntity(const ComponentMask mask) {
+    uint32_t index;
+    if (!m_freeRecords.empty()) {
+        index = m_freeRecords.back();
+        m_freeRecords.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_records.size());
+        m_records.emplace_back();
+    }
+
+    const uint32_t archetype = getArchetype(mask);
+    const uint32_t row = allocateRow(archetype);
+    EntityRecord& record = m_records[index];
+    record.archetype = archetype;
+    record.row = row;
+
+    const Entity entity { .index = index, .generation = record.generation };
+    Archetype& target = m_archetypes[archetype];
+    reinterpret_cast<Entity*>(target.chunks[row / target.capacity].get())[row % target.capacity] = entity;
+
+    ++m_entityCount;
+    ++m_structureVersion;
+    return entity;
+}
+
+void EntityWorld::destroy(const Entity entity) {
+    const EntityRecord record = getRecord(entity);
+    freeRow(record.archetype, record.row);
+
+    // The bumped generation turns every outstanding handle stale
+    m_records[entity.index].archetype = kInvalid;
+    ++m_records[entity.index].generation;
+    m_freeRecords.push_back(entity.index);
+
+    --m_entityCount;
+    ++m_structureVersion;
+}
+
+void EntityWorld::clear() {
+    for (uint32_t index = 0; index < m_records.size(); ++index) {
+        EntityRecord& record = m_records[index];
+        if (record.archetype == kInvalid) continue;
+        record.archetype = kInvalid;
+        ++record.generation;
+        m_freeRecords.push_back(index);
+    }
+
+    // Layouts stay cached; their chunks go back to the pool
+    for (Archetype& archetype : m_archetypes) {
+        for (ChunkPointer& chunk : archetype.chunks) m_freeChunks.push_back(std::move(chunk));
+        archetype.chunks.clear();
+        archetype.count = 0;
+    }
+
+    m_entityCount = 0;
+    ++m_structureVersion;
+}
+
+// The overlap between both archetypes is copied; components the target adds
+// are left for the caller to write
+void EntityWorld::moveEntity(const Entity entity, const ComponentMask mask) {
+    const EntityRecord record = getRecord(entity);
+    const uint32_t target = getArchetype(mask);
+    const uint32_t row = allocateRow(target);
+
+    Archetype& from = m_archetypes[record.archetype];
+    Archetype& to = m_archetypes[target];
+    for (const uint32_t id : to.components) {
+        if (from.offsets[id] == 0) continue;
+        std::memcpy(getRowPointer(to, row, id), getRowPointer(from, record.row, id), getComponentSize(id));
+    }
+    reinterpret_cast<Entity*>(to.chunks[row / to.capacity].get())[row % to.capacity] = entity;
+
+    freeRow(record.archetype, record.row);
+    m_records[entity.index].archetype = target;
+    m_records[entity.index].row = row;
+    ++m_structureVersion;
+}
+
+uint32_t EntityWorld::getArchetype(const ComponentMask mask) {
+    if (const auto found = m_archetypeByMask.find(mask); found != m_archetypeByMask.end()) return found->second;
+
+    Archetype archetype;
+    archetype.mask = mask;
+    uint32_t rowBytes = sizeof(Entity);
+    for (ComponentMask bits = mask; bits != 0; bits &= bits - 1) {
+        const auto id = static_cast<uint32_t>(std::countr_zero(bits));
+        archetype.components.push_back(id);
+        rowBytes += static_cast<uint32_t>(g_components[id].size);
+    }
+
+    // Largest row count whose arrays, each aligned, still fit the chunk
+    for (uint32_t capacity = kChunkSize / rowBytes; capacity > 0; --capacity) {
+        uint32_t offset = capacity * static_cast<uint32_t>(sizeof(Entity));
+        for (const uint32_t id : archetype.components) {
+            const auto alignment = std::max(kChunkAlignment, static_cast<uint32_t>(g_components[id].alignment));
+            offset = alignUp(offset, alignment);
+            archetype.offsets[id] = offset;
+            offset += capacity * static_cast<uint32_t>(g_components[id].size);
+        }
+        if (offset <= kChunkSize) {
+            archetype.capacity = capacity;
+            break;
+        }
+    }
+    if (archetype.capacity == 0) throw std::runtime_error("Archetype components do not fit in one chunk");
+
+    const auto index = static_cast<uint32_t>(m_archetypes.size());
+    m_archetypes.push_back(std::move(archetype));
+    m_archetypeByMask.emplace(mask, index);
+    return index;
+}
+
+uint32_t EntityWorld::allocateRow(const uint32_t archetype) {
+    Archetype& target = m_archetypes[archetype];
+    if (target.count == target.chunks.size() * target.capacity) {
+        if (!m_freeChunks.empty()) {
+            target.chunks.push_back(std::move(m_freeChunks.back()));
+            m_freeChunks.pop_back();
+        } else {
+            target.chunks.emplace_back(
+                static_cast<std::byte*>(::operator new[](kChunkSize, std::align_val_t(kChunkAlignment))));
+        }
+    }
+    return target.count++;
+}
+
+void EntityWorld::freeRow(const uint32_t archetype, const uint32_t row) {
+    Archetype& source = m_archetypes[archetype];
+    const uint32_t last = --source.count;
+
+    if (row != last) {
+        for (const uint32_t id : source.components) {
+            std::memcpy(getRowPointer(source, row, id), getRowPointer(source, last, id), getComponentSize(id));
+        }
+        auto* rowEntity = reinterpret_cast<Entity*>(source.chunks[row / source.capacity].get()) + row % source.capacity;
+        *rowEntity = reinterpret_cast<const Entity*>(source.chunks[last / source.capacity].get())[last % source.capacity];
+        m_records[rowEntity->index].row = row;
+    }
+
+    if (source.count <= (source.chunks.size() - 1) * source.capacity) {
+        m_freeChunks.push_back(std::move(source.chunks.back()));
+        source.chunks.pop_back();
+    }
+}
+
+std::vector<EntityWorld::ChunkRef> EntityWorld::collectChunks(const ComponentMask mask) const {
+    std::vector<ChunkRef> chunks;
+    for (uint32_t archetype = 0; archetype < m_archetypes.size(); ++archetype) {
+        if ((m_archetypes[archetype].mask & mask) != mask) continue;
+        for (uint32_t chunk = 0; chunk < m_archetypes[archetype].chunks.size(); ++chunk) {
+            chunks.push_back({ .archetype = archetype, .chunk = chunk });
+        }
+    }
+    return chunks;
+}
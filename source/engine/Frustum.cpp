@@ -0,0 +1,30 @@
+#include "Frustum.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "Camera.h"
+
+Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+    // Gribb-Hartmann: each plane is the last row plus or minus one of the others
+    const auto row = [&](const int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    Frustum frustum;
+    frustum.planes[Left]   = row(3) + row(0);
+    frustum.planes[Right]  = row(3) - row(0);
+    frustum.planes[Bottom] = row(3) + row(1);
+    frustum.planes[Top]    = row(3) - row(1);
+    frustum.planes[Near]   = row(3) + row(2);
+    frustum.planes[Far]    = row(3) - row(2);
+
+    // Unit normals, so plane distances compare directly against sphere radii
+    for (glm::vec4& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+Frustum Frustum::fromCamera(const Camera& camera) {
+    return fromMatrix(camera.getProjectionMatrix() * camera.getViewMatrix());
+}
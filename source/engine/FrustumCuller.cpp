@@ -0,0 +1,497 @@
+#include "FrustumCuller.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#include "JobSystem.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define VULKANLAB_CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX instructions in functions that ask for them;
+// MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define VULKANLAB_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VULKANLAB_TARGET(isa)
+#endif
+
+namespace {
+
+// Objects per parallel cull task
+constexpr uint32_t kBlockSize = 16384;
+
+// Plane coefficients broadcast once per call, plus |n| for the box extents
+struct CullPlanes {
+    float x[Frustum::PlaneCount], y[Frustum::PlaneCount], z[Frustum::PlaneCount], w[Frustum::PlaneCount];
+    float absX[Frustum::PlaneCount], absY[Frustum::PlaneCount], absZ[Frustum::PlaneCount];
+
+    explicit CullPlanes(const Frustum& frustum) {
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            x[p] = frustum.planes[p].x;
+            y[p] = frustum.planes[p].y;
+            z[p] = frustum.planes[p].z;
+            w[p] = frustum.planes[p].w;
+            absX[p] = std::abs(x[p]);
+            absY[p] = std::abs(y[p]);
+            absZ[p] = std::abs(z[p]);
+        }
+    }
+};
+
+// Scalar kernels, also used for the tails of the SSE2 and AVX2 ones
+
+bool sphereVisible(const CullPlanes& planes, const BoundingSpheres& spheres, const uint32_t i) {
+    for (int p = 0; p < Frustum::PlaneCount; ++p) {
+        const float distance = planes.x[p] * spheres.centerX[i] + planes.y[p] * spheres.centerY[i] +
+                               planes.z[p] * spheres.centerZ[i] + planes.w[p];
+        if (distance < -spheres.radius[i]) return false;
+    }
+    return true;
+}
+
+bool boxVisible(const CullPlanes& planes, const BoundingBoxes& boxes, const uint32_t i) {
+    for (int p = 0; p < Frustum::PlaneCount; ++p) {
+        const float distance = planes.x[p] * boxes.centerX[i] + planes.y[p] * boxes.centerY[i] +
+                               planes.z[p] * boxes.centerZ[i] + planes.w[p];
+        const float reach = planes.absX[p] * boxes.extentX[i] + planes.absY[p] * boxes.extentY[i] +
+                            planes.absZ[p] * boxes.extentZ[i];
+        if (distance < -reach) return false;
+    }
+    return true;
+}
+
+template<typename Bounds, typename Visible>
+uint32_t cullScalar(const CullPlanes& planes, const Bounds& bounds, const uint32_t begin, const uint32_t end,
+                    uint32_t* out, const Visible& visible) {
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; ++i) {
+        out[count] = i;
+        count += visible(planes, bounds, i) ? 1 : 0;
+    }
+    return count;
+}
+
+#if VULKANLAB_CULL_X86
+
+// Lane shuffles that move the set lanes of an 8-bit mask to the front
+struct CompressTable {
+    alignas(32) std::array<std::array<uint32_t, 8>, 256> lanes;
+
+    constexpr CompressTable() : lanes() {
+        for (uint32_t mask = 0; mask < 256; ++mask) {
+            uint32_t count = 0;
+            for (uint32_t lane = 0; lane < 8; ++lane) {
+                if (mask & (1u << lane)) lanes[mask][count++] = lane;
+            }
+        }
+    }
+};
+
+constexpr CompressTable kCompress;
+
+// Plain mul/add rather than FMA, so the vector kernels round like the scalar test
+
+uint32_t cullSpheresSse2(const CullPlanes& planes, const BoundingSpheres& spheres, const uint32_t begin,
+                         const uint32_t end, uint32_t* out) {
+    uint32_t count = 0;
+    uint32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&spheres.centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&spheres.centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&spheres.centerZ[i]);
+        const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(planes.x[p]), cx);
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.y[p]), cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.z[p]), cz));
+            distance = _mm_add_ps(distance, _mm_set1_ps(planes.w[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        for (uint32_t mask = _mm_movemask_ps(inside); mask != 0; mask &= mask - 1) {
+            out[count++] = i + std::countr_zero(mask);
+        }
+    }
+    return count + cullScalar(planes, spheres, i, end, out + count, sphereVisible);
+}
+
+uint32_t cullBoxesSse2(const CullPlanes& planes, const BoundingBoxes& boxes, const uint32_t begin,
+                       const uint32_t end, uint32_t* out) {
+    uint32_t count = 0;
+    uint32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&boxes.centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&boxes.centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&boxes.centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&boxes.extentX[i]);
+        const __m128 ey = _mm_loadu_ps(&boxes.extentY[i]);
+        const __m128 ez = _mm_loadu_ps(&boxes.extentZ[i]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(planes.x[p]), cx);
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.y[p]), cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.z[p]), cz));
+            distance = _mm_add_ps(distance, _mm_set1_ps(planes.w[p]));
+
+            __m128 reach = _mm_mul_ps(_mm_set1_ps(planes.absX[p]), ex);
+            reach = _mm_add_ps(reach, _mm_mul_ps(_mm_set1_ps(planes.absY[p]), ey));
+            reach = _mm_add_ps(reach, _mm_mul_ps(_mm_set1_ps(planes.absZ[p]), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_sub_ps(_mm_setzero_ps(), reach)));
+        }
+
+        for (uint32_t mask = _mm_movemask_ps(inside); mask != 0; mask &= mask - 1) {
+            out[count++] = i + std::countr_zero(mask);
+        }
+    }
+    return count + cullScalar(planes, boxes, i, end, out + count, boxVisible);
+}
+
+// Survivors are packed with one permute from kCompress and stored as a whole register
+
+VULKANLAB_TARGET("avx2,popcnt")
+uint32_t cullSpheresAvx2(const CullPlanes& planes, const BoundingSpheres& spheres, const uint32_t begin,
+                         const uint32_t end, uint32_t* out) {
+    const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    uint32_t count = 0;
+    uint32_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(&spheres.centerX[i]);
+        const __m256 cy = _mm256_loadu_ps(&spheres.centerY[i]);
+        const __m256 cz = _mm256_loadu_ps(&spheres.centerZ[i]);
+        const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.radius[i]));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            __m256 distance = _mm256_mul_ps(_mm256_set1_ps(planes.x[p]), cx);
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.y[p]), cy));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.z[p]), cz));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(planes.w[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+        const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(kCompress.lanes[mask].data()));
+        const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), laneIndex);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), _mm256_permutevar8x32_epi32(indices, shuffle));
+        count += std::popcount(mask);
+    }
+    return count + cullScalar(planes, spheres, i, end, out + count, sphereVisible);
+}
+
+VULKANLAB_TARGET("avx2,popcnt")
+uint32_t cullBoxesAvx2(const CullPlanes& planes, const BoundingBoxes& boxes, const uint32_t begin,
+                       const uint32_t end, uint32_t* out) {
+    const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    uint32_t count = 0;
+    uint32_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(&boxes.centerX[i]);
+        const __m256 cy = _mm256_loadu_ps(&boxes.centerY[i]);
+        const __m256 cz = _mm256_loadu_ps(&boxes.centerZ[i]);
+        const __m256 ex = _mm256_loadu_ps(&boxes.extentX[i]);
+        const __m256 ey = _mm256_loadu_ps(&boxes.extentY[i]);
+        const __m256 ez = _mm256_loadu_ps(&boxes.extentZ[i]);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            __m256 distance = _mm256_mul_ps(_mm256_set1_ps(planes.x[p]), cx);
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.y[p]), cy));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.z[p]), cz));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(planes.w[p]));
+
+            __m256 reach = _mm256_mul_ps(_mm256_set1_ps(planes.absX[p]), ex);
+            reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_set1_ps(planes.absY[p]), ey));
+            reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_set1_ps(planes.absZ[p]), ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_sub_ps(_mm256_setzero_ps(), reach), _CMP_GE_OQ));
+        }
+
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+        const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(kCompress.lanes[mask].data()));
+        const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), laneIndex);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), _mm256_permutevar8x32_epi32(indices, shuffle));
+        count += std::popcount(mask);
+    }
+    return count + cullScalar(planes, boxes, i, end, out + count, boxVisible);
+}
+
+// Tails use masked loads instead of a scalar loop. Survivors are packed in a
+// register and stored whole; compressstoreu straight to memory is microcoded
+// and much slower on some cores.
+
+VULKANLAB_TARGET("avx512f,popcnt")
+uint32_t cullSpheresAvx512(const CullPlanes& planes, const BoundingSpheres& spheres, const uint32_t begin,
+                           const uint32_t end, uint32_t* out) {
+    const __m512i laneIndex = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; i += 16) {
+        const __mmask16 valid = end - i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (end - i)) - 1);
+        const __m512 cx = _mm512_maskz_loadu_ps(valid, &spheres.centerX[i]);
+        const __m512 cy = _mm512_maskz_loadu_ps(valid, &spheres.centerY[i]);
+        const __m512 cz = _mm512_maskz_loadu_ps(valid, &spheres.centerZ[i]);
+        const __m512 negRadius = _mm512_sub_ps(_mm512_setzero_ps(), _mm512_maskz_loadu_ps(valid, &spheres.radius[i]));
+
+        __mmask16 inside = valid;
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            __m512 distance = _mm512_mul_ps(_mm512_set1_ps(planes.x[p]), cx);
+            distance = _mm512_add_ps(distance, _mm512_mul_ps(_mm512_set1_ps(planes.y[p]), cy));
+            distance = _mm512_add_ps(distance, _mm512_mul_ps(_mm512_set1_ps(planes.z[p]), cz));
+            distance = _mm512_add_ps(distance, _mm512_set1_ps(planes.w[p]));
+            inside = _mm512_mask_cmp_ps_mask(inside, distance, negRadius, _CMP_GE_OQ);
+        }
+
+        const __m512i indices = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(i)), laneIndex);
+        _mm512_storeu_si512(out + count, _mm512_maskz_compress_epi32(inside, indices));
+        count += std::popcount(static_cast<uint32_t>(inside));
+    }
+    return count;
+}
+
+VULKANLAB_TARGET("avx512f,popcnt")
+uint32_t cullBoxesAvx512(const CullPlanes& planes, const BoundingBoxes& boxes, const uint32_t begin,
+                         const uint32_t end, uint32_t* out) {
+    const __m512i laneIndex = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; i += 16) {
+        const __mmask16 valid = end - i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (end - i)) - 1);
+        const __m512 cx = _mm512_maskz_loadu_ps(valid, &boxes.centerX[i]);
+        const __m512 cy = _mm512_maskz_loadu_ps(valid, &boxes.centerY[i]);
+        const __m512 cz = _mm512_maskz_loadu_ps(valid, &boxes.centerZ[i]);
+        const __m512 ex = _mm512_maskz_loadu_ps(valid, &boxes.extentX[i]);
+        const __m512 ey = _mm512_maskz_loadu_ps(valid, &boxes.extentY[i]);
+        const __m512 ez = _mm512_maskz_loadu_ps(valid, &boxes.extentZ[i]);
+
+        __mmask16 inside = valid;
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            __m512 distance = _mm512_mul_ps(_mm512_set1_ps(planes.x[p]), cx);
+            distance = _mm512_add_ps(distance, _mm512_mul_ps(_mm512_set1_ps(planes.y[p]), cy));
+            distance = _mm512_add_ps(distance, _mm512_mul_ps(_mm512_set1_ps(planes.z[p]), cz));
+            distance = _mm512_add_ps(distance, _mm512_set1_ps(planes.w[p]));
+
+            __m512 reach = _mm512_mul_ps(_mm512_set1_ps(planes.absX[p]), ex);
+            reach = _mm512_add_ps(reach, _mm512_mul_ps(_mm512_set1_ps(planes.absY[p]), ey));
+            reach = _mm512_add_ps(reach, _mm512_mul_ps(_mm512_set1_ps(planes.absZ[p]), ez));
+            inside = _mm512_mask_cmp_ps_mask(inside, distance, _mm512_sub_ps(_mm512_setzero_ps(), reach), _CMP_GE_OQ);
+        }
+
+        const __m512i indices = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(i)), laneIndex);
+        _mm512_storeu_si512(out + count, _mm512_maskz_compress_epi32(inside, indices));
+        count += std::popcount(static_cast<uint32_t>(inside));
+    }
+    return count;
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+bool cpuHas(const FrustumCuller::Isa isa) {
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+    const bool popcnt = info[2] & (1 << 23);
+    if (isa == FrustumCuller::Isa::Sse2) return true;
+    if (!osxsave || !avx || !popcnt || maxLeaf < 7) return false;
+
+    // The OS must save the YMM state, and for AVX-512 the opmask and ZMM state too
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    if (isa == FrustumCuller::Isa::Avx2) return (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5));
+    return (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16));
+}
+#else
+bool cpuHas(const FrustumCuller::Isa isa) {
+    // libgcc and compiler-rt check the OS-enabled register state along with the CPUID bits
+    __builtin_cpu_init();
+    switch (isa) {
+        case FrustumCuller::Isa::Sse2:   return true;
+        case FrustumCuller::Isa::Avx2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+        case FrustumCuller::Isa::Avx512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+        default:                         return true;
+    }
+}
+#endif
+
+#endif // VULKANLAB_CULL_X86
+
+// Culls [0, count) in blocks, each written to its own stretch of storage
+// (with slack, since the kernels store whole registers), then moves the
+// survivors together
+template<typename Range>
+std::span<const uint32_t> cullBlocks(const uint32_t count, std::vector<uint32_t>& storage, JobSystem* jobs,
+                                     const Range& range) {
+    if (!jobs || jobs->getThreadCount() == 1 || count <= kBlockSize) {
+        if (storage.size() < count + FrustumCuller::kOutputSlack) storage.resize(count + FrustumCuller::kOutputSlack);
+        return { storage.data(), range(0, count, storage.data()) };
+    }
+
+    constexpr uint32_t stride = kBlockSize + FrustumCuller::kOutputSlack;
+    const uint32_t blockCount = (count + kBlockSize - 1) / kBlockSize;
+    if (storage.size() < size_t(blockCount) * stride) storage.resize(size_t(blockCount) * stride);
+
+    std::vector<uint32_t> survivors(blockCount);
+    jobs->parallelFor(blockCount, [&](const uint32_t block, uint32_t) {
+        const uint32_t begin = block * kBlockSize;
+        const uint32_t end = std::min(count, begin + kBlockSize);
+        survivors[block] = range(begin, end, storage.data() + size_t(block) * stride);
+    });
+
+    // Destinations never pass their sources, so this can run front to back in place
+    uint32_t total = survivors[0];
+    for (uint32_t block = 1; block < blockCount; ++block) {
+        std::memmove(storage.data() + total, storage.data() + size_t(block) * stride, survivors[block] * sizeof(uint32_t));
+        total += survivors[block];
+    }
+    return { storage.data(), total };
+}
+
+}
+
+void BoundingSpheres::reserve(const size_t count) {
+    centerX.reserve(count);
+    centerY.reserve(count);
+    centerZ.reserve(count);
+    radius.reserve(count);
+}
+
+void BoundingSpheres::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+void BoundingSpheres::add(const glm::vec3& center, const float sphereRadius) {
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(sphereRadius);
+}
+
+void BoundingSpheres::set(const uint32_t index, const glm::vec3& center, const float sphereRadius) {
+    centerX[index] = center.x;
+    centerY[index] = center.y;
+    centerZ[index] = center.z;
+    radius[index] = sphereRadius;
+}
+
+void BoundingBoxes::reserve(const size_t count) {
+    centerX.reserve(count);
+    centerY.reserve(count);
+    centerZ.reserve(count);
+    extentX.reserve(count);
+    extentY.reserve(count);
+    extentZ.reserve(count);
+}
+
+void BoundingBoxes::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+}
+
+void BoundingBoxes::add(const glm::vec3& min, const glm::vec3& max) {
+    centerX.push_back(0.5f * (min.x + max.x));
+    centerY.push_back(0.5f * (min.y + max.y));
+    centerZ.push_back(0.5f * (min.z + max.z));
+    extentX.push_back(0.5f * (max.x - min.x));
+    extentY.push_back(0.5f * (max.y - min.y));
+    extentZ.push_back(0.5f * (max.z - min.z));
+}
+
+void BoundingBoxes::set(const uint32_t index, const glm::vec3& min, const glm::vec3& max) {
+    centerX[index] = 0.5f * (min.x + max.x);
+    centerY[index] = 0.5f * (min.y + max.y);
+    centerZ[index] = 0.5f * (min.z + max.z);
+    extentX[index] = 0.5f * (max.x - min.x);
+    extentY[index] = 0.5f * (max.y - min.y);
+    extentZ[index] = 0.5f * (max.z - min.z);
+}
+
+FrustumCuller::Isa FrustumCuller::detectIsa() {
+    static const Isa isa = [] {
+        for (const Isa candidate : { Isa::Avx512, Isa::Avx2, Isa::Sse2 }) {
+            if (isSupported(candidate)) return candidate;
+        }
+        return Isa::Scalar;
+    }();
+    return isa;
+}
+
+bool FrustumCuller::isSupported(const Isa isa) {
+#if VULKANLAB_CULL_X86
+    return cpuHas(isa);
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+const char* FrustumCuller::getIsaName(const Isa isa) {
+    switch (isa) {
+        case Isa::Sse2:   return "SSE2";
+        case Isa::Avx2:   return "AVX2";
+        case Isa::Avx512: return "AVX-512";
+        default:          return "scalar";
+    }
+}
+
+FrustumCuller::FrustumCuller(const Isa isa) : m_isa(isSupported(isa) ? isa : detectIsa()) {}
+
+std::span<const uint32_t> FrustumCuller::cull(const Frustum& frustum, const BoundingSpheres& spheres,
+                                              std::vector<uint32_t>& storage, JobSystem* jobs) const {
+    return cullBlocks(spheres.size(), storage, jobs, [&](const uint32_t begin, const uint32_t end, uint32_t* out) {
+        return cullRange(frustum, spheres, begin, end, out);
+    });
+}
+
+std::span<const uint32_t> FrustumCuller::cull(const Frustum& frustum, const BoundingBoxes& boxes,
+                                              std::vector<uint32_t>& storage, JobSystem* jobs) const {
+    return cullBlocks(boxes.size(), storage, jobs, [&](const uint32_t begin, const uint32_t end, uint32_t* out) {
+        return cullRange(frustum, boxes, begin, end, out);
+    });
+}
+
+uint32_t FrustumCuller::cullRange(const Frustum& frustum, const BoundingSpheres& spheres, const uint32_t begin,
+                                  const uint32_t end, uint32_t* out) const {
+    const CullPlanes planes(frustum);
+    switch (m_isa) {
+#if VULKANLAB_CULL_X86
+        case Isa::Sse2:   return cullSpheresSse2(planes, spheres, begin, end, out);
+        case Isa::Avx2:   return cullSpheresAvx2(planes, spheres, begin, end, out);
+        case Isa::Avx512: return cullSpheresAvx512(planes, spheres, begin, end, out);
+#endif
+        default:          return cullScalar(planes, spheres, begin, end, out, sphereVisible);
+    }
+}
+
+uint32_t FrustumCuller::cullRange(const Frustum& frustum, const BoundingBoxes& boxes, const uint32_t begin,
+                                  const uint32_t end, uint32_t* out) const {
+    const CullPlanes planes(frustum);
+    switch (m_isa) {
+#if VULKANLAB_CULL_X86
+        case Isa::Sse2:   return cullBoxesSse2(planes, boxes, begin, end, out);
+        case Isa::Avx2:   return cullBoxesAvx2(planes, boxes, begin, end, out);
+        case Isa::Avx512: return cullBoxesAvx512(planes, boxes, begin, end, out);
+#endif
+        default:          return cullScalar(planes, boxes, begin, end, out, boxVisible);
+    }
+}
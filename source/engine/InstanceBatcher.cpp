@@ -0,0 +1,123 @@
+#include "InstanceBatcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "GpuScene.h"
+#include "JobSystem.h"
+
+namespace {
+
+// Instances per cull and write task; matches FrustumCuller's own blocks
+constexpr uint32_t kPieceSize = 16384;
+
+// Largest length of the matrix's three axes, so the sphere covers non-uniform scale
+float getMaxScale(const glm::mat4& model) {
+    const glm::vec3 x(model[0]);
+    const glm::vec3 y(model[1]);
+    const glm::vec3 z(model[2]);
+    return std::sqrt(std::max({ glm::dot(x, x), glm::dot(y, y), glm::dot(z, z) }));
+}
+
+// Runs task over [0, count) on the job system when there is more than one piece
+void forEachPiece(JobSystem* jobs, const uint32_t count, const JobSystem::Task& task) {
+    if (jobs && count > 1) {
+        jobs->parallelFor(count, task);
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) task(i, 0);
+}
+
+}
+
+uint32_t InstanceBatcher::addMesh(const float radius) {
+    m_radii.push_back(radius);
+    return static_cast<uint32_t>(m_radii.size() - 1);
+}
+
+void InstanceBatcher::submit(const uint32_t mesh, const std::span<const glm::mat4> transforms) {
+    if (mesh >= m_radii.size()) {
+        throw std::runtime_error("Instances submitted for an unregistered mesh.");
+    }
+    if (transforms.empty()) return;
+
+    m_submissions.push_back({ .mesh = mesh, .transforms = transforms });
+    m_submittedCount += static_cast<uint32_t>(transforms.size());
+}
+
+uint32_t InstanceBatcher::build(const Frustum& frustum, JobSystem* jobs) {
+    m_batches.clear();
+    m_pieces.clear();
+    m_visibleCount = 0;
+
+    // Grouped by mesh so each batch is one contiguous range; stable keeps submission order within it
+    std::ranges::stable_sort(m_submissions, {}, &Submission::mesh);
+
+    size_t survivors = 0;
+    for (uint32_t s = 0; s < m_submissions.size(); ++s) {
+        const auto size = static_cast<uint32_t>(m_submissions[s].transforms.size());
+        for (uint32_t begin = 0; begin < size; begin += kPieceSize) {
+            const uint32_t end = std::min(begin + kPieceSize, size);
+            m_pieces.push_back({ .submission = s, .begin = begin, .end = end, .survivors = survivors,
+                                 .visibleCount = 0, .firstVisible = 0 });
+            survivors += end - begin + FrustumCuller::kOutputSlack;
+        }
+    }
+    if (m_pieces.empty()) return 0;
+
+    if (m_survivors.size() < survivors) m_survivors.resize(survivors);
+    m_spheres.resize(std::max<size_t>(m_spheres.size(), jobs ? jobs->getThreadCount() : 1));
+
+    forEachPiece(jobs, static_cast<uint32_t>(m_pieces.size()), [&](const uint32_t index, const uint32_t worker) {
+        Piece& piece = m_pieces[index];
+        const Submission& submission = m_submissions[piece.submission];
+        const float radius = m_radii[submission.mesh];
+
+        BoundingSpheres& spheres = m_spheres[worker];
+        spheres.clear();
+        for (uint32_t i = piece.begin; i < piece.end; ++i) {
+            const glm::mat4& model = submission.transforms[i];
+            spheres.add(glm::vec3(model[3]), radius * getMaxScale(model));
+        }
+        piece.visibleCount = m_culler.cullRange(frustum, spheres, 0, spheres.size(),
+                                                m_survivors.data() + piece.survivors);
+    });
+
+    // Pieces are in mesh order, so the prefix sum over them doubles as the batch layout
+    for (Piece& piece : m_pieces) {
+        piece.firstVisible = m_visibleCount;
+        if (piece.visibleCount == 0) continue;
+
+        const uint32_t mesh = m_submissions[piece.submission].mesh;
+        if (m_batches.empty() || m_batches.back().mesh != mesh) {
+            m_batches.push_back({ .mesh = mesh, .firstInstance = m_visibleCount, .instanceCount = 0 });
+        }
+        m_batches.back().instanceCount += piece.visibleCount;
+        m_visibleCount += piece.visibleCount;
+    }
+    return m_visibleCount;
+}
+
+void InstanceBatcher::write(GpuBatchInstance* out, JobSystem* jobs) const {
+    forEachPiece(jobs, static_cast<uint32_t>(m_pieces.size()), [&](const uint32_t index, uint32_t) {
+        const Piece& piece = m_pieces[index];
+        const glm::mat4* transforms = m_submissions[piece.submission].transforms.data() + piece.begin;
+        const uint32_t* visible = m_survivors.data() + piece.survivors;
+        GpuBatchInstance* target = out + piece.firstVisible;
+
+        // Built on the stack and copied whole, since out is usually write-combined memory
+        for (uint32_t i = 0; i < piece.visibleCount; ++i) {
+            GpuBatchInstance instance;
+            instance.model = transforms[visible[i]];
+            setNormalMatrix(instance.normalMatrix, instance.model);
+            std::memcpy(target + i, &instance, sizeof(instance));
+        }
+    });
+}
+
+void InstanceBatcher::clear() {
+    m_submissions.clear();
+    m_submittedCount = 0;
+}
@@ -0,0 +1,84 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::string& path) {
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(m_file, &size);
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) return;
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping ? static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!m_data) {
+        unmap();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+}
+
+void MappedFile::unmap() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    m_file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_file < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat status {};
+    if (fstat(m_file, &status) != 0) {
+        unmap();
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    m_size = static_cast<size_t>(status.st_size);
+    if (m_size == 0) return;
+
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+    if (data == MAP_FAILED) {
+        unmap();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+    m_data = static_cast<const std::byte*>(data);
+    madvise(data, m_size, MADV_SEQUENTIAL);
+}
+
+void MappedFile::unmap() {
+    if (m_data) munmap(const_cast<std::byte*>(m_data), m_size);
+    if (m_file >= 0) close(m_file);
+    m_data = nullptr;
+    m_file = -1;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+}
@@ -0,0 +1,62 @@
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+// Vertex i sits at ((i & 1), (i >> 1 & 1), (i >> 2 & 1)) - 0.5; faces wound counter-clockwise from outside
+constexpr uint32_t kCubeIndices[] = {
+    1, 3, 7, 1, 7, 5,   // +X
+    0, 4, 6, 0, 6, 2,   // -X
+    2, 6, 7, 2, 7, 3,   // +Y
+    0, 1, 5, 0, 5, 4,   // -Y
+    4, 5, 7, 4, 7, 6,   // +Z
+    0, 2, 3, 0, 3, 1    // -Z
+};
+}
+
+Mesh Mesh::cube() {
+    Mesh mesh;
+    for (uint32_t i = 0; i < 8; ++i) {
+        const glm::vec3 corner(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+        mesh.vertices.push_back({
+            .position   = corner - 0.5f,
+            .color      = glm::mix(glm::vec3(0.2f), glm::vec3(1.0f), corner),
+            .normal     = glm::normalize(corner - 0.5f)
+        });
+    }
+    mesh.indices.assign(std::begin(kCubeIndices), std::end(kCubeIndices));
+    return mesh;
+}
+
+Mesh Mesh::uvSphere(const uint32_t segments) {
+    const uint32_t n = std::max(segments, 3u);
+    Mesh mesh;
+    mesh.vertices.reserve(size_t(n + 1) * (n + 1));
+    mesh.indices.reserve(size_t(n) * n * 6);
+
+    // Z+ is up, matching the camera; rows run from the north pole down
+    for (uint32_t v = 0; v <= n; ++v) {
+        const float phi = std::numbers::pi_v<float> * static_cast<float>(v) / static_cast<float>(n);
+        for (uint32_t u = 0; u <= n; ++u) {
+            const float theta = 2.0f * std::numbers::pi_v<float> * static_cast<float>(u) / static_cast<float>(n);
+            const glm::vec3 normal(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi));
+            mesh.vertices.push_back({ .position = normal, .color = normal * 0.5f + 0.5f, .normal = normal });
+        }
+    }
+
+    const uint32_t row = n + 1;
+    for (uint32_t v = 0; v < n; ++v) {
+        for (uint32_t u = 0; u < n; ++u) {
+            const uint32_t a = v * row + u;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + row + 1;
+            const uint32_t d = a + row;
+            // Counter-clockwise seen from outside, like cube(); the pole rows collapse one of each pair
+            if (v > 0) mesh.indices.insert(mesh.indices.end(), { a, c, b });
+            if (v + 1 < n) mesh.indices.insert(mesh.indices.end(), { a, d, c });
+        }
+    }
+    return mesh;
+}
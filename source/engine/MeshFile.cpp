@@ -0,0 +1,133 @@
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+uint64_t alignUp(const uint64_t value, const uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void writePadding(std::ofstream& file, const uint64_t target) {
+    static constexpr char kZeros[256] = {};
+    for (uint64_t position = static_cast<uint64_t>(file.tellp()); position < target;) {
+        const uint64_t count = std::min<uint64_t>(sizeof(kZeros), target - position);
+        file.write(kZeros, static_cast<std::streamsize>(count));
+        position += count;
+    }
+}
+}
+
+MeshFile::MeshFile(const std::string& path) : m_file(path) {
+    const std::byte* data = m_file.getData().data();
+    const size_t size = m_file.getSize();
+
+    if (size < sizeof(MeshFileHeader)) {
+        throw std::runtime_error("Mesh file is truncated: " + path);
+    }
+
+    m_header = reinterpret_cast<const MeshFileHeader*>(data);
+    const MeshFileHeader& header = *m_header;
+    if (header.magic != MeshFileHeader::kMagic || header.version != MeshFileHeader::kVersion) {
+        throw std::runtime_error("Not a version " + std::to_string(MeshFileHeader::kVersion) + " mesh file: " + path);
+    }
+
+    if (header.vertexFormat != MeshVertexFormat::Float && header.vertexFormat != MeshVertexFormat::Packed) {
+        throw std::runtime_error("Mesh file has an unknown vertex format: " + path);
+    }
+    if (header.indexType != VK_INDEX_TYPE_UINT16 && header.indexType != VK_INDEX_TYPE_UINT32) {
+        throw std::runtime_error("Mesh file has an unsupported index type: " + path);
+    }
+
+    // Counts are bounded by the file size first, so the products below cannot wrap
+    const uint64_t expectedStride = header.vertexFormat == MeshVertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    const uint64_t indexSize = header.indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4;
+    if (header.vertexStride != expectedStride || header.lodCount == 0 ||
+        header.vertexCount > size / expectedStride || header.vertexBytes != header.vertexCount * expectedStride ||
+        header.indexCount > size / indexSize || header.indexBytes != header.indexCount * indexSize) {
+        throw std::runtime_error("Mesh file header is inconsistent: " + path);
+    }
+
+    // offset + bytes <= size, written so corrupt offsets cannot wrap around
+    const auto inside = [size](const uint64_t offset, const uint64_t bytes) {
+        return offset <= size && bytes <= size - offset;
+    };
+    if (!inside(sizeof(MeshFileHeader), static_cast<uint64_t>(header.lodCount) * sizeof(MeshFileLod)) ||
+        !inside(header.vertexOffset, header.vertexBytes) ||
+        !inside(header.indexOffset, header.indexBytes)) {
+        throw std::runtime_error("Mesh file streams exceed the file size: " + path);
+    }
+
+    m_lods = { reinterpret_cast<const MeshFileLod*>(data + sizeof(MeshFileHeader)), header.lodCount };
+    for (const MeshFileLod& lod : m_lods) {
+        if (static_cast<uint64_t>(lod.firstIndex) + lod.indexCount > header.indexCount) {
+            throw std::runtime_error("Mesh file LOD exceeds the index stream: " + path);
+        }
+    }
+    m_vertexData = { data + header.vertexOffset, header.vertexBytes };
+    m_indexData = { data + header.indexOffset, header.indexBytes };
+}
+
+void MeshFile::write(const std::string& path, const Mesh& mesh, const MeshVertexFormat format,
+                     const std::vector<MeshFileLod>& lods) {
+    MeshFileHeader header;
+    header.vertexFormat = format;
+    header.indexType = mesh.getIndexType();
+    header.lodCount = lods.empty() ? 1 : static_cast<uint32_t>(lods.size());
+    header.vertexCount = mesh.vertices.size();
+    header.indexCount = mesh.indices.size();
+
+    if (!mesh.vertices.empty()) {
+        header.boundsMin = header.boundsMax = mesh.vertices.front().position;
+    }
+    for (const Vertex& vertex : mesh.vertices) {
+        header.boundsMin = glm::min(header.boundsMin, vertex.position);
+        header.boundsMax = glm::max(header.boundsMax, vertex.position);
+        header.radius = std::max(header.radius, glm::length(vertex.position));
+    }
+
+    // Streams are converted in full before anything is written, so a failed
+    // conversion never leaves a half-written file behind
+    std::vector<PackedVertex> packed;
+    const void* vertexData = mesh.vertices.data();
+    if (format == MeshVertexFormat::Packed) {
+        VertexQuantization quantization;
+        packed = packVertices<PackedVertex>(mesh.vertices, quantization);
+        header.quantizationOffset = quantization.offset;
+        header.quantizationScale = quantization.scale;
+        header.vertexStride = sizeof(PackedVertex);
+        vertexData = packed.data();
+    } else {
+        header.vertexStride = sizeof(Vertex);
+    }
+    const std::vector<uint8_t> indexData = mesh.packIndices();
+
+    const uint64_t lodEnd = sizeof(MeshFileHeader) + header.lodCount * sizeof(MeshFileLod);
+    header.vertexOffset = alignUp(lodEnd, MeshFileHeader::kStreamAlignment);
+    header.vertexBytes = header.vertexCount * header.vertexStride;
+    header.indexOffset = alignUp(header.vertexOffset + header.vertexBytes, MeshFileHeader::kStreamAlignment);
+    header.indexBytes = indexData.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to create mesh file: " + path);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (lods.empty()) {
+        const MeshFileLod whole { .firstIndex = 0, .indexCount = static_cast<uint32_t>(mesh.indices.size()) };
+        file.write(reinterpret_cast<const char*>(&whole), sizeof(whole));
+    } else {
+        file.write(reinterpret_cast<const char*>(lods.data()), static_cast<std::streamsize>(lods.size() * sizeof(MeshFileLod)));
+    }
+
+    writePadding(file, header.vertexOffset);
+    file.write(static_cast<const char*>(vertexData), static_cast<std::streamsize>(header.vertexBytes));
+    writePadding(file, header.indexOffset);
+    file.write(reinterpret_cast<const char*>(indexData.data()), static_cast<std::streamsize>(header.indexBytes));
+
+    if (!file) {
+        throw std::runtime_error("Failed to write mesh file: " + path);
+    }
+}
@@ -0,0 +1,385 @@
+#include "MeshImporter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+
+namespace {
+constexpr float kDefaultGray = 0.8f;
+constexpr int32_t kNoNormal = INT32_MIN;
+
+// One face corner as written. Positive OBJ indices are stored 0-based;
+// negative ones are resolved against the chunk's own element count, which
+// leaves them relative to the chunk start until its base is known.
+struct ObjCorner {
+    int32_t position;
+    int32_t normal;             // kNoNormal when the face gave none
+    bool relativePosition;
+    bool relativeNormal;
+};
+
+// Faces between two o/g statements inside one chunk
+struct ObjGroup {
+    std::string name;
+    bool continues = false;     // Leading faces of a chunk, which belong to the previous chunk's object
+    std::vector<ObjCorner> corners;
+};
+
+struct ObjChunk {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> colors;
+    std::vector<glm::vec3> normals;
+    std::vector<ObjGroup> groups;
+    bool parsed = false;
+};
+
+// An object whose faces have all been seen, waiting to be indexed
+struct ObjObject {
+    uint32_t index = 0;
+    std::string name;
+    std::vector<Vertex> soup;
+    std::vector<uint32_t> positionIds;  // Global position of every soup vertex, for smooth normals
+    bool missingNormals = false;
+};
+
+class Cursor {
+public:
+    explicit Cursor(const std::string_view text) : m_it(text.data()), m_end(text.data() + text.size()) {}
+
+    [[nodiscard]] bool done() const { return m_it == m_end; }
+
+    void skipSpaces() {
+        while (m_it != m_end && (*m_it == ' ' || *m_it == '\t' || *m_it == '\r')) ++m_it;
+    }
+
+    void nextLine() {
+        while (m_it != m_end && *m_it++ != '\n') {}
+    }
+
+    [[nodiscard]] bool atLineEnd() const { return m_it == m_end || *m_it == '\n' || *m_it == '#'; }
+    [[nodiscard]] char peek() const { return m_it != m_end ? *m_it : '\0'; }
+    void advance() { ++m_it; }
+
+    std::string_view word() {
+        skipSpaces();
+        const char* start = m_it;
+        while (m_it != m_end && *m_it != ' ' && *m_it != '\t' && *m_it != '\r' && *m_it != '\n') ++m_it;
+        return { start, static_cast<size_t>(m_it - start) };
+    }
+
+    // The rest of the line without surrounding whitespace
+    std::string_view rest() {
+        skipSpaces();
+        const char* start = m_it;
+        while (m_it != m_end && *m_it != '\n') ++m_it;
+        const char* end = m_it;
+        while (end != start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+        return { start, static_cast<size_t>(end - start) };
+    }
+
+    bool number(float& value) {
+        skipSpaces();
+        const auto [next, error] = std::from_chars(m_it, m_end, value);
+        if (error != std::errc()) return false;
+        m_it = next;
+        return true;
+    }
+
+    bool number(int32_t& value) {
+        const auto [next, error] = std::from_chars(m_it, m_end, value);
+        if (error != std::errc()) return false;
+        m_it = next;
+        return true;
+    }
+
+private:
+    const char* m_it;
+    const char* m_end;
+};
+
+// OBJ indices are 1-based; negative ones count back from the latest element
+void storeIndex(const int32_t written, const size_t localCount, int32_t& index, bool& relative) {
+    if (written == 0) {
+        throw std::runtime_error("OBJ face index 0 is invalid");
+    }
+    relative = written < 0;
+    index = relative ? static_cast<int32_t>(localCount) + written : written - 1;
+}
+
+glm::vec3 readVec3(Cursor& cursor, const char* what) {
+    glm::vec3 value;
+    if (!cursor.number(value.x) || !cursor.number(value.y) || !cursor.number(value.z)) {
+        throw std::runtime_error(std::string("Malformed OBJ ") + what);
+    }
+    return value;
+}
+
+ObjChunk parseObjChunk(const std::string_view text) {
+    ObjChunk chunk;
+    chunk.groups.push_back({ .name = {}, .continues = true, .corners = {} });
+    std::vector<ObjCorner> polygon;
+
+    for (Cursor cursor(text); !cursor.done(); cursor.nextLine()) {
+        const std::string_view keyword = cursor.word();
+
+        if (keyword == "v") {
+            chunk.positions.push_back(readVec3(cursor, "vertex"));
+
+            // x y z [w], or x y z r g b; only exactly six values carry a color
+            float extra[4];
+            uint32_t extraCount = 0;
+            while (extraCount < 4 && cursor.number(extra[extraCount])) ++extraCount;
+            chunk.colors.push_back(extraCount == 3 ? glm::vec3(extra[0], extra[1], extra[2]) : glm::vec3(kDefaultGray));
+        } else if (keyword == "vn") {
+            chunk.normals.push_back(readVec3(cursor, "normal"));
+        } else if (keyword == "f") {
+            polygon.clear();
+            for (cursor.skipSpaces(); !cursor.atLineEnd(); cursor.skipSpaces()) {
+                ObjCorner corner { .position = 0, .normal = kNoNormal, .relativePosition = false, .relativeNormal = false };
+                int32_t written;
+                if (!cursor.number(written)) {
+                    throw std::runtime_error("Malformed OBJ face");
+                }
+                storeIndex(written, chunk.positions.size(), corner.position, corner.relativePosition);
+
+                // p, p/t, p//n or p/t/n; texture coordinates are skipped
+                if (cursor.peek() == '/') {
+                    cursor.advance();
+                    cursor.number(written);
+                    if (cursor.peek() == '/') {
+                        cursor.advance();
+                        if (cursor.number(written)) {
+                            storeIndex(written, chunk.normals.size(), corner.normal, corner.relativeNormal);
+                        }
+                    }
+                }
+                polygon.push_back(corner);
+            }
+
+            std::vector<ObjCorner>& corners = chunk.groups.back().corners;
+            for (size_t i = 2; i < polygon.size(); ++i) {
+                corners.insert(corners.end(), { polygon[0], polygon[i - 1], polygon[i] });
+            }
+        } else if (keyword == "o" || keyword == "g") {
+            chunk.groups.push_back({ .name = std::string(cursor.rest()), .continues = false, .corners = {} });
+        }
+    }
+    return chunk;
+}
+
+// Stitches parsed chunks together in file order. Elements are appended to
+// the global arrays; faces are resolved against them straight into the
+// open object's vertex soup.
+class ObjAssembler {
+public:
+    // Returns the objects the chunk closed
+    std::vector<ObjObject> append(ObjChunk&& chunk) {
+        const size_t positionBase = m_positions.size();
+        const size_t normalBase = m_normals.size();
+        m_positions.insert(m_positions.end(), chunk.positions.begin(), chunk.positions.end());
+        m_colors.insert(m_colors.end(), chunk.colors.begin(), chunk.colors.end());
+        m_normals.insert(m_normals.end(), chunk.normals.begin(), chunk.normals.end());
+
+        std::vector<ObjObject> closed;
+        for (ObjGroup& group : chunk.groups) {
+            if (!group.continues) {
+                close(closed);
+                m_open.name = std::move(group.name);
+            }
+
+            for (const ObjCorner& corner : group.corners) {
+                const size_t position = resolve(corner.position, corner.relativePosition, positionBase, m_positions.size());
+                const glm::vec3 normal = corner.normal != kNoNormal
+                    ? m_normals[resolve(corner.normal, corner.relativeNormal, normalBase, m_normals.size())]
+                    : glm::vec3(0.0f);
+
+                // Zero normals are filled in once the object is complete
+                const float length = glm::length(normal);
+                m_open.missingNormals |= length == 0.0f;
+                m_open.soup.push_back({
+                    .position   = m_positions[position],
+                    .color      = m_colors[position],
+                    .normal     = length > 0.0f ? normal / length : glm::vec3(0.0f)
+                });
+                m_open.positionIds.push_back(static_cast<uint32_t>(position));
+            }
+        }
+        return closed;
+    }
+
+    // Closes the object still open at the end of the file
+    std::vector<ObjObject> finish() {
+        std::vector<ObjObject> closed;
+        close(closed);
+        return closed;
+    }
+
+private:
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::vec3> m_colors;
+    std::vector<glm::vec3> m_normals;
+    ObjObject m_open;
+    uint32_t m_nextIndex = 0;
+
+    static size_t resolve(const int32_t index, const bool relative, const size_t base, const size_t count) {
+        const int64_t resolved = relative ? static_cast<int64_t>(base) + index : index;
+        if (resolved < 0 || resolved >= static_cast<int64_t>(count)) {
+            throw std::runtime_error("OBJ face index " + std::to_string(resolved + 1) + " is out of range");
+        }
+        return static_cast<size_t>(resolved);
+    }
+
+    // Objects without faces (consecutive o/g statements) are dropped
+    void close(std::vector<ObjObject>& closed) {
+        if (!m_open.soup.empty()) {
+            m_open.index = m_nextIndex++;
+            closed.push_back(std::move(m_open));
+        }
+        m_open = {};
+    }
+};
+
+// Area-weighted normals for corners the file left without a usable one
+void computeMissingNormals(ObjObject& object) {
+    const auto [lowest, highest] = std::ranges::minmax(object.positionIds);
+    std::vector<glm::vec3> accumulated(highest - lowest + 1, glm::vec3(0.0f));
+
+    // The cross product's length is twice the triangle area, which weights the sum
+    for (size_t t = 0; t + 2 < object.soup.size(); t += 3) {
+        const glm::vec3 faceNormal = glm::cross(object.soup[t + 1].position - object.soup[t].position,
+                                                object.soup[t + 2].position - object.soup[t].position);
+        for (size_t k = 0; k < 3; ++k) {
+            accumulated[object.positionIds[t + k] - lowest] += faceNormal;
+        }
+    }
+
+    for (size_t i = 0; i < object.soup.size(); ++i) {
+        Vertex& vertex = object.soup[i];
+        if (vertex.normal != glm::vec3(0.0f)) continue;
+
+        const glm::vec3& sum = accumulated[object.positionIds[i] - lowest];
+        const float length = glm::length(sum);
+        vertex.normal = length > 0.0f ? sum / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+}
+}
+
+MeshImporter::MeshImporter(JobSystem& jobs) : MeshImporter(jobs, Options {}) {}
+
+MeshImporter::MeshImporter(JobSystem& jobs, const Options& options) : m_jobs(jobs), m_options(options) {}
+
+void MeshImporter::import(const std::string& path, const MeshCallback& onMesh) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::ranges::transform(extension, extension.begin(), [](const unsigned char c) { return std::tolower(c); });
+
+    if (extension == ".obj") {
+        importObj(path, onMesh);
+    } else if (extension == ".gltf" || extension == ".glb") {
+        importGltf(path, onMesh);
+    } else {
+        throw std::runtime_error("Unsupported mesh format: " + path);
+    }
+}
+
+std::vector<ImportedMesh> MeshImporter::import(const std::string& path) {
+    std::vector<ImportedMesh> meshes;
+    std::mutex mutex;
+    import(path, [&](ImportedMesh&& mesh) {
+        std::lock_guard lock(mutex);
+        meshes.push_back(std::move(mesh));
+    });
+
+    std::ranges::sort(meshes, {}, &ImportedMesh::index);
+    return meshes;
+}
+
+void MeshImporter::finish(ImportedMesh&& mesh, const MeshCallback& onMesh) const {
+    if (m_options.optimize) {
+        MeshOptimizer::optimize(mesh.mesh);
+    }
+    onMesh(std::move(mesh));
+}
+
+void MeshImporter::importObj(const std::string& path, const MeshCallback& onMesh) {
+    const MappedFile file(path);
+    const std::string_view text(reinterpret_cast<const char*>(file.getData().data()), file.getSize());
+
+    // Chunks end just past a newline, so no line straddles two tasks
+    std::vector<std::string_view> slices;
+    for (size_t begin = 0; begin < text.size();) {
+        size_t end = text.find('\n', std::min(text.size(), begin + std::max<size_t>(1, m_options.objChunkBytes)) - 1);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+        slices.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<ObjChunk> chunks(slices.size());
+    ObjAssembler assembler;
+    std::deque<ObjObject> ready;
+    size_t frontier = 0;
+    bool assembling = false;
+    std::mutex mutex;
+    TaskErrors errors;
+
+    const auto build = [&](ObjObject&& object) {
+        if (object.missingNormals) computeMissingNormals(object);
+        ImportedMesh mesh {
+            .index  = object.index,
+            .name   = std::move(object.name),
+            .mesh   = MeshOptimizer::buildIndexed(object.soup)
+        };
+        object = {};
+        finish(std::move(mesh), onMesh);
+    };
+
+    m_jobs.parallelFor(static_cast<uint32_t>(slices.size()), [&](const uint32_t task, uint32_t) {
+        errors.run([&] {
+            ObjChunk chunk = parseObjChunk(slices[task]);
+            chunk.parsed = true;
+
+            // Whoever completes the frontier stitches every consecutive finished
+            // chunk; the others go straight on to building closed objects
+            std::unique_lock lock(mutex);
+            chunks[task] = std::move(chunk);
+            if (!assembling) {
+                assembling = true;
+                while (frontier < chunks.size() && chunks[frontier].parsed) {
+                    ObjChunk next = std::move(chunks[frontier]);
+                    chunks[frontier++] = {};
+                    lock.unlock();
+
+                    std::vector<ObjObject> closed = assembler.append(std::move(next));
+
+                    lock.lock();
+                    std::ranges::move(closed, std::back_inserter(ready));
+                }
+                assembling = false;
+            }
+
+            while (!ready.empty() && !errors.failed()) {
+                ObjObject object = std::move(ready.front());
+                ready.pop_front();
+                lock.unlock();
+                build(std::move(object));
+                lock.lock();
+            }
+        });
+    });
+    errors.rethrow();
+
+    // Objects closed by the last chunks, and the one still open at the end
+    std::vector<ObjObject> last = assembler.finish();
+    std::ranges::move(last, std::back_inserter(ready));
+    m_jobs.parallelFor(static_cast<uint32_t>(ready.size()), [&](const uint32_t task, uint32_t) {
+        errors.run([&] { build(std::move(ready[task])); });
+    });
+    errors.rethrow();
+}
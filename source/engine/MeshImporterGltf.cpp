@@ -0,0 +1,594 @@
+#include "MeshImporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+namespace {
+constexpr uint32_t kGlbMagic = 0x46546C67;      // "glTF"
+constexpr uint32_t kGlbJsonChunk = 0x4E4F534A;  // "JSON"
+constexpr uint32_t kGlbBinChunk = 0x004E4942;   // "BIN\0"
+constexpr uint32_t kMaxJsonDepth = 128;
+
+constexpr uint32_t kComponentByte = 5120;
+constexpr uint32_t kComponentUnsignedByte = 5121;
+constexpr uint32_t kComponentShort = 5122;
+constexpr uint32_t kComponentUnsignedShort = 5123;
+constexpr uint32_t kComponentUnsignedInt = 5125;
+constexpr uint32_t kComponentFloat = 5126;
+constexpr uint32_t kModeTriangles = 4;
+
+constexpr float kDefaultGray = 0.8f;
+
+std::runtime_error gltfError(const std::string& message) {
+    return std::runtime_error("glTF: " + message);
+}
+
+// Just enough JSON for glTF documents, which are small next to their buffers
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    [[nodiscard]] const JsonValue* find(const std::string_view key) const {
+        for (const auto& [name, value] : members) {
+            if (name == key) return &value;
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] double numberOr(const std::string_view key, const double fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Type::Number ? value->number : fallback;
+    }
+
+    [[nodiscard]] const JsonValue& at(const std::string_view key) const {
+        const JsonValue* value = find(key);
+        if (!value) throw gltfError("missing \"" + std::string(key) + "\"");
+        return *value;
+    }
+
+    // Non-negative integer member such as a count, offset or index; NaN, fractions and negatives are rejected
+    [[nodiscard]] size_t sizeAt(const std::string_view key) const {
+        return toSize(key, at(key));
+    }
+
+    [[nodiscard]] size_t sizeOr(const std::string_view key, const size_t fallback) const {
+        const JsonValue* value = find(key);
+        return value ? toSize(key, *value) : fallback;
+    }
+
+    // Element of a top-level array such as "accessors", by index
+    [[nodiscard]] const JsonValue& element(const std::string_view key, const size_t index) const {
+        const JsonValue& list = at(key);
+        if (list.type != Type::Array || index >= list.array.size()) {
+            throw gltfError(std::string(key) + " index " + std::to_string(index) + " is out of range");
+        }
+        return list.array[index];
+    }
+
+private:
+    static size_t toSize(const std::string_view key, const JsonValue& value) {
+        // Up to 2^53, so every accepted value is exact in the double it came from
+        if (value.type != Type::Number || !(value.number >= 0.0) || value.number > 9007199254740992.0 ||
+            value.number != std::floor(value.number)) {
+            throw gltfError("\"" + std::string(key) + "\" must be a non-negative integer");
+        }
+        return static_cast<size_t>(value.number);
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string_view text) : m_it(text.data()), m_end(text.data() + text.size()) {}
+
+    JsonValue parse() {
+        JsonValue value = parseValue(0);
+        skipSpaces();
+        if (m_it != m_end) throw gltfError("trailing characters after the JSON document");
+        return value;
+    }
+
+private:
+    const char* m_it;
+    const char* m_end;
+
+    void skipSpaces() {
+        while (m_it != m_end && (*m_it == ' ' || *m_it == '\t' || *m_it == '\n' || *m_it == '\r')) ++m_it;
+    }
+
+    void expect(const char c) {
+        skipSpaces();
+        if (m_it == m_end || *m_it != c) throw gltfError(std::string("malformed JSON, expected '") + c + "'");
+        ++m_it;
+    }
+
+    bool consume(const char c) {
+        skipSpaces();
+        if (m_it == m_end || *m_it != c) return false;
+        ++m_it;
+        return true;
+    }
+
+    bool consumeWord(const std::string_view word) {
+        if (static_cast<size_t>(m_end - m_it) < word.size() || std::string_view(m_it, word.size()) != word) return false;
+        m_it += word.size();
+        return true;
+    }
+
+    JsonValue parseValue(const uint32_t depth) {
+        if (depth > kMaxJsonDepth) throw gltfError("JSON nesting is too deep");
+
+        skipSpaces();
+        if (m_it == m_end) throw gltfError("unexpected end of JSON");
+
+        JsonValue value;
+        if (*m_it == '{') {
+            ++m_it;
+            value.type = JsonValue::Type::Object;
+            if (consume('}')) return value;
+            do {
+                skipSpaces();
+                std::string key = parseString();
+                expect(':');
+                value.members.emplace_back(std::move(key), parseValue(depth + 1));
+            } while (consume(','));
+            expect('}');
+        } else if (*m_it == '[') {
+            ++m_it;
+            value.type = JsonValue::Type::Array;
+            if (consume(']')) return value;
+            do {
+                value.array.push_back(parseValue(depth + 1));
+            } while (consume(','));
+            expect(']');
+        } else if (*m_it == '"') {
+            value.type = JsonValue::Type::String;
+            value.string = parseString();
+        } else if (consumeWord("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+        } else if (consumeWord("false")) {
+            value.type = JsonValue::Type::Bool;
+        } else if (consumeWord("null")) {
+            value.type = JsonValue::Type::Null;
+        } else {
+            value.type = JsonValue::Type::Number;
+            const auto [next, error] = std::from_chars(m_it, m_end, value.number);
+            if (error != std::errc()) throw gltfError("malformed JSON value");
+            m_it = next;
+        }
+        return value;
+    }
+
+    std::string parseString() {
+        if (m_it == m_end || *m_it != '"') throw gltfError("malformed JSON, expected a string");
+        ++m_it;
+
+        std::string result;
+        while (m_it != m_end && *m_it != '"') {
+            if (*m_it != '\\') {
+                result += *m_it++;
+                continue;
+            }
+            if (++m_it == m_end) break;
+            switch (const char escape = *m_it++) {
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': appendCodePoint(result, parseHex4()); break;
+                default:  result += escape; break;
+            }
+        }
+        if (m_it == m_end) throw gltfError("unterminated JSON string");
+        ++m_it;
+        return result;
+    }
+
+    uint32_t parseHex4() {
+        uint32_t value = 0;
+        if (m_end - m_it < 4 || std::from_chars(m_it, m_it + 4, value, 16).ptr != m_it + 4) {
+            throw gltfError("malformed JSON unicode escape");
+        }
+        m_it += 4;
+        return value;
+    }
+
+    // \uXXXX escapes as UTF-8, with surrogate pairs combined
+    void appendCodePoint(std::string& out, uint32_t codePoint) {
+        if (codePoint >= 0xD800 && codePoint < 0xDC00 && consumeWord("\\u")) {
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (parseHex4() - 0xDC00);
+        }
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+};
+
+std::vector<std::byte> decodeBase64(const std::string_view text) {
+    const auto sextet = [](const char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+    };
+
+    std::vector<std::byte> bytes;
+    bytes.reserve(text.size() / 4 * 3);
+    uint32_t bits = 0;
+    int count = 0;
+    for (const char c : text) {
+        const int value = sextet(c);
+        if (value < 0) continue;  // Padding and whitespace
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        if (++count == 4) {
+            bytes.push_back(static_cast<std::byte>(bits >> 16));
+            bytes.push_back(static_cast<std::byte>(bits >> 8));
+            bytes.push_back(static_cast<std::byte>(bits));
+            bits = 0;
+            count = 0;
+        }
+    }
+    if (count >= 2) bytes.push_back(static_cast<std::byte>(bits >> (count * 6 - 8)));
+    if (count == 3) bytes.push_back(static_cast<std::byte>(bits >> 2));
+    return bytes;
+}
+
+std::string decodePercent(const std::string_view uri) {
+    std::string result;
+    for (size_t i = 0; i < uri.size(); ++i) {
+        uint32_t value = 0;
+        if (uri[i] == '%' && i + 2 < uri.size() && std::from_chars(&uri[i + 1], &uri[i + 3], value, 16).ptr == &uri[i + 3]) {
+            result += static_cast<char>(value);
+            i += 2;
+        } else {
+            result += uri[i];
+        }
+    }
+    return result;
+}
+
+uint32_t readU32(const std::byte* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// The document and every buffer it references, kept alive for the decode tasks
+struct GltfAsset {
+    std::unique_ptr<MappedFile> file;
+    JsonValue document;
+    std::vector<std::span<const std::byte>> buffers;
+    std::vector<std::unique_ptr<MappedFile>> externalBuffers;
+    std::vector<std::vector<std::byte>> embeddedBuffers;
+};
+
+GltfAsset loadGltf(const std::string& path) {
+    GltfAsset asset;
+    asset.file = std::make_unique<MappedFile>(path);
+    const std::span<const std::byte> data = asset.file->getData();
+
+    std::string_view json(reinterpret_cast<const char*>(data.data()), data.size());
+    std::span<const std::byte> glbBinary;
+    if (data.size() >= 12 && readU32(data.data()) == kGlbMagic) {
+        // Binary container: a JSON chunk, then an optional BIN chunk for buffer 0
+        json = {};
+        for (size_t offset = 12; offset + 8 <= data.size();) {
+            const uint32_t length = readU32(data.data() + offset);
+            const uint32_t type = readU32(data.data() + offset + 4);
+            if (offset + 8 + length > data.size()) throw gltfError("truncated GLB chunk in " + path);
+
+            if (type == kGlbJsonChunk) json = { reinterpret_cast<const char*>(data.data() + offset + 8), length };
+            if (type == kGlbBinChunk) glbBinary = data.subspan(offset + 8, length);
+            offset += 8 + ((length + 3) & ~3u);
+        }
+        if (json.empty()) throw gltfError("GLB without a JSON chunk: " + path);
+    }
+
+    asset.document = JsonParser(json).parse();
+
+    const JsonValue* buffers = asset.document.find("buffers");
+    if (!buffers) return asset;
+
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    for (const JsonValue& buffer : buffers->array) {
+        const JsonValue* uri = buffer.find("uri");
+        if (!uri) {
+            asset.buffers.push_back(glbBinary);
+        } else if (uri->string.starts_with("data:")) {
+            const size_t comma = uri->string.find(',');
+            if (comma == std::string::npos || uri->string.rfind(";base64", comma) == std::string::npos) {
+                throw gltfError("only base64 data URIs are supported");
+            }
+            asset.embeddedBuffers.push_back(decodeBase64(std::string_view(uri->string).substr(comma + 1)));
+            asset.buffers.emplace_back(asset.embeddedBuffers.back());
+        } else {
+            asset.externalBuffers.push_back(std::make_unique<MappedFile>((directory / decodePercent(uri->string)).string()));
+            asset.buffers.push_back(asset.externalBuffers.back()->getData());
+        }
+
+        const size_t length = buffer.sizeOr("byteLength", 0);
+        if (asset.buffers.back().size() < length) throw gltfError("buffer is shorter than its byteLength");
+    }
+    return asset;
+}
+
+// Strided view of one accessor's elements
+struct Accessor {
+    const std::byte* data = nullptr;
+    size_t count = 0;
+    size_t stride = 0;
+    uint32_t componentType = 0;
+    uint32_t components = 0;
+    bool normalized = false;
+
+    [[nodiscard]] float read(const size_t element, const uint32_t component) const {
+        const std::byte* p = data + element * stride;
+        switch (componentType) {
+            case kComponentFloat: {
+                float value;
+                std::memcpy(&value, p + component * 4, 4);
+                return value;
+            }
+            case kComponentUnsignedByte: {
+                const auto value = static_cast<float>(std::to_integer<uint8_t>(p[component]));
+                return normalized ? value / 255.0f : value;
+            }
+            case kComponentByte: {
+                const auto value = static_cast<float>(static_cast<int8_t>(std::to_integer<uint8_t>(p[component])));
+                return normalized ? std::max(value / 127.0f, -1.0f) : value;
+            }
+            case kComponentUnsignedShort: {
+                uint16_t value;
+                std::memcpy(&value, p + component * 2, 2);
+                return normalized ? value / 65535.0f : value;
+            }
+            case kComponentShort: {
+                int16_t value;
+                std::memcpy(&value, p + component * 2, 2);
+                return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+            }
+            default:
+                throw gltfError("unsupported accessor component type " + std::to_string(componentType));
+        }
+    }
+
+    [[nodiscard]] glm::vec3 readVec3(const size_t element) const {
+        return { read(element, 0), read(element, 1), read(element, 2) };
+    }
+
+    [[nodiscard]] uint32_t readIndex(const size_t element) const {
+        const std::byte* p = data + element * stride;
+        switch (componentType) {
+            case kComponentUnsignedByte: return std::to_integer<uint8_t>(*p);
+            case kComponentUnsignedShort: { uint16_t value; std::memcpy(&value, p, 2); return value; }
+            case kComponentUnsignedInt: { uint32_t value; std::memcpy(&value, p, 4); return value; }
+            default: throw gltfError("unsupported index component type " + std::to_string(componentType));
+        }
+    }
+};
+
+uint32_t componentSize(const uint32_t componentType) {
+    switch (componentType) {
+        case kComponentByte:
+        case kComponentUnsignedByte: return 1;
+        case kComponentShort:
+        case kComponentUnsignedShort: return 2;
+        case kComponentUnsignedInt:
+        case kComponentFloat: return 4;
+        default: throw gltfError("unsupported accessor component type " + std::to_string(componentType));
+    }
+}
+
+uint32_t componentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    throw gltfError("unsupported accessor type " + type);
+}
+
+// offset + length <= limit, without overflowing
+bool fits(const size_t offset, const size_t length, const size_t limit) {
+    return offset <= limit && length <= limit - offset;
+}
+
+Accessor resolveAccessor(const GltfAsset& asset, const size_t index) {
+    const JsonValue& json = asset.document.element("accessors", index);
+    if (json.find("sparse")) throw gltfError("sparse accessors are not supported");
+    if (!json.find("bufferView")) throw gltfError("accessors without a bufferView are not supported");
+
+    // Anything past 32 bits becomes 0, which componentSize() rejects
+    const size_t componentType = json.sizeAt("componentType");
+    Accessor accessor {
+        .data           = nullptr,
+        .count          = json.sizeAt("count"),
+        .stride         = 0,
+        .componentType  = componentType <= UINT32_MAX ? static_cast<uint32_t>(componentType) : 0,
+        .components     = componentCount(json.at("type").string),
+        .normalized     = json.find("normalized") && json.at("normalized").boolean
+    };
+    const size_t elementSize = componentSize(accessor.componentType) * accessor.components;
+
+    const JsonValue& view = asset.document.element("bufferViews", json.sizeAt("bufferView"));
+    const size_t buffer = view.sizeAt("buffer");
+    if (buffer >= asset.buffers.size()) throw gltfError("bufferView references a missing buffer");
+
+    const size_t viewOffset = view.sizeOr("byteOffset", 0);
+    const size_t viewLength = view.sizeAt("byteLength");
+    const size_t accessorOffset = json.sizeOr("byteOffset", 0);
+    accessor.stride = view.sizeOr("byteStride", elementSize);
+    if (accessor.stride < elementSize) throw gltfError("byteStride is smaller than the accessor's elements");
+
+    // offset + stride * (count - 1) + elementSize <= viewLength, rearranged so nothing can wrap
+    if (!fits(viewOffset, viewLength, asset.buffers[buffer].size()) ||
+        (accessor.count > 0 && (!fits(accessorOffset, elementSize, viewLength) ||
+                                accessor.count - 1 > (viewLength - accessorOffset - elementSize) / accessor.stride))) {
+        throw gltfError("accessor exceeds its buffer");
+    }
+    accessor.data = asset.buffers[buffer].data() + viewOffset + accessorOffset;
+    return accessor;
+}
+
+// Accessor::read() covers floats and 8/16-bit integers; normalized integers
+// are how KHR_mesh_quantization stores normals and colors
+void checkAttribute(const Accessor& accessor, const char* name, const uint32_t minComponents,
+                    const uint32_t maxComponents, const bool normalizedOnly) {
+    if (accessor.components < minComponents || accessor.components > maxComponents) {
+        throw gltfError(std::string(name) + " has the wrong number of components");
+    }
+    const bool integer = accessor.componentType != kComponentFloat;
+    if (integer && (accessor.componentType == kComponentUnsignedInt || (normalizedOnly && !accessor.normalized))) {
+        throw gltfError(std::string(name) + " has an unsupported component type");
+    }
+}
+
+struct GltfPrimitive {
+    std::string name;
+    const JsonValue* json;
+};
+
+// Decodes one triangle primitive. The per-element passes run over ranges of
+// grain elements on the job system, so one huge accessor still spreads across
+// workers; every accessor is validated first, since jobs must not throw.
+Mesh decodePrimitive(const GltfAsset& asset, const JsonValue& primitive, JobSystem& jobs, const uint32_t grain) {
+    const JsonValue& attributes = primitive.at("attributes");
+    const Accessor positions = resolveAccessor(asset, attributes.sizeAt("POSITION"));
+    checkAttribute(positions, "POSITION", 3, 3, false);
+    if (positions.count > UINT32_MAX) throw gltfError("POSITION has more than 2^32 elements");
+
+    std::optional<Accessor> colors;
+    if (attributes.find("COLOR_0")) {
+        colors = resolveAccessor(asset, attributes.sizeAt("COLOR_0"));
+        checkAttribute(*colors, "COLOR_0", 3, 4, true);
+    }
+    std::optional<Accessor> normals;
+    if (attributes.find("NORMAL")) {
+        normals = resolveAccessor(asset, attributes.sizeAt("NORMAL"));
+        checkAttribute(*normals, "NORMAL", 3, 3, true);
+    }
+    std::optional<Accessor> indices;
+    if (primitive.find("indices")) {
+        indices = resolveAccessor(asset, primitive.sizeAt("indices"));
+        if (indices->components != 1 || indices->normalized || (indices->componentType != kComponentUnsignedByte &&
+            indices->componentType != kComponentUnsignedShort && indices->componentType != kComponentUnsignedInt)) {
+            throw gltfError("indices must be unsigned SCALAR");
+        }
+        if (indices->count > UINT32_MAX) throw gltfError("more than 2^32 indices");
+    }
+
+    Mesh mesh;
+    const auto vertexCount = static_cast<uint32_t>(positions.count);
+    const bool hasNormals = normals && normals->count >= vertexCount;
+    mesh.vertices.resize(vertexCount);
+    jobs.parallelFor(vertexCount, grain, [&](const uint32_t begin, const uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; ++i) {
+            mesh.vertices[i] = {
+                .position   = positions.readVec3(i),
+                .color      = colors && i < colors->count ? colors->readVec3(i) : glm::vec3(kDefaultGray),
+                .normal     = hasNormals ? normals->readVec3(i) : glm::vec3(0.0f)
+            };
+        }
+    });
+
+    const auto indexCount = static_cast<uint32_t>(indices ? indices->count : vertexCount);
+    mesh.indices.resize(indexCount - indexCount % 3);
+    std::atomic<bool> outOfRange = false;
+    jobs.parallelFor(static_cast<uint32_t>(mesh.indices.size()), grain,
+                     [&](const uint32_t begin, const uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; ++i) {
+            mesh.indices[i] = indices ? indices->readIndex(i) : i;
+            if (mesh.indices[i] >= vertexCount) outOfRange.store(true, std::memory_order_relaxed);
+        }
+    });
+    if (outOfRange.load(std::memory_order_relaxed)) throw gltfError("index out of range");
+
+    if (!hasNormals) {
+        // Area-weighted, as the cross product's length is twice the triangle area; a scatter, so serial
+        for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+            Vertex& a = mesh.vertices[mesh.indices[t]];
+            Vertex& b = mesh.vertices[mesh.indices[t + 1]];
+            Vertex& c = mesh.vertices[mesh.indices[t + 2]];
+            const glm::vec3 faceNormal = glm::cross(b.position - a.position, c.position - a.position);
+            a.normal += faceNormal;
+            b.normal += faceNormal;
+            c.normal += faceNormal;
+        }
+    }
+    jobs.parallelFor(vertexCount, grain, [&](const uint32_t begin, const uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; ++i) {
+            glm::vec3& normal = mesh.vertices[i].normal;
+            const float length = glm::length(normal);
+            normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+        }
+    });
+    return mesh;
+}
+}
+
+void MeshImporter::importGltf(const std::string& path, const MeshCallback& onMesh) {
+    const GltfAsset asset = loadGltf(path);
+
+    // Every triangle primitive becomes its own mesh and its own task, which splits its accessors further
+    std::vector<GltfPrimitive> primitives;
+    if (const JsonValue* meshes = asset.document.find("meshes")) {
+        for (size_t m = 0; m < meshes->array.size(); ++m) {
+            const JsonValue& mesh = meshes->array[m];
+            const JsonValue* name = mesh.find("name");
+            const std::string meshName = name ? name->string : "mesh" + std::to_string(m);
+
+            const std::vector<JsonValue>& list = mesh.at("primitives").array;
+            for (size_t p = 0; p < list.size(); ++p) {
+                if (list[p].numberOr("mode", kModeTriangles) != kModeTriangles) continue;
+                primitives.push_back({
+                    .name = list.size() > 1 ? meshName + "/" + std::to_string(p) : meshName,
+                    .json = &list[p]
+                });
+            }
+        }
+    }
+
+    TaskErrors errors;
+    m_jobs.parallelFor(static_cast<uint32_t>(primitives.size()), [&](const uint32_t task, uint32_t) {
+        errors.run([&] {
+            finish({
+                .index  = task,
+                .name   = primitives[task].name,
+                .mesh   = decodePrimitive(asset, *primitives[task].json, m_jobs,
+                                          std::max(1u, m_options.gltfElementsPerTask))
+            }, onMesh);
+        });
+    });
+    errors.rethrow();
+}
@@ -0,0 +1,435 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+// Forsyth's tuned scoring constants; the LRU model is larger than the FIFO
+// ones real GPUs use, which keeps the order good across cache sizes
+constexpr uint32_t kScoreCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+constexpr uint32_t kMaxTabulatedValence = 32;
+
+// Overdraw clustering simulates the same cache the analyzer defaults to
+constexpr uint32_t kClusterCacheSize = 16;
+
+static_assert(sizeof(Vertex) == 9 * sizeof(float), "Vertex hashing assumes no padding");
+
+struct VertexHash {
+    size_t operator()(const Vertex& vertex) const {
+        uint32_t words[sizeof(Vertex) / sizeof(uint32_t)];
+        std::memcpy(words, &vertex, sizeof(words));
+        size_t hash = 0;
+        for (const uint32_t word : words) {
+            hash = (hash ^ word) * 0x100000001b3ull; // FNV-1a over 32-bit words
+        }
+        return hash;
+    }
+};
+
+// Bitwise, so -0.0 and 0.0 stay distinct and NaNs still merge with themselves
+struct VertexEqual {
+    bool operator()(const Vertex& a, const Vertex& b) const {
+        return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+    }
+};
+
+// Scores for each cache position and small valences, computed once
+struct ScoreTables {
+    float cache[kScoreCacheSize];
+    float valence[kMaxTabulatedValence + 1];
+
+    ScoreTables() {
+        for (uint32_t i = 0; i < kScoreCacheSize; ++i) {
+            // The last triangle's vertices score flat, so its neighbours don't win just for sharing an edge
+            cache[i] = i < 3 ? kLastTriangleScore
+                             : std::pow(1.0f - static_cast<float>(i - 3) / (kScoreCacheSize - 3), kCacheDecayPower);
+        }
+        valence[0] = 0.0f;
+        for (uint32_t i = 1; i <= kMaxTabulatedValence; ++i) {
+            valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+        }
+    }
+};
+
+float vertexScore(const ScoreTables& tables, const int32_t cachePosition, const uint32_t liveTriangles) {
+    if (liveTriangles == 0) return 0.0f;
+
+    // Vertices with few triangles left are finished off before they get evicted
+    const float valence = liveTriangles <= kMaxTabulatedValence
+        ? tables.valence[liveTriangles]
+        : kValenceBoostScale * std::pow(static_cast<float>(liveTriangles), -kValenceBoostPower);
+    return (cachePosition >= 0 ? tables.cache[cachePosition] : 0.0f) + valence;
+}
+
+// Timestamp FIFO: a vertex hits while fewer than `size` misses happened since it was loaded
+class FifoCache {
+public:
+    FifoCache(const size_t vertexCount, const uint32_t size)
+        : m_stamps(vertexCount, 0), m_time(size + 1), m_size(size) {}
+
+    // Returns the number of misses for the triangle
+    uint32_t access(const uint32_t* triangle) {
+        uint32_t misses = 0;
+        for (uint32_t k = 0; k < 3; ++k) {
+            if (m_time - m_stamps[triangle[k]] > m_size) {
+                m_stamps[triangle[k]] = m_time++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    void reset() { m_time += m_size + 1; }
+
+private:
+    std::vector<uint32_t> m_stamps;
+    uint32_t m_time;
+    uint32_t m_size;
+};
+}
+
+Mesh MeshOptimizer::buildIndexed(const std::vector<Vertex>& vertices) {
+    Mesh mesh;
+    mesh.indices.reserve(vertices.size());
+
+    std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> unique;
+    unique.reserve(vertices.size());
+
+    for (const Vertex& vertex : vertices) {
+        const auto [it, inserted] = unique.try_emplace(vertex, static_cast<uint32_t>(mesh.vertices.size()));
+        if (inserted) {
+            mesh.vertices.push_back(vertex);
+        }
+        mesh.indices.push_back(it->second);
+    }
+    return mesh;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, const size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Per-vertex lists of the triangles not emitted yet; the live count is each list's length
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (const uint32_t index : indices) {
+        ++liveTriangles[index];
+    }
+
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] = offsets[v] + liveTriangles[v];
+    }
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    static const ScoreTables tables;
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScores[v] = vertexScore(tables, -1, liveTriangles[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                            vertexScores[indices[t * 3 + 2]];
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    // Three spare entries hold what the newest triangle pushes out, so those vertices get rescored too
+    uint32_t cache[kScoreCacheSize + 3];
+    uint32_t cacheCount = 0;
+    size_t inputCursor = 0;
+    int64_t best = static_cast<int64_t>(std::max_element(triangleScores.begin(), triangleScores.end()) -
+                                        triangleScores.begin());
+
+    while (result.size() < indices.size()) {
+        if (best < 0) {
+            // Nothing in the cache has triangles left: restart from the next one in input order
+            while (emitted[inputCursor]) ++inputCursor;
+            best = static_cast<int64_t>(inputCursor);
+        }
+
+        const uint32_t* triangle = &indices[static_cast<size_t>(best) * 3];
+        result.insert(result.end(), triangle, triangle + 3);
+        emitted[static_cast<size_t>(best)] = true;
+
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t v = triangle[k];
+            uint32_t* list = &adjacency[offsets[v]];
+            uint32_t* last = list + liveTriangles[v];
+            if (uint32_t* it = std::find(list, last, static_cast<uint32_t>(best)); it != last) {
+                *it = *(last - 1);
+                --liveTriangles[v];
+            }
+        }
+
+        // Most recent first: the triangle's vertices, then the previous entries that aren't among them
+        uint32_t newCache[kScoreCacheSize + 6];
+        uint32_t newCount = 0;
+        for (uint32_t k = 0; k < 3; ++k) {
+            if (std::find(newCache, newCache + newCount, triangle[k]) == newCache + newCount) {
+                newCache[newCount++] = triangle[k];
+            }
+        }
+        const uint32_t triangleVertices = newCount;
+        for (uint32_t i = 0; i < cacheCount; ++i) {
+            if (std::find(newCache, newCache + triangleVertices, cache[i]) == newCache + triangleVertices) {
+                newCache[newCount++] = cache[i];
+            }
+        }
+        newCount = std::min(newCount, kScoreCacheSize + 3);
+
+        for (uint32_t i = 0; i < newCount; ++i) {
+            cachePosition[newCache[i]] = i < kScoreCacheSize ? static_cast<int32_t>(i) : -1;
+        }
+
+        // Only triangles touching the cache changed score, so the next pick comes from them
+        for (uint32_t i = 0; i < newCount; ++i) {
+            const uint32_t v = newCache[i];
+            const float score = vertexScore(tables, cachePosition[v], liveTriangles[v]);
+            const float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            for (uint32_t j = 0; j < liveTriangles[v]; ++j) {
+                triangleScores[adjacency[offsets[v] + j]] += delta;
+            }
+        }
+
+        best = -1;
+        float bestScore = -1.0f;
+        for (uint32_t i = 0; i < newCount; ++i) {
+            const uint32_t v = newCache[i];
+            for (uint32_t j = 0; j < liveTriangles[v]; ++j) {
+                const uint32_t t = adjacency[offsets[v] + j];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, kScoreCacheSize);
+        std::copy_n(newCache, cacheCount, cache);
+    }
+
+    indices = std::move(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                                     const float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Hard boundaries: triangles that miss on all three vertices start a new strip anyway
+    std::vector<uint32_t> hardBoundaries;
+    {
+        FifoCache cache(vertices.size(), kClusterCacheSize);
+        for (uint32_t t = 0; t < triangleCount; ++t) {
+            if (cache.access(&indices[t * 3]) == 3 || t == 0) {
+                hardBoundaries.push_back(t);
+            }
+        }
+        hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+    }
+
+    // Soft boundaries: split a strip early once its running ACMR is within threshold of the whole strip's
+    std::vector<uint32_t> clusters;
+    FifoCache cache(vertices.size(), kClusterCacheSize);
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h) {
+        const uint32_t start = hardBoundaries[h];
+        const uint32_t end = hardBoundaries[h + 1];
+
+        cache.reset();
+        uint32_t misses = 0;
+        for (uint32_t t = start; t < end; ++t) {
+            misses += cache.access(&indices[t * 3]);
+        }
+        const float limit = threshold * static_cast<float>(misses) / static_cast<float>(end - start);
+
+        cache.reset();
+        clusters.push_back(start);
+        uint32_t runningMisses = 0;
+        uint32_t runningTriangles = 0;
+        for (uint32_t t = start; t < end; ++t) {
+            runningMisses += cache.access(&indices[t * 3]);
+            ++runningTriangles;
+
+            if (t + 1 < end && static_cast<float>(runningMisses) <= limit * static_cast<float>(runningTriangles)) {
+                clusters.push_back(t + 1);
+                cache.reset();
+                runningMisses = 0;
+                runningTriangles = 0;
+            }
+        }
+    }
+    clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+    // Area-weighted centroid and normal per cluster
+    struct Cluster {
+        uint32_t start;
+        uint32_t end;
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        float sortKey = 0.0f;
+    };
+
+    std::vector<Cluster> sorted(clusters.size() - 1);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (size_t c = 0; c + 1 < clusters.size(); ++c) {
+        Cluster& cluster = sorted[c];
+        cluster = { .start = clusters[c], .end = clusters[c + 1], .centroid = glm::vec3(0.0f), .normal = glm::vec3(0.0f) };
+
+        float clusterArea = 0.0f;
+        for (uint32_t t = cluster.start; t < cluster.end; ++t) {
+            const glm::vec3& a = vertices[indices[t * 3]].position;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p = vertices[indices[t * 3 + 2]].position;
+
+            const glm::vec3 normal = glm::cross(b - a, p - a);
+            const float area = glm::length(normal);
+            cluster.centroid += (a + b + p) * (area / 3.0f);
+            cluster.normal += normal;
+            clusterArea += area;
+        }
+
+        meshCentroid += cluster.centroid;
+        meshArea += clusterArea;
+        cluster.centroid = clusterArea > 0.0f ? cluster.centroid / clusterArea : glm::vec3(0.0f);
+    }
+    meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : glm::vec3(0.0f);
+
+    // Clusters facing away from the center tend to occlude the rest, so they go first
+    for (Cluster& cluster : sorted) {
+        const float normalLength = glm::length(cluster.normal);
+        cluster.sortKey = normalLength > 0.0f
+            ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / normalLength)
+            : 0.0f;
+    }
+    std::ranges::stable_sort(sorted, [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (const Cluster& cluster : sorted) {
+        result.insert(result.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+    }
+    indices = std::move(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(Mesh& mesh) {
+    std::vector<uint32_t> remap(mesh.vertices.size(), UINT32_MAX);
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+void MeshOptimizer::optimize(Mesh& mesh) {
+    optimizeVertexCache(mesh.indices, mesh.vertices.size());
+    optimizeOverdraw(mesh.indices, mesh.vertices);
+    optimizeVertexFetch(mesh);
+}
+
+std::vector<uint32_t> MeshOptimizer::simplifyClustered(const std::vector<uint32_t>& indices,
+                                                       const std::vector<Vertex>& vertices, const float cellSize) {
+    if (vertices.empty() || cellSize <= 0.0f) return indices;
+
+    glm::vec3 lower = vertices.front().position;
+    for (const Vertex& vertex : vertices) {
+        lower = glm::min(lower, vertex.position);
+    }
+
+    // 21 bits per axis keeps the packed key fields disjoint; a grid finer than 2^21 cells shares its last cell
+    constexpr uint32_t kMaxCell = (1u << 21) - 1;
+
+    // Cell of every vertex, and the mean position of every cell
+    std::unordered_map<uint64_t, uint32_t> cellIds;
+    std::vector<uint32_t> cellOf(vertices.size());
+    std::vector<glm::vec4> cellSums;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const glm::uvec3 cell = glm::uvec3(glm::min((vertices[i].position - lower) / cellSize,
+                                                    glm::vec3(static_cast<float>(kMaxCell))));
+        const uint64_t key = cell.x | (static_cast<uint64_t>(cell.y) << 21) | (static_cast<uint64_t>(cell.z) << 42);
+        const auto [it, inserted] = cellIds.try_emplace(key, static_cast<uint32_t>(cellSums.size()));
+        if (inserted) cellSums.emplace_back(0.0f);
+        cellOf[i] = it->second;
+        cellSums[it->second] += glm::vec4(vertices[i].position, 1.0f);
+    }
+
+    // Each cell is represented by its vertex closest to the mean
+    std::vector<uint32_t> representative(cellSums.size(), UINT32_MAX);
+    std::vector<float> bestDistance(cellSums.size(), 0.0f);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const uint32_t cell = cellOf[i];
+        const glm::vec3 mean = glm::vec3(cellSums[cell]) / cellSums[cell].w;
+        const glm::vec3 delta = vertices[i].position - mean;
+        const float distance = glm::dot(delta, delta);
+        if (representative[cell] == UINT32_MAX || distance < bestDistance[cell]) {
+            representative[cell] = static_cast<uint32_t>(i);
+            bestDistance[cell] = distance;
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const uint32_t a = representative[cellOf[indices[t]]];
+        const uint32_t b = representative[cellOf[indices[t + 1]]];
+        const uint32_t c = representative[cellOf[indices[t + 2]]];
+        if (a == b || b == c || c == a) continue;  // Collapsed into a cell edge or point
+        result.insert(result.end(), { a, b, c });
+    }
+
+    optimizeVertexCache(result, vertices.size());
+    return result;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices,
+                                                            const size_t vertexCount, const uint32_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return {};
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t misses = 0;
+    size_t referencedCount = 0;
+
+    for (size_t t = 0; t < triangleCount; ++t) {
+        misses += cache.access(&indices[t * 3]);
+        for (uint32_t k = 0; k < 3; ++k) {
+            if (!referenced[indices[t * 3 + k]]) {
+                referenced[indices[t * 3 + k]] = true;
+                ++referencedCount;
+            }
+        }
+    }
+
+    return {
+        .acmr = static_cast<float>(misses) / static_cast<float>(triangleCount),
+        .atvr = static_cast<float>(misses) / static_cast<float>(referencedCount)
+    };
+}
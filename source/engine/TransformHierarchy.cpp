@@ -0,0 +1,318 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define VULKANLAB_TRANSFORM_SSE 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Levels smaller than this are composed inline
+constexpr uint32_t kParallelThreshold = 4096;
+// Fewest slots per job system range
+constexpr uint32_t kMinGrain = 512;
+
+// Columns of a TRS matrix without the translation: rotation scaled per axis
+struct Basis {
+    glm::vec3 x, y, z;
+};
+
+Basis getBasis(const Transform& transform) {
+    const glm::quat& q = transform.rotation;
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    return {
+        .x = glm::vec3(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy)) * transform.scale.x,
+        .y = glm::vec3(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx)) * transform.scale.y,
+        .z = glm::vec3(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy)) * transform.scale.z
+    };
+}
+
+#if VULKANLAB_TRANSFORM_SSE
+
+// parent * TRS(local). The local matrix is affine, so each result column is
+// the parent's first three columns weighted by one local column (plus the
+// parent's translation for the last): 12 multiplies and 10 adds of whole
+// columns instead of a generic 4x4 product.
+void compose(const float* parent, const Transform& local, float* out) {
+    const Basis basis = getBasis(local);
+    const __m128 p0 = _mm_loadu_ps(parent);
+    const __m128 p1 = _mm_loadu_ps(parent + 4);
+    const __m128 p2 = _mm_loadu_ps(parent + 8);
+    const __m128 p3 = _mm_loadu_ps(parent + 12);
+
+    const auto column = [&](const glm::vec3& v) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(v.x)), _mm_mul_ps(p1, _mm_set1_ps(v.y))),
+                          _mm_mul_ps(p2, _mm_set1_ps(v.z)));
+    };
+    _mm_storeu_ps(out, column(basis.x));
+    _mm_storeu_ps(out + 4, column(basis.y));
+    _mm_storeu_ps(out + 8, column(basis.z));
+    _mm_storeu_ps(out + 12, _mm_add_ps(column(local.position), p3));
+}
+
+#else
+
+void compose(const float* parent, const Transform& local, float* out) {
+    const Basis basis = getBasis(local);
+    const glm::mat4 matrix(glm::vec4(basis.x, 0.0f), glm::vec4(basis.y, 0.0f), glm::vec4(basis.z, 0.0f),
+                           glm::vec4(local.position, 1.0f));
+    glm::mat4 parentMatrix;
+    std::memcpy(&parentMatrix, parent, sizeof(glm::mat4));
+    const glm::mat4 result = parentMatrix * matrix;
+    std::memcpy(out, &result, sizeof(glm::mat4));
+}
+
+#endif
+
+const glm::mat4 kIdentity(1.0f);
+
+}
+
+TransformHierarchy::TransformHierarchy() : TransformHierarchy(Options {}) {}
+
+TransformHierarchy::TransformHierarchy(const Options& options) : m_options(options) {}
+
+uint32_t TransformHierarchy::add(const Transform& local, const uint32_t parent, const uint32_t outputIndex) {
+    if (parent != kInvalid && !isAlive(parent)) {
+        throw std::runtime_error("Transform parent " + std::to_string(parent) + " is not alive");
+    }
+
+    uint32_t node;
+    if (!m_freeNodes.empty()) {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    } else {
+        node = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    // Appended out of order; the next update() sorts it into its level
+    const auto slot = static_cast<uint32_t>(m_local.size());
+    m_nodes[node] = { .parent = parent, .slot = slot, .level = 0, .removed = false };
+    m_local.push_back(local);
+    m_world.emplace_back(1.0f);
+    m_parentSlot.push_back(kInvalid);
+    m_outputIndex.push_back(outputIndex);
+    m_handle.push_back(node);
+    m_dirty.push_back(1);
+
+    ++m_nodeCount;
+    m_orderDirty = true;
+    return node;
+}
+
+void TransformHierarchy::remove(const uint32_t node) {
+    if (!isAlive(node)) throw std::runtime_error("Transform node " + std::to_string(node) + " is not alive");
+    m_nodes[node].removed = true;
+    m_orderDirty = true;
+}
+
+void TransformHierarchy::setParent(const uint32_t node, const uint32_t parent) {
+    if (!isAlive(node)) throw std::runtime_error("Transform node " + std::to_string(node) + " is not alive");
+    if (parent != kInvalid) {
+        if (!isAlive(parent)) throw std::runtime_error("Transform parent " + std::to_string(parent) + " is not alive");
+        for (uint32_t ancestor = parent; ancestor != kInvalid; ancestor = m_nodes[ancestor].parent) {
+            if (ancestor == node) throw std::runtime_error("Transform parent would create a cycle");
+        }
+    }
+
+    m_nodes[node].parent = parent;
+    m_dirty[m_nodes[node].slot] = 1;
+    m_orderDirty = true;
+}
+
+void TransformHierarchy::setLocal(const uint32_t node, const Transform& local) {
+    const Node& record = m_nodes[node];
+    m_local[record.slot] = local;
+    m_dirty[record.slot] = 1;
+    if (!m_orderDirty) m_levelDirty[record.level] = 1;
+}
+
+void TransformHierarchy::clear() {
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_nodeCount = 0;
+    m_local.clear();
+    m_world.clear();
+    m_parentSlot.clear();
+    m_outputIndex.clear();
+    m_handle.clear();
+    m_dirty.clear();
+    m_levelStart.clear();
+    m_levelDirty.clear();
+    m_orderDirty = false;
+    m_updatedCount = 0;
+}
+
+// Descendants of a removed node are still in the arrays until the next sort
+bool TransformHierarchy::isAlive(const uint32_t node) const {
+    if (node >= m_nodes.size() || m_nodes[node].slot == kInvalid) return false;
+    for (uint32_t ancestor = node; ancestor != kInvalid; ancestor = m_nodes[ancestor].parent) {
+        if (m_nodes[ancestor].removed) return false;
+    }
+    return true;
+}
+
+void TransformHierarchy::sort() {
+    const auto handleCount = static_cast<uint32_t>(m_nodes.size());
+    const auto isLinked = [&](const Node& node) {
+        return node.slot != kInvalid && !node.removed && node.parent != kInvalid;
+    };
+
+    // Children grouped by parent, so the walk below keeps siblings together
+    std::vector<uint32_t> childStart(handleCount + 1, 0);
+    for (const Node& node : m_nodes) {
+        if (isLinked(node)) ++childStart[node.parent + 1];
+    }
+    for (uint32_t node = 0; node < handleCount; ++node) childStart[node + 1] += childStart[node];
+    std::vector<uint32_t> children(childStart[handleCount]);
+    std::vector<uint32_t> cursor(childStart.begin(), childStart.end() - 1);
+    for (uint32_t node = 0; node < handleCount; ++node) {
+        if (isLinked(m_nodes[node])) children[cursor[m_nodes[node].parent]++] = node;
+    }
+
+    // Breadth first from the live roots; removed nodes are never reached, nor is anything below them
+    std::vector<uint32_t> order;
+    order.reserve(m_local.size());
+    for (uint32_t node = 0; node < handleCount; ++node) {
+        const Node& record = m_nodes[node];
+        if (record.slot != kInvalid && !record.removed && record.parent == kInvalid) order.push_back(node);
+    }
+    m_levelStart.assign(1, 0);
+    for (size_t begin = 0; begin < order.size();) {
+        const size_t end = order.size();
+        m_levelStart.push_back(static_cast<uint32_t>(end));
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t node = order[i];
+            order.insert(order.end(), children.begin() + childStart[node], children.begin() + childStart[node + 1]);
+        }
+        begin = end;
+    }
+
+    const auto count = static_cast<uint32_t>(order.size());
+    std::vector<uint32_t> newSlot(handleCount, kInvalid);
+    for (uint32_t slot = 0; slot < count; ++slot) newSlot[order[slot]] = slot;
+
+    std::vector<Transform> local(count);
+    std::vector<glm::mat4> world(count);
+    std::vector<uint32_t> parentSlot(count);
+    std::vector<uint32_t> outputIndex(count);
+    std::vector<uint8_t> dirty(count);
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        const Node& record = m_nodes[order[slot]];
+        local[slot] = m_local[record.slot];
+        world[slot] = m_world[record.slot];
+        parentSlot[slot] = record.parent == kInvalid ? kInvalid : newSlot[record.parent];
+        outputIndex[slot] = m_outputIndex[record.slot];
+        dirty[slot] = m_dirty[record.slot];
+    }
+    m_local = std::move(local);
+    m_world = std::move(world);
+    m_parentSlot = std::move(parentSlot);
+    m_outputIndex = std::move(outputIndex);
+    m_dirty = std::move(dirty);
+    m_handle = std::move(order);
+
+    for (uint32_t node = 0; node < handleCount; ++node) {
+        Node& record = m_nodes[node];
+        if (record.slot == kInvalid) continue;
+        if (newSlot[node] == kInvalid) {
+            record = {};
+            m_freeNodes.push_back(node);
+            continue;
+        }
+        record.slot = newSlot[node];
+    }
+
+    const auto levelCount = static_cast<uint32_t>(m_levelStart.size() - 1);
+    m_levelDirty.assign(levelCount, 0);
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        for (uint32_t slot = m_levelStart[level]; slot < m_levelStart[level + 1]; ++slot) {
+            m_nodes[m_handle[slot]].level = level;
+            m_levelDirty[level] |= m_dirty[slot];
+        }
+    }
+
+    m_nodeCount = count;
+    m_orderDirty = false;
+}
+
+uint32_t TransformHierarchy::updateRange(const uint32_t begin, const uint32_t end, const Output& output) {
+    auto* destination = static_cast<std::byte*>(output.data);
+    uint32_t updated = 0;
+
+    for (uint32_t slot = begin; slot < end; ++slot) {
+        const uint32_t parent = m_parentSlot[slot];
+        // The parent's flag is still set when it was recomputed this update
+        const uint8_t dirty = m_dirty[slot] | (parent != kInvalid ? m_dirty[parent] : uint8_t(0));
+        if (dirty) {
+            m_dirty[slot] = 1;
+            const glm::mat4& parentWorld = parent != kInvalid ? m_world[parent] : kIdentity;
+            if (m_options.simd) {
+                compose(reinterpret_cast<const float*>(&parentWorld), m_local[slot],
+                        reinterpret_cast<float*>(&m_world[slot]));
+            } else {
+                m_world[slot] = parentWorld * m_local[slot].getMatrix();
+            }
+            ++updated;
+        }
+        if (destination && m_outputIndex[slot] != kInvalid) {
+            std::memcpy(destination + static_cast<size_t>(m_outputIndex[slot]) * output.stride, &m_world[slot],
+                        sizeof(glm::mat4));
+        }
+    }
+
+    return updated;
+}
+
+void TransformHierarchy::update(JobSystem* jobs) {
+    update(jobs, Output {});
+}
+
+void TransformHierarchy::update(JobSystem* jobs, const Output& output) {
+    if (m_orderDirty) sort();
+
+    const auto levelCount = static_cast<uint32_t>(m_levelDirty.size());
+    m_updatedCount = 0;
+
+    // m_levelDirty switches meaning on the way down: a level whose flags the pass below must clear
+    bool parentLevelChanged = false;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const uint32_t begin = m_levelStart[level];
+        const uint32_t end = m_levelStart[level + 1];
+        if (!m_levelDirty[level] && !parentLevelChanged && !output.data) continue;
+
+        uint32_t updated;
+        if (jobs && end - begin >= kParallelThreshold) {
+            std::atomic<uint32_t> total = 0;
+            const uint32_t grain = std::max(kMinGrain, (end - begin) / (jobs->getThreadCount() * 8));
+            jobs->parallelFor(end - begin, grain, [&](const uint32_t first, const uint32_t last, uint32_t) {
+                total.fetch_add(updateRange(begin + first, begin + last, output), std::memory_order_relaxed);
+            });
+            updated = total.load(std::memory_order_relaxed);
+        } else {
+            updated = updateRange(begin, end, output);
+        }
+
+        parentLevelChanged = updated > 0;
+        m_levelDirty[level] = updated > 0;
+        m_updatedCount += updated;
+    }
+
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        if (!m_levelDirty[level]) continue;
+        std::fill(m_dirty.begin() + m_levelStart[level], m_dirty.begin() + m_levelStart[level + 1], uint8_t(0));
+        m_levelDirty[level] = 0;
+    }
+}
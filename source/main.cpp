@@ -1,8 +1,8 @@
 #include "Application.h"
 
-int main() {
-    Application app;
+int main(int argc, char** argv) {
+    Application app(LaunchOptions::parse(argc, argv));
     app.run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,36 +1,95 @@
 #include "../../include/vulkan/Renderer.h"
 
-#include <../../build/debug/_deps/imgui-src/imgui.h>
+#include <imgui.h>
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
 #include <cstring>
+#include <utility>
 #include <InputManager.h>
 
 #include "../../include/Logger.h"
 #include "../../include/core/WindowManager.h"
 #include "../../include/core/ImGuiLayer.h"
+#include "../../include/core/JobSystem.h"
 #include "../../include/vulkan/VulkanCommandManager.h"
 #include "../../include/vulkan/VulkanInstance.h"
 #include "../../include/vulkan/VulkanDebugMessenger.h"
 #include "../../include/vulkan/VulkanDevice.h"
 #include "../../include/vulkan/VulkanSwapchain.h"
+#include "../../include/vulkan/VulkanOffscreenTarget.h"
 #include "../../include/vulkan/VulkanFramebuffer.h"
 #include "../../include/vulkan/VulkanRenderPass.h"
-#include "../../include/vulkan/VulkanSyncObjects.h"
+#include "../../include/vulkan/VulkanFrameScheduler.h"
 #include "../../include/vulkan/Vertex.h"
 #include "../../include/vulkan/VulkanBuffer.h"
+#include "../../include/vulkan/VulkanMemoryAllocator.h"
+#include "../../include/vulkan/VulkanUniformRing.h"
+#include "../../include/vulkan/VulkanUploadManager.h"
 #include "../../include/vulkan/VulkanPipeline.h"
+#include "../../include/vulkan/VulkanPipelineCache.h"
+#include "../../include/vulkan/VulkanGpuProfiler.h"
+#include "../../include/vulkan/VulkanRenderGraph.h"
+#include "../../include/vulkan/VulkanDeletionQueue.h"
+#include "../../include/vulkan/VulkanBindlessTable.h"
+#include "../../include/vulkan/VulkanIndirectCuller.h"
+#include "../../include/engine/Components.h"
+#include "../../include/engine/MeshFile.h"
+#include "../../include/engine/MeshOptimizer.h"
 
 static std::vector<Vertex> vertices = {
-    { { 0.0f, -0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f } },  // bottom left (YZ plane)
-    { { 0.0f,  0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f } },  // top
-    { { 0.0f, -0.5f, -0.5f }, { 0.0f, 0.0f, 1.0f } }  // bottom right
+    { { 0.0f, -0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },  // bottom left (YZ plane)
+    { { 0.0f,  0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },  // top
+    { { 0.0f, -0.5f, -0.5f }, { 0.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f } }  // bottom right
 };
 
+namespace {
+// Stress scene meshes are unit-sized; this leaves a gap between neighbours
+constexpr float kStressSpacing = 2.5f;
+// Radians per second of the animated stress scene's spinning slabs
+constexpr float kStressSpinSpeed = 0.3f;
+// Smallest per-frame region of the batch ring; it grows in powers of two from here
+constexpr VkDeviceSize kMinBatchRegionSize = 64 * 1024;
+
+// Edge length, in meshes, of the cubic stress grid holding count of them
+uint32_t getStressGridSide(const uint32_t count) {
+    return static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+}
+
+// Cell i of that grid, centered on the origin so any camera direction sees some meshes and culls the rest
+glm::vec3 getStressGridPosition(const uint32_t i, const uint32_t side) {
+    const float halfExtent = 0.5f * static_cast<float>(side - 1) * kStressSpacing;
+    return glm::vec3(i % side, (i / side) % side, i / (side * side)) * kStressSpacing - halfExtent;
+}
+
+// Bounding sphere radius of a mesh around its model-space origin
+float getMeshRadius(const Mesh& mesh) {
+    float radius = 0.0f;
+    for (const Vertex& vertex : mesh.vertices) {
+        radius = std::max(radius, glm::length(vertex.position));
+    }
+    return radius;
+}
+
+// First depth format the device can render to; D16 is always supported
+VkFormat findDepthFormat(VkPhysicalDevice physicalDevice) {
+    for (const VkFormat format : { VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D16_UNORM }) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+        if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) return format;
+    }
+    throw std::runtime_error("No supported depth attachment format.");
+}
+}
+
 
-Renderer::Renderer(WindowManager& windowManager)
-    : m_windowManager(windowManager) {
+Renderer::Renderer(WindowManager* windowManager, const VulkanConfig& config)
+    : m_windowManager(windowManager), m_config(config) {
 
-    m_config.enableValidationLayers = true;
-    m_config.preferredPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+    m_config.headless = isHeadless();
 
     m_instance = std::make_unique<VulkanInstance>(m_config);
 
@@ -38,60 +97,121 @@ Renderer::Renderer(WindowManager& windowManager)
         m_debugMessenger = std::make_unique<VulkanDebugMessenger>(m_instance->get());
     }
 
-    m_device = std::make_unique<VulkanDevice>(m_instance->get(), m_windowManager);
-    auto extent = m_windowManager.getExtent();
-
-    const auto&[graphics, present] = m_device->getQueueIndices();
-        m_swapchain = std::make_unique<VulkanSwapchain>(
-        m_device->getPhysicalDevice(),
-        m_device->getDevice(),
-        m_config,
-        m_device->getSurface(),
-        graphics.value(),
-        present.value(),
-        extent.width, extent.height
+    m_device = std::make_unique<VulkanDevice>(
+        m_instance->get(),
+        m_windowManager ? m_windowManager->get() : nullptr,
+        m_config
     );
 
-    m_renderPass = std::make_unique<VulkanRenderPass>(
-        m_device->getDevice(),
-        m_swapchain->getImageFormat()
+    // Every buffer, image and sampler shaders index lives in one table, bound once per command buffer
+    m_bindlessTable = std::make_unique<VulkanBindlessTable>(
+        *m_device,
+        m_config.bindlessStorageBuffers,
+        m_config.bindlessSampledImages,
+        m_config.bindlessSamplers
     );
 
-    m_framebuffer = std::make_unique<VulkanFramebuffer>(
-        m_device->getDevice(),
-        m_renderPass->get(),
-        m_swapchain->getImageViews(),
-        extent
-    );
+    // Shared trilinear repeat sampler; textures pick it unless they register their own
+    VkSamplerCreateInfo samplerInfo {
+        .sType          = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter      = VK_FILTER_LINEAR,
+        .minFilter      = VK_FILTER_LINEAR,
+        .mipmapMode     = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+        .addressModeU   = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeV   = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeW   = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .maxLod         = VK_LOD_CLAMP_NONE
+    };
+    if (vkCreateSampler(m_device->getDevice(), &samplerInfo, nullptr, &m_defaultSampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create default sampler.");
+    }
+    m_defaultSamplerIndex = m_bindlessTable->addSampler(m_defaultSampler);
+
+    VkFormat colorFormat;
+    VkExtent2D extent;
+
+    if (isHeadless()) {
+        // One offscreen image per frame slot stands in for the swapchain
+        m_offscreenTarget = std::make_unique<VulkanOffscreenTarget>(
+            m_device->getAllocator(),
+            m_config.preferredSurfaceFormat,
+            m_config.headlessExtent,
+            m_config.frameSlotCount
+        );
+        colorFormat = m_offscreenTarget->getImageFormat();
+        extent = m_offscreenTarget->getExtent();
+    } else {
+        const auto& queueIndices = m_device->getQueueIndices();
+        extent = m_windowManager->getExtent();
+        m_swapchain = std::make_unique<VulkanSwapchain>(
+            m_device->getPhysicalDevice(),
+            m_device->getDevice(),
+            m_config,
+            m_device->getSurface(),
+            queueIndices.graphics.value(),
+            queueIndices.present.value(),
+            extent.width, extent.height
+        );
+        colorFormat = m_swapchain->getImageFormat();
+    }
 
+    m_depthFormat = findDepthFormat(m_device->getPhysicalDevice());
+
+    if (!m_device->hasDynamicRendering()) {
+        // The render graph moves the target in and out of the attachment layout;
+        // framebuffers come with the graph, which owns the depth image
+        m_renderPass = std::make_unique<VulkanRenderPass>(
+            m_device->getDevice(),
+            colorFormat,
+            m_depthFormat,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+        );
+    }
+
+    // With dynamic rendering only the attachment format is baked in, so nothing here is rebuilt on resize
+    createPipelines(colorFormat);
+
+    // Each job system worker gets its own command pool per frame slot
+    m_jobSystem = std::make_unique<JobSystem>(JobSystem::Options {
+        .threadCount    = m_config.recordThreads,
+        .pinThreads     = m_config.pinWorkerThreads
+    });
     m_commandManager = std::make_unique<VulkanCommandManager>(
         m_device->getDevice(),
         m_device->getQueueIndices().graphics.value(),
-        m_config.maxFramesInFlight
+        m_config.frameSlotCount,
+        m_jobSystem->getThreadCount()
     );
 
-    m_syncObjects = std::make_unique<VulkanSyncObjects>(
+    // Slots bound the per-frame resources; how many of them are in flight can change later
+    m_frameScheduler = std::make_unique<VulkanFrameScheduler>(
         m_device->getDevice(),
+        m_config.frameSlotCount,
         m_config.maxFramesInFlight
     );
+    if (m_swapchain) {
+        m_frameScheduler->setSwapchainImageCount(static_cast<uint32_t>(m_swapchain->getImages().size()));
+    }
 
-    m_pipeline = std::make_unique<VulkanPipeline>(
-        m_device->getDevice(),
-        m_renderPass->get()
-    );
-
-    // Create uniform buffer for camera
-    m_cameraBuffer = std::make_unique<VulkanBuffer>(
-        m_device->getDevice(),
-        m_device->getPhysicalDevice(),
-        sizeof(CameraUBO),
-        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    // Per-frame uniform data is sub-allocated from one persistently mapped ring.
+    // An animated stress scene rewrites every instance record there each frame;
+    // batches have a ring of their own, sized by what survives culling.
+    const VkPhysicalDeviceLimits& limits = m_device->getProperties().limits;
+    VkDeviceSize ringRegionSize = m_config.uniformRingRegionSize;
+    if (m_config.animateStressScene && !m_config.batchedStressScene) {
+        ringRegionSize += sizeof(GpuInstance) * static_cast<VkDeviceSize>(m_config.stressInstanceCount);
+    }
+    m_uniformRing = std::make_unique<VulkanUniformRing>(
+        m_device->getAllocator(),
+        std::max(limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment),
+        ringRegionSize,
+        m_config.frameSlotCount
     );
 
     // Create descriptor pool
     VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     poolSize.descriptorCount = 1;
 
     VkDescriptorPoolCreateInfo poolInfo{};
@@ -113,9 +233,9 @@ Renderer::Renderer(WindowManager& windowManager)
 
     vkAllocateDescriptorSets(m_device->getDevice(), &allocInfo, &m_descriptorSet);
 
-    // Update descriptor set with buffer info
+    // Update descriptor set with buffer info; the frame's offset is supplied at bind time
     VkDescriptorBufferInfo bufferInfo{};
-    bufferInfo.buffer = m_cameraBuffer->get();
+    bufferInfo.buffer = m_uniformRing->getBuffer();
     bufferInfo.offset = 0;
     bufferInfo.range = sizeof(CameraUBO);
 
@@ -124,25 +244,38 @@ Renderer::Renderer(WindowManager& windowManager)
     descriptorWrite.dstSet = m_descriptorSet;
     descriptorWrite.dstBinding = 0;
     descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descriptorWrite.descriptorCount = 1;
     descriptorWrite.pBufferInfo = &bufferInfo;
 
     vkUpdateDescriptorSets(m_device->getDevice(), 1, &descriptorWrite, 0, nullptr);
 
-    m_vertexBuffer = std::make_unique<VulkanBuffer>(
-        m_device->getDevice(),
-        m_device->getPhysicalDevice(),
-        sizeof(Vertex) * vertices.size(),
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    );
+    m_gpuProfiler = std::make_unique<VulkanGpuProfiler>(*m_device, m_config.frameSlotCount);
+
+    m_uploadManager = std::make_unique<VulkanUploadManager>(*m_device, m_config.stagingBufferSize);
+
+    if (m_config.stressInstanceCount > 0 && m_config.batchedStressScene) {
+        createBatchedStressScene(m_config.stressInstanceCount);
+    } else if (m_config.stressInstanceCount > 0) {
+        const bool packedVertices = m_config.packedVertices;
+        createStressScene(m_config.stressInstanceCount);
 
-    // Upload vertex data
-    void* data;
-    vkMapMemory(m_device->getDevice(), m_vertexBuffer->getMemory(), 0, VK_WHOLE_SIZE, 0, &data);
-    memcpy(data, vertices.data(), sizeof(Vertex) * vertices.size());
-    vkUnmapMemory(m_device->getDevice(), m_vertexBuffer->getMemory());
+        // A mesh file brings its own vertex layout
+        if (m_config.packedVertices != packedVertices) createPipelines(colorFormat);
+        setGpuCulling(m_config.gpuCulling);
+    }
+    if (!m_config.scenePath.empty()) importScene(m_config.scenePath);
+
+    // Geometry is indexed and optimized at load, then streamed into device-local memory
+    Mesh mesh = MeshOptimizer::buildIndexed(vertices);
+    MeshOptimizer::optimize(mesh);
+    m_indexType = mesh.getIndexType();
+
+    const std::vector<uint8_t> indexData = mesh.packIndices();
+    m_vertexBuffer = uploadStatic(mesh.vertices.data(), sizeof(Vertex) * mesh.vertices.size(),
+                                  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_pendingGeometryUploads);
+    m_indexBuffer = uploadStatic(indexData.data(), indexData.size(),
+                                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_pendingGeometryUploads);
 
     m_context.instance             = m_instance->get();
     m_context.device               = m_device->getDevice();
@@ -150,27 +283,54 @@ Renderer::Renderer(WindowManager& windowManager)
     m_context.surface              = m_device->getSurface();
     m_context.graphicsQueue        = m_device->getGraphicsQueue();
     m_context.presentQueue         = m_device->getPresentQueue();
-    m_context.renderPass           = m_renderPass->get();
-    m_context.swapchainExtent      = m_swapchain->getExtent();
-    m_context.swapchainImageFormat = m_swapchain->getImageFormat();
+    m_context.renderPass           = m_renderPass ? m_renderPass->get() : VK_NULL_HANDLE;
+    m_context.dynamicRendering     = m_device->hasDynamicRendering();
+    m_context.swapchainExtent      = extent;
+    m_context.swapchainImageFormat = colorFormat;
+    m_context.depthFormat          = m_depthFormat;
 
     m_context.graphicsQueueFamily = m_device->getQueueIndices().graphics.value();
 
+    m_drawList = { DrawCommand { .indexCount = static_cast<uint32_t>(mesh.indices.size()), .firstIndex = 0, .vertexOffset = 0 } };
+
     m_camera.setPosition({ -2.0f, 0.0f, 0.0f });
 
+    buildRenderGraph();
 }
 
 Renderer::~Renderer() {
+    // The importer cannot be interrupted; its callback only touches m_importedMeshes
+    if (m_importThread.joinable()) m_importThread.join();
     waitIdle();
+    m_deletionQueue.flush();
 
+    m_uploadManager.reset();
+    m_gpuProfiler.reset();
     m_vertexBuffer.reset();
-    m_cameraBuffer.reset();
+    m_indexBuffer.reset();
+    m_uniformRing.reset();
+    m_batchRing.reset();
     m_pipeline.reset();
     m_framebuffer.reset();
+    m_renderGraph.reset();
     m_renderPass.reset();
-    m_syncObjects.reset();
+    m_frameScheduler.reset();
     m_commandManager.reset();
+    m_indirectCuller.reset();
+    m_instancedPipeline.reset();
+    m_batchPipeline.reset();
+    m_batchMeshes.clear();
+    m_sceneVertexBuffer.reset();
+    m_sceneIndexBuffer.reset();
+    m_instanceBuffer.reset();
+    m_meshBuffer.reset();
+    m_bindlessTable.reset();
+    if (m_defaultSampler != VK_NULL_HANDLE) {
+        vkDestroySampler(m_device->getDevice(), m_defaultSampler, nullptr);
+    }
+    m_jobSystem.reset();
     m_swapchain.reset();
+    m_offscreenTarget.reset();
 
     if (m_descriptorPool != VK_NULL_HANDLE) {
         vkDestroyDescriptorPool(m_device->getDevice(), m_descriptorPool, nullptr);
@@ -187,85 +347,839 @@ Renderer::~Renderer() {
 
 
 void Renderer::draw() {
-    const size_t frameIndex = m_currentFrame;
-    const auto& frameSync = m_syncObjects->getFrameSync(frameIndex);
-    const auto& commandBuffers = m_commandManager->getCommandBuffers();
+    PROFILE_FUNCTION();
+
     VkDevice device = m_device->getDevice();
-    VkSwapchainKHR swapchain = m_swapchain->get();
-    VkRenderPass renderPass = m_renderPass->get();
-    const VkExtent2D extent = m_swapchain->getExtent();
-    const auto& framebuffers = m_framebuffer->getFramebuffers();
 
-    static double lastFrame = glfwGetTime();
-    double now = glfwGetTime();
-    float deltaTime = static_cast<float>(now - lastFrame);
-    lastFrame = now;
+    const auto now = std::chrono::steady_clock::now();
+    const float deltaTime = std::chrono::duration<float>(now - m_lastFrameTime).count();
+    m_lastFrameTime = now;
 
-    if (InputManager::isMouseDown(GLFW_MOUSE_BUTTON_2)) {
+    if (!isHeadless() && InputManager::isMouseDown(GLFW_MOUSE_BUTTON_2)) {
         m_camera.update(deltaTime);
     }
 
-    // Update camera UBO
-    m_cameraUBO.view = m_camera.getViewMatrix();         // <- you need to provide this
-    m_cameraUBO.projection = m_camera.getProjectionMatrix();   // <- and this
+    // Last frame's debug UI edits; they may rebuild the render graph, so never mid-recording
+    applyDebugUiChanges();
+
+    // Blocks until the frame that last used this slot has retired on the timeline
+    uint64_t frame;
+    {
+        PROFILE_SCOPE("Frame wait");
+        frame = m_frameScheduler->beginFrame();
+    }
+    const uint32_t slot = m_frameScheduler->getSlot(frame);
 
-    void* data;
-    vkMapMemory(m_device->getDevice(), m_cameraBuffer->getMemory(), 0, sizeof(CameraUBO), 0, &data);
-    memcpy(data, &m_cameraUBO, sizeof(CameraUBO));
-    vkUnmapMemory(m_device->getDevice(), m_cameraBuffer->getMemory());
+    m_deletionQueue.collect(m_frameScheduler->getCompletedFrame());
 
-    // Wait for this frame’s fence
-    vkWaitForFences(device, 1, &frameSync.inFlight, VK_TRUE, UINT64_MAX);
-    vkResetFences(device, 1, &frameSync.inFlight);
+    // Resize events only flag the swapchain; it is rebuilt here, at most once per frame
+    if (m_framebufferResized && !recreateSwapchain()) {
+        m_batcher.clear();
+        return; // Minimized; the next call picks up the same frame
+    }
+    VkSwapchainKHR swapchain = m_swapchain ? m_swapchain->get() : VK_NULL_HANDLE;
+
+    // Headless frames own their offscreen image outright, so there is nothing to acquire
+    uint32_t imageIndex = slot;
+    VkResult result = VK_SUCCESS;
+    VkSemaphore acquireSemaphore = VK_NULL_HANDLE;
+
+    if (!isHeadless()) {
+        PROFILE_SCOPE("Acquire");
+        acquireSemaphore = m_frameScheduler->getAcquireSemaphore(frame);
+        result = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, acquireSemaphore, VK_NULL_HANDLE, &imageIndex);
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+            m_framebufferResized = true;
+            m_batcher.clear();
+            return; // Skip this frame; the acquire semaphore was left unsignaled
+        }
+
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+            throw std::runtime_error("Failed to acquire swapchain image.");
+        }
+    }
 
-    // Acquire image to render into
-    uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, frameSync.imageAvailable, VK_NULL_HANDLE, &imageIndex);
+    // Update camera UBO in this frame's ring region
+    m_cameraUBO.view = m_camera.getViewMatrix();
+    m_cameraUBO.projection = m_camera.getProjectionMatrix();
+    m_frustum = Frustum::fromMatrix(m_cameraUBO.projection * m_cameraUBO.view);
+
+    m_uniformRing->beginFrame(slot);
+    const uint32_t cameraOffset = m_uniformRing->push(m_cameraUBO);
+    if (!m_frameInstanceIndices.empty()) animateStressScene(slot, deltaTime);
+    registerImportedMeshes();
+    if (m_config.batchedStressScene) submitWorld();
+    for (const uint32_t mesh : m_sceneMeshes) submitInstances(mesh, { &m_sceneTransform, 1 });
+    uploadBatches(slot);
+
+    // Resets this slot's pools wholesale; beginFrame() above guarantees they are idle
+    VkCommandBuffer cmd = m_commandManager->beginFrame(slot);
+    uint64_t uploadWaitValue;
+    {
+        PROFILE_SCOPE("Record");
+        const auto recordStart = std::chrono::steady_clock::now();
+        uploadWaitValue = recordCommandBuffer(cmd, frame, imageIndex, cameraOffset);
+        m_lastRecordMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count();
+    }
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        recreateSwapchain();
-        return; // Skip this frame
+    // Submit; the upload timeline wait is already satisfied and only orders memory.
+    // Headless frames skip the acquire/present semaphores entirely.
+    VkSemaphore waitSemaphores[2];
+    VkPipelineStageFlags waitStages[2];
+    uint64_t waitValues[2];
+    uint32_t waitCount = 0;
+
+    if (!isHeadless()) {
+        waitSemaphores[waitCount] = acquireSemaphore;
+        waitStages[waitCount] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        waitValues[waitCount++] = 0;
     }
+    if (uploadWaitValue > 0) {
+        waitSemaphores[waitCount] = m_uploadManager->getTimelineSemaphore();
+        waitStages[waitCount] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        waitValues[waitCount++] = uploadWaitValue;
+    }
+
+    // The frame timeline replaces the fence; the present semaphore's value is ignored
+    VkSemaphore presentSemaphore = isHeadless() ? VK_NULL_HANDLE : m_frameScheduler->getPresentSemaphore(imageIndex);
+    VkSemaphore signalSemaphores[] = { m_frameScheduler->getTimelineSemaphore(), presentSemaphore };
+    const uint64_t signalValues[] = { frame, 0 };
+    const uint32_t signalCount = isHeadless() ? 1 : 2;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = waitCount,
+        .pWaitSemaphoreValues = waitValues,
+        .signalSemaphoreValueCount = signalCount,
+        .pSignalSemaphoreValues = signalValues
+    };
+
+    VkSubmitInfo submitInfo {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timelineInfo,
+        .waitSemaphoreCount = waitCount,
+        .pWaitSemaphores = waitSemaphores,
+        .pWaitDstStageMask = waitStages,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &cmd,
+        .signalSemaphoreCount = signalCount,
+        .pSignalSemaphores = signalSemaphores
+    };
 
-    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-        throw std::runtime_error("Failed to acquire swapchain image.");
+    {
+        PROFILE_SCOPE("Submit");
+        if (vkQueueSubmit(m_device->getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit frame command buffer.");
+        }
     }
+    m_frameScheduler->endFrame();
+
+    if (isHeadless()) return;
 
-    // Use command buffer for this frame, not image
-    VkCommandBuffer cmd = commandBuffers[frameIndex];
-    vkResetCommandBuffer(cmd, 0);
+    // Present
+    VkPresentInfoKHR presentInfo {
+        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+        .waitSemaphoreCount = 1,
+        .pWaitSemaphores = &presentSemaphore,
+        .swapchainCount = 1,
+        .pSwapchains = &swapchain,
+        .pImageIndices = &imageIndex
+    };
 
+    {
+        PROFILE_SCOPE("Present");
+        result = vkQueuePresentKHR(m_device->getPresentQueue(), &presentInfo);
+    }
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        m_framebufferResized = true;
+    } else if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to present swapchain image.");
+    } else if (m_resizeStart) {
+        // Resize event to the first frame presented at the new size
+        m_lastResizeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - *m_resizeStart).count();
+        m_resizeStart.reset();
+        INFO("First frame after resize in ", m_lastResizeMs, " ms (",
+             m_device->hasDynamicRendering() ? "dynamic rendering" : "render pass", ").");
+    }
+}
+
+void Renderer::buildRenderGraph() {
+    // In-flight frames may still use the old graph's transients
+    m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_renderGraph));
+    m_renderGraph = std::make_unique<VulkanRenderGraph>(m_device->getAllocator());
+
+    // Offscreen images are left ready to be copied out instead of presented
+    const VulkanRenderGraph::ImportedImageState backbufferState {
+        .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+        .initialStage   = isHeadless() ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                                       : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, // Acquire wait stage
+        .finalLayout    = isHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+    };
+
+    m_backbuffer = m_renderGraph->importImage(
+        "Backbuffer",
+        { .format = m_context.swapchainImageFormat, .extent = getTargetExtent() },
+        backbufferState
+    );
+
+    // The stress scene's draws are generated on the GPU into this frame slot's buffers
+    if (m_indirectCuller) {
+        m_cullDraws = m_renderGraph->importBuffer("Cull draws", m_indirectCuller->getDrawBufferSize());
+        m_cullCount = m_renderGraph->importBuffer("Cull count", sizeof(uint32_t));
+
+        m_renderGraph->addPass(
+            "Cull",
+            [this](VulkanRenderGraph::PassBuilder& pass) {
+                pass.write(m_cullDraws, VulkanRenderGraph::BufferUsage::Storage);
+                pass.write(m_cullCount, VulkanRenderGraph::BufferUsage::Storage);
+            },
+            [this](VkCommandBuffer cmd) {
+                if (m_pendingSceneUploads > 0) return; // Instance data not resident yet
+                m_indirectCuller->recordCull(cmd, m_frameContext.frameIndex, m_frustum,
+                                             m_drawInstanceBufferIndex, m_meshBufferIndex,
+                                             static_cast<uint32_t>(m_instances.size()));
+            }
+        );
+    } else {
+        m_cullDraws = {};
+        m_cullCount = {};
+    }
+
+    m_renderGraph->addPass(
+        "Main pass",
+        [this](VulkanRenderGraph::PassBuilder& pass) {
+            if (m_indirectCuller) {
+                pass.read(m_cullDraws, VulkanRenderGraph::BufferUsage::Indirect);
+                pass.read(m_cullCount, VulkanRenderGraph::BufferUsage::Indirect);
+            }
+            pass.write(m_backbuffer, VulkanRenderGraph::ImageUsage::ColorAttachment);
+
+            // Transient: cleared on load and dropped after the pass
+            m_depth = pass.createImage("Depth", { .format = m_depthFormat, .extent = getTargetExtent() });
+            pass.write(m_depth, VulkanRenderGraph::ImageUsage::DepthAttachment);
+        },
+        [this](VkCommandBuffer cmd) { recordMainPass(cmd); }
+    );
+
+    m_renderGraph->compile();
+
+    // Render pass framebuffers bind the graph's depth image, so they are rebuilt with it
+    if (!m_device->hasDynamicRendering()) {
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_framebuffer));
+        m_framebuffer = std::make_unique<VulkanFramebuffer>(
+            m_device->getDevice(),
+            m_renderPass->get(),
+            isHeadless() ? m_offscreenTarget->getImageViews() : m_swapchain->getImageViews(),
+            getTargetExtent(),
+            m_renderGraph->getImageView(m_depth)
+        );
+    }
+}
+
+uint64_t Renderer::recordCommandBuffer(VkCommandBuffer cmd, const uint64_t frame,
+                                       const uint32_t imageIndex, const uint32_t cameraOffset) {
+    const uint32_t slot = m_frameScheduler->getSlot(frame);
     VkCommandBufferBeginInfo beginInfo {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
     };
     vkBeginCommandBuffer(cmd, &beginInfo);
 
-    VkClearValue clearColor = { .color = {{ 0.01f, 0.01, 0.01f, 1.0f }} };
+    // Reads back this slot's previous results now that its frame has retired
+    m_gpuProfiler->beginFrame(cmd, slot, frame);
 
-    VkRenderPassBeginInfo renderPassInfo {
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .renderPass = renderPass,
-        .framebuffer = framebuffers[imageIndex],
-        .renderArea = { {0, 0}, extent },
-        .clearValueCount = 1,
-        .pClearValues = &clearColor
+    // Hand finished uploads over to the graphics queue before anything reads them
+    m_uploadManager->flush();
+    const uint64_t uploadWaitValue = m_uploadManager->recordAcquireBarriers(cmd);
+
+    // Start GUI; headless runs have no ImGui context
+    if (!isHeadless()) {
+        ImGuiLayer::beginFrame();
+        drawDebugUi();
+    }
+
+    m_frameContext = {
+        .frameIndex     = slot,
+        .imageIndex     = imageIndex,
+        .cameraOffset   = cameraOffset
     };
 
-    vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    // Only the target changes per frame; the compiled graph is replayed as is
+    if (isHeadless()) {
+        m_renderGraph->setImportedImage(m_backbuffer, m_offscreenTarget->getImages()[imageIndex],
+                                        m_offscreenTarget->getImageViews()[imageIndex]);
+    } else {
+        m_renderGraph->setImportedImage(m_backbuffer, m_swapchain->getImages()[imageIndex],
+                                        m_swapchain->getImageViews()[imageIndex]);
+    }
+    if (m_indirectCuller) {
+        m_renderGraph->setImportedBuffer(m_cullDraws, m_indirectCuller->getDrawBuffer(slot));
+        m_renderGraph->setImportedBuffer(m_cullCount, m_indirectCuller->getCountBuffer(slot));
+    }
+    m_renderGraph->execute(cmd, m_gpuProfiler.get());
+
+    m_gpuProfiler->endFrame(cmd);
 
-    // Start GUI
-    ImGuiLayer::beginFrame();
-    ImGui::Begin("Debug Info");
-    ImGui::Text("Hello from ImGui");
-    ImGui::Text("Application FPS: %.0f", ImGui::GetIO().Framerate);
-    ImGui::End();
+    vkEndCommandBuffer(cmd);
+    return uploadWaitValue;
+}
 
-    // Draw triangle
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline->get());
+void Renderer::recordMainPass(VkCommandBuffer cmd) {
+    const VkExtent2D extent = getTargetExtent();
+    const auto [frameIndex, imageIndex, cameraOffset] = m_frameContext;
+    const bool dynamicRendering = m_device->hasDynamicRendering();
 
-    VkDeviceSize offset = 0;
-    VkBuffer buffer = m_vertexBuffer->get();
-    vkCmdBindVertexBuffers(cmd, 0, 1, &buffer, &offset);
+    const VkClearValue clearValues[] = {
+        { .color = {{ 0.01f, 0.01, 0.01f, 1.0f }} },
+        { .depthStencil = { .depth = 1.0f, .stencil = 0 } }
+    };
+
+    // Either path leaves the backbuffer in COLOR_ATTACHMENT_OPTIMAL for the graph
+    const auto beginPass = [&](const bool secondaries) {
+        if (dynamicRendering) {
+            const VkRenderingAttachmentInfo colorAttachment {
+                .sType          = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                .imageView      = m_renderGraph->getImageView(m_backbuffer),
+                .imageLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+                .clearValue     = clearValues[0]
+            };
+
+            const VkRenderingAttachmentInfo depthAttachment {
+                .sType          = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                .imageView      = m_renderGraph->getImageView(m_depth),
+                .imageLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .clearValue     = clearValues[1]
+            };
+
+            const VkRenderingInfo renderingInfo {
+                .sType                  = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                .flags                  = secondaries ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0u,
+                .renderArea             = { {0, 0}, extent },
+                .layerCount             = 1,
+                .colorAttachmentCount   = 1,
+                .pColorAttachments      = &colorAttachment,
+                .pDepthAttachment       = &depthAttachment
+            };
+            vkCmdBeginRendering(cmd, &renderingInfo);
+            return;
+        }
+
+        VkRenderPassBeginInfo renderPassInfo {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = m_renderPass->get(),
+            .framebuffer = m_framebuffer->getFramebuffers()[imageIndex],
+            .renderArea = { {0, 0}, extent },
+            .clearValueCount = 2,
+            .pClearValues = clearValues
+        };
+        vkCmdBeginRenderPass(cmd, &renderPassInfo,
+                             secondaries ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+    };
+
+    // Small draw lists are cheaper to record inline than to fan out
+    const auto drawCount = static_cast<uint32_t>(m_drawList.size());
+    const uint32_t minPerTask = std::max(1u, m_config.minDrawsPerRecordTask);
+    const uint32_t taskCount = std::min(m_jobSystem->getThreadCount(), (drawCount + minPerTask - 1) / minPerTask);
+
+    if (taskCount <= 1) {
+        beginPass(false);
+
+        recordDraws(cmd, 0, drawCount, cameraOffset, extent);
+        recordInstances(cmd, cameraOffset, extent);
+        recordBatches(cmd, cameraOffset, extent);
+
+        // End GUI
+        if (!isHeadless()) {
+            VulkanGpuProfiler::Scope imguiScope(*m_gpuProfiler, cmd, "ImGui");
+            ImGuiLayer::endFrame(cmd);
+        }
+    } else {
+        beginPass(true);
+
+        // Secondaries inherit either the render pass or the dynamic rendering formats
+        const VkFormat colorFormat = m_context.swapchainImageFormat;
+        const VkCommandBufferInheritanceRenderingInfo inheritanceRendering {
+            .sType                      = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+            .colorAttachmentCount       = 1,
+            .pColorAttachmentFormats    = &colorFormat,
+            .depthAttachmentFormat      = m_depthFormat,
+            .rasterizationSamples       = VK_SAMPLE_COUNT_1_BIT
+        };
+
+        const VkCommandBufferInheritanceInfo inheritance {
+            .sType          = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .pNext          = dynamicRendering ? &inheritanceRendering : nullptr,
+            .renderPass     = dynamicRendering ? VK_NULL_HANDLE : m_renderPass->get(),
+            .subpass        = 0,
+            .framebuffer    = dynamicRendering ? VK_NULL_HANDLE : m_framebuffer->getFramebuffers()[imageIndex]
+        };
+
+        const VkCommandBufferBeginInfo secondaryBegin {
+            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags              = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                                  VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+            .pInheritanceInfo   = &inheritance
+        };
+
+        // One secondary per slice, plus one each for the instanced scene, batches and ImGui since the primary can only execute
+        std::vector<VkCommandBuffer> secondaries(taskCount);
+
+        m_jobSystem->parallelFor(taskCount, [&](const uint32_t task, const uint32_t worker) {
+            PROFILE_SCOPE("Record slice");
+            const uint32_t first = static_cast<uint32_t>(uint64_t(drawCount) * task / taskCount);
+            const uint32_t last = static_cast<uint32_t>(uint64_t(drawCount) * (task + 1) / taskCount);
+
+            VkCommandBuffer secondary = m_commandManager->acquireSecondary(frameIndex, worker);
+            vkBeginCommandBuffer(secondary, &secondaryBegin);
+            recordDraws(secondary, first, last, cameraOffset, extent);
+            vkEndCommandBuffer(secondary);
+            secondaries[task] = secondary;
+        });
+
+        if (!m_instances.empty()) {
+            VkCommandBuffer secondary = m_commandManager->acquireSecondary(frameIndex, 0);
+            vkBeginCommandBuffer(secondary, &secondaryBegin);
+            recordInstances(secondary, cameraOffset, extent);
+            vkEndCommandBuffer(secondary);
+            secondaries.push_back(secondary);
+        }
+
+        if (!m_batcher.getBatches().empty()) {
+            VkCommandBuffer secondary = m_commandManager->acquireSecondary(frameIndex, 0);
+            vkBeginCommandBuffer(secondary, &secondaryBegin);
+            recordBatches(secondary, cameraOffset, extent);
+            vkEndCommandBuffer(secondary);
+            secondaries.push_back(secondary);
+        }
+
+        if (!isHeadless()) {
+            VkCommandBuffer secondary = m_commandManager->acquireSecondary(frameIndex, 0);
+            vkBeginCommandBuffer(secondary, &secondaryBegin);
+            {
+                VulkanGpuProfiler::Scope imguiScope(*m_gpuProfiler, secondary, "ImGui");
+                ImGuiLayer::endFrame(secondary);
+            }
+            vkEndCommandBuffer(secondary);
+            secondaries.push_back(secondary);
+        }
+
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+    }
+
+    if (dynamicRendering) {
+        vkCmdEndRendering(cmd);
+    } else {
+        vkCmdEndRenderPass(cmd);
+    }
+}
+
+void Renderer::createPipelines(const VkFormat colorFormat) {
+    m_pipeline = createPipeline(colorFormat, {});
+    if (m_config.stressInstanceCount > 0 && !m_config.batchedStressScene) {
+        m_instancedPipeline = createPipeline(colorFormat, m_config.packedVertices
+            ? VulkanShaderStages { .vertex = "instanced_packed.vert.spv", .vertexInput = VulkanVertexInput::of<PackedVertex>() }
+            : VulkanShaderStages { .vertex = "instanced.vert.spv" });
+    }
+    if ((m_config.stressInstanceCount > 0 && m_config.batchedStressScene) || !m_batchMeshes.empty()) {
+        m_batchPipeline = createPipeline(colorFormat, { .vertex = "instanced_batch.vert.spv" });
+    }
+}
+
+std::unique_ptr<VulkanPipeline> Renderer::createPipeline(const VkFormat colorFormat,
+                                                         const VulkanShaderStages& shaders) const {
+    if (m_device->hasDynamicRendering()) {
+        return std::make_unique<VulkanPipeline>(m_device->getDevice(), colorFormat, m_depthFormat,
+                                                m_bindlessTable->getSetLayout(), m_device->getPipelineCache(),
+                                                shaders);
+    }
+    return std::make_unique<VulkanPipeline>(m_device->getDevice(), m_renderPass->get(), m_bindlessTable->getSetLayout(),
+                                            m_device->getPipelineCache(), shaders);
+}
+
+std::unique_ptr<VulkanBuffer> Renderer::uploadStatic(const void* data, const VkDeviceSize size,
+                                                     const VkBufferUsageFlags usage, uint32_t& pendingUploads) {
+    auto buffer = std::make_unique<VulkanBuffer>(
+        m_device->getAllocator(),
+        size,
+        usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    );
+
+    ++pendingUploads;
+    m_uploadManager->uploadBuffer(buffer->get(), 0, data, size, [&pendingUploads] { --pendingUploads; });
+    return buffer;
+}
+
+void Renderer::createStressScene(const uint32_t count) {
+    float radius = 0.0f;
+    size_t vertexCount = 0;
+    VertexQuantization quantization;
+
+    if (!m_config.stressMeshPath.empty()) {
+        // Both streams go straight from the mapping into staging; the file is unmapped once they're recorded
+        const MeshFile file(m_config.stressMeshPath);
+        const MeshFileHeader& header = file.getHeader();
+        const MeshFileLod& lod = file.getLods().front();
+
+        m_config.packedVertices = header.vertexFormat == MeshVertexFormat::Packed;
+        m_sceneIndexType = header.indexType;
+        m_meshes = { GpuMesh {
+            .indexCount     = lod.indexCount,
+            .firstIndex     = lod.firstIndex,
+            .vertexOffset   = 0
+        } };
+
+        radius = header.radius;
+        vertexCount = header.vertexCount;
+        quantization = file.getQuantization();
+
+        m_sceneVertexBytes = file.getVertexData().size();
+        m_sceneVertexBuffer = uploadStatic(file.getVertexData().data(), m_sceneVertexBytes,
+                                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_pendingSceneUploads);
+        m_sceneIndexBuffer = uploadStatic(file.getIndexData().data(), file.getIndexData().size(),
+                                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_pendingSceneUploads);
+    } else {
+        Mesh mesh = m_config.stressMeshSegments > 0 ? Mesh::uvSphere(m_config.stressMeshSegments) : Mesh::cube();
+        MeshOptimizer::optimize(mesh);
+        m_sceneIndexType = mesh.getIndexType();
+
+        m_meshes = { GpuMesh {
+            .indexCount     = static_cast<uint32_t>(mesh.indices.size()),
+            .firstIndex     = 0,
+            .vertexOffset   = 0
+        } };
+
+        for (const Vertex& vertex : mesh.vertices) {
+            radius = std::max(radius, glm::length(vertex.position));
+        }
+        vertexCount = mesh.vertices.size();
+
+        // Packing happens once here; the mesh record carries the dequantization to the vertex shader
+        if (m_config.packedVertices) {
+            const std::vector<PackedVertex> packed = packVertices<PackedVertex>(mesh.vertices, quantization);
+            m_sceneVertexBytes = sizeof(PackedVertex) * packed.size();
+            m_sceneVertexBuffer = uploadStatic(packed.data(), m_sceneVertexBytes,
+                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_pendingSceneUploads);
+        } else {
+            m_sceneVertexBytes = sizeof(Vertex) * mesh.vertices.size();
+            m_sceneVertexBuffer = uploadStatic(mesh.vertices.data(), m_sceneVertexBytes,
+                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_pendingSceneUploads);
+        }
+
+        const std::vector<uint8_t> indexData = mesh.packIndices();
+        m_sceneIndexBuffer = uploadStatic(indexData.data(), indexData.size(),
+                                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_pendingSceneUploads);
+    }
+    m_meshes.front().positionScale = glm::vec4(quantization.scale, 0.0f);
+    m_meshes.front().positionOffset = glm::vec4(quantization.offset, 0.0f);
+
+    const uint32_t side = getStressGridSide(count);
+    const float halfExtent = 0.5f * static_cast<float>(side - 1) * kStressSpacing;
+
+    m_world.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        const glm::vec3 position = getStressGridPosition(i, side);
+        WorldTransform world;
+        world.matrix[3] = glm::vec4(position, 1.0f);
+        m_world.create(Transform { .position = position }, world, WorldBounds { .center = position, .radius = radius },
+                       Renderable { .mesh = 0, .material = 0 });
+    }
+    gatherInstances();
+
+    // The same grid as a hierarchy: every z slab spins about its own center, carrying its rows
+    m_transforms.clear();
+    m_slabNodes.clear();
+    m_instanceNodes.clear();
+    if (m_config.animateStressScene) {
+        const uint32_t slabCount = (count + side * side - 1) / (side * side);
+        std::vector<uint32_t> rowNodes(static_cast<size_t>(slabCount) * side);
+        for (uint32_t z = 0; z < slabCount; ++z) {
+            m_slabNodes.push_back(m_transforms.add(Transform {
+                .position = glm::vec3(0.0f, 0.0f, static_cast<float>(z) * kStressSpacing - halfExtent) }));
+            for (uint32_t y = 0; y < side; ++y) {
+                rowNodes[z * side + y] = m_transforms.add(Transform {
+                    .position = glm::vec3(0.0f, static_cast<float>(y) * kStressSpacing - halfExtent, 0.0f) },
+                    m_slabNodes.back());
+            }
+        }
+        m_instanceNodes.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            const Transform local {
+                .position = glm::vec3(static_cast<float>(i % side) * kStressSpacing - halfExtent, 0.0f, 0.0f)
+            };
+            m_instanceNodes.push_back(m_transforms.add(local, rowNodes[i / side], i));
+        }
+    }
+
+    m_instanceBuffer = uploadStatic(m_instances.data(), sizeof(GpuInstance) * m_instances.size(),
+                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_pendingSceneUploads);
+    m_meshBuffer = uploadStatic(m_meshes.data(), sizeof(GpuMesh) * m_meshes.size(),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_pendingSceneUploads);
+
+    m_instanceBufferIndex = m_bindlessTable->addStorageBuffer(m_instanceBuffer->get());
+    m_meshBufferIndex = m_bindlessTable->addStorageBuffer(m_meshBuffer->get());
+    m_drawInstanceBufferIndex = m_instanceBufferIndex;
+
+    // Each slot's index is repointed at that frame's ring allocation once the slot is idle
+    m_frameInstanceIndices.clear();
+    if (m_config.animateStressScene) {
+        for (uint32_t slot = 0; slot < m_config.frameSlotCount; ++slot) {
+            m_frameInstanceIndices.push_back(m_bindlessTable->addStorageBuffer(m_instanceBuffer->get()));
+        }
+    }
+
+    INFO("Stress scene: ", count, " instances on a ", side, "^3 grid, ", vertexCount, " vertices in ",
+         m_sceneVertexBytes / 1024.0, " KiB (", m_config.packedVertices ? "packed" : "float", ").");
+}
+
+void Renderer::gatherInstances() {
+    m_instances.clear();
+    m_instances.reserve(m_world.getEntityCount());
+    m_instanceBounds.clear();
+    m_instanceBounds.reserve(m_world.getEntityCount());
+
+    m_world.forEachChunk<const WorldTransform, const WorldBounds, const Renderable>(
+        [&](const uint32_t count, const Entity*, const WorldTransform* transforms, const WorldBounds* bounds,
+            const Renderable* renderables) {
+            for (uint32_t i = 0; i < count; ++i) {
+                GpuInstance& instance = m_instances.emplace_back();
+                instance = {};
+                instance.model = transforms[i].matrix;
+                setNormalMatrix(instance.normalMatrix, instance.model);
+                instance.boundingSphere = glm::vec4(bounds[i].center, bounds[i].radius);
+                instance.mesh = renderables[i].mesh;
+                m_instanceBounds.add(bounds[i].center, bounds[i].radius);
+            }
+        });
+}
+
+void Renderer::animateStressScene(const uint32_t slot, const float deltaTime) {
+    PROFILE_FUNCTION();
+
+    // Every other slab spins; the rest stay clean and cost the hierarchy one flag test per node
+    m_animationTime += deltaTime;
+    const glm::quat spin = glm::angleAxis(m_animationTime * kStressSpinSpeed, glm::vec3(0.0f, 0.0f, 1.0f));
+    for (size_t z = 1; z < m_slabNodes.size(); z += 2) {
+        Transform slab = m_transforms.getLocal(m_slabNodes[z]);
+        slab.rotation = spin;
+        m_transforms.setLocal(m_slabNodes[z], slab);
+    }
+
+    // Model matrices land in the ring straight from the hierarchy; the normal matrices, spheres
+    // and mesh indices behind them are filled in here, and the CPU culler's copy with them
+    static_assert(offsetof(GpuInstance, model) == 0);
+    const auto count = static_cast<uint32_t>(m_instances.size());
+    const VulkanUniformRing::Allocation allocation = m_uniformRing->allocate(sizeof(GpuInstance) * count);
+    auto* instances = static_cast<GpuInstance*>(allocation.data);
+    m_transforms.update(m_jobSystem.get(), { .data = instances, .stride = sizeof(GpuInstance) });
+
+    m_jobSystem->parallelFor(count, 0, [&](const uint32_t begin, const uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; ++i) {
+            // Read back from the hierarchy rather than the ring, whose host-visible memory may be uncached
+            const glm::mat4& world = m_transforms.getWorld(m_instanceNodes[i]);
+            const glm::vec3 center(world[3]);
+            const float radius = m_instances[i].boundingSphere.w;
+            setNormalMatrix(instances[i].normalMatrix, world);
+            instances[i].boundingSphere = glm::vec4(center, radius);
+            instances[i].mesh = m_instances[i].mesh;
+            m_instanceBounds.set(i, center, radius);
+        }
+    });
+
+    // Update-after-bind: only the retired frame that last used this slot ever read this index
+    m_drawInstanceBufferIndex = m_frameInstanceIndices[slot];
+    m_bindlessTable->updateStorageBuffer(m_drawInstanceBufferIndex, m_uniformRing->getBuffer(),
+                                         allocation.offset, allocation.size);
+}
+
+void Renderer::createBatchedStressScene(const uint32_t count) {
+    // Batches take float vertices and carry no dequantization, so the generated mesh stands in
+    if (!m_config.stressMeshPath.empty() || m_config.packedVertices) {
+        WARN("The batched stress scene instances the generated mesh with float vertices.");
+        m_config.packedVertices = false;
+    }
+    Mesh mesh = m_config.stressMeshSegments > 0 ? Mesh::uvSphere(m_config.stressMeshSegments) : Mesh::cube();
+    MeshOptimizer::optimize(mesh);
+    const uint32_t batchMesh = registerMesh(mesh);
+    const float radius = getMeshRadius(mesh);
+
+    const uint32_t side = getStressGridSide(count);
+    m_world.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        const glm::vec3 position = getStressGridPosition(i, side);
+        WorldTransform world;
+        world.matrix[3] = glm::vec4(position, 1.0f);
+        m_world.create(Transform { .position = position }, world,
+                       WorldBounds { .center = position, .radius = radius },
+                       Renderable { .mesh = batchMesh, .material = 0 });
+    }
+
+    INFO("Batched stress scene: ", count, " instances on a ", side, "^3 grid, ", mesh.vertices.size(), " vertices.");
+}
+
+uint32_t Renderer::registerMesh(const Mesh& mesh) {
+    // Batches recorded before the first registration had nothing to draw, so no frame uses this yet
+    if (!m_batchPipeline) {
+        m_batchPipeline = createPipeline(m_context.swapchainImageFormat, { .vertex = "instanced_batch.vert.spv" });
+    }
+    if (m_batchBufferIndices.empty()) {
+        // Placeholders until uploadBatches() points each slot at its frame's instances
+        for (uint32_t slot = 0; slot < m_config.frameSlotCount; ++slot) {
+            m_batchBufferIndices.push_back(m_bindlessTable->addStorageBuffer(m_uniformRing->getBuffer()));
+        }
+    }
+
+    BatchMesh& batchMesh = m_batchMeshes.emplace_back();
+    batchMesh.indexType = mesh.getIndexType();
+    batchMesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+    const std::vector<uint8_t> indexData = mesh.packIndices();
+    batchMesh.vertexBuffer = uploadStatic(mesh.vertices.data(), sizeof(Vertex) * mesh.vertices.size(),
+                                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, batchMesh.pendingUploads);
+    batchMesh.indexBuffer = uploadStatic(indexData.data(), indexData.size(),
+                                         VK_BUFFER_USAGE_INDEX_BUFFER_BIT, batchMesh.pendingUploads);
+    return m_batcher.addMesh(getMeshRadius(mesh));
+}
+
+void Renderer::submitInstances(const uint32_t mesh, const std::span<const glm::mat4> transforms) {
+    if (mesh >= m_batchMeshes.size()) {
+        throw std::runtime_error("Instances submitted for an unregistered mesh.");
+    }
+    // Meshes still uploading drop their instances, as if culled
+    if (m_batchMeshes[mesh].pendingUploads > 0) return;
+
+    m_batcher.submit(mesh, transforms);
+}
+
+void Renderer::submitWorld() {
+    PROFILE_FUNCTION();
+
+    // Spans point into the chunks, which nothing moves before uploadBatches() has written them out
+    static_assert(sizeof(WorldTransform) == sizeof(glm::mat4));
+    m_world.forEachChunk<const WorldTransform, const Renderable>(
+        [&](const uint32_t count, const Entity*, const WorldTransform* transforms, const Renderable* renderables) {
+            const auto* matrices = reinterpret_cast<const glm::mat4*>(transforms);
+            uint32_t first = 0;
+            for (uint32_t i = 1; i <= count; ++i) {
+                if (i < count && renderables[i].mesh == renderables[first].mesh) continue;
+                submitInstances(renderables[first].mesh, { matrices + first, i - first });
+                first = i;
+            }
+        });
+}
+
+void Renderer::importScene(const std::string& path) {
+    if (m_importThread.joinable()) {
+        throw std::runtime_error("A scene import is already running.");
+    }
+
+    m_importThread = std::thread([this, path] {
+        PROFILE_THREAD("Import");
+        try {
+            // Its own job system, since only the owning thread may submit; half the cores leaves the rest to frames
+            JobSystem jobs(std::max(1u, std::thread::hardware_concurrency() / 2));
+            const auto start = std::chrono::steady_clock::now();
+            uint32_t meshCount = 0;
+            MeshImporter(jobs).import(path, [&](ImportedMesh&& mesh) {
+                std::lock_guard lock(m_importMutex);
+                m_importedMeshes.push_back(std::move(mesh));
+                ++meshCount;
+            });
+            INFO("Imported ", meshCount, " meshes from ", path, " in ",
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), " ms.");
+        } catch (...) {
+            std::lock_guard lock(m_importMutex);
+            m_importError = std::current_exception();
+        }
+    });
+}
+
+void Renderer::registerImportedMeshes() {
+    std::vector<ImportedMesh> meshes;
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(m_importMutex);
+        meshes.swap(m_importedMeshes);
+        error = std::exchange(m_importError, nullptr);
+    }
+
+    // Meshes that arrived before a failed import are still registered, not dropped with the error
+    for (const ImportedMesh& imported : meshes) {
+        m_sceneMeshes.push_back(registerMesh(imported.mesh));
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void Renderer::uploadBatches(const uint32_t slot) {
+    PROFILE_FUNCTION();
+
+    m_lastSubmittedBatchInstances = m_batcher.getSubmittedCount();
+    const uint32_t visibleCount = m_batcher.build(m_frustum, m_jobSystem.get());
+    if (visibleCount == 0) {
+        m_batcher.clear();
+        return;
+    }
+
+    // Grown to the next power of two; frames in flight keep reading the old buffer until they retire.
+    // Indices repointed below are update-after-bind, and the other slots still name the old buffer
+    // only until their own next frame rewrites them.
+    const VkDeviceSize size = sizeof(GpuBatchInstance) * static_cast<VkDeviceSize>(visibleCount);
+    if (!m_batchRing || m_batchRing->getRegionSize() < size) {
+        const VkPhysicalDeviceLimits& limits = m_device->getProperties().limits;
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_batchRing));
+        m_batchRing = std::make_unique<VulkanUniformRing>(
+            m_device->getAllocator(),
+            limits.minStorageBufferOffsetAlignment,
+            std::bit_ceil(std::max(size, kMinBatchRegionSize)),
+            m_config.frameSlotCount
+        );
+    }
+
+    // The survivors go straight into this frame's mapped region, one piece per job
+    m_batchRing->beginFrame(slot);
+    const VulkanUniformRing::Allocation allocation = m_batchRing->allocate(size);
+    m_batcher.write(static_cast<GpuBatchInstance*>(allocation.data), m_jobSystem.get());
+    m_batcher.clear();
+
+    // Update-after-bind: only the retired frame that last used this slot ever read this index
+    m_bindlessTable->updateStorageBuffer(m_batchBufferIndices[slot], m_batchRing->getBuffer(),
+                                         allocation.offset, allocation.size);
+}
+
+void Renderer::setGpuCulling(const bool enabled) {
+    m_config.gpuCulling = enabled;
+    if (m_instances.empty()) return;
+
+    if (enabled && !VulkanIndirectCuller::isSupported(*m_device)) {
+        WARN("GPU culling needs drawIndirectCount and subgroup ballots; culling on the CPU instead.");
+        m_config.gpuCulling = false;
+    }
+    if (m_config.gpuCulling == (m_indirectCuller != nullptr)) return;
+
+    if (m_config.gpuCulling) {
+        m_indirectCuller = std::make_unique<VulkanIndirectCuller>(
+            *m_device,
+            *m_bindlessTable,
+            static_cast<uint32_t>(m_instances.size()),
+            m_config.frameSlotCount
+        );
+    } else {
+        // Its bindless indices are released with it, after the frames that cull into them
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_indirectCuller));
+    }
+
+    // The cull pass comes and goes with the culler
+    if (m_renderGraph) buildRenderGraph();
+}
+
+void Renderer::bindPipeline(VkCommandBuffer cmd, const VulkanPipeline& pipeline, const uint32_t cameraOffset,
+                            const VkExtent2D extent, const BindlessPushConstants& pushConstants) const {
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.get());
 
     VkViewport viewport {
         .x = 0.0f,
@@ -284,118 +1198,274 @@ void Renderer::draw() {
     vkCmdSetViewport(cmd, 0, 1, &viewport);
     vkCmdSetScissor(cmd, 0, 1, &scissor);
 
+    // The frame's camera set and the bindless table in one call; draws only change push constants
+    const VkDescriptorSet descriptorSets[] = { m_descriptorSet, m_bindlessTable->getSet() };
     vkCmdBindDescriptorSets(
         cmd,
         VK_PIPELINE_BIND_POINT_GRAPHICS,
-        m_pipeline->getLayout(),
-        0, 1,
-        &m_descriptorSet,
-        0, nullptr
+        pipeline.getLayout(),
+        0, 2,
+        descriptorSets,
+        1, &cameraOffset
     );
 
-    vkCmdDraw(cmd, static_cast<uint32_t>(vertices.size()), 1, 0, 0);
+    vkCmdPushConstants(cmd, pipeline.getLayout(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(pushConstants), &pushConstants);
+}
 
-    // End GUI
-    ImGuiLayer::endFrame(cmd);
+void Renderer::recordDraws(VkCommandBuffer cmd, const uint32_t first, const uint32_t last,
+                           const uint32_t cameraOffset, const VkExtent2D extent) const {
+    bindPipeline(cmd, *m_pipeline, cameraOffset, extent, { .samplerIndex = m_defaultSamplerIndex });
 
-    vkCmdEndRenderPass(cmd);
-    vkEndCommandBuffer(cmd);
+    if (m_pendingGeometryUploads > 0) return;
 
-    // Submit
-    VkSemaphore waitSemaphores[] = { frameSync.imageAvailable };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    VkSemaphore signalSemaphores[] = { frameSync.renderFinished };
+    VkDeviceSize offset = 0;
+    VkBuffer buffer = m_vertexBuffer->get();
+    vkCmdBindVertexBuffers(cmd, 0, 1, &buffer, &offset);
+    vkCmdBindIndexBuffer(cmd, m_indexBuffer->get(), 0, m_indexType);
 
-    VkSubmitInfo submitInfo {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = waitSemaphores,
-        .pWaitDstStageMask = waitStages,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &cmd,
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores = signalSemaphores
-    };
+    for (uint32_t i = first; i < last; ++i) {
+        const DrawCommand& draw = m_drawList[i];
+        vkCmdDrawIndexed(cmd, draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+    }
+}
 
-    vkQueueSubmit(m_device->getGraphicsQueue(), 1, &submitInfo, frameSync.inFlight);
+void Renderer::recordInstances(VkCommandBuffer cmd, const uint32_t cameraOffset, const VkExtent2D extent) {
+    if (m_instances.empty() || m_pendingSceneUploads > 0) return;
 
-    // Present
-    VkPresentInfoKHR presentInfo {
-        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = signalSemaphores,
-        .swapchainCount = 1,
-        .pSwapchains = &swapchain,
-        .pImageIndices = &imageIndex
-    };
+    bindPipeline(cmd, *m_instancedPipeline, cameraOffset, extent, {
+        .bufferIndex        = m_drawInstanceBufferIndex,
+        .samplerIndex       = m_defaultSamplerIndex,
+        .meshBufferIndex    = m_meshBufferIndex
+    });
 
-    result = vkQueuePresentKHR(m_device->getPresentQueue(), &presentInfo);
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_framebufferResized) {
-        m_framebufferResized = false;
-        recreateSwapchain();
-    } else if (result != VK_SUCCESS) {
-        throw std::runtime_error("Failed to present swapchain image.");
+    VkDeviceSize offset = 0;
+    VkBuffer vertexBuffer = m_sceneVertexBuffer->get();
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(cmd, m_sceneIndexBuffer->get(), 0, m_sceneIndexType);
+
+    if (m_indirectCuller) {
+        // Survivors and their count were written by the graph's cull pass
+        m_indirectCuller->recordDraw(cmd, m_frameContext.frameIndex);
+        return;
     }
 
-    // Advance frame
-    m_currentFrame = (m_currentFrame + 1) % m_config.maxFramesInFlight;
+    // Baseline: SIMD sphere tests on the job system, then one draw call per survivor
+    const std::span<const uint32_t> visible = m_frustumCuller.cull(m_frustum, m_instanceBounds, m_visibleInstances,
+                                                                   m_jobSystem.get());
+    for (const uint32_t i : visible) {
+        const GpuMesh& mesh = m_meshes[m_instances[i].mesh];
+        vkCmdDrawIndexed(cmd, mesh.indexCount, 1, mesh.firstIndex, mesh.vertexOffset, i);
+    }
+    m_lastVisibleCount = static_cast<uint32_t>(visible.size());
 }
 
-void Renderer::onResize() {
-    m_framebufferResized = true;
-    // Wait for all operations to complete before recreating
-    vkDeviceWaitIdle(m_device->getDevice());
+void Renderer::recordBatches(VkCommandBuffer cmd, const uint32_t cameraOffset, const VkExtent2D extent) const {
+    if (m_batcher.getBatches().empty()) return;
+
+    // Every registered mesh shares the Vertex layout, so one pipeline bind covers all batches
+    bindPipeline(cmd, *m_batchPipeline, cameraOffset, extent, {
+        .bufferIndex    = m_batchBufferIndices[m_frameContext.frameIndex],
+        .samplerIndex   = m_defaultSamplerIndex
+    });
+
+    for (const InstanceBatcher::Batch& batch : m_batcher.getBatches()) {
+        const BatchMesh& mesh = m_batchMeshes[batch.mesh];
+        VkDeviceSize offset = 0;
+        VkBuffer vertexBuffer = mesh.vertexBuffer->get();
+        vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
+        vkCmdBindIndexBuffer(cmd, mesh.indexBuffer->get(), 0, mesh.indexType);
+        vkCmdDrawIndexed(cmd, mesh.indexCount, batch.instanceCount, 0, 0, batch.firstInstance);
+    }
+}
 
-    int width = 0, height = 0;
-    glfwGetFramebufferSize(m_windowManager.get(), &width, &height);
+uint32_t Renderer::getRecordThreadCount() const {
+    return m_jobSystem->getThreadCount();
+}
+
+void Renderer::setRecordThreadCount(const uint32_t threadCount) {
+    waitIdle();
+
+    m_config.recordThreads = threadCount;
+    m_commandManager.reset();
+    m_jobSystem.reset();
+    m_jobSystem = std::make_unique<JobSystem>(JobSystem::Options {
+        .threadCount    = threadCount,
+        .pinThreads     = m_config.pinWorkerThreads
+    });
+    m_commandManager = std::make_unique<VulkanCommandManager>(
+        m_device->getDevice(),
+        m_device->getQueueIndices().graphics.value(),
+        m_config.frameSlotCount,
+        m_jobSystem->getThreadCount()
+    );
+}
+
+void Renderer::setMaxFramesInFlight(const uint32_t count) {
+    m_frameScheduler->setMaxFramesInFlight(count);
+    m_config.maxFramesInFlight = m_frameScheduler->getMaxFramesInFlight();
+}
+
+uint32_t Renderer::getMaxFramesInFlight() const {
+    return m_frameScheduler->getMaxFramesInFlight();
+}
 
-    // Wait until window is non-zero
-    while (width == 0 || height == 0) {
-        glfwGetFramebufferSize(m_windowManager.get(), &width, &height);
-        glfwWaitEvents();
+void Renderer::retireBindless(const VulkanBindlessTable::Kind kind, const uint32_t index) {
+    m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), [this, kind, index] {
+        m_bindlessTable->release(kind, index);
+    });
+}
+
+uint64_t Renderer::getFrameNumber() const {
+    return m_frameScheduler->getSubmittedFrame();
+}
+
+void Renderer::drawDebugUi() {
+    ImGui::Begin("Debug Info");
+    ImGui::Text("Hello from ImGui");
+    ImGui::Text("Application FPS: %.0f", ImGui::GetIO().Framerate);
+
+    const VulkanAllocatorStats memoryStats = m_device->getAllocator().getStats();
+    ImGui::Separator();
+    ImGui::Text("GPU memory blocks: %u (%u dedicated)", memoryStats.blockCount, memoryStats.dedicatedBlockCount);
+    ImGui::Text("Allocations: %u", memoryStats.allocationCount);
+    ImGui::Text("Used: %.2f / %.2f MiB", memoryStats.usedBytes / 1048576.0, memoryStats.reservedBytes / 1048576.0);
+    ImGui::Text("Wasted: %.1f KiB", memoryStats.wastedBytes / 1024.0);
+    ImGui::Text("Fragmentation: %.1f%%", memoryStats.fragmentation * 100.0f);
+
+    const VulkanPipelineCache::Stats cacheStats = m_device->getPipelineCache().getStats();
+    ImGui::Separator();
+    ImGui::Text("Pipeline cache: %s", cacheStats.warmStart ? "warm" : "cold");
+    ImGui::Text("Pipelines: %u, first %.2f ms, last %.2f ms",
+                cacheStats.pipelineCount, cacheStats.firstCreateMs, cacheStats.lastCreateMs);
+
+    ImGui::Text("Rendering: %s", m_device->hasDynamicRendering() ? "dynamic" : "render pass");
+    if (m_lastResizeMs > 0.0) {
+        ImGui::Text("Last resize to first frame: %.2f ms", m_lastResizeMs);
+    }
+    ImGui::Text("Pending deletions: %zu", m_deletionQueue.size());
+
+    const VulkanBindlessTable::Stats bindless = m_bindlessTable->getStats();
+    ImGui::Text("Bindless: %u/%u buffers, %u/%u images, %u/%u samplers",
+                bindless.used[0], bindless.capacity[0], bindless.used[1], bindless.capacity[1],
+                bindless.used[2], bindless.capacity[2]);
+
+    if (!m_instances.empty()) {
+        bool gpuCulling = isGpuCulling();
+        if (ImGui::Checkbox("GPU culling", &gpuCulling)) {
+            m_debugUiChanges.gpuCulling = gpuCulling;
+        }
+        ImGui::Text("Scene vertices: %.1f KiB (%s)", m_sceneVertexBytes / 1024.0,
+                    m_config.packedVertices ? "packed" : "float");
+        if (isGpuCulling()) {
+            ImGui::Text("Instances: %u, culled on the GPU", getInstanceCount());
+        } else {
+            ImGui::Text("Instances: %u, %u visible (%s)", getInstanceCount(), m_lastVisibleCount,
+                        FrustumCuller::getIsaName(m_frustumCuller.getIsa()));
+        }
+        if (!m_frameInstanceIndices.empty()) {
+            ImGui::Text("Transforms: %u of %u recomputed, %u levels", m_transforms.getUpdatedCount(),
+                        m_transforms.getNodeCount(), m_transforms.getLevelCount());
+        }
+    }
+    if (!m_batchMeshes.empty()) {
+        ImGui::Text("Batches: %u meshes, %u draws, %u of %u instances", static_cast<uint32_t>(m_batchMeshes.size()),
+                    getBatchCount(), getBatchedInstanceCount(), m_lastSubmittedBatchInstances);
     }
 
-    vkDeviceWaitIdle(m_device->getDevice());
+    // Takes effect at the next frame; the slider only spans the allocated slots
+    int framesInFlight = static_cast<int>(getMaxFramesInFlight());
+    if (ImGui::SliderInt("Frames in flight", &framesInFlight, 1, static_cast<int>(m_frameScheduler->getSlotCount()))) {
+        m_debugUiChanges.maxFramesInFlight = static_cast<uint32_t>(framesInFlight);
+    }
+    ImGui::Text("Frame %llu, GPU at %llu",
+                static_cast<unsigned long long>(m_frameScheduler->getSubmittedFrame()),
+                static_cast<unsigned long long>(m_frameScheduler->getCompletedFrame()));
+
+    const VulkanRenderGraph::Stats& graphStats = m_renderGraph->getStats();
+    ImGui::Separator();
+    ImGui::Text("Render graph: %u passes (%u culled), %u barrier batches",
+                graphStats.passCount, graphStats.culledPassCount, graphStats.barrierBatchCount);
+    ImGui::Text("Transients: %u images, %u buffers in %u slots, %.2f / %.2f MiB",
+                graphStats.transientImageCount, graphStats.transientBufferCount, graphStats.memorySlotCount,
+                graphStats.allocatedBytes / 1048576.0, graphStats.transientBytes / 1048576.0);
+
+    // GPU timings lag frameSlotCount frames behind; the graphs show the last few seconds
+    ImGui::Separator();
+    if (!m_gpuProfiler->isEnabled()) {
+        ImGui::Text("GPU timestamps unsupported");
+    } else if (const auto& gpu = m_gpuProfiler->getLatestResult()) {
+        const auto plot = [](const char* label, const VulkanGpuProfiler::History& history) {
+            char overlay[32];
+            std::snprintf(overlay, sizeof(overlay), "%.3f ms", history.averageMs);
+            ImGui::PlotLines(label, history.samples.data(), VulkanGpuProfiler::kHistorySize,
+                             static_cast<int>(history.next), overlay, 0.0f, FLT_MAX, ImVec2(0, 40));
+        };
+
+        plot("GPU frame", m_gpuProfiler->getFrameHistory());
+        for (const auto& scope : gpu->scopes) {
+            // Scopes sit under the frame graph, nested ones further in
+            const float indent = static_cast<float>(scope.depth + 1) * 8.0f;
+            if (const auto* history = m_gpuProfiler->getScopeHistory(scope.name)) {
+                ImGui::Indent(indent);
+                plot(scope.name.c_str(), *history);
+                ImGui::Unindent(indent);
+            }
+        }
+    }
+    ImGui::End();
+}
 
-    // Destroy old
-    m_framebuffer.reset();
-    m_renderPass.reset();
-    m_swapchain.reset();
+void Renderer::applyDebugUiChanges() {
+    const DebugUiChanges changes = std::exchange(m_debugUiChanges, {});
+    if (changes.gpuCulling) setGpuCulling(*changes.gpuCulling);
+    if (changes.maxFramesInFlight) setMaxFramesInFlight(*changes.maxFramesInFlight);
+}
 
-    // Recreate
-    const auto& indices = m_device->getQueueIndices();
-    auto oldSwapchain = std::move(m_swapchain);
+VkExtent2D Renderer::getTargetExtent() const {
+    return isHeadless() ? m_offscreenTarget->getExtent() : m_swapchain->getExtent();
+}
 
-    m_swapchain = std::make_unique<VulkanSwapchain>(
-        m_device->getPhysicalDevice(),
-        m_device->getDevice(),
-        m_config,
-        m_device->getSurface(),
-        indices.graphics.value(),
-        indices.present.value(),
-        static_cast<uint32_t>(width),
-        static_cast<uint32_t>(height),
-        oldSwapchain ? oldSwapchain->get() : VK_NULL_HANDLE
-    );
+void Renderer::onResize() {
+    if (isHeadless()) return;
 
-    m_renderPass = std::make_unique<VulkanRenderPass>(
-        m_device->getDevice(),
-        m_swapchain->getImageFormat()
-    );
+    // Runs inside the GLFW callback, often many times per frame while dragging;
+    // draw() does the actual recreation once
+    if (!m_resizeStart) m_resizeStart = std::chrono::steady_clock::now();
+    m_framebufferResized = true;
+}
 
-    m_framebuffer = std::make_unique<VulkanFramebuffer>(
-        m_device->getDevice(),
-        m_renderPass->get(),
-        m_swapchain->getImageViews(),
-        m_swapchain->getExtent()
-    );
+void Renderer::recreateSwapchainDependents(const bool formatChanged) {
+    if (m_device->hasDynamicRendering()) {
+        // Dynamic rendering pipelines only know the format, which a resize normally keeps
+        if (!formatChanged) return;
 
-    m_pipeline.reset();
-    m_pipeline = std::make_unique<VulkanPipeline>(
-        m_device->getDevice(),
-        m_renderPass->get()
-    );
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_pipeline));
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_instancedPipeline));
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_batchPipeline));
+        createPipelines(m_swapchain->getImageFormat());
+        return;
+    }
+
+    // Framebuffers are rebuilt with the render graph, which owns their depth image
+    if (formatChanged) {
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_pipeline));
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_instancedPipeline));
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_batchPipeline));
+        m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_renderPass));
+
+        m_renderPass = std::make_unique<VulkanRenderPass>(
+            m_context.device,
+            m_swapchain->getImageFormat(),
+            m_depthFormat,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+        );
+
+        createPipelines(m_swapchain->getImageFormat());
 
+        m_context.renderPass = m_renderPass->get();
+    }
 }
 
 void Renderer::waitIdle() const {
@@ -414,66 +1484,52 @@ uint32_t Renderer::getGraphicsQueueIndex() const {
     return m_device->getQueueIndices().graphics.value();
 }
 
-void Renderer::recreateSwapchain() {
-    vkDeviceWaitIdle(m_context.device);
+bool Renderer::recreateSwapchain() {
+    PROFILE_FUNCTION();
 
     int width = 0, height = 0;
-    glfwGetFramebufferSize(m_windowManager.get(), &width, &height);
-    while (width == 0 || height == 0) {
-        glfwGetFramebufferSize(m_windowManager.get(), &width, &height);
-        glfwWaitEvents();
+    glfwGetFramebufferSize(m_windowManager->get(), &width, &height);
+    if (width == 0 || height == 0) {
+        return false; // Minimized; stays pending until the window has a size again
     }
 
-    // Destroy and reset relevant resources
-    m_framebuffer.reset();
-    m_renderPass.reset();
-    m_swapchain.reset();
-    m_pipeline.reset();
-    m_syncObjects.reset();
-
-    // Save old swapchain to allow reuse
-    auto oldSwapchain = std::move(m_swapchain);
+    if (!m_resizeStart) m_resizeStart = std::chrono::steady_clock::now();
+    m_framebufferResized = false;
 
+    // The old swapchain is handed over while still alive, then retired together
+    // with everything built on it once the frames in flight are done with it
+    const VkFormat oldFormat = m_swapchain->getImageFormat();
     const auto& indices = m_device->getQueueIndices();
-    m_swapchain = std::make_unique<VulkanSwapchain>(
+    auto swapchain = std::make_unique<VulkanSwapchain>(
         m_context.physicalDevice,
         m_context.device,
-        m_config, // ✅ reuse your existing config
+        m_config,
         m_context.surface,
         indices.graphics.value(),
         indices.present.value(),
         static_cast<uint32_t>(width),
         static_cast<uint32_t>(height),
-        oldSwapchain ? oldSwapchain->get() : VK_NULL_HANDLE
+        m_swapchain->get()
     );
+    m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(), std::move(m_swapchain));
+    m_swapchain = std::move(swapchain);
 
-    m_renderPass = std::make_unique<VulkanRenderPass>(
-        m_context.device,
-        m_swapchain->getImageFormat()
-    );
+    // The old swapchain's last presents may still wait on its present semaphores, so they retire after it
+    std::vector<VkSemaphore> oldSemaphores =
+        m_frameScheduler->setSwapchainImageCount(static_cast<uint32_t>(m_swapchain->getImages().size()));
+    m_deletionQueue.retire(m_frameScheduler->getSubmittedFrame(),
+                           [device = m_context.device, semaphores = std::move(oldSemaphores)] {
+        for (VkSemaphore semaphore : semaphores) vkDestroySemaphore(device, semaphore, nullptr);
+    });
 
-    m_framebuffer = std::make_unique<VulkanFramebuffer>(
-        m_context.device,
-        m_renderPass->get(),
-        m_swapchain->getImageViews(),
-        m_swapchain->getExtent()
-    );
-
-    m_pipeline = std::make_unique<VulkanPipeline>(
-        m_context.device,
-        m_renderPass->get()
-    );
-
-    // ✅ Recreate sync objects after swapchain recreation
-    m_syncObjects = std::make_unique<VulkanSyncObjects>(
-        m_context.device,
-        m_config.maxFramesInFlight
-    );
-
-    // ✅ Update context with the new swapchain values
-    m_context.renderPass = m_renderPass->get();
     m_context.swapchainExtent = m_swapchain->getExtent();
     m_context.swapchainImageFormat = m_swapchain->getImageFormat();
-}
 
+    const bool formatChanged = m_swapchain->getImageFormat() != oldFormat;
+    recreateSwapchainDependents(formatChanged);
+    if (formatChanged && m_formatChangedCallback) m_formatChangedCallback(m_context);
 
+    // New extent and images; the graph's topology is declared again for them
+    buildRenderGraph();
+    return true;
+}
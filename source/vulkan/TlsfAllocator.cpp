@@ -0,0 +1,216 @@
+#include "TlsfAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+TlsfAllocator::TlsfAllocator(const uint64_t size)
+    : m_size(size) {
+    if (size == 0) {
+        throw std::runtime_error("TLSF allocator requires a non-zero size.");
+    }
+
+    for (auto& heads : m_freeHeads) heads.fill(kInvalidNode);
+
+    const uint32_t node = createNode();
+    m_blocks[node].offset = 0;
+    m_blocks[node].size = size;
+    insertFree(node);
+}
+
+void TlsfAllocator::mapping(const uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+    if (size < kSecondLevelCount) {
+        // Tiny sizes get linear classes in the first row
+        firstLevel = 0;
+        secondLevel = static_cast<uint32_t>(size);
+        return;
+    }
+
+    const uint32_t msb = 63u - static_cast<uint32_t>(std::countl_zero(size));
+    secondLevel = static_cast<uint32_t>(size >> (msb - kSecondLevelLog2)) ^ kSecondLevelCount;
+    firstLevel = msb - kSecondLevelLog2 + 1;
+}
+
+void TlsfAllocator::mappingSearch(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+    // Round up to the next class so any block found is guaranteed to fit
+    if (size >= kSecondLevelCount) {
+        const uint32_t msb = 63u - static_cast<uint32_t>(std::countl_zero(size));
+        const uint64_t round = (uint64_t{1} << (msb - kSecondLevelLog2)) - 1;
+        size = size > UINT64_MAX - round ? UINT64_MAX : size + round;
+    }
+    mapping(size, firstLevel, secondLevel);
+}
+
+uint32_t TlsfAllocator::createNode() {
+    if (!m_unusedNodes.empty()) {
+        const uint32_t node = m_unusedNodes.back();
+        m_unusedNodes.pop_back();
+        m_blocks[node] = Block{};
+        return node;
+    }
+
+    m_blocks.emplace_back();
+    return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+void TlsfAllocator::releaseNode(const uint32_t node) {
+    m_unusedNodes.push_back(node);
+}
+
+void TlsfAllocator::insertFree(const uint32_t node) {
+    Block& block = m_blocks[node];
+    uint32_t fl, sl;
+    mapping(block.size, fl, sl);
+
+    const uint32_t head = m_freeHeads[fl][sl];
+    block.free = true;
+    block.prevFree = kInvalidNode;
+    block.nextFree = head;
+    if (head != kInvalidNode) m_blocks[head].prevFree = node;
+    m_freeHeads[fl][sl] = node;
+
+    m_firstLevelBitmap |= uint64_t{1} << fl;
+    m_secondLevelBitmaps[fl] |= 1u << sl;
+    ++m_freeBlockCount;
+}
+
+void TlsfAllocator::removeFree(const uint32_t node) {
+    Block& block = m_blocks[node];
+    uint32_t fl, sl;
+    mapping(block.size, fl, sl);
+
+    if (block.prevFree != kInvalidNode) m_blocks[block.prevFree].nextFree = block.nextFree;
+    if (block.nextFree != kInvalidNode) m_blocks[block.nextFree].prevFree = block.prevFree;
+
+    if (m_freeHeads[fl][sl] == node) {
+        m_freeHeads[fl][sl] = block.nextFree;
+        if (block.nextFree == kInvalidNode) {
+            m_secondLevelBitmaps[fl] &= ~(1u << sl);
+            if (m_secondLevelBitmaps[fl] == 0) m_firstLevelBitmap &= ~(uint64_t{1} << fl);
+        }
+    }
+
+    block.free = false;
+    block.prevFree = kInvalidNode;
+    block.nextFree = kInvalidNode;
+    --m_freeBlockCount;
+}
+
+uint32_t TlsfAllocator::findSuitable(const uint64_t size) const {
+    uint32_t fl, sl;
+    mappingSearch(size, fl, sl);
+    if (fl >= kFirstLevelCount) return kInvalidNode;
+
+    uint32_t secondMap = sl < kSecondLevelCount ? m_secondLevelBitmaps[fl] & (~0u << sl) : 0;
+    if (secondMap == 0) {
+        const uint64_t firstMap = fl + 1 < 64 ? m_firstLevelBitmap & (~uint64_t{0} << (fl + 1)) : 0;
+        if (firstMap == 0) return kInvalidNode;
+
+        fl = static_cast<uint32_t>(std::countr_zero(firstMap));
+        secondMap = m_secondLevelBitmaps[fl];
+    }
+
+    sl = static_cast<uint32_t>(std::countr_zero(secondMap));
+    return m_freeHeads[fl][sl];
+}
+
+std::optional<TlsfAllocator::Allocation> TlsfAllocator::allocate(uint64_t size, uint64_t alignment) {
+    if (size == 0) size = 1;
+    if (alignment == 0) alignment = 1;
+    if (!std::has_single_bit(alignment)) {
+        throw std::runtime_error("TLSF allocation alignment must be a power of two.");
+    }
+
+    // Reserve worst-case padding so the aligned range always fits the block
+    const uint32_t node = findSuitable(size + alignment - 1);
+    if (node == kInvalidNode) return std::nullopt;
+
+    removeFree(node);
+
+    const uint64_t blockOffset = m_blocks[node].offset;
+    const uint64_t alignedOffset = (blockOffset + alignment - 1) & ~(alignment - 1);
+    const uint64_t used = alignedOffset - blockOffset + size;
+    const uint64_t remainder = m_blocks[node].size - used;
+
+    if (remainder >= kMinSplitSize) {
+        const uint32_t tail = createNode();
+        Block& block = m_blocks[node];
+        Block& tailBlock = m_blocks[tail];
+
+        tailBlock.offset = blockOffset + used;
+        tailBlock.size = remainder;
+        tailBlock.prevPhysical = node;
+        tailBlock.nextPhysical = block.nextPhysical;
+        if (block.nextPhysical != kInvalidNode) m_blocks[block.nextPhysical].prevPhysical = tail;
+
+        block.nextPhysical = tail;
+        block.size = used;
+        insertFree(tail);
+    }
+
+    Block& block = m_blocks[node];
+    block.requested = size;
+    m_usedBytes += block.size;
+    m_wastedBytes += block.size - size;
+    ++m_allocationCount;
+
+    return Allocation{ .offset = alignedOffset, .size = size, .node = node };
+}
+
+void TlsfAllocator::free(uint32_t node) {
+    if (node >= m_blocks.size() || m_blocks[node].free) {
+        throw std::runtime_error("Invalid or double TLSF free.");
+    }
+
+    m_usedBytes -= m_blocks[node].size;
+    m_wastedBytes -= m_blocks[node].size - m_blocks[node].requested;
+    --m_allocationCount;
+
+    // Coalesce with the physical neighbours so free space never fragments needlessly
+    if (const uint32_t prev = m_blocks[node].prevPhysical;
+        prev != kInvalidNode && m_blocks[prev].free) {
+        removeFree(prev);
+        m_blocks[prev].size += m_blocks[node].size;
+        m_blocks[prev].nextPhysical = m_blocks[node].nextPhysical;
+        if (m_blocks[node].nextPhysical != kInvalidNode) {
+            m_blocks[m_blocks[node].nextPhysical].prevPhysical = prev;
+        }
+        releaseNode(node);
+        node = prev;
+    }
+
+    if (const uint32_t next = m_blocks[node].nextPhysical;
+        next != kInvalidNode && m_blocks[next].free) {
+        removeFree(next);
+        m_blocks[node].size += m_blocks[next].size;
+        m_blocks[node].nextPhysical = m_blocks[next].nextPhysical;
+        if (m_blocks[next].nextPhysical != kInvalidNode) {
+            m_blocks[m_blocks[next].nextPhysical].prevPhysical = node;
+        }
+        releaseNode(next);
+    }
+
+    m_blocks[node].requested = 0;
+    insertFree(node);
+}
+
+TlsfAllocator::Stats TlsfAllocator::getStats() const {
+    Stats stats {
+        .totalSize          = m_size,
+        .usedBytes          = m_usedBytes,
+        .wastedBytes        = m_wastedBytes,
+        .allocationCount    = m_allocationCount,
+        .freeBlockCount     = m_freeBlockCount
+    };
+
+    // The largest free block lives in the highest non-empty class; walk just that list
+    if (m_firstLevelBitmap != 0) {
+        const uint32_t fl = 63u - static_cast<uint32_t>(std::countl_zero(m_firstLevelBitmap));
+        const uint32_t sl = 31u - static_cast<uint32_t>(std::countl_zero(m_secondLevelBitmaps[fl]));
+        for (uint32_t node = m_freeHeads[fl][sl]; node != kInvalidNode; node = m_blocks[node].nextFree) {
+            stats.largestFreeBlock = std::max(stats.largestFreeBlock, m_blocks[node].size);
+        }
+    }
+
+    return stats;
+}
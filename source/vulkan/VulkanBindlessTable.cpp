@@ -0,0 +1,204 @@
+#include "VulkanBindlessTable.h"
+#include "VulkanDevice.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+// Indexed by VulkanBindlessTable::Kind, which is also the binding number
+constexpr VkDescriptorType kDescriptorTypes[] = {
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+    VK_DESCRIPTOR_TYPE_SAMPLER
+};
+}
+
+uint32_t VulkanBindlessTable::Slots::acquire() {
+    if (!freed.empty()) {
+        const uint32_t index = freed.back();
+        freed.pop_back();
+        return index;
+    }
+    if (next == capacity) {
+        throw std::runtime_error("Bindless descriptor table is full.");
+    }
+    return next++;
+}
+
+void VulkanBindlessTable::Slots::release(const uint32_t index) {
+    freed.push_back(index);
+}
+
+VulkanBindlessTable::VulkanBindlessTable(const VulkanDevice& device, const uint32_t bufferCapacity,
+                                         const uint32_t imageCapacity, const uint32_t samplerCapacity)
+    : m_device(device.getDevice())
+{
+    VkPhysicalDeviceVulkan12Properties properties12 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES
+    };
+    VkPhysicalDeviceProperties2 properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &properties12
+    };
+    vkGetPhysicalDeviceProperties2(device.getPhysicalDevice(), &properties);
+
+    // The whole table is visible to every stage, so the per-stage limits are the binding ones
+    slots(Kind::StorageBuffer).capacity = std::min({
+        bufferCapacity,
+        properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+        properties12.maxDescriptorSetUpdateAfterBindStorageBuffers
+    });
+    slots(Kind::SampledImage).capacity = std::min({
+        imageCapacity,
+        properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        properties12.maxDescriptorSetUpdateAfterBindSampledImages
+    });
+    slots(Kind::Sampler).capacity = std::min({
+        samplerCapacity,
+        properties12.maxPerStageDescriptorUpdateAfterBindSamplers,
+        properties12.maxDescriptorSetUpdateAfterBindSamplers
+    });
+
+    VkDescriptorSetLayoutBinding bindings[3];
+    VkDescriptorBindingFlags bindingFlags[3];
+    VkDescriptorPoolSize poolSizes[3];
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        bindings[i] = {
+            .binding            = i,
+            .descriptorType     = kDescriptorTypes[i],
+            .descriptorCount    = m_slots[i].capacity,
+            .stageFlags         = VK_SHADER_STAGE_ALL
+        };
+        bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        poolSizes[i] = {
+            .type               = kDescriptorTypes[i],
+            .descriptorCount    = m_slots[i].capacity
+        };
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo {
+        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount   = 3,
+        .pBindingFlags  = bindingFlags
+    };
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo {
+        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext          = &flagsInfo,
+        .flags          = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount   = 3,
+        .pBindings      = bindings
+    };
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create bindless descriptor set layout.");
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo {
+        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags          = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets        = 1,
+        .poolSizeCount  = 3,
+        .pPoolSizes     = poolSizes
+    };
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create bindless descriptor pool.");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo {
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool     = m_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts        = &m_setLayout
+    };
+
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, &m_set) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate bindless descriptor set.");
+    }
+
+    DEBUG("Bindless table created: ", m_slots[0].capacity, " buffers, ",
+          m_slots[1].capacity, " images, ", m_slots[2].capacity, " samplers.");
+}
+
+VulkanBindlessTable::~VulkanBindlessTable() {
+    // Destroying the pool frees the set
+    if (m_pool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+    }
+    if (m_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+    }
+}
+
+uint32_t VulkanBindlessTable::addStorageBuffer(VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize range) {
+    const uint32_t index = slots(Kind::StorageBuffer).acquire();
+    updateStorageBuffer(index, buffer, offset, range);
+    return index;
+}
+
+uint32_t VulkanBindlessTable::addSampledImage(VkImageView view, const VkImageLayout layout) {
+    const uint32_t index = slots(Kind::SampledImage).acquire();
+    updateSampledImage(index, view, layout);
+    return index;
+}
+
+uint32_t VulkanBindlessTable::addSampler(VkSampler sampler) {
+    const uint32_t index = slots(Kind::Sampler).acquire();
+    const VkDescriptorImageInfo imageInfo { .sampler = sampler };
+    write(Kind::Sampler, index, nullptr, &imageInfo);
+    return index;
+}
+
+void VulkanBindlessTable::updateStorageBuffer(const uint32_t index, VkBuffer buffer,
+                                              const VkDeviceSize offset, const VkDeviceSize range) {
+    const VkDescriptorBufferInfo bufferInfo {
+        .buffer = buffer,
+        .offset = offset,
+        .range  = range
+    };
+    write(Kind::StorageBuffer, index, &bufferInfo, nullptr);
+}
+
+void VulkanBindlessTable::updateSampledImage(const uint32_t index, VkImageView view, const VkImageLayout layout) {
+    const VkDescriptorImageInfo imageInfo {
+        .imageView      = view,
+        .imageLayout    = layout
+    };
+    write(Kind::SampledImage, index, nullptr, &imageInfo);
+}
+
+void VulkanBindlessTable::release(const Kind kind, const uint32_t index) {
+    // The stale descriptor stays in place; partially bound arrays never validate unused entries
+    if (index != kInvalidIndex) {
+        slots(kind).release(index);
+    }
+}
+
+VulkanBindlessTable::Stats VulkanBindlessTable::getStats() const {
+    Stats stats;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        stats.used[i] = m_slots[i].used();
+        stats.capacity[i] = m_slots[i].capacity;
+    }
+    return stats;
+}
+
+void VulkanBindlessTable::write(const Kind kind, const uint32_t index,
+                                const VkDescriptorBufferInfo* bufferInfo, const VkDescriptorImageInfo* imageInfo) const {
+    const VkWriteDescriptorSet write {
+        .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet             = m_set,
+        .dstBinding         = static_cast<uint32_t>(kind),
+        .dstArrayElement    = index,
+        .descriptorCount    = 1,
+        .descriptorType     = kDescriptorTypes[static_cast<size_t>(kind)],
+        .pImageInfo         = imageInfo,
+        .pBufferInfo        = bufferInfo
+    };
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+}
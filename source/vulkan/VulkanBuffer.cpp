@@ -2,12 +2,13 @@
 #include <stdexcept>
 
 VulkanBuffer::VulkanBuffer(
-    VkDevice device,
-    VkPhysicalDevice physicalDevice,
+    VulkanMemoryAllocator& allocator,
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties)
-        : m_device(device) {
+        : m_allocator(allocator),
+          m_device(allocator.getDevice()),
+          m_size(size) {
 
     VkBufferCreateInfo bufferInfo {
         .sType          = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -16,45 +17,37 @@ VulkanBuffer::VulkanBuffer(
         .sharingMode    = VK_SHARING_MODE_EXCLUSIVE
     };
 
-    if (vkCreateBuffer(device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create buffer.");
     }
 
-    allocate(physicalDevice, properties, size);
+    // Mapped buffers are written and read without flushes or invalidates, so host-visible memory must be coherent
+    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        properties |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
+
+    // The destructor does not run for a constructor that throws
+    try {
+        allocate(properties);
+    } catch (...) {
+        vkDestroyBuffer(m_device, m_buffer, nullptr);
+        throw;
+    }
 }
 
-void VulkanBuffer::allocate(VkPhysicalDevice physicalDevice, VkMemoryPropertyFlags properties, VkDeviceSize size) {
+void VulkanBuffer::allocate(VkMemoryPropertyFlags properties) {
     VkMemoryRequirements memReqs;
     vkGetBufferMemoryRequirements(m_device, m_buffer, &memReqs);
 
-    VkMemoryAllocateInfo allocInfo {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = memReqs.size,
-        .memoryTypeIndex = findMemoryType(physicalDevice, memReqs.memoryTypeBits, properties)
-    };
-
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &m_memory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate buffer memory.");
-    }
-
-    vkBindBufferMemory(m_device, m_buffer, m_memory, 0);
-}
+    m_allocation = m_allocator.allocate(memReqs, properties, VulkanResourceKind::Linear);
 
-uint32_t VulkanBuffer::findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i) {
-        if (typeFilter & 1 << i &&
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
+    if (vkBindBufferMemory(m_device, m_buffer, m_allocation.memory, m_allocation.offset) != VK_SUCCESS) {
+        m_allocator.free(m_allocation);
+        throw std::runtime_error("Failed to bind buffer memory.");
     }
-
-    throw std::runtime_error("Failed to find suitable memory type.");
 }
 
 VulkanBuffer::~VulkanBuffer() {
     if (m_buffer) vkDestroyBuffer(m_device, m_buffer, nullptr);
-    if (m_memory) vkFreeMemory(m_device, m_memory, nullptr);
+    m_allocator.free(m_allocation);
 }
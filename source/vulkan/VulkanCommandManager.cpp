@@ -5,46 +5,93 @@
 VulkanCommandManager::VulkanCommandManager(
     VkDevice device,
     uint32_t queueFamily,
-    size_t bufferCount)
-        : m_device(device) {
+    uint32_t frameCount,
+    uint32_t workerCount)
+        : m_device(device),
+          m_workerCount(workerCount) {
+
+    m_frames.resize(frameCount);
+    for (FrameCommands& frame : m_frames) {
+        frame.primaryPool = createPool(queueFamily);
+
+        VkCommandBufferAllocateInfo allocInfo {
+            .sType                  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool            = frame.primaryPool,
+            .level                  = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount     = 1
+        };
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &frame.primary) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate command buffers.");
+        }
+
+        frame.workers.resize(workerCount);
+        for (WorkerCommands& worker : frame.workers) {
+            worker.pool = createPool(queueFamily);
+        }
+    }
+
+    DEBUG("Command pools created: ", frameCount, " frames x ", workerCount + 1, " pools.");
+}
+
+VulkanCommandManager::~VulkanCommandManager() {
+    // Destroying a pool frees every buffer allocated from it
+    for (const FrameCommands& frame : m_frames) {
+        for (const WorkerCommands& worker : frame.workers) {
+            vkDestroyCommandPool(m_device, worker.pool, nullptr);
+        }
+        vkDestroyCommandPool(m_device, frame.primaryPool, nullptr);
+    }
+
+    DEBUG("Command pools destroyed.");
+}
+
+VkCommandPool VulkanCommandManager::createPool(const uint32_t queueFamily) const {
+    // Buffers are re-recorded every frame and only ever reset through their pool
     VkCommandPoolCreateInfo poolInfo {
         .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
         .queueFamilyIndex = queueFamily
     };
 
-    if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+    VkCommandPool pool;
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create command pool.");
     }
+    return pool;
+}
 
-    DEBUG("Command pool created.");
-
-    m_commandBuffers.resize(bufferCount);
-
-    VkCommandBufferAllocateInfo allocInfo {
-        .sType                  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool            = m_commandPool,
-        .level                  = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount     = static_cast<uint32_t>(bufferCount)
-    };
+VkCommandBuffer VulkanCommandManager::beginFrame(const uint32_t frameIndex) {
+    FrameCommands& frame = m_frames[frameIndex];
 
-    if (vkAllocateCommandBuffers(device, &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate command buffers.");
+    vkResetCommandPool(m_device, frame.primaryPool, 0);
+    for (WorkerCommands& worker : frame.workers) {
+        if (worker.used > 0) {
+            vkResetCommandPool(m_device, worker.pool, 0);
+            worker.used = 0;
+        }
     }
 
-    DEBUG("Allocated ", bufferCount, " command buffers.");
+    return frame.primary;
 }
 
-VulkanCommandManager::~VulkanCommandManager() {
-    if (!m_commandBuffers.empty()) {
-        vkFreeCommandBuffers(m_device, m_commandPool,
-                             static_cast<uint32_t>(m_commandBuffers.size()),
-                             m_commandBuffers.data());
-        m_commandBuffers.clear();
-    }
+VkCommandBuffer VulkanCommandManager::acquireSecondary(const uint32_t frameIndex, const uint32_t worker) {
+    WorkerCommands& pool = m_frames[frameIndex].workers[worker];
 
-    if (m_commandPool != VK_NULL_HANDLE) {
-        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
-        DEBUG("Command pool destroyed.");
+    if (pool.used == pool.secondaries.size()) {
+        VkCommandBufferAllocateInfo allocInfo {
+            .sType                  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool            = pool.pool,
+            .level                  = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount     = 1
+        };
+
+        VkCommandBuffer cmd;
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &cmd) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate secondary command buffer.");
+        }
+        pool.secondaries.push_back(cmd);
     }
+
+    return pool.secondaries[pool.used++];
 }
@@ -0,0 +1,22 @@
+#include "VulkanDeletionQueue.h"
+
+void VulkanDeletionQueue::retire(const uint64_t lastUse, std::function<void()> deleter) {
+    m_entries.push_back({ lastUse, std::move(deleter) });
+}
+
+void VulkanDeletionQueue::collect(const uint64_t completedFrame) {
+    // Frame numbers only grow, so retired entries are already sorted
+    while (!m_entries.empty() && m_entries.front().lastUse <= completedFrame) {
+        auto deleter = std::move(m_entries.front().deleter);
+        m_entries.pop_front();
+        deleter();
+    }
+}
+
+void VulkanDeletionQueue::flush() {
+    while (!m_entries.empty()) {
+        auto deleter = std::move(m_entries.front().deleter);
+        m_entries.pop_front();
+        deleter();
+    }
+}
@@ -6,23 +6,29 @@
 
 #include <vector>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
-#include "WindowManager.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanPipelineCache.h"
 
-const std::vector deviceExtensions = {
-    VK_KHR_SWAPCHAIN_EXTENSION_NAME
-};
-
-VulkanDevice::VulkanDevice(VkInstance instance, const WindowManager& windowManager)
+VulkanDevice::VulkanDevice(VkInstance instance, GLFWwindow* window, const VulkanConfig& config)
     : m_instance(instance) {
 
-    createSurface(windowManager.get());
+    if (window) {
+        createSurface(window);
+    }
     pickPhysicalDevice();
-    createLogicalDevice();
+    createLogicalDevice(config);
 
+    m_allocator = std::make_unique<VulkanMemoryAllocator>(m_device, m_memoryProperties, m_properties.limits);
+    m_pipelineCache = std::make_unique<VulkanPipelineCache>(m_device, m_properties, config.pipelineCachePath);
 }
 
 VulkanDevice::~VulkanDevice() {
+    m_pipelineCache.reset();
+    m_allocator.reset();
+
     if (m_surface != VK_NULL_HANDLE) {
         vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
         DEBUG("Surface destroyed.");
@@ -51,15 +57,31 @@ void VulkanDevice::pickPhysicalDevice() {
 
     for (const auto& device : devices) {
         const QueueFamilyIndices indices = findQueueFamilies(device);
-        if (indices.isComplete()) {
-            m_physicalDevice = device;
-            m_queueIndices = indices;
-            DEBUG("Physical device selected.");
-            return;
+        if (!indices.isComplete(!isHeadless())) continue;
+
+        // Query once; allocations and limits checks read the cached copies
+        vkGetPhysicalDeviceProperties(device, &m_properties);
+
+        const std::vector<const char*> missing = findMissingFeatures(device);
+        if (!missing.empty()) {
+            std::string names;
+            for (const char* name : missing) names += std::string(names.empty() ? "" : ", ") + name;
+            WARN("Skipping ", m_properties.deviceName, ", which lacks ", names, ".");
+            continue;
         }
+
+        m_physicalDevice = device;
+        m_queueIndices = indices;
+        vkGetPhysicalDeviceMemoryProperties(device, &m_memoryProperties);
+        DEBUG("Physical device selected: ", m_properties.deviceName);
+        if (indices.transfer) {
+            DEBUG("Using dedicated transfer queue family ", indices.transfer.value(), ".");
+        }
+        return;
     }
 
-    throw std::runtime_error("No suitable GPU found.");
+    throw std::runtime_error("No suitable GPU found. VulkanLab needs timeline semaphores and bindless descriptor "
+                             "indexing with update-after-bind; see the requirements in README.md.");
 }
 
 QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device) const {
@@ -73,29 +95,75 @@ QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device) cons
     for (uint32_t i = 0; i < count; ++i) {
         const auto& props = families[i];
 
-        if (props.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        if (props.queueFlags & VK_QUEUE_GRAPHICS_BIT && !indices.graphics) {
             indices.graphics = i;
         }
 
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
-        if (presentSupport) {
+        if (m_surface != VK_NULL_HANDLE) {
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+        }
+        if (presentSupport && !indices.present) {
             indices.present = i;
         }
 
-        if (indices.isComplete()) break;
+        // Transfer-only families map to the copy engines; prefer them over async compute
+        const bool transferOnly = (props.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                                  !(props.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+        if (transferOnly && !indices.transfer) {
+            indices.transfer = i;
+        }
     }
 
     return indices;
 }
 
-void VulkanDevice::createLogicalDevice() {
-    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set uniqueQueueFamilies = {
-        m_queueIndices.graphics.value(),
-        m_queueIndices.present.value()
+std::vector<const char*> VulkanDevice::findMissingFeatures(VkPhysicalDevice device) {
+    // Shaders are built for vulkan1.3 and the device is created with its feature struct;
+    // older devices can't be queried for the 1.2 struct either
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_3) return { "Vulkan 1.3" };
+
+    VkPhysicalDeviceVulkan12Features features12 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES
+    };
+    VkPhysicalDeviceFeatures2 features {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &features12
+    };
+    vkGetPhysicalDeviceFeatures2(device, &features);
+
+    // Bindless descriptors: partially bound, update-after-bind arrays indexed at runtime
+    const std::pair<VkBool32, const char*> required[] = {
+        { features12.timelineSemaphore, "timelineSemaphore" },
+        { features12.descriptorIndexing, "descriptorIndexing" },
+        { features12.runtimeDescriptorArray, "runtimeDescriptorArray" },
+        { features12.descriptorBindingPartiallyBound, "descriptorBindingPartiallyBound" },
+        { features12.descriptorBindingUpdateUnusedWhilePending, "descriptorBindingUpdateUnusedWhilePending" },
+        { features12.descriptorBindingStorageBufferUpdateAfterBind, "descriptorBindingStorageBufferUpdateAfterBind" },
+        { features12.descriptorBindingSampledImageUpdateAfterBind, "descriptorBindingSampledImageUpdateAfterBind" },
+        { features12.shaderSampledImageArrayNonUniformIndexing, "shaderSampledImageArrayNonUniformIndexing" },
+        { features12.shaderStorageBufferArrayNonUniformIndexing, "shaderStorageBufferArrayNonUniformIndexing" }
     };
 
+    std::vector<const char*> missing;
+    for (const auto& [supported, name] : required) {
+        if (supported != VK_TRUE) missing.push_back(name);
+    }
+    return missing;
+}
+
+void VulkanDevice::createLogicalDevice(const VulkanConfig& config) {
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+    std::set uniqueQueueFamilies = { m_queueIndices.graphics.value() };
+    if (m_queueIndices.present) {
+        uniqueQueueFamilies.insert(m_queueIndices.present.value());
+    }
+    if (m_queueIndices.transfer) {
+        uniqueQueueFamilies.insert(m_queueIndices.transfer.value());
+    }
+
     float queuePriority = 1.0f;
     for (const uint32_t family : uniqueQueueFamilies) {
         VkDeviceQueueCreateInfo queueInfo {
@@ -107,15 +175,69 @@ void VulkanDevice::createLogicalDevice() {
         queueCreateInfos.push_back(queueInfo);
     }
 
-    VkPhysicalDeviceFeatures deviceFeatures{}; // Fill later when needed
+    std::vector<const char*> deviceExtensions;
+    if (!isHeadless()) {
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+
+    // Dynamic rendering is core in 1.3 but still optional to enable; fall back to render passes without it
+    VkPhysicalDeviceVulkan13Features supported13 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES
+    };
+    VkPhysicalDeviceVulkan12Features supported12 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = &supported13
+    };
+    VkPhysicalDeviceFeatures2 supported {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &supported12
+    };
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supported);
+    m_dynamicRendering = config.dynamicRendering && supported13.dynamicRendering == VK_TRUE;
+
+    // Optional as well; without them GPU-driven culling falls back to CPU-recorded draws
+    m_indirectCount = supported12.drawIndirectCount == VK_TRUE &&
+                      supported.features.multiDrawIndirect == VK_TRUE &&
+                      supported.features.drawIndirectFirstInstance == VK_TRUE;
+
+    VkPhysicalDeviceVulkan13Features features13 {
+        .sType              = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .dynamicRendering   = m_dynamicRendering ? VK_TRUE : VK_FALSE
+    };
+
+    // Timeline semaphores pace frames and uploads; descriptor indexing backs the bindless table
+    VkPhysicalDeviceVulkan12Features features12 {
+        .sType                                          = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext                                          = &features13,
+        .drawIndirectCount                              = m_indirectCount ? VK_TRUE : VK_FALSE,
+        .descriptorIndexing                             = VK_TRUE,
+        .shaderSampledImageArrayNonUniformIndexing      = VK_TRUE,
+        .shaderStorageBufferArrayNonUniformIndexing     = VK_TRUE,
+        .descriptorBindingSampledImageUpdateAfterBind   = VK_TRUE,
+        .descriptorBindingStorageBufferUpdateAfterBind  = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending      = VK_TRUE,
+        .descriptorBindingPartiallyBound                = VK_TRUE,
+        .runtimeDescriptorArray                         = VK_TRUE,
+        .timelineSemaphore                              = VK_TRUE
+    };
+
+    VkPhysicalDeviceFeatures2 deviceFeatures {
+        .sType      = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext      = &features12,
+        .features   = {
+            .multiDrawIndirect          = m_indirectCount ? VK_TRUE : VK_FALSE,
+            .drawIndirectFirstInstance  = m_indirectCount ? VK_TRUE : VK_FALSE
+        }
+    };
 
     VkDeviceCreateInfo createInfo {
         .sType                      = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext                      = &deviceFeatures,
         .queueCreateInfoCount       = static_cast<uint32_t>(queueCreateInfos.size()),
         .pQueueCreateInfos          = queueCreateInfos.data(),
         .enabledExtensionCount      = static_cast<uint32_t>(deviceExtensions.size()),
-        .ppEnabledExtensionNames    = deviceExtensions.data(),
-        .pEnabledFeatures           = &deviceFeatures
+        .ppEnabledExtensionNames    = deviceExtensions.empty() ? nullptr : deviceExtensions.data(),
+        .pEnabledFeatures           = nullptr
     };
 
     const auto result = vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device);
@@ -123,9 +245,12 @@ void VulkanDevice::createLogicalDevice() {
         throw std::runtime_error("Failed to create logical device.");
     }
 
-    DEBUG("Logical device created.");
+    DEBUG("Logical device created", m_dynamicRendering ? " with dynamic rendering." : ".");
 
     vkGetDeviceQueue(m_device, m_queueIndices.graphics.value(), 0, &m_graphicsQueue);
-    vkGetDeviceQueue(m_device, m_queueIndices.present.value(), 0, &m_presentQueue);
+    if (m_queueIndices.present) {
+        vkGetDeviceQueue(m_device, m_queueIndices.present.value(), 0, &m_presentQueue);
+    }
+    vkGetDeviceQueue(m_device, getTransferQueueFamily(), 0, &m_transferQueue);
 }
 
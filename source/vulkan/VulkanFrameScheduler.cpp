@@ -0,0 +1,110 @@
+#include "VulkanFrameScheduler.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+VulkanFrameScheduler::VulkanFrameScheduler(VkDevice device, const uint32_t slotCount, const uint32_t maxFramesInFlight)
+    : m_device(device),
+      m_slotCount(std::max(1u, slotCount)),
+      m_maxFramesInFlight(std::clamp(maxFramesInFlight, 1u, m_slotCount))
+{
+    VkSemaphoreTypeCreateInfo timelineInfo {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType  = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue   = 0
+    };
+
+    VkSemaphoreCreateInfo semaphoreInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &timelineInfo
+    };
+
+    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_timeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create frame timeline semaphore.");
+    }
+
+    m_acquireSemaphores.resize(m_slotCount);
+    for (auto& semaphore : m_acquireSemaphores) {
+        semaphore = createBinarySemaphore();
+    }
+
+    DEBUG("Frame scheduler created: ", m_maxFramesInFlight, " of ", m_slotCount, " frames in flight.");
+}
+
+VulkanFrameScheduler::~VulkanFrameScheduler() {
+    for (VkSemaphore semaphore : m_presentSemaphores) {
+        vkDestroySemaphore(m_device, semaphore, nullptr);
+    }
+    for (VkSemaphore semaphore : m_acquireSemaphores) {
+        vkDestroySemaphore(m_device, semaphore, nullptr);
+    }
+    if (m_timeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(m_device, m_timeline, nullptr);
+    }
+}
+
+VkSemaphore VulkanFrameScheduler::createBinarySemaphore() const {
+    VkSemaphoreCreateInfo semaphoreInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+    };
+
+    VkSemaphore semaphore;
+    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create frame semaphore.");
+    }
+    return semaphore;
+}
+
+uint64_t VulkanFrameScheduler::beginFrame() {
+    const uint64_t frame = m_submittedFrame + 1;
+
+    // Both the in-flight limit and slot reuse are satisfied once this frame is done
+    if (frame > m_maxFramesInFlight) {
+        waitForFrame(frame - m_maxFramesInFlight);
+    }
+    return frame;
+}
+
+void VulkanFrameScheduler::endFrame() {
+    ++m_submittedFrame;
+}
+
+uint64_t VulkanFrameScheduler::getCompletedFrame() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(m_device, m_timeline, &value);
+    m_completedFrame = std::max(m_completedFrame, value);
+    return m_completedFrame;
+}
+
+void VulkanFrameScheduler::waitForFrame(const uint64_t frame) const {
+    // The cached value first, then one counter read, before blocking
+    if (frame <= m_completedFrame || frame <= getCompletedFrame()) return;
+
+    VkSemaphoreWaitInfo waitInfo {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores    = &m_timeline,
+        .pValues        = &frame
+    };
+
+    if (vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to wait for frame timeline semaphore.");
+    }
+    m_completedFrame = std::max(m_completedFrame, frame);
+}
+
+void VulkanFrameScheduler::setMaxFramesInFlight(const uint32_t count) {
+    m_maxFramesInFlight = std::clamp(count, 1u, m_slotCount);
+}
+
+std::vector<VkSemaphore> VulkanFrameScheduler::setSwapchainImageCount(const uint32_t imageCount) {
+    std::vector<VkSemaphore> previous = std::move(m_presentSemaphores);
+    m_presentSemaphores.clear();
+    m_presentSemaphores.reserve(imageCount);
+    for (uint32_t i = 0; i < imageCount; ++i) {
+        m_presentSemaphores.push_back(createBinarySemaphore());
+    }
+    return previous;
+}
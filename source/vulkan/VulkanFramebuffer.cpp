@@ -6,18 +6,19 @@ VulkanFramebuffer::VulkanFramebuffer(
     VkDevice device,
     VkRenderPass renderPass,
     const std::vector<VkImageView>& imageViews,
-    VkExtent2D extent
+    VkExtent2D extent,
+    VkImageView depthView
 ) : m_device(device)
 {
     m_framebuffers.reserve(imageViews.size());
 
     for (const auto& view : imageViews) {
-        VkImageView attachments[] = { view };
+        VkImageView attachments[] = { view, depthView };
 
         VkFramebufferCreateInfo info {
             .sType              = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
             .renderPass         = renderPass,
-            .attachmentCount    = 1,
+            .attachmentCount    = depthView != VK_NULL_HANDLE ? 2u : 1u,
             .pAttachments       = attachments,
             .width              = extent.width,
             .height             = extent.height,
@@ -0,0 +1,144 @@
+#include "VulkanGpuProfiler.h"
+#include "VulkanDevice.h"
+#include "Logger.h"
+
+#include <stdexcept>
+
+void VulkanGpuProfiler::History::push(const float ms) {
+    samples[next] = ms;
+    next = (next + 1) % kHistorySize;
+
+    // Exponential average; reacts within a few dozen frames without jittering
+    averageMs = averageMs == 0.0f ? ms : averageMs + (ms - averageMs) * 0.05f;
+}
+
+VulkanGpuProfiler::VulkanGpuProfiler(const VulkanDevice& device, const uint32_t framesInFlight, const uint32_t maxScopesPerFrame)
+    : m_device(device.getDevice()),
+      m_maxScopes(maxScopesPerFrame),
+      m_queriesPerFrame(2 + maxScopesPerFrame * 2) {
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, families.data());
+
+    const uint32_t validBits = families[device.getQueueIndices().graphics.value()].timestampValidBits;
+    if (validBits == 0) {
+        WARN("Graphics queue does not support timestamps; GPU profiling disabled.");
+        return;
+    }
+
+    m_validMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    m_periodNs = device.getProperties().limits.timestampPeriod;
+    m_slots.resize(framesInFlight);
+    m_readback.resize(m_queriesPerFrame);
+
+    VkQueryPoolCreateInfo poolInfo {
+        .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType  = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = m_queriesPerFrame * framesInFlight
+    };
+
+    if (vkCreateQueryPool(m_device, &poolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool.");
+    }
+
+    DEBUG("GPU profiler created: ", m_queriesPerFrame, " queries per frame, ", m_periodNs, " ns/tick.");
+}
+
+VulkanGpuProfiler::~VulkanGpuProfiler() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+    }
+}
+
+void VulkanGpuProfiler::beginFrame(VkCommandBuffer cmd, const uint32_t frameIndex, const uint64_t frameNumber) {
+    if (!isEnabled()) return;
+
+    FrameSlot& slot = m_slots[frameIndex];
+    const uint32_t base = frameIndex * m_queriesPerFrame;
+
+    if (slot.frame != 0) {
+        collect(slot, base);
+    }
+
+    slot.frame = frameNumber;
+    slot.scopes.clear();
+    m_current = &slot;
+    m_currentBase = base;
+    m_depth = 0;
+
+    vkCmdResetQueryPool(cmd, m_queryPool, base, m_queriesPerFrame);
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, base);
+}
+
+void VulkanGpuProfiler::endFrame(VkCommandBuffer cmd) {
+    if (!m_current) return;
+
+    // Close scopes left open so every query in the slice is written and the readback succeeds
+    for (uint32_t scope = 0; scope < m_current->scopes.size(); ++scope) {
+        if (!m_current->scopes[scope].ended) {
+            endScope(cmd, scope);
+        }
+    }
+
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, m_currentBase + 1);
+    m_current = nullptr;
+}
+
+uint32_t VulkanGpuProfiler::beginScope(VkCommandBuffer cmd, std::string name) {
+    if (!m_current || m_current->scopes.size() >= m_maxScopes) return kInvalidScope;
+
+    const auto scope = static_cast<uint32_t>(m_current->scopes.size());
+    m_current->scopes.push_back({ std::move(name), m_depth++, false });
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, m_currentBase + 2 + scope * 2);
+    return scope;
+}
+
+void VulkanGpuProfiler::endScope(VkCommandBuffer cmd, const uint32_t scope) {
+    if (!m_current || scope == kInvalidScope) return;
+
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, m_currentBase + 3 + scope * 2);
+    m_current->scopes[scope].ended = true;
+    --m_depth;
+}
+
+const VulkanGpuProfiler::History* VulkanGpuProfiler::getScopeHistory(const std::string& name) const {
+    const auto it = m_scopeHistory.find(name);
+    return it != m_scopeHistory.end() ? &it->second : nullptr;
+}
+
+void VulkanGpuProfiler::collect(FrameSlot& slot, const uint32_t base) {
+    const uint32_t used = 2 + static_cast<uint32_t>(slot.scopes.size()) * 2;
+
+    // The slot's previous frame has retired, so this never blocks; NOT_READY drops the frame
+    const VkResult result = vkGetQueryPoolResults(
+        m_device, m_queryPool, base, used,
+        used * sizeof(uint64_t), m_readback.data(), sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT
+    );
+    if (result != VK_SUCCESS) {
+        slot.frame = 0;
+        return;
+    }
+
+    const auto toMs = [&](const uint64_t begin, const uint64_t end) {
+        return static_cast<double>((end - begin) & m_validMask) * m_periodNs / 1e6;
+    };
+
+    FrameResult frame {
+        .frame = slot.frame,
+        .totalMs = toMs(m_readback[0], m_readback[1])
+    };
+    m_frameHistory.push(static_cast<float>(frame.totalMs));
+
+    for (size_t i = 0; i < slot.scopes.size(); ++i) {
+        PendingScope& scope = slot.scopes[i];
+        const double ms = toMs(m_readback[2 + i * 2], m_readback[3 + i * 2]);
+        m_scopeHistory[scope.name].push(static_cast<float>(ms));
+        frame.scopes.push_back({ std::move(scope.name), scope.depth, ms });
+    }
+
+    m_latest = std::move(frame);
+    slot.frame = 0;
+}
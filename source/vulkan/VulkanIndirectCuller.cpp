@@ -0,0 +1,169 @@
+#include "VulkanIndirectCuller.h"
+#include "VulkanBindlessTable.h"
+#include "VulkanBuffer.h"
+#include "VulkanDevice.h"
+#include "VulkanPipeline.h"
+#include "VulkanPipelineCache.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+bool VulkanIndirectCuller::isSupported(const VulkanDevice& device) {
+    if (!device.hasIndirectCount()) return false;
+
+    VkPhysicalDeviceVulkan11Properties properties11 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_PROPERTIES
+    };
+    VkPhysicalDeviceProperties2 properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &properties11
+    };
+    vkGetPhysicalDeviceProperties2(device.getPhysicalDevice(), &properties);
+
+    return (properties11.subgroupSupportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+           (properties11.subgroupSupportedOperations & VK_SUBGROUP_FEATURE_BALLOT_BIT);
+}
+
+VulkanIndirectCuller::VulkanIndirectCuller(const VulkanDevice& device, VulkanBindlessTable& bindless,
+                                           const uint32_t maxDraws, const uint32_t slotCount)
+    : m_device(device.getDevice()),
+      m_bindless(bindless),
+      m_maxDraws(maxDraws)
+{
+    VkDescriptorSetLayoutCreateInfo emptyLayoutInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO
+    };
+
+    if (vkCreateDescriptorSetLayout(m_device, &emptyLayoutInfo, nullptr, &m_emptySetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create empty descriptor set layout.");
+    }
+
+    const VkDescriptorSetLayout setLayouts[] = { m_emptySetLayout, bindless.getSetLayout() };
+
+    VkPushConstantRange pushConstantRange {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset     = 0,
+        .size       = sizeof(PushConstants)
+    };
+
+    VkPipelineLayoutCreateInfo layoutInfo {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount         = 2,
+        .pSetLayouts            = setLayouts,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &pushConstantRange
+    };
+
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create cull pipeline layout.");
+    }
+
+    VkShaderModule shader = VulkanPipeline::loadShaderModule(m_device, VULKANLAB_SHADER_DIR "/cull.comp.spv");
+
+    VkComputePipelineCreateInfo pipelineInfo {
+        .sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage  = {
+            .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage  = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = shader,
+            .pName  = "main"
+        },
+        .layout = m_pipelineLayout
+    };
+
+    VulkanPipelineCache& pipelineCache = device.getPipelineCache();
+    const auto start = std::chrono::steady_clock::now();
+    const VkResult result = vkCreateComputePipelines(m_device, pipelineCache.get(), 1, &pipelineInfo, nullptr, &m_pipeline);
+    vkDestroyShaderModule(m_device, shader, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create cull pipeline.");
+    }
+    pipelineCache.recordPipelineCreation(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+    // The compute pass writes these through the bindless table; the draw reads them as indirect arguments
+    m_slots.resize(slotCount);
+    for (SlotBuffers& slot : m_slots) {
+        slot.draws = std::make_unique<VulkanBuffer>(
+            device.getAllocator(),
+            sizeof(VkDrawIndexedIndirectCommand) * maxDraws,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        slot.count = std::make_unique<VulkanBuffer>(
+            device.getAllocator(),
+            sizeof(uint32_t),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        slot.drawIndex = bindless.addStorageBuffer(slot.draws->get());
+        slot.countIndex = bindless.addStorageBuffer(slot.count->get());
+    }
+
+    DEBUG("Indirect culler created: ", maxDraws, " draws, ", slotCount, " slots.");
+}
+
+VulkanIndirectCuller::~VulkanIndirectCuller() {
+    // Only destroyed once the GPU is done with every slot
+    for (const SlotBuffers& slot : m_slots) {
+        m_bindless.release(VulkanBindlessTable::Kind::StorageBuffer, slot.drawIndex);
+        m_bindless.release(VulkanBindlessTable::Kind::StorageBuffer, slot.countIndex);
+    }
+    if (m_pipeline != VK_NULL_HANDLE) vkDestroyPipeline(m_device, m_pipeline, nullptr);
+    if (m_pipelineLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    if (m_emptySetLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(m_device, m_emptySetLayout, nullptr);
+}
+
+void VulkanIndirectCuller::recordCull(VkCommandBuffer cmd, const uint32_t slot, const Frustum& frustum,
+                                      const uint32_t instanceBuffer, const uint32_t meshBuffer,
+                                      const uint32_t instanceCount) const {
+    const SlotBuffers& buffers = m_slots[slot];
+
+    // Survivors are appended with atomics, so the count starts from zero every frame
+    vkCmdFillBuffer(cmd, buffers.count->get(), 0, sizeof(uint32_t), 0);
+
+    const VkMemoryBarrier clearBarrier {
+        .sType          = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask  = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask  = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    };
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+    PushConstants pushConstants {
+        .instanceBuffer = instanceBuffer,
+        .meshBuffer     = meshBuffer,
+        .drawBuffer     = buffers.drawIndex,
+        .countBuffer    = buffers.countIndex,
+        .instanceCount  = std::min(instanceCount, m_maxDraws)
+    };
+    for (uint32_t i = 0; i < Frustum::PlaneCount; ++i) {
+        pushConstants.planes[i] = frustum.planes[i];
+    }
+
+    const VkDescriptorSet bindlessSet = m_bindless.getSet();
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 1, 1, &bindlessSet, 0, nullptr);
+    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+    vkCmdDispatch(cmd, (pushConstants.instanceCount + kWorkgroupSize - 1) / kWorkgroupSize, 1, 1);
+}
+
+void VulkanIndirectCuller::recordDraw(VkCommandBuffer cmd, const uint32_t slot) const {
+    const SlotBuffers& buffers = m_slots[slot];
+    vkCmdDrawIndexedIndirectCount(cmd, buffers.draws->get(), 0, buffers.count->get(), 0,
+                                  m_maxDraws, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+VkBuffer VulkanIndirectCuller::getDrawBuffer(const uint32_t slot) const {
+    return m_slots[slot].draws->get();
+}
+
+VkBuffer VulkanIndirectCuller::getCountBuffer(const uint32_t slot) const {
+    return m_slots[slot].count->get();
+}
+
+VkDeviceSize VulkanIndirectCuller::getDrawBufferSize() const {
+    return sizeof(VkDrawIndexedIndirectCommand) * m_maxDraws;
+}
@@ -43,7 +43,7 @@ VulkanInstance::VulkanInstance(VulkanConfig config) : m_config(std::move(config)
         .enabledLayerCount          = m_config.enableValidationLayers ? static_cast<uint32_t>(validationLayers().size()) : 0,
         .ppEnabledLayerNames        = m_config.enableValidationLayers ? validationLayers().data() : VK_NULL_HANDLE,
         .enabledExtensionCount      = static_cast<uint32_t>(extensions.size()),
-        .ppEnabledExtensionNames    = extensions.data(),
+        .ppEnabledExtensionNames    = extensions.empty() ? VK_NULL_HANDLE : extensions.data(),
     };
 
     if (const auto result = vkCreateInstance(&createInfo, nullptr, &m_instance);
@@ -62,9 +62,14 @@ VulkanInstance::~VulkanInstance() {
 }
 
 std::vector<const char*> VulkanInstance::getRequiredExtensions() const {
-    uint32_t count = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&count);
-    std::vector extensions(glfwExtensions, glfwExtensions + count);
+    std::vector<const char*> extensions;
+
+    // Headless runs never create a surface, so GLFW is not even initialized
+    if (!m_config.headless) {
+        uint32_t count = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&count);
+        extensions.assign(glfwExtensions, glfwExtensions + count);
+    }
 
     if (m_config.enableValidationLayers) {
         extensions.push_back("VK_EXT_debug_utils");
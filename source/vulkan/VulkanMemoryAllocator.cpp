@@ -0,0 +1,194 @@
+#include "VulkanMemoryAllocator.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+constexpr VkDeviceSize kSmallHeapLimit = 1ull << 30;        // 1 GiB
+constexpr VkDeviceSize kLargeHeapBlockSize = 128ull << 20;  // 128 MiB
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(
+    VkDevice device,
+    const VkPhysicalDeviceMemoryProperties& memoryProperties,
+    const VkPhysicalDeviceLimits& limits)
+        : m_device(device),
+          m_memoryProperties(memoryProperties),
+          m_bufferImageGranularity(limits.bufferImageGranularity) {
+
+    m_pools.resize(m_memoryProperties.memoryTypeCount * 2);
+    for (uint32_t type = 0; type < m_memoryProperties.memoryTypeCount; ++type) {
+        for (uint32_t kind = 0; kind < 2; ++kind) {
+            Pool& pool = m_pools[type * 2 + kind];
+            pool.memoryType = type;
+            pool.blockSize = preferredBlockSize(type);
+        }
+    }
+
+    DEBUG("Memory allocator created for ", m_memoryProperties.memoryTypeCount, " memory types.");
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+    for (auto& pool : m_pools) {
+        for (uint32_t i = 0; i < pool.blocks.size(); ++i) {
+            if (!pool.blocks[i]) continue;
+            if (!pool.blocks[i]->allocator->empty()) {
+                WARN("Memory block of type ", pool.memoryType, " destroyed with live allocations.");
+            }
+            destroyBlock(pool, i);
+        }
+    }
+    DEBUG("Memory allocator destroyed.");
+}
+
+VkDeviceSize VulkanMemoryAllocator::preferredBlockSize(const uint32_t memoryType) const {
+    const uint32_t heapIndex = m_memoryProperties.memoryTypes[memoryType].heapIndex;
+    const VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[heapIndex].size;
+    return heapSize <= kSmallHeapLimit ? heapSize / 8 : kLargeHeapBlockSize;
+}
+
+uint32_t VulkanMemoryAllocator::findMemoryType(const uint32_t typeFilter, const VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i) {
+        if (typeFilter & 1 << i &&
+            (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Failed to find suitable memory type.");
+}
+
+uint32_t VulkanMemoryAllocator::createBlock(Pool& pool, const VkDeviceSize size, const bool dedicated) {
+    auto block = std::make_unique<Block>();
+    block->dedicated = dedicated;
+    block->allocator = std::make_unique<TlsfAllocator>(size);
+
+    VkMemoryAllocateInfo allocInfo {
+        .sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize     = size,
+        .memoryTypeIndex    = pool.memoryType
+    };
+
+    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &block->memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate device memory block.");
+    }
+
+    // Host-visible blocks stay mapped for their whole lifetime
+    const VkMemoryPropertyFlags flags = m_memoryProperties.memoryTypes[pool.memoryType].propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(m_device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped) != VK_SUCCESS) {
+            vkFreeMemory(m_device, block->memory, nullptr);
+            throw std::runtime_error("Failed to map device memory block.");
+        }
+    }
+
+    const auto slot = std::ranges::find(pool.blocks, nullptr);
+    if (slot != pool.blocks.end()) {
+        *slot = std::move(block);
+        return static_cast<uint32_t>(slot - pool.blocks.begin());
+    }
+
+    pool.blocks.push_back(std::move(block));
+    return static_cast<uint32_t>(pool.blocks.size() - 1);
+}
+
+void VulkanMemoryAllocator::destroyBlock(Pool& pool, const uint32_t blockIndex) {
+    auto& block = pool.blocks[blockIndex];
+    if (block->mapped) vkUnmapMemory(m_device, block->memory);
+    vkFreeMemory(m_device, block->memory, nullptr);
+    block.reset();
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    const VkMemoryPropertyFlags properties,
+    const VulkanResourceKind kind) {
+
+    std::lock_guard lock(m_mutex);
+
+    const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+    const uint32_t kindIndex = m_bufferImageGranularity > 1 ? static_cast<uint32_t>(kind) : 0;
+    const uint32_t poolIndex = memoryType * 2 + kindIndex;
+    Pool& pool = m_pools[poolIndex];
+
+    uint32_t blockIndex = UINT32_MAX;
+    std::optional<TlsfAllocator::Allocation> suballocation;
+
+    if (requirements.size > pool.blockSize / 2) {
+        // Large resources get their own VkDeviceMemory; offset zero satisfies any alignment
+        blockIndex = createBlock(pool, requirements.size, true);
+        suballocation = pool.blocks[blockIndex]->allocator->allocate(requirements.size, 1);
+    } else {
+        for (uint32_t i = 0; i < pool.blocks.size() && !suballocation; ++i) {
+            if (!pool.blocks[i] || pool.blocks[i]->dedicated) continue;
+            suballocation = pool.blocks[i]->allocator->allocate(requirements.size, requirements.alignment);
+            blockIndex = i;
+        }
+
+        if (!suballocation) {
+            blockIndex = createBlock(pool, pool.blockSize, false);
+            suballocation = pool.blocks[blockIndex]->allocator->allocate(requirements.size, requirements.alignment);
+        }
+    }
+
+    if (!suballocation) {
+        throw std::runtime_error("Failed to sub-allocate device memory.");
+    }
+
+    const Block& block = *pool.blocks[blockIndex];
+    return VulkanAllocation {
+        .memory     = block.memory,
+        .offset     = suballocation->offset,
+        .size       = suballocation->size,
+        .mapped     = block.mapped ? static_cast<char*>(block.mapped) + suballocation->offset : nullptr,
+        .pool       = poolIndex,
+        .block      = blockIndex,
+        .node       = suballocation->node
+    };
+}
+
+void VulkanMemoryAllocator::free(const VulkanAllocation& allocation) {
+    if (!allocation.isValid()) return;
+
+    std::lock_guard lock(m_mutex);
+
+    Pool& pool = m_pools[allocation.pool];
+    Block& block = *pool.blocks[allocation.block];
+    block.allocator->free(allocation.node);
+
+    if (!block.allocator->empty()) return;
+
+    // Keep one empty shared block around so alloc/free churn doesn't hit the driver
+    const auto sharedBlocks = std::ranges::count_if(pool.blocks, [](const auto& b) {
+        return b && !b->dedicated;
+    });
+
+    if (block.dedicated || sharedBlocks > 1) {
+        destroyBlock(pool, allocation.block);
+    }
+}
+
+VulkanAllocatorStats VulkanMemoryAllocator::getStats() const {
+    std::lock_guard lock(m_mutex);
+
+    VulkanAllocatorStats stats{};
+    for (const auto& pool : m_pools) {
+        for (const auto& block : pool.blocks) {
+            if (!block) continue;
+
+            const TlsfAllocator::Stats blockStats = block->allocator->getStats();
+            ++stats.blockCount;
+            if (block->dedicated) ++stats.dedicatedBlockCount;
+            stats.allocationCount += blockStats.allocationCount;
+            stats.reservedBytes += blockStats.totalSize;
+            stats.usedBytes += blockStats.usedBytes;
+            stats.wastedBytes += blockStats.wastedBytes;
+            if (!block->dedicated) {
+                stats.fragmentation = std::max(stats.fragmentation, blockStats.fragmentation());
+            }
+        }
+    }
+
+    return stats;
+}
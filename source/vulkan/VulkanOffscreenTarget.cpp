@@ -0,0 +1,89 @@
+#include "VulkanOffscreenTarget.h"
+#include "Logger.h"
+
+#include <stdexcept>
+
+VulkanOffscreenTarget::VulkanOffscreenTarget(
+    VulkanMemoryAllocator& allocator,
+    VkFormat format,
+    VkExtent2D extent,
+    uint32_t imageCount)
+        : m_allocator(allocator),
+          m_device(allocator.getDevice()),
+          m_imageFormat(format),
+          m_extent(extent) {
+
+    m_images.reserve(imageCount);
+    m_allocations.reserve(imageCount);
+    m_imageViews.reserve(imageCount);
+
+    for (uint32_t i = 0; i < imageCount; ++i) {
+        VkImageCreateInfo imageInfo {
+            .sType          = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType      = VK_IMAGE_TYPE_2D,
+            .format         = m_imageFormat,
+            .extent         = { m_extent.width, m_extent.height, 1 },
+            .mipLevels      = 1,
+            .arrayLayers    = 1,
+            .samples        = VK_SAMPLE_COUNT_1_BIT,
+            .tiling         = VK_IMAGE_TILING_OPTIMAL,
+            .usage          = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode    = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        VkImage image;
+        if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create offscreen image.");
+        }
+        m_images.push_back(image);
+
+        VkMemoryRequirements memReqs;
+        vkGetImageMemoryRequirements(m_device, image, &memReqs);
+
+        const VulkanAllocation allocation = m_allocator.allocate(
+            memReqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VulkanResourceKind::Optimal);
+        m_allocations.push_back(allocation);
+
+        if (vkBindImageMemory(m_device, image, allocation.memory, allocation.offset) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to bind offscreen image memory.");
+        }
+
+        VkImageViewCreateInfo viewInfo {
+            .sType              = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image              = image,
+            .viewType           = VK_IMAGE_VIEW_TYPE_2D,
+            .format             = m_imageFormat,
+            .components         = {},
+            .subresourceRange   = {
+                .aspectMask         = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel       = 0,
+                .levelCount         = 1,
+                .baseArrayLayer     = 0,
+                .layerCount         = 1,
+            }
+        };
+
+        VkImageView imageView;
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &imageView) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create offscreen image view.");
+        }
+        m_imageViews.push_back(imageView);
+    }
+
+    DEBUG("Offscreen target created with ", m_images.size(), " images (",
+          m_extent.width, "x", m_extent.height, ").");
+}
+
+VulkanOffscreenTarget::~VulkanOffscreenTarget() {
+    for (auto view : m_imageViews) {
+        vkDestroyImageView(m_device, view, nullptr);
+    }
+    for (auto image : m_images) {
+        vkDestroyImage(m_device, image, nullptr);
+    }
+    for (const auto& allocation : m_allocations) {
+        m_allocator.free(allocation);
+    }
+    DEBUG("Offscreen target destroyed.");
+}
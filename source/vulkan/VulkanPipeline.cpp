@@ -1,13 +1,29 @@
 #include "VulkanPipeline.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanBindlessTable.h"
+#include "Logger.h"
+#include <chrono>
 #include <vector>
 #include <fstream>
 #include <stdexcept>
 
-VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
+VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout bindlessLayout,
+                               VulkanPipelineCache& pipelineCache, const VulkanShaderStages& shaders)
+    : VulkanPipeline(device, renderPass, VK_FORMAT_UNDEFINED, VK_FORMAT_UNDEFINED, bindlessLayout, pipelineCache,
+                     shaders) {}
+
+VulkanPipeline::VulkanPipeline(VkDevice device, VkFormat colorFormat, VkFormat depthFormat,
+                               VkDescriptorSetLayout bindlessLayout, VulkanPipelineCache& pipelineCache,
+                               const VulkanShaderStages& shaders)
+    : VulkanPipeline(device, VK_NULL_HANDLE, colorFormat, depthFormat, bindlessLayout, pipelineCache, shaders) {}
+
+VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass, VkFormat colorFormat, VkFormat depthFormat,
+                               VkDescriptorSetLayout bindlessLayout, VulkanPipelineCache& pipelineCache,
+                               const VulkanShaderStages& shaders)
     : m_device(device)
 {
-    VkShaderModule vertShader = loadShaderModule("/home/devkon/CLionProjects/VulkanLab/assets/shaders/triangle.vert.spv");
-    VkShaderModule fragShader = loadShaderModule("/home/devkon/CLionProjects/VulkanLab/assets/shaders/triangle.frag.spv");
+    VkShaderModule vertShader = loadShaderModule(device, VULKANLAB_SHADER_DIR "/" + shaders.vertex);
+    VkShaderModule fragShader = loadShaderModule(device, VULKANLAB_SHADER_DIR "/" + shaders.fragment);
 
     VkPipelineShaderStageCreateInfo vertStage {
         .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -25,22 +41,19 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
 
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertStage, fragStage };
 
-    // Vertex input
-    const auto bindingDescriptions = Vertex::getBindingDescription();
-    const auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
+    // Vertex input, generated from the VertexLayout's encodings
     VkPipelineVertexInputStateCreateInfo vertexInput {
         .sType                              = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .vertexBindingDescriptionCount      = 1,
-        .pVertexBindingDescriptions         = &bindingDescriptions,
-        .vertexAttributeDescriptionCount    = static_cast<uint32_t>(attributeDescriptions.size()),
-        .pVertexAttributeDescriptions       = attributeDescriptions.data()
+        .pVertexBindingDescriptions         = &shaders.vertexInput.binding,
+        .vertexAttributeDescriptionCount    = static_cast<uint32_t>(shaders.vertexInput.attributes.size()),
+        .pVertexAttributeDescriptions       = shaders.vertexInput.attributes.data()
     };
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly {
         .sType                      = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
         .topology                   = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
-        .primitiveRestartEnable     = VK_FALSE
+        .primitiveRestartEnable     = VK_FALSE  // Keeps 0xFFFF a valid 16-bit index (Mesh::getIndexType)
     };
 
     VkPipelineViewportStateCreateInfo viewportState {
@@ -64,6 +77,14 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
         .rasterizationSamples   = VK_SAMPLE_COUNT_1_BIT
     };
 
+    // Ignored when the pass has no depth attachment
+    VkPipelineDepthStencilStateCreateInfo depthStencil {
+        .sType              = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .depthTestEnable    = VK_TRUE,
+        .depthWriteEnable   = VK_TRUE,
+        .depthCompareOp     = VK_COMPARE_OP_LESS_OR_EQUAL
+    };
+
     VkPipelineColorBlendAttachmentState colorBlendAttachment {
         .colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
                           VK_COLOR_COMPONENT_G_BIT |
@@ -77,10 +98,10 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
         .pAttachments       = &colorBlendAttachment
     };
 
-    // Descriptor set layout for camera UBO
+    // Descriptor set layout for camera UBO, offset into the per-frame uniform ring
     VkDescriptorSetLayoutBinding uboLayoutBinding{
         .binding = 0,
-        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
         .descriptorCount = 1,
         .stageFlags = VK_SHADER_STAGE_VERTEX_BIT
     };
@@ -95,11 +116,21 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
         throw std::runtime_error("Failed to create descriptor set layout.");
     }
 
-    // Layout
+    // Layout: per-frame set, then the bindless table; push constants index into the table
+    const VkDescriptorSetLayout setLayouts[] = { m_descriptorSetLayout, bindlessLayout };
+
+    VkPushConstantRange pushConstantRange {
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        .offset     = 0,
+        .size       = sizeof(BindlessPushConstants)
+    };
+
     VkPipelineLayoutCreateInfo pipelineLayoutInfo {
-        .sType              = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount     = 1,
-        .pSetLayouts        = &m_descriptorSetLayout
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount         = 2,
+        .pSetLayouts            = setLayouts,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &pushConstantRange
     };
 
     if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
@@ -116,9 +147,18 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
         .pDynamicStates     = dynamicStates
     };
 
+    // Without a render pass the attachment formats are all the pipeline needs to know
+    VkPipelineRenderingCreateInfo renderingInfo {
+        .sType                      = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount       = 1,
+        .pColorAttachmentFormats    = &colorFormat,
+        .depthAttachmentFormat      = depthFormat
+    };
+
     // Pipeline
     VkGraphicsPipelineCreateInfo pipelineInfo {
         .sType                  = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext                  = renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr,
         .stageCount             = 2,
         .pStages                = shaderStages,
         .pVertexInputState      = &vertexInput,
@@ -126,6 +166,7 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
         .pViewportState         = &viewportState,
         .pRasterizationState    = &rasterizer,
         .pMultisampleState      = &multisampling,
+        .pDepthStencilState     = &depthStencil,
         .pColorBlendState       = &colorBlending,
         .pDynamicState          = &dynamicState,
         .layout                 = m_pipelineLayout,
@@ -133,8 +174,13 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
         .subpass                = 0
     };
 
-    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+    const auto start = std::chrono::steady_clock::now();
+    if (vkCreateGraphicsPipelines(device, pipelineCache.get(), 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
         throw std::runtime_error("Failed to create graphics pipeline.");
+    const double createMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    pipelineCache.recordPipelineCreation(createMs);
+    DEBUG("Graphics pipeline created in ", createMs, " ms.");
 
     vkDestroyShaderModule(device, vertShader, nullptr);
     vkDestroyShaderModule(device, fragShader, nullptr);
@@ -143,9 +189,10 @@ VulkanPipeline::VulkanPipeline(VkDevice device, VkRenderPass renderPass)
 VulkanPipeline::~VulkanPipeline() {
     if (m_pipeline) vkDestroyPipeline(m_device, m_pipeline, nullptr);
     if (m_pipelineLayout) vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    if (m_descriptorSetLayout) vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
 }
 
-VkShaderModule VulkanPipeline::loadShaderModule(const std::string& path) const {
+VkShaderModule VulkanPipeline::loadShaderModule(VkDevice device, const std::string& path) {
     std::ifstream file(path, std::ios::binary | std::ios::ate);
     if (!file) throw std::runtime_error("Failed to open shader file: " + path);
 
@@ -161,7 +208,7 @@ VkShaderModule VulkanPipeline::loadShaderModule(const std::string& path) const {
     };
 
     VkShaderModule shader;
-    if (vkCreateShaderModule(m_device, &createInfo, nullptr, &shader) != VK_SUCCESS)
+    if (vkCreateShaderModule(device, &createInfo, nullptr, &shader) != VK_SUCCESS)
         throw std::runtime_error("Failed to create shader module.");
 
     return shader;
@@ -0,0 +1,127 @@
+#include "VulkanPipelineCache.h"
+#include "Logger.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+VulkanPipelineCache::VulkanPipelineCache(
+    VkDevice device,
+    const VkPhysicalDeviceProperties& properties,
+    std::filesystem::path path)
+        : m_device(device),
+          m_properties(properties),
+          m_path(std::move(path)) {
+
+    const std::vector<char> blob = loadValidatedBlob();
+    m_stats.warmStart = !blob.empty();
+
+    VkPipelineCacheCreateInfo createInfo {
+        .sType              = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize    = blob.size(),
+        .pInitialData       = blob.empty() ? nullptr : blob.data()
+    };
+
+    if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache.");
+    }
+
+    DEBUG("Pipeline cache created (", m_stats.warmStart ? "warm, " : "cold, ", blob.size(), " bytes loaded).");
+}
+
+VulkanPipelineCache::~VulkanPipelineCache() {
+    const Stats stats = getStats();
+    if (stats.pipelineCount > 0) {
+        INFO("Pipeline creation (", stats.warmStart ? "warm" : "cold", " cache): ",
+             stats.pipelineCount, " pipelines, first ", stats.firstCreateMs, " ms, total ",
+             stats.totalCreateMs, " ms.");
+    }
+
+    try {
+        save();
+    } catch (const std::exception& e) {
+        WARN("Failed to save pipeline cache: ", e.what());
+    }
+
+    vkDestroyPipelineCache(m_device, m_cache, nullptr);
+    DEBUG("Pipeline cache destroyed.");
+}
+
+std::vector<char> VulkanPipelineCache::loadValidatedBlob() const {
+    if (m_path.empty()) return {};
+
+    std::ifstream file(m_path, std::ios::binary | std::ios::ate);
+    if (!file) return {};
+
+    const auto size = static_cast<size_t>(file.tellg());
+    if (size < sizeof(VkPipelineCacheHeaderVersionOne)) {
+        WARN("Ignoring truncated pipeline cache: ", m_path.string());
+        return {};
+    }
+
+    std::vector<char> blob(size);
+    file.seekg(0);
+    file.read(blob.data(), static_cast<std::streamsize>(size));
+    if (!file) return {};
+
+    // A blob from another driver or GPU is at best useless and at worst crashes the driver
+    VkPipelineCacheHeaderVersionOne header;
+    std::memcpy(&header, blob.data(), sizeof(header));
+
+    const bool valid =
+        header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+        header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        header.vendorID == m_properties.vendorID &&
+        header.deviceID == m_properties.deviceID &&
+        std::memcmp(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+    if (!valid) {
+        INFO("Pipeline cache does not match this device/driver; starting cold.");
+        return {};
+    }
+
+    return blob;
+}
+
+void VulkanPipelineCache::save() const {
+    if (m_path.empty()) return;
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(m_device, m_cache, &size, nullptr) != VK_SUCCESS || size == 0) return;
+
+    std::vector<char> blob(size);
+    if (vkGetPipelineCacheData(m_device, m_cache, &size, blob.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to read pipeline cache data.");
+    }
+
+    if (m_path.has_parent_path()) {
+        std::filesystem::create_directories(m_path.parent_path());
+    }
+
+    // Write next to the target, then rename, so a crash never leaves a torn cache
+    std::filesystem::path tempPath = m_path;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("Failed to open " + tempPath.string());
+        file.write(blob.data(), static_cast<std::streamsize>(size));
+        if (!file) throw std::runtime_error("Failed to write " + tempPath.string());
+    }
+
+    std::filesystem::rename(tempPath, m_path);
+    DEBUG("Pipeline cache saved (", size, " bytes).");
+}
+
+void VulkanPipelineCache::recordPipelineCreation(const double milliseconds) {
+    std::lock_guard lock(m_statsMutex);
+    if (m_stats.pipelineCount == 0) m_stats.firstCreateMs = milliseconds;
+    m_stats.lastCreateMs = milliseconds;
+    m_stats.totalCreateMs += milliseconds;
+    ++m_stats.pipelineCount;
+}
+
+VulkanPipelineCache::Stats VulkanPipelineCache::getStats() const {
+    std::lock_guard lock(m_statsMutex);
+    return m_stats;
+}
@@ -0,0 +1,618 @@
+#include "VulkanRenderGraph.h"
+#include "VulkanGpuProfiler.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+struct UsageInfo {
+    VkPipelineStageFlags stage;
+    VkAccessFlags readAccess;
+    VkAccessFlags writeAccess;
+    VkImageLayout layout;
+    VkFlags usageFlag; // VkImageUsageFlags or VkBufferUsageFlags
+};
+
+UsageInfo imageUsageInfo(const VulkanRenderGraph::ImageUsage usage) {
+    using Usage = VulkanRenderGraph::ImageUsage;
+    switch (usage) {
+        case Usage::ColorAttachment:
+            return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+        case Usage::DepthAttachment:
+            return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                     VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+        case Usage::DepthRead:
+            return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                     VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+        case Usage::Sampled:
+            return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                     VK_ACCESS_SHADER_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT };
+        case Usage::Storage:
+            return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT };
+        case Usage::TransferSrc:
+            return { VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_ACCESS_TRANSFER_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
+        case Usage::TransferDst:
+            return { VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+    }
+    throw std::runtime_error("Unknown render graph image usage.");
+}
+
+UsageInfo bufferUsageInfo(const VulkanRenderGraph::BufferUsage usage) {
+    using Usage = VulkanRenderGraph::BufferUsage;
+    switch (usage) {
+        case Usage::Vertex:
+            return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_UNDEFINED, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+        case Usage::Index:
+            return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_UNDEFINED, VK_BUFFER_USAGE_INDEX_BUFFER_BIT };
+        case Usage::Indirect:
+            return { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_UNDEFINED, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT };
+        case Usage::Uniform:
+            return { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                     VK_ACCESS_UNIFORM_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_UNDEFINED, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT };
+        case Usage::Storage:
+            return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_UNDEFINED, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+        case Usage::TransferSrc:
+            return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0,
+                     VK_IMAGE_LAYOUT_UNDEFINED, VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+        case Usage::TransferDst:
+            return { VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_UNDEFINED, VK_BUFFER_USAGE_TRANSFER_DST_BIT };
+    }
+    throw std::runtime_error("Unknown render graph buffer usage.");
+}
+
+bool isDepthFormat(const VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+VkImageAspectFlags aspectFor(const VkFormat format) {
+    return isDepthFormat(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+}
+
+// --- PassBuilder ---
+
+VulkanRenderGraph::ImageHandle VulkanRenderGraph::PassBuilder::createImage(std::string name, const ImageDesc& desc) {
+    m_graph.m_images.push_back({ .name = std::move(name), .desc = desc, .imported = false, .importState = {} });
+    return { static_cast<uint32_t>(m_graph.m_images.size() - 1) };
+}
+
+VulkanRenderGraph::BufferHandle VulkanRenderGraph::PassBuilder::createBuffer(std::string name, const VkDeviceSize size) {
+    m_graph.m_buffers.push_back({ .name = std::move(name), .size = size, .imported = false });
+    return { static_cast<uint32_t>(m_graph.m_buffers.size() - 1) };
+}
+
+void VulkanRenderGraph::PassBuilder::read(const ImageHandle image, const ImageUsage usage) {
+    m_graph.m_passes[m_pass].accesses.push_back({ image.index, true, false, static_cast<uint32_t>(usage) });
+}
+
+void VulkanRenderGraph::PassBuilder::write(const ImageHandle image, const ImageUsage usage) {
+    m_graph.m_passes[m_pass].accesses.push_back({ image.index, true, true, static_cast<uint32_t>(usage) });
+}
+
+void VulkanRenderGraph::PassBuilder::read(const BufferHandle buffer, const BufferUsage usage) {
+    m_graph.m_passes[m_pass].accesses.push_back({ buffer.index, false, false, static_cast<uint32_t>(usage) });
+}
+
+void VulkanRenderGraph::PassBuilder::write(const BufferHandle buffer, const BufferUsage usage) {
+    m_graph.m_passes[m_pass].accesses.push_back({ buffer.index, false, true, static_cast<uint32_t>(usage) });
+}
+
+void VulkanRenderGraph::PassBuilder::setSideEffect() const {
+    m_graph.m_passes[m_pass].sideEffect = true;
+}
+
+// --- Declaration ---
+
+VulkanRenderGraph::VulkanRenderGraph(VulkanMemoryAllocator& allocator)
+    : m_allocator(allocator),
+      m_device(allocator.getDevice()) {}
+
+VulkanRenderGraph::~VulkanRenderGraph() {
+    destroyTransients();
+}
+
+VulkanRenderGraph::ImageHandle VulkanRenderGraph::importImage(std::string name, const ImageDesc& desc,
+                                                              const ImportedImageState& state) {
+    m_images.push_back({ .name = std::move(name), .desc = desc, .imported = true, .importState = state });
+    m_compiled = false;
+    return { static_cast<uint32_t>(m_images.size() - 1) };
+}
+
+VulkanRenderGraph::BufferHandle VulkanRenderGraph::importBuffer(std::string name, const VkDeviceSize size) {
+    m_buffers.push_back({ .name = std::move(name), .size = size, .imported = true });
+    m_compiled = false;
+    return { static_cast<uint32_t>(m_buffers.size() - 1) };
+}
+
+void VulkanRenderGraph::addPass(std::string name, const SetupFn& setup, ExecuteFn execute) {
+    m_passes.push_back({ .name = std::move(name), .execute = std::move(execute) });
+
+    PassBuilder builder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+    setup(builder);
+    m_compiled = false;
+}
+
+void VulkanRenderGraph::reset() {
+    destroyTransients();
+    m_passes.clear();
+    m_images.clear();
+    m_buffers.clear();
+    m_steps.clear();
+    m_finalBarriers = {};
+    m_stats = {};
+    m_compiled = false;
+}
+
+void VulkanRenderGraph::setImportedImage(const ImageHandle handle, VkImage image, VkImageView view) {
+    m_images[handle.index].image = image;
+    m_images[handle.index].view = view;
+}
+
+void VulkanRenderGraph::setImportedBuffer(const BufferHandle handle, VkBuffer buffer) {
+    m_buffers[handle.index].buffer = buffer;
+}
+
+// --- Compilation ---
+
+void VulkanRenderGraph::compile() {
+    if (m_compiled) return;
+
+    destroyTransients();
+    m_steps.clear();
+    m_finalBarriers = {};
+    m_stats = {};
+
+    cullPasses();
+    computeLifetimes();
+    allocateTransients();
+    planBarriers();
+
+    m_compiled = true;
+
+    DEBUG("Render graph compiled: ", m_stats.passCount - m_stats.culledPassCount, "/", m_stats.passCount,
+          " passes, ", m_stats.transientImageCount + m_stats.transientBufferCount, " transients in ",
+          m_stats.memorySlotCount, " slots (", m_stats.allocatedBytes / 1024, " KiB of ",
+          m_stats.transientBytes / 1024, " KiB).");
+}
+
+void VulkanRenderGraph::cullPasses() {
+    // Walk backwards from the roots: a pass lives if it has side effects, writes
+    // an imported resource, or writes something a live pass reads
+    std::vector<bool> imageNeeded(m_images.size(), false);
+    std::vector<bool> bufferNeeded(m_buffers.size(), false);
+
+    for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); ++pass) {
+        pass->live = pass->sideEffect;
+
+        for (const Access& access : pass->accesses) {
+            if (!access.isWrite) continue;
+            const bool needed = access.isImage
+                ? m_images[access.resource].imported || imageNeeded[access.resource]
+                : m_buffers[access.resource].imported || bufferNeeded[access.resource];
+            pass->live = pass->live || needed;
+        }
+
+        if (!pass->live) continue;
+
+        for (const Access& access : pass->accesses) {
+            if (access.isWrite) continue;
+            (access.isImage ? imageNeeded : bufferNeeded)[access.resource] = true;
+        }
+    }
+
+    m_stats.passCount = static_cast<uint32_t>(m_passes.size());
+    m_stats.culledPassCount = static_cast<uint32_t>(std::ranges::count_if(m_passes, [](const Pass& pass) {
+        return !pass.live;
+    }));
+}
+
+void VulkanRenderGraph::computeLifetimes() {
+    for (auto& image : m_images) {
+        image.firstPass = UINT32_MAX;
+        image.lastPass = 0;
+        image.usage = 0;
+    }
+    for (auto& buffer : m_buffers) {
+        buffer.firstPass = UINT32_MAX;
+        buffer.lastPass = 0;
+        buffer.usage = 0;
+    }
+
+    for (uint32_t i = 0; i < m_passes.size(); ++i) {
+        if (!m_passes[i].live) continue;
+
+        for (const Access& access : m_passes[i].accesses) {
+            if (access.isImage) {
+                ImageResource& image = m_images[access.resource];
+                image.firstPass = std::min(image.firstPass, i);
+                image.lastPass = std::max(image.lastPass, i);
+                image.usage |= imageUsageInfo(static_cast<ImageUsage>(access.usage)).usageFlag;
+            } else {
+                BufferResource& buffer = m_buffers[access.resource];
+                buffer.firstPass = std::min(buffer.firstPass, i);
+                buffer.lastPass = std::max(buffer.lastPass, i);
+                buffer.usage |= bufferUsageInfo(static_cast<BufferUsage>(access.usage)).usageFlag;
+            }
+        }
+    }
+}
+
+uint32_t VulkanRenderGraph::assignSlot(const VkMemoryRequirements& requirements, const VulkanResourceKind kind,
+                                       const uint32_t firstPass, const uint32_t lastPass) {
+    const auto overlaps = [&](const MemorySlot& slot) {
+        return std::ranges::any_of(slot.lifetimes, [&](const auto& lifetime) {
+            return firstPass <= lifetime.second && lifetime.first <= lastPass;
+        });
+    };
+
+    // First fit over existing slots; growing a slot is fine since nothing is allocated yet
+    for (uint32_t i = 0; i < m_slots.size(); ++i) {
+        MemorySlot& slot = m_slots[i];
+        const uint32_t commonTypes = slot.requirements.memoryTypeBits & requirements.memoryTypeBits;
+        if (slot.kind != kind || commonTypes == 0 || overlaps(slot)) continue;
+
+        slot.requirements.size = std::max(slot.requirements.size, requirements.size);
+        slot.requirements.alignment = std::max(slot.requirements.alignment, requirements.alignment);
+        slot.requirements.memoryTypeBits = commonTypes;
+        slot.lifetimes.emplace_back(firstPass, lastPass);
+        return i;
+    }
+
+    m_slots.push_back({ .allocation = {}, .requirements = requirements, .kind = kind,
+                        .lifetimes = { { firstPass, lastPass } } });
+    return static_cast<uint32_t>(m_slots.size() - 1);
+}
+
+void VulkanRenderGraph::allocateTransients() {
+    struct Pending {
+        bool isImage;
+        uint32_t index;
+        VkMemoryRequirements requirements;
+    };
+    std::vector<Pending> pending;
+
+    for (uint32_t i = 0; i < m_images.size(); ++i) {
+        ImageResource& image = m_images[i];
+        if (image.imported || image.firstPass == UINT32_MAX) continue;
+
+        VkImageCreateInfo imageInfo {
+            .sType          = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType      = VK_IMAGE_TYPE_2D,
+            .format         = image.desc.format,
+            .extent         = { image.desc.extent.width, image.desc.extent.height, 1 },
+            .mipLevels      = 1,
+            .arrayLayers    = 1,
+            .samples        = VK_SAMPLE_COUNT_1_BIT,
+            .tiling         = VK_IMAGE_TILING_OPTIMAL,
+            .usage          = image.usage,
+            .sharingMode    = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        if (vkCreateImage(m_device, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create render graph image " + image.name + ".");
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(m_device, image.image, &requirements);
+        pending.push_back({ true, i, requirements });
+        ++m_stats.transientImageCount;
+    }
+
+    for (uint32_t i = 0; i < m_buffers.size(); ++i) {
+        BufferResource& buffer = m_buffers[i];
+        if (buffer.imported || buffer.firstPass == UINT32_MAX) continue;
+
+        VkBufferCreateInfo bufferInfo {
+            .sType          = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size           = buffer.size,
+            .usage          = buffer.usage,
+            .sharingMode    = VK_SHARING_MODE_EXCLUSIVE
+        };
+
+        if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create render graph buffer " + buffer.name + ".");
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_device, buffer.buffer, &requirements);
+        pending.push_back({ false, i, requirements });
+        ++m_stats.transientBufferCount;
+    }
+
+    // Biggest first so small transients fill in around them
+    std::ranges::sort(pending, [](const Pending& a, const Pending& b) {
+        return a.requirements.size > b.requirements.size;
+    });
+
+    for (const Pending& item : pending) {
+        m_stats.transientBytes += item.requirements.size;
+        if (item.isImage) {
+            ImageResource& image = m_images[item.index];
+            image.slot = assignSlot(item.requirements, VulkanResourceKind::Optimal, image.firstPass, image.lastPass);
+        } else {
+            BufferResource& buffer = m_buffers[item.index];
+            buffer.slot = assignSlot(item.requirements, VulkanResourceKind::Linear, buffer.firstPass, buffer.lastPass);
+        }
+    }
+
+    for (MemorySlot& slot : m_slots) {
+        slot.allocation = m_allocator.allocate(slot.requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, slot.kind);
+        m_stats.allocatedBytes += slot.requirements.size;
+    }
+    m_stats.memorySlotCount = static_cast<uint32_t>(m_slots.size());
+
+    for (ImageResource& image : m_images) {
+        if (image.imported || image.image == VK_NULL_HANDLE) continue;
+
+        const VulkanAllocation& allocation = m_slots[image.slot].allocation;
+        vkBindImageMemory(m_device, image.image, allocation.memory, allocation.offset);
+
+        VkImageViewCreateInfo viewInfo {
+            .sType      = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image      = image.image,
+            .viewType   = VK_IMAGE_VIEW_TYPE_2D,
+            .format     = image.desc.format,
+            .subresourceRange = {
+                .aspectMask     = aspectFor(image.desc.format),
+                .baseMipLevel   = 0,
+                .levelCount     = 1,
+                .baseArrayLayer = 0,
+                .layerCount     = 1
+            }
+        };
+
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &image.view) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create render graph image view " + image.name + ".");
+        }
+    }
+
+    for (BufferResource& buffer : m_buffers) {
+        if (buffer.imported || buffer.buffer == VK_NULL_HANDLE) continue;
+
+        const VulkanAllocation& allocation = m_slots[buffer.slot].allocation;
+        vkBindBufferMemory(m_device, buffer.buffer, allocation.memory, allocation.offset);
+    }
+}
+
+void VulkanRenderGraph::planBarriers() {
+    struct State {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stage = 0;
+        VkAccessFlags access = 0;      // Accesses since the last barrier
+        bool written = false;          // Whether any of them wrote
+        bool touched = false;
+    };
+
+    std::vector<State> imageStates;
+    std::vector<State> bufferStates;
+
+    // Every frame in flight shares the transients' memory, so a slot's first occupant must also wait
+    // for the previous frame's last occupant. The first round only leaves that last use in the slots;
+    // the second plans against it, since a barrier's first scope covers earlier submissions too.
+    for (uint32_t round = 0; round < 2; ++round) {
+        m_steps.clear();
+        m_stats.barrierBatchCount = 0;
+        imageStates.assign(m_images.size(), {});
+        bufferStates.assign(m_buffers.size(), {});
+
+        for (uint32_t i = 0; i < m_images.size(); ++i) {
+            if (m_images[i].imported) {
+                imageStates[i].layout = m_images[i].importState.initialLayout;
+                imageStates[i].stage = m_images[i].importState.initialStage;
+            }
+        }
+
+        for (uint32_t p = 0; p < m_passes.size(); ++p) {
+            const Pass& pass = m_passes[p];
+            if (!pass.live) continue;
+
+            Step step { .pass = p };
+            BarrierBatch& batch = step.barriers;
+
+            for (const Access& access : pass.accesses) {
+                const UsageInfo info = access.isImage
+                    ? imageUsageInfo(static_cast<ImageUsage>(access.usage))
+                    : bufferUsageInfo(static_cast<BufferUsage>(access.usage));
+                const VkAccessFlags dstAccess = access.isWrite ? info.writeAccess | info.readAccess : info.readAccess;
+
+                State& state = access.isImage ? imageStates[access.resource] : bufferStates[access.resource];
+
+                // A transient's first use inherits the hazard of whatever used its memory before
+                if (!state.touched && access.isImage && !m_images[access.resource].imported) {
+                    const MemorySlot& slot = m_slots[m_images[access.resource].slot];
+                    state.stage = slot.lastStage;
+                    state.access = slot.lastAccess;
+                    state.written = slot.lastAccess != 0;
+                } else if (!state.touched && !access.isImage && !m_buffers[access.resource].imported) {
+                    const MemorySlot& slot = m_slots[m_buffers[access.resource].slot];
+                    state.stage = slot.lastStage;
+                    state.access = slot.lastAccess;
+                    state.written = slot.lastAccess != 0;
+                }
+
+                const bool layoutChange = access.isImage && state.layout != info.layout;
+                const bool hazard = state.written || (access.isWrite && state.access != 0);
+
+                if (layoutChange || hazard || (access.isImage && !state.touched && state.stage != 0)) {
+                    batch.srcStage |= state.stage != 0 ? state.stage : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                    batch.dstStage |= info.stage;
+
+                    const VkAccessFlags srcAccess = state.written ? state.access : 0;
+                    if (access.isImage) {
+                        batch.images.push_back({ access.resource, state.layout, info.layout, srcAccess, dstAccess });
+                    } else {
+                        batch.buffers.push_back({ access.resource, srcAccess, dstAccess });
+                    }
+
+                    state.stage = info.stage;
+                    state.access = dstAccess;
+                    state.written = access.isWrite;
+                } else {
+                    // Read after read in the same layout: just widen the tracked scope
+                    state.stage |= info.stage;
+                    state.access |= dstAccess;
+                }
+
+                state.layout = access.isImage ? info.layout : state.layout;
+                state.touched = true;
+            }
+
+            if (!batch.empty()) {
+                ++m_stats.barrierBatchCount;
+            }
+            m_steps.push_back(std::move(step));
+
+            // Record the last use of every transient that dies here for its slot's next occupant
+            for (const Access& access : pass.accesses) {
+                if (access.isImage) {
+                    const ImageResource& image = m_images[access.resource];
+                    if (!image.imported && image.lastPass == p) {
+                        m_slots[image.slot].lastStage = imageStates[access.resource].stage;
+                        m_slots[image.slot].lastAccess = imageStates[access.resource].access;
+                    }
+                } else {
+                    const BufferResource& buffer = m_buffers[access.resource];
+                    if (!buffer.imported && buffer.lastPass == p) {
+                        m_slots[buffer.slot].lastStage = bufferStates[access.resource].stage;
+                        m_slots[buffer.slot].lastAccess = bufferStates[access.resource].access;
+                    }
+                }
+            }
+        }
+    }
+
+    // Hand imported images back in the layout their owner expects (present, readback)
+    for (uint32_t i = 0; i < m_images.size(); ++i) {
+        const ImageResource& image = m_images[i];
+        const State& state = imageStates[i];
+        if (!image.imported || !state.touched || state.layout == image.importState.finalLayout) continue;
+
+        m_finalBarriers.srcStage |= state.stage;
+        m_finalBarriers.dstStage |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        m_finalBarriers.images.push_back({ i, state.layout, image.importState.finalLayout,
+                                           state.written ? state.access : 0, 0 });
+    }
+}
+
+void VulkanRenderGraph::destroyTransients() {
+    for (ImageResource& image : m_images) {
+        if (image.imported) continue;
+        if (image.view != VK_NULL_HANDLE) vkDestroyImageView(m_device, image.view, nullptr);
+        if (image.image != VK_NULL_HANDLE) vkDestroyImage(m_device, image.image, nullptr);
+        image.view = VK_NULL_HANDLE;
+        image.image = VK_NULL_HANDLE;
+        image.slot = UINT32_MAX;
+    }
+
+    for (BufferResource& buffer : m_buffers) {
+        if (buffer.imported) continue;
+        if (buffer.buffer != VK_NULL_HANDLE) vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+        buffer.buffer = VK_NULL_HANDLE;
+        buffer.slot = UINT32_MAX;
+    }
+
+    for (const MemorySlot& slot : m_slots) {
+        if (slot.allocation.isValid()) m_allocator.free(slot.allocation);
+    }
+    m_slots.clear();
+}
+
+// --- Execution ---
+
+void VulkanRenderGraph::recordBarriers(VkCommandBuffer cmd, const BarrierBatch& batch,
+                                       const std::vector<ImageResource>& images,
+                                       const std::vector<BufferResource>& buffers) {
+    if (batch.empty()) return;
+
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    imageBarriers.reserve(batch.images.size());
+    for (const ImageBarrier& barrier : batch.images) {
+        const ImageResource& image = images[barrier.image];
+        imageBarriers.push_back({
+            .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask          = barrier.srcAccess,
+            .dstAccessMask          = barrier.dstAccess,
+            .oldLayout              = barrier.oldLayout,
+            .newLayout              = barrier.newLayout,
+            .srcQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+            .image                  = image.image,
+            .subresourceRange = {
+                .aspectMask     = aspectFor(image.desc.format),
+                .baseMipLevel   = 0,
+                .levelCount     = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount     = VK_REMAINING_ARRAY_LAYERS
+            }
+        });
+    }
+
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    bufferBarriers.reserve(batch.buffers.size());
+    for (const BufferBarrier& barrier : batch.buffers) {
+        bufferBarriers.push_back({
+            .sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask          = barrier.srcAccess,
+            .dstAccessMask          = barrier.dstAccess,
+            .srcQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+            .buffer                 = buffers[barrier.buffer].buffer,
+            .offset                 = 0,
+            .size                   = VK_WHOLE_SIZE
+        });
+    }
+
+    vkCmdPipelineBarrier(cmd, batch.srcStage, batch.dstStage, 0,
+                         0, nullptr,
+                         static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                         static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+void VulkanRenderGraph::execute(VkCommandBuffer cmd, VulkanGpuProfiler* profiler) const {
+    if (!m_compiled) {
+        throw std::runtime_error("Render graph executed before compile().");
+    }
+
+    for (const Step& step : m_steps) {
+        const Pass& pass = m_passes[step.pass];
+        recordBarriers(cmd, step.barriers, m_images, m_buffers);
+
+        const uint32_t scope = profiler ? profiler->beginScope(cmd, pass.name) : VulkanGpuProfiler::kInvalidScope;
+        pass.execute(cmd);
+        if (profiler) profiler->endScope(cmd, scope);
+    }
+
+    recordBarriers(cmd, m_finalBarriers, m_images, m_buffers);
+}
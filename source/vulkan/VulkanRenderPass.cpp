@@ -2,18 +2,34 @@
 #include "Logger.h"
 #include <stdexcept>
 
-VulkanRenderPass::VulkanRenderPass(VkDevice device, VkFormat imageFormat)
+VulkanRenderPass::VulkanRenderPass(VkDevice device, VkFormat imageFormat, VkFormat depthFormat,
+                                   VkImageLayout finalLayout, VkImageLayout initialLayout)
     : m_device(device)
 {
-    VkAttachmentDescription colorAttachment {
-        .format             = imageFormat,
-        .samples            = VK_SAMPLE_COUNT_1_BIT,
-        .loadOp             = VK_ATTACHMENT_LOAD_OP_CLEAR,
-        .storeOp            = VK_ATTACHMENT_STORE_OP_STORE,
-        .stencilLoadOp      = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-        .stencilStoreOp     = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-        .initialLayout      = VK_IMAGE_LAYOUT_UNDEFINED,
-        .finalLayout        = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+    const bool hasDepth = depthFormat != VK_FORMAT_UNDEFINED;
+
+    const VkAttachmentDescription attachments[] = {
+        {
+            .format             = imageFormat,
+            .samples            = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp             = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp            = VK_ATTACHMENT_STORE_OP_STORE,
+            .stencilLoadOp      = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp     = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout      = initialLayout,
+            .finalLayout        = finalLayout
+        },
+        {
+            // Depth only lives for the pass, so it is never stored
+            .format             = depthFormat,
+            .samples            = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp             = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp            = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .stencilLoadOp      = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp     = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .finalLayout        = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+        }
     };
 
     VkAttachmentReference colorRef {
@@ -21,25 +37,34 @@ VulkanRenderPass::VulkanRenderPass(VkDevice device, VkFormat imageFormat)
         .layout         = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
     };
 
+    VkAttachmentReference depthRef {
+        .attachment     = 1,
+        .layout         = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+    };
+
     VkSubpassDescription subpass {
-        .pipelineBindPoint      = VK_PIPELINE_BIND_POINT_GRAPHICS,
-        .colorAttachmentCount   = 1,
-        .pColorAttachments      = &colorRef
+        .pipelineBindPoint          = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .colorAttachmentCount       = 1,
+        .pColorAttachments          = &colorRef,
+        .pDepthStencilAttachment    = hasDepth ? &depthRef : nullptr
     };
 
     VkSubpassDependency dependency {
         .srcSubpass     = VK_SUBPASS_EXTERNAL,
         .dstSubpass     = 0,
-        .srcStageMask   = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        .dstStageMask   = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        .srcAccessMask  = 0,
-        .dstAccessMask  = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+        .srcStageMask   = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                          VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        .dstStageMask   = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                          VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+        .srcAccessMask  = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask  = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
     };
 
     VkRenderPassCreateInfo renderPassInfo {
         .sType              = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-        .attachmentCount    = 1,
-        .pAttachments       = &colorAttachment,
+        .attachmentCount    = hasDepth ? 2u : 1u,
+        .pAttachments       = attachments,
         .subpassCount       = 1,
         .pSubpasses         = &subpass,
         .dependencyCount    = 1,
@@ -0,0 +1,59 @@
+#include "VulkanUniformRing.h"
+#include "VulkanBuffer.h"
+#include "Logger.h"
+
+#include <stdexcept>
+
+namespace {
+VkDeviceSize alignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+}
+
+VulkanUniformRing::VulkanUniformRing(
+    VulkanMemoryAllocator& allocator,
+    VkDeviceSize minOffsetAlignment,
+    VkDeviceSize regionSize,
+    uint32_t regionCount)
+        : m_alignment(minOffsetAlignment > 0 ? minOffsetAlignment : 1),
+          m_regionSize(alignUp(regionSize, m_alignment)),
+          m_regionCount(regionCount) {
+
+    m_buffer = std::make_unique<VulkanBuffer>(
+        allocator,
+        m_regionSize * m_regionCount,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+
+    if (!m_buffer->getMappedData()) {
+        throw std::runtime_error("Uniform ring buffer is not host-mapped.");
+    }
+
+    DEBUG("Uniform ring created with ", m_regionCount, " regions of ", m_regionSize, " bytes.");
+}
+
+VulkanUniformRing::~VulkanUniformRing() = default;
+
+void VulkanUniformRing::beginFrame(const uint32_t frameIndex) {
+    m_regionBegin = static_cast<VkDeviceSize>(frameIndex % m_regionCount) * m_regionSize;
+    m_head = m_regionBegin;
+}
+
+VulkanUniformRing::Allocation VulkanUniformRing::allocate(const VkDeviceSize size) {
+    const VkDeviceSize offset = alignUp(m_head, m_alignment);
+    if (offset + size > m_regionBegin + m_regionSize) {
+        throw std::runtime_error("Uniform ring region exhausted for this frame.");
+    }
+
+    m_head = offset + size;
+    return {
+        .data   = static_cast<char*>(m_buffer->getMappedData()) + offset,
+        .offset = static_cast<uint32_t>(offset),
+        .size   = size
+    };
+}
+
+VkBuffer VulkanUniformRing::getBuffer() const {
+    return m_buffer->get();
+}
@@ -0,0 +1,407 @@
+#include "VulkanUploadManager.h"
+#include "VulkanBuffer.h"
+#include "VulkanDevice.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+VkDeviceSize alignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+VulkanUploadManager::VulkanUploadManager(const VulkanDevice& device, VkDeviceSize stagingSize)
+    : m_device(device.getDevice()),
+      m_vulkanDevice(device),
+      m_queue(device.getTransferQueue()),
+      m_transferFamily(device.getTransferQueueFamily()),
+      m_graphicsFamily(device.getQueueIndices().graphics.value()),
+      m_stagingSize(stagingSize) {
+
+    // Copy offsets must be a multiple of 4 and of the texel size; 16 covers every format we use
+    m_stagingAlignment = std::max<VkDeviceSize>(16, device.getProperties().limits.optimalBufferCopyOffsetAlignment);
+
+    VkCommandPoolCreateInfo poolInfo {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags              = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
+                              VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex   = m_transferFamily
+    };
+
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload command pool.");
+    }
+
+    VkSemaphoreTypeCreateInfo timelineInfo {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType  = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue   = 0
+    };
+
+    VkSemaphoreCreateInfo semaphoreInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &timelineInfo
+    };
+
+    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_timeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload timeline semaphore.");
+    }
+
+    m_staging = std::make_unique<VulkanBuffer>(
+        device.getAllocator(),
+        m_stagingSize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+
+    DEBUG("Upload manager created on queue family ", m_transferFamily,
+          ownershipTransferRequired() ? " (dedicated transfer queue)." : " (shared with graphics).");
+}
+
+VulkanUploadManager::~VulkanUploadManager() {
+    waitIdle();
+
+    m_recording = {};
+    m_inFlight.clear();
+    m_staging.reset();
+
+    vkDestroySemaphore(m_device, m_timeline, nullptr);
+    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    DEBUG("Upload manager destroyed.");
+}
+
+uint64_t VulkanUploadManager::completedValue() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(m_device, m_timeline, &value);
+    return value;
+}
+
+bool VulkanUploadManager::isComplete(const uint64_t ticket) const {
+    return completedValue() >= ticket;
+}
+
+void VulkanUploadManager::waitIdle() {
+    std::lock_guard lock(m_mutex);
+
+    const uint64_t lastSubmitted = m_nextValue - 1;
+    if (lastSubmitted == 0) return;
+
+    VkSemaphoreWaitInfo waitInfo {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores    = &m_timeline,
+        .pValues        = &lastSubmitted
+    };
+    vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX);
+    retireStaging(lastSubmitted);
+}
+
+void VulkanUploadManager::beginRecording() {
+    if (m_recording.cmd != VK_NULL_HANDLE) return;
+
+    VkCommandBuffer cmd;
+    if (!m_freeCommandBuffers.empty()) {
+        cmd = m_freeCommandBuffers.back();
+        m_freeCommandBuffers.pop_back();
+    } else {
+        VkCommandBufferAllocateInfo allocInfo {
+            .sType                  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool            = m_commandPool,
+            .level                  = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount     = 1
+        };
+
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &cmd) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate upload command buffer.");
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    m_recording.cmd = cmd;
+    m_recording.value = m_nextValue;
+}
+
+void VulkanUploadManager::submitRecording() {
+    vkEndCommandBuffer(m_recording.cmd);
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo {
+        .sType                      = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount  = 1,
+        .pSignalSemaphoreValues     = &m_recording.value
+    };
+
+    VkSubmitInfo submitInfo {
+        .sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext                  = &timelineInfo,
+        .commandBufferCount     = 1,
+        .pCommandBuffers        = &m_recording.cmd,
+        .signalSemaphoreCount   = 1,
+        .pSignalSemaphores      = &m_timeline
+    };
+
+    if (vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit upload batch.");
+    }
+
+    ++m_nextValue;
+    m_inFlight.push_back(std::move(m_recording));
+    m_recording = {};
+}
+
+void VulkanUploadManager::flush() {
+    std::lock_guard lock(m_mutex);
+    if (m_recording.cmd != VK_NULL_HANDLE) {
+        submitRecording();
+    }
+}
+
+void VulkanUploadManager::retireStaging(const uint64_t completed) {
+    // Batches finish in submission order, so the ring tail simply follows them
+    for (auto& batch : m_inFlight) {
+        if (batch.value > completed) break;
+        if (batch.value <= m_stagingRetiredValue) continue;
+
+        if (batch.stagingBytes > 0) {
+            m_stagingUsed -= batch.stagingBytes;
+            m_stagingTail = batch.stagingEnd;
+        }
+        batch.dedicatedStaging.clear();
+        m_stagingRetiredValue = batch.value;
+    }
+
+    if (m_stagingUsed == 0) {
+        m_stagingHead = 0;
+        m_stagingTail = 0;
+    }
+}
+
+std::pair<VkBuffer, VkDeviceSize> VulkanUploadManager::stage(const void* data, const VkDeviceSize size) {
+    retireStaging(completedValue());
+
+    const VkDeviceSize aligned = alignUp(m_stagingHead, m_stagingAlignment);
+    std::optional<VkDeviceSize> offset;
+    VkDeviceSize consumed = 0;
+
+    if (m_stagingUsed == 0 || m_stagingHead > m_stagingTail) {
+        // Live bytes are [tail, head): space after head, or wrap to the front
+        if (aligned + size <= m_stagingSize) {
+            offset = aligned;
+            consumed = aligned - m_stagingHead + size;
+        } else if (size < m_stagingTail) {
+            offset = 0;
+            consumed = m_stagingSize - m_stagingHead + size;
+        }
+    } else if (aligned + size < m_stagingTail) {
+        // Wrapped: live bytes are [tail, end) and [0, head)
+        offset = aligned;
+        consumed = aligned - m_stagingHead + size;
+    }
+
+    if (!offset) {
+        // Ring is full; a one-off buffer keeps uploads non-blocking
+        auto dedicated = std::make_unique<VulkanBuffer>(
+            m_vulkanDevice.getAllocator(),
+            size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        std::memcpy(dedicated->getMappedData(), data, size);
+
+        const VkBuffer buffer = dedicated->get();
+        m_recording.dedicatedStaging.push_back(std::move(dedicated));
+        return { buffer, 0 };
+    }
+
+    std::memcpy(static_cast<char*>(m_staging->getMappedData()) + *offset, data, size);
+
+    m_stagingHead = *offset + size;
+    m_stagingUsed += consumed;
+    m_recording.stagingEnd = m_stagingHead;
+    m_recording.stagingBytes += consumed;
+
+    return { m_staging->get(), *offset };
+}
+
+uint64_t VulkanUploadManager::uploadBuffer(
+    VkBuffer dst,
+    VkDeviceSize dstOffset,
+    const void* data,
+    VkDeviceSize size,
+    Callback onComplete) {
+
+    std::lock_guard lock(m_mutex);
+
+    beginRecording();
+    const auto [src, srcOffset] = stage(data, size);
+
+    const VkBufferCopy region {
+        .srcOffset  = srcOffset,
+        .dstOffset  = dstOffset,
+        .size       = size
+    };
+    vkCmdCopyBuffer(m_recording.cmd, src, dst, 1, &region);
+
+    if (ownershipTransferRequired()) {
+        // Release half of the queue-family ownership transfer
+        const VkBufferMemoryBarrier release {
+            .sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask          = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask          = 0,
+            .srcQueueFamilyIndex    = m_transferFamily,
+            .dstQueueFamilyIndex    = m_graphicsFamily,
+            .buffer                 = dst,
+            .offset                 = dstOffset,
+            .size                   = size
+        };
+        vkCmdPipelineBarrier(m_recording.cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0, 0, nullptr, 1, &release, 0, nullptr);
+    }
+
+    m_recording.buffers.push_back({ dst, dstOffset, size });
+    if (onComplete) m_recording.callbacks.push_back(std::move(onComplete));
+    return m_recording.value;
+}
+
+uint64_t VulkanUploadManager::uploadImage(
+    VkImage dst,
+    VkExtent3D extent,
+    VkImageAspectFlags aspect,
+    const void* data,
+    VkDeviceSize size,
+    VkImageLayout finalLayout,
+    Callback onComplete) {
+
+    std::lock_guard lock(m_mutex);
+
+    beginRecording();
+    const auto [src, srcOffset] = stage(data, size);
+
+    const VkImageSubresourceRange range {
+        .aspectMask     = aspect,
+        .baseMipLevel   = 0,
+        .levelCount     = 1,
+        .baseArrayLayer = 0,
+        .layerCount     = 1
+    };
+
+    const VkImageMemoryBarrier toTransfer {
+        .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask          = 0,
+        .dstAccessMask          = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout              = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout              = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+        .image                  = dst,
+        .subresourceRange       = range
+    };
+    vkCmdPipelineBarrier(m_recording.cmd,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+    const VkBufferImageCopy region {
+        .bufferOffset       = srcOffset,
+        .imageSubresource   = { aspect, 0, 0, 1 },
+        .imageOffset        = { 0, 0, 0 },
+        .imageExtent        = extent
+    };
+    vkCmdCopyBufferToImage(m_recording.cmd, src, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // The layout change rides along with the release when ownership moves to graphics
+    const bool transfer = ownershipTransferRequired();
+    const VkImageMemoryBarrier toFinal {
+        .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask          = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask          = 0,
+        .oldLayout              = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout              = finalLayout,
+        .srcQueueFamilyIndex    = transfer ? m_transferFamily : VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex    = transfer ? m_graphicsFamily : VK_QUEUE_FAMILY_IGNORED,
+        .image                  = dst,
+        .subresourceRange       = range
+    };
+    vkCmdPipelineBarrier(m_recording.cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toFinal);
+
+    m_recording.images.push_back({ dst, aspect, finalLayout });
+    if (onComplete) m_recording.callbacks.push_back(std::move(onComplete));
+    return m_recording.value;
+}
+
+uint64_t VulkanUploadManager::recordAcquireBarriers(VkCommandBuffer graphicsCmd) {
+    std::vector<Callback> callbacks;
+    uint64_t waitValue = 0;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        const uint64_t completed = completedValue();
+        retireStaging(completed);
+
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+
+        while (!m_inFlight.empty() && m_inFlight.front().value <= completed) {
+            Batch& batch = m_inFlight.front();
+
+            if (ownershipTransferRequired()) {
+                for (const auto& [buffer, offset, size] : batch.buffers) {
+                    bufferBarriers.push_back({
+                        .sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                        .srcAccessMask          = 0,
+                        .dstAccessMask          = VK_ACCESS_MEMORY_READ_BIT,
+                        .srcQueueFamilyIndex    = m_transferFamily,
+                        .dstQueueFamilyIndex    = m_graphicsFamily,
+                        .buffer                 = buffer,
+                        .offset                 = offset,
+                        .size                   = size
+                    });
+                }
+
+                for (const auto& [image, aspect, layout] : batch.images) {
+                    imageBarriers.push_back({
+                        .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                        .srcAccessMask          = 0,
+                        .dstAccessMask          = VK_ACCESS_MEMORY_READ_BIT,
+                        .oldLayout              = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        .newLayout              = layout,
+                        .srcQueueFamilyIndex    = m_transferFamily,
+                        .dstQueueFamilyIndex    = m_graphicsFamily,
+                        .image                  = image,
+                        .subresourceRange       = { aspect, 0, 1, 0, 1 }
+                    });
+                }
+            }
+
+            std::ranges::move(batch.callbacks, std::back_inserter(callbacks));
+            m_freeCommandBuffers.push_back(batch.cmd);
+            waitValue = batch.value;
+            m_inFlight.pop_front();
+        }
+
+        if (!bufferBarriers.empty() || !imageBarriers.empty()) {
+            vkCmdPipelineBarrier(graphicsCmd,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0, 0, nullptr,
+                static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+        }
+    }
+
+    // Outside the lock so callbacks can queue follow-up uploads
+    for (const auto& callback : callbacks) callback();
+
+    return waitValue;
+}
@@ -0,0 +1,135 @@
+// Converts OBJ or glTF geometry into the memory-mapped mesh format the
+// renderer loads (MeshFile.h): every mesh in the source merged into one,
+// indexed, optimized, optionally packed, with a chain of vertex-clustering
+// LODs sharing one vertex stream.
+//
+//   VulkanLabMeshConverter input.{obj,gltf,glb} output.vmesh [--packed] [--lods N] [--no-optimize]
+
+#include "JobSystem.h"
+#include "MeshFile.h"
+#include "MeshImporter.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string input;
+    std::string output;
+    bool packed = false;
+    uint32_t lodCount = 1;      // Levels written, the source mesh included
+    bool optimize = true;
+};
+
+bool parseOptions(const int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (!std::strcmp(argv[i], "--packed")) options.packed = true;
+        else if (!std::strcmp(argv[i], "--lods")) options.lodCount = std::max(1ul, std::strtoul(value(), nullptr, 10));
+        else if (!std::strcmp(argv[i], "--no-optimize")) options.optimize = false;
+        else if (options.input.empty()) options.input = argv[i];
+        else if (options.output.empty()) options.output = argv[i];
+        else std::fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+    }
+    return !options.input.empty() && !options.output.empty();
+}
+
+// The first simplified level clusters on cells of 1/64 of the largest extent;
+// every further level doubles the cell size
+// Source meshes keep their model-space placement, so they are simply concatenated
+Mesh merge(std::vector<ImportedMesh>&& meshes) {
+    if (meshes.size() == 1) return std::move(meshes.front().mesh);
+
+    Mesh merged;
+    for (ImportedMesh& imported : meshes) {
+        const auto base = static_cast<uint32_t>(merged.vertices.size());
+        merged.vertices.insert(merged.vertices.end(), imported.mesh.vertices.begin(), imported.mesh.vertices.end());
+        for (const uint32_t index : imported.mesh.indices) {
+            merged.indices.push_back(base + index);
+        }
+        imported.mesh = {};
+    }
+    return merged;
+}
+
+std::vector<MeshFileLod> buildLods(Mesh& mesh, const uint32_t lodCount) {
+    std::vector<MeshFileLod> lods { { .firstIndex = 0, .indexCount = static_cast<uint32_t>(mesh.indices.size()) } };
+    if (lodCount <= 1 || mesh.vertices.empty()) return lods;
+
+    glm::vec3 lower = mesh.vertices.front().position;
+    glm::vec3 upper = lower;
+    for (const Vertex& vertex : mesh.vertices) {
+        lower = glm::min(lower, vertex.position);
+        upper = glm::max(upper, vertex.position);
+    }
+    const glm::vec3 extent = upper - lower;
+    float cellSize = std::max(extent.x, std::max(extent.y, extent.z)) / 64.0f;
+
+    const std::vector<uint32_t> source = mesh.indices;
+    for (uint32_t level = 1; level < lodCount; ++level, cellSize *= 2.0f) {
+        const std::vector<uint32_t> indices = MeshOptimizer::simplifyClustered(source, mesh.vertices, cellSize);
+        if (indices.empty()) break;
+
+        lods.push_back({
+            .firstIndex = static_cast<uint32_t>(mesh.indices.size()),
+            .indexCount = static_cast<uint32_t>(indices.size()),
+            .error      = cellSize
+        });
+        mesh.indices.insert(mesh.indices.end(), indices.begin(), indices.end());
+    }
+    return lods;
+}
+
+}
+
+int main(const int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s input.{obj,gltf,glb} output.vmesh [--packed] [--lods N] [--no-optimize]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+
+        // The merged mesh is optimized as a whole, so the per-mesh pass is skipped
+        JobSystem jobs;
+        MeshImporter importer(jobs, { .optimize = false });
+        std::vector<ImportedMesh> imported = importer.import(options.input);
+        const size_t meshCount = imported.size();
+        Mesh mesh = merge(std::move(imported));
+        const auto parsed = clock::now();
+
+        if (options.optimize) {
+            MeshOptimizer::optimize(mesh);
+        }
+        const std::vector<MeshFileLod> lods = buildLods(mesh, options.lodCount);
+        const auto processed = clock::now();
+
+        MeshFile::write(options.output, mesh, options.packed ? MeshVertexFormat::Packed : MeshVertexFormat::Float, lods);
+        const auto written = clock::now();
+
+        const auto ms = [](const auto from, const auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+        std::printf("%s: %zu meshes merged, %zu vertices, %zu LODs (", options.output.c_str(), meshCount,
+                    mesh.vertices.size(), lods.size());
+        for (size_t i = 0; i < lods.size(); ++i) {
+            std::printf("%s%u", i == 0 ? "" : "/", lods[i].indexCount / 3);
+        }
+        std::printf(" triangles)\n");
+        std::printf("import %.1f ms, optimize %.1f ms, write %.1f ms\n",
+                    ms(start, parsed), ms(parsed, processed), ms(processed, written));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}